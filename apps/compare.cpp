@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip> // For std::setw()
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "filament-sliding/Clock.hpp"
+#include "filament-sliding/CommandArgumentHandler.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Input.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/Simulation.hpp"
+#include "filament-sliding/Statistics.hpp"
+
+int main(int argc, char* argv[]) {
+    Clock clock; // Counts time from creation to destruction
+    CommandArgumentHandler invokerInputHandler(argc, argv);
+    Input input(invokerInputHandler); // Names the comparison, and holds the
+                                      // output settings of the compared runs
+
+    const std::string runName = input.getRunName();
+    std::cout << "This is compare " << runName << std::endl;
+
+    Log log(runName, clock);
+
+    //-----------------------------------------------------------------------------------------------------
+    // Get the runs that are compared, each followed by the name of its group
+
+    std::string compareRuns;
+    input.copyParameter("compareRuns", compareRuns);
+    if (compareRuns == "NONE") {
+        throw GeneralException(
+                "The parameter compareRuns should name the list of runs to "
+                "compare.");
+    }
+
+    std::ifstream listFile(compareRuns.c_str());
+    if (!listFile) {
+        throw GeneralException(
+                "The list of runs " + compareRuns + " could not be opened.");
+    }
+
+    //-----------------------------------------------------------------------------------------------------
+    // Every run is an independent replica, of which the mean of each statistic
+    // is one sample of its group. Unlike the samples within a run, which
+    // follow each other in one trajectory, these are independent, such that
+    // the SEM of the means of a group is an honest error
+
+    const Simulation simulation(input.getParameterMap(), runName, log);
+
+    std::vector<std::string> groupNames;
+    std::vector<std::string> statisticNames; // In the order first found
+    std::map<std::pair<std::string, std::string>, Statistics> runMeans;
+
+    std::string comparedRunName, groupName;
+    while (listFile >> comparedRunName >> groupName) {
+        if (std::find(groupNames.begin(), groupNames.end(), groupName) ==
+            groupNames.end()) {
+            if (groupNames.size() == 2) {
+                throw GeneralException(
+                        "The list of runs " + compareRuns +
+                        " names more than two groups.");
+            }
+            groupNames.push_back(groupName);
+        }
+
+        const std::string fileName = comparedRunName + ".accumulators.bin";
+        std::ifstream accumulatorFile(fileName.c_str(), std::ios::binary);
+        if (!accumulatorFile) {
+            throw GeneralException(
+                    "The accumulators " + fileName + " could not be opened.");
+        }
+        const std::unique_ptr<Output> p_runOutput =
+                simulation.createOutput(false);
+        p_runOutput->mergeAccumulators(accumulatorFile);
+
+        for (const auto& [statisticName, p_statistic]:
+             p_runOutput->getSampledStatistics()) {
+            if (std::find(
+                        statisticNames.begin(),
+                        statisticNames.end(),
+                        statisticName) == statisticNames.end()) {
+                statisticNames.push_back(statisticName);
+            }
+            runMeans[std::make_pair(statisticName, groupName)].addValue(
+                    p_statistic->getMean());
+        }
+    }
+    if (groupNames.size() != 2) {
+        throw GeneralException(
+                "The list of runs " + compareRuns +
+                " should name exactly two groups.");
+    }
+
+    //-----------------------------------------------------------------------------------------------------
+    // Write, per statistic, the mean over the runs of each group with its SEM,
+    // and the difference of the means in units of its standard error. For
+    // groups that sample the same distribution, this is close to standard
+    // normal, such that values beyond about 3 point at a difference
+
+    const int collumnWidth = 40;
+    std::ofstream comparisonFile((runName + ".comparison.txt").c_str());
+    comparisonFile << std::setprecision(10) << std::setw(collumnWidth)
+                   << "STATISTIC";
+    for (const std::string& name: groupNames) {
+        comparisonFile << std::setw(collumnWidth) << ("RUNS " + name)
+                       << std::setw(collumnWidth) << ("MEAN " + name)
+                       << std::setw(collumnWidth) << ("SEM " + name);
+    }
+    comparisonFile << std::setw(collumnWidth) << "DIFFERENCE/ERROR" << '\n';
+
+    int32_t nCompared = 0;
+    for (const std::string& statisticName: statisticNames) {
+        const auto first =
+                runMeans.find(std::make_pair(statisticName, groupNames[0]));
+        const auto second =
+                runMeans.find(std::make_pair(statisticName, groupNames[1]));
+        // The SEM of a group needs at least two runs
+        if (first == runMeans.end() || second == runMeans.end() ||
+            !first->second.canReportStatistics() ||
+            !second->second.canReportStatistics()) {
+            continue;
+        }
+
+        comparisonFile << std::setw(collumnWidth) << statisticName;
+        for (const auto& group: {first, second}) {
+            comparisonFile << std::setw(collumnWidth)
+                           << group->second.getNumberOfSamples()
+                           << std::setw(collumnWidth) << group->second.getMean()
+                           << std::setw(collumnWidth) << group->second.getSEM();
+        }
+        const double error = std::sqrt(
+                first->second.getSEM() * first->second.getSEM() +
+                second->second.getSEM() * second->second.getSEM());
+        comparisonFile << std::setw(collumnWidth)
+                       << ((second->second.getMean() -
+                            first->second.getMean()) /
+                           error)
+                       << '\n';
+        ++nCompared;
+    }
+    std::cout << "Compared " << nCompared << " statistics" << std::endl;
+
+    return 0;
+}
@@ -1,20 +1,29 @@
-#include <algorithm>
+#include <algorithm> // std::min
+#include <cmath> // std::pow
 #include <cstdint>
 #include <iostream>
+#include <memory> // std::unique_ptr
 #include <string>
+#include <vector>
 
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/Clock.hpp"
 #include "filament-sliding/CommandArgumentHandler.hpp"
 #include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/EquilibrationCache.hpp"
 #include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/Graphics.hpp"
 #include "filament-sliding/Initialiser.hpp"
 #include "filament-sliding/Input.hpp"
 #include "filament-sliding/Log.hpp"
+#include "filament-sliding/MultilevelEstimator.hpp"
 #include "filament-sliding/Output.hpp"
 #include "filament-sliding/Propagator.hpp"
 #include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/ReplicaExchange.hpp"
+#include "filament-sliding/Simulation.hpp"
 #include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 
 int main(int argc, char* argv[]) {
 #ifdef MYDEBUG
@@ -56,456 +65,180 @@ int main(int argc, char* argv[]) {
 #endif // MYDEBUG
 
     //-----------------------------------------------------------------------------------------------------
-    // Get the parameters needed for defining the general systemState.
-    double lengthMobileMicrotubule;
-    input.copyParameter("lengthMobileMicrotubule", lengthMobileMicrotubule);
-    if (lengthMobileMicrotubule <= 0.0) {
-        throw GeneralException(
-                "The parameter lengthMobileMicrotubule contains a wrong "
-                "value.");
-    }
+    // Set the threads over which the work on large systems is divided
 
-    double lengthFixedMicrotubule;
-    input.copyParameter("lengthFixedMicrotubule", lengthFixedMicrotubule);
-    if (lengthFixedMicrotubule <= 0.0) {
+    int32_t nThreads;
+    input.copyParameter("numberThreads", nThreads);
+    if (nThreads <= 0) {
         throw GeneralException(
-                "The parameter lengthFixedMicrotubule contains a wrong value.");
+                "The parameter numberThreads contains a wrong value.");
     }
 
-    double latticeSpacing;
-    input.copyParameter("latticeSpacing", latticeSpacing);
-    if (latticeSpacing <= 0.0) {
-        throw GeneralException(
-                "The parameter latticeSpacing contains a wrong value.");
-    }
+    ThreadPool threadPool(nThreads);
 
-    double maximumStretchPerLatticeSpacing;
-    input.copyParameter("maximumStretch", maximumStretchPerLatticeSpacing);
-    if (maximumStretchPerLatticeSpacing <= 0.0) {
+    // With more than one replica, the threads run whole replicas instead of
+    // splitting the reaction rates of a single system
+    int32_t nReplicas;
+    input.copyParameter("numberReplicas", nReplicas);
+    if (nReplicas <= 0) {
         throw GeneralException(
-                "The parameter maximumStretchPerLatticeSpacing "
-                "contains a wrong value.");
+                "The parameter numberReplicas contains a wrong value.");
     }
 
-    int32_t nActiveCrosslinkers;
-    input.copyParameter("numberActiveCrosslinkers", nActiveCrosslinkers);
-    if (nActiveCrosslinkers < 0) {
-        throw GeneralException(
-                "The parameter nActiveCrosslinkers contains a wrong value.");
-    }
+    std::string lockstepReplicasString;
+    input.copyParameter("lockstepReplicas", lockstepReplicasString);
+    const bool lockstepReplicas = (lockstepReplicasString == "TRUE");
 
-    int32_t nDualCrosslinkers;
-    input.copyParameter("numberDualCrosslinkers", nDualCrosslinkers);
-    if (nDualCrosslinkers < 0) {
+    // With more than one rung, the system is run at a ladder of external
+    // forces, whose states are exchanged
+    int32_t replicaExchangeRungs;
+    input.copyParameter("replicaExchangeRungs", replicaExchangeRungs);
+    if (replicaExchangeRungs <= 0) {
         throw GeneralException(
-                "The parameter nDualCrosslinkers contains a wrong value.");
+                "The parameter replicaExchangeRungs contains a wrong value.");
     }
 
-    int32_t nPassiveCrosslinkers;
-    input.copyParameter("numberPassiveCrosslinkers", nPassiveCrosslinkers);
-    if (nPassiveCrosslinkers < 0) {
-        throw GeneralException(
-                "The parameter nPassiveCrosslinkers contains a wrong value.");
-    }
-
-    double springConstant;
-    input.copyParameter("springConstant", springConstant);
-    if (springConstant < 0.0) {
-        throw GeneralException(
-                "The parameter springConstant contains a wrong value.");
-    }
-
-    std::string addExternalForceString;
-    input.copyParameter("addExternalForce", addExternalForceString);
-    const bool addExternalForce =
-            (addExternalForceString ==
-             "TRUE"); // Whenever it is not TRUE, assume it is false
-
-    std::string externalForceTypeString;
-    input.copyParameter("externalForceType", externalForceTypeString);
-
-    double externalForceValue;
-    input.copyParameter("externalForceValue", externalForceValue);
-
-    SystemState systemState(
-            lengthMobileMicrotubule,
-            lengthFixedMicrotubule,
-            latticeSpacing,
-            maximumStretchPerLatticeSpacing,
-            nActiveCrosslinkers,
-            nDualCrosslinkers,
-            nPassiveCrosslinkers,
-            springConstant,
-            addExternalForce,
-            externalForceTypeString,
-            externalForceValue);
-
-    //-----------------------------------------------------------------------------------------------------
-    // Create the output class. Needs to be done before the propagator, since
-    // this needs samplePositionalDistribution as well
-
-    std::string recordTransitionPathsString;
-    input.copyParameter("recordTransitionPaths", recordTransitionPathsString);
-    const bool recordTransitionPaths = (recordTransitionPathsString == "TRUE");
-
-    std::string samplePositionalDistributionString;
-    input.copyParameter(
-            "samplePositionalDistribution", samplePositionalDistributionString);
-    // Whenever it is not TRUE, assume it is false.
-    // Also overwrite sampling the positional distribution even when it is
-    // turned off when recordTransitionPaths is true. This is a choice made in
-    // the output class, and setting samplePositionalDistribution to true makes
-    // sure those assumptions are satisfied
-    const bool samplePositionalDistribution =
-            (samplePositionalDistributionString == "TRUE") ||
-            recordTransitionPaths;
-
-    double positionalHistogramBinSize;
-    input.copyParameter(
-            "positionalHistogramBinSize", positionalHistogramBinSize);
-    if (samplePositionalDistribution && positionalHistogramBinSize <= 0.0) {
-        throw GeneralException(
-                "The parameter positionalHistogramBinSize contains a wrong "
-                "value.");
-    }
-
-    double positionalHistogramLowestValue;
+    double replicaExchangeLastForceValue;
     input.copyParameter(
-            "positionalHistogramLowestValue", positionalHistogramLowestValue);
-    if (positionalHistogramLowestValue < 0.0) {
-        throw GeneralException(
-                "The parameter positionalHistogramLowestValue contains a wrong "
-                "value.");
-    }
+            "replicaExchangeLastForceValue", replicaExchangeLastForceValue);
 
-    double positionalHistogramHighestValue;
-    input.copyParameter(
-            "positionalHistogramHighestValue", positionalHistogramHighestValue);
-    if (positionalHistogramHighestValue <= positionalHistogramLowestValue) {
+    int32_t replicaExchangePeriod;
+    input.copyParameter("replicaExchangePeriod", replicaExchangePeriod);
+    if (replicaExchangePeriod <= 0) {
         throw GeneralException(
-                "The parameter positionalHistogramHighestValue "
-                "contains a wrong value.");
+                "The parameter replicaExchangePeriod contains a wrong value.");
     }
 
-    std::string bindingDynamicsString;
-    input.copyParameter("bindingDynamics", bindingDynamicsString);
-    const bool bindingDynamics = (bindingDynamicsString == "TRUE");
-
-    int32_t maxNFullCrosslinkers;
-    if (bindingDynamics) {
-        maxNFullCrosslinkers = std::min(
-                systemState.getNFreeSitesFixed(),
-                systemState.getNFreeSitesMobile());
-    }
-    else {
-        maxNFullCrosslinkers =
-                nActiveCrosslinkers + nDualCrosslinkers + nPassiveCrosslinkers;
-    }
-
-#ifdef MYDEBUG
-    std::cout << "The maximum number of full linkers is given by "
-              << maxNFullCrosslinkers << ".\n";
-#endif // MYDEBUG
-
-    int32_t transitionPathProbePeriod;
-    input.copyParameter("transitionPathProbePeriod", transitionPathProbePeriod);
-    if (transitionPathProbePeriod <= 0) {
-        throw GeneralException(
-                "The parameter transitionPathProbePeriod contains a wrong "
-                "value.");
-    }
-
-    int32_t maxNumberTransitionPaths;
-    input.copyParameter("maxNumberTransitionPaths", maxNumberTransitionPaths);
-    if (maxNumberTransitionPaths < 0) {
-        throw GeneralException(
-                "The parameter maxNumberTransitionPaths contains a wrong "
-                "value.");
-    }
-
-    double maxPeriodPositionTracking;
-    input.copyParameter("maxPeriodPositionTracking", maxPeriodPositionTracking);
-    if (maxPeriodPositionTracking < 0.0) {
-        throw GeneralException(
-                "The parameter maxPeriodPositionTracking contains a wrong "
-                "value.");
-    }
+    //-----------------------------------------------------------------------------------------------------
+    // Get the parameters of the system, its output and its propagation, from
+    // which the objects of the run are created
 
-    std::string estimateTimeEvolutionAtPeakString;
-    input.copyParameter(
-            "estimateTimeEvolutionAtPeak", estimateTimeEvolutionAtPeakString);
-    const bool estimateTimeEvolutionAtPeak =
-            (estimateTimeEvolutionAtPeakString == "TRUE");
+    Simulation simulation(input.getParameterMap(), runName, log);
 
-    int32_t timeStepsPerDistributionEstimate;
-    input.copyParameter(
-            "timeStepsPerDistributionEstimate",
-            timeStepsPerDistributionEstimate);
-    if (estimateTimeEvolutionAtPeak && timeStepsPerDistributionEstimate <= 0) {
-        throw GeneralException(
-                "The parameter timeStepsPerDistributionEstimate "
-                "contains a wrong value.");
-    }
+    const std::unique_ptr<SystemState> p_systemState =
+            simulation.createSystemState(threadPool);
+    SystemState& systemState = *p_systemState;
 
-    int32_t nEstimatesDistribution;
-    input.copyParameter("nEstimatesDistribution", nEstimatesDistribution);
-    if (estimateTimeEvolutionAtPeak && nEstimatesDistribution <= 0) {
-        throw GeneralException(
-                "The parameter nEstimatesDistribution contains a wrong value.");
-    }
+    const std::unique_ptr<Output> p_output = simulation.createOutput(true);
+    Output& output = *p_output;
 
-    double dynamicsEstimationInitialRegionWidth;
-    input.copyParameter(
-            "dynamicsEstimationInitialRegionWidth",
-            dynamicsEstimationInitialRegionWidth);
-    if (estimateTimeEvolutionAtPeak &&
-        (dynamicsEstimationInitialRegionWidth <= 0.0 ||
-         dynamicsEstimationInitialRegionWidth > 1.0)) {
-        throw GeneralException(
-                "The parameter dynamicsEstimationInitialRegionWidth "
-                "contains a wrong value.");
-    }
-
-    double dynamicsEstimationFinalRegionWidth;
-    input.copyParameter(
-            "dynamicsEstimationFinalRegionWidth",
-            dynamicsEstimationFinalRegionWidth);
-    if (estimateTimeEvolutionAtPeak &&
-        (dynamicsEstimationFinalRegionWidth <= 0.0 ||
-         dynamicsEstimationFinalRegionWidth > 1.0)) {
-        throw GeneralException(
-                "The parameter dynamicsEstimationFinalRegionWidth "
-                "contains a wrong value.");
-    }
-
-    Output output(
-            runName,
-            samplePositionalDistribution,
-            recordTransitionPaths,
-            transitionPathProbePeriod,
-            maxNumberTransitionPaths,
-            positionalHistogramBinSize,
-            positionalHistogramLowestValue,
-            positionalHistogramHighestValue,
-            maxNFullCrosslinkers,
-            maxPeriodPositionTracking,
-            latticeSpacing,
-            estimateTimeEvolutionAtPeak,
-            timeStepsPerDistributionEstimate,
-            nEstimatesDistribution,
-            dynamicsEstimationInitialRegionWidth,
-            dynamicsEstimationFinalRegionWidth);
+    const std::unique_ptr<Initialiser> p_initialiser =
+            simulation.createInitialiser();
+    Initialiser& initialiser = *p_initialiser;
 
     //-----------------------------------------------------------------------------------------------------
-    // Get the parameters needed for initialising the state.
+    // Get the parameters for resuming a run or reusing an equilibrated state
 
-    double initialPositionMicrotubule;
-    input.copyParameter(
-            "initialPositionMicrotubule", initialPositionMicrotubule);
-
-    double fractionOverlapSitesConnected;
-    input.copyParameter(
-            "fractionOverlapSitesConnected", fractionOverlapSitesConnected);
-    if (fractionOverlapSitesConnected < 0.0 ||
-        fractionOverlapSitesConnected > 1.0) {
-        throw GeneralException(
-                "The parameter fractionOverlapSitesConnected contains a wrong "
-                "value.");
-    }
+    std::string resumeFromCheckpoint;
+    input.copyParameter("resumeFromCheckpoint", resumeFromCheckpoint);
 
-    std::string initialCrosslinkerDistributionString;
+    std::string equilibrationCacheDirectory;
     input.copyParameter(
-            "initialCrosslinkerDistribution",
-            initialCrosslinkerDistributionString);
-
-    Initialiser initialiser(
-            initialPositionMicrotubule,
-            fractionOverlapSitesConnected,
-            initialCrosslinkerDistributionString);
+            "equilibrationCacheDirectory", equilibrationCacheDirectory);
+    const bool useEquilibrationCache = (equilibrationCacheDirectory != "NONE");
 
-    //-----------------------------------------------------------------------------------------------------
-    // Get the parameters needed for setting the propagator
-
-    int32_t numberEquilibrationBlocks;
-    input.copyParameter("numberEquilibrationBlocks", numberEquilibrationBlocks);
-    if (numberEquilibrationBlocks < 0) {
+    int32_t equilibrationCacheSlots;
+    input.copyParameter("equilibrationCacheSlots", equilibrationCacheSlots);
+    if (equilibrationCacheSlots <= 0) {
         throw GeneralException(
-                "The parameter numberEquilibrationBlocks contains a wrong "
+                "The parameter equilibrationCacheSlots contains a wrong "
                 "value.");
     }
 
-    int32_t numberRunBlocks;
-    input.copyParameter("numberRunBlocks", numberRunBlocks);
-    if (numberRunBlocks < 0) {
-        throw GeneralException(
-                "The parameter numberRunBlocks contains a wrong value.");
-    }
-
-    int32_t nTimeSteps;
-    input.copyParameter("timeStepsPerBlock", nTimeSteps);
-    if (nTimeSteps <= 0) {
-        throw GeneralException(
-                "The parameter nTimeSteps contains a wrong value.");
-    }
+    EquilibrationCache equilibrationCache(
+            equilibrationCacheDirectory,
+            equilibrationCacheSlots,
+            input.getValuesAffectingState() +
+                    simulation.getEquilibrationSettings());
 
-    double calcTimeStep;
-    input.copyParameter("calcTimeStep", calcTimeStep);
-    if (calcTimeStep <= 0.0) {
-        throw GeneralException(
-                "The parameter calcTimeStep contains a wrong value.");
-    }
+    //-----------------------------------------------------------------------------------------------------
+    // Get the parameters for gathering the statistics together with the other
+    // processes of an ensemble
 
-    int32_t positionProbePeriod;
-    input.copyParameter("positionProbePeriod", positionProbePeriod);
-    if (positionProbePeriod <= 0) {
-        throw GeneralException(
-                "The parameter positionProbePeriod contains a wrong value.");
-    }
+    std::string sharedAccumulators;
+    input.copyParameter("sharedAccumulators", sharedAccumulators);
 
-    double diffusionConstantMicrotubule;
+    int32_t sharedAccumulatorsProcesses;
     input.copyParameter(
-            "diffusionConstantMicrotubule", diffusionConstantMicrotubule);
-    if (diffusionConstantMicrotubule < 0.0) {
+            "sharedAccumulatorsProcesses", sharedAccumulatorsProcesses);
+    if (sharedAccumulatorsProcesses <= 0) {
         throw GeneralException(
-                "The parameter diffusionConstantMicrotubule contains a wrong "
+                "The parameter sharedAccumulatorsProcesses contains a wrong "
                 "value.");
     }
 
-    double ratePassivePartialHop;
-    input.copyParameter("ratePassivePartialHop", ratePassivePartialHop);
-    if (ratePassivePartialHop < 0.0) {
-        throw GeneralException(
-                "The parameter ratePassivePartialHop contains a wrong value.");
-    }
-
-    double ratePassiveFullHop;
-    input.copyParameter("ratePassiveFullHop", ratePassiveFullHop);
-    if (ratePassiveFullHop < 0.0) {
-        throw GeneralException(
-                "The parameter ratePassiveFullHop contains a wrong value.");
+    std::string sharedAccumulatorsEnsemble;
+    input.copyParameter(
+            "sharedAccumulatorsEnsemble", sharedAccumulatorsEnsemble);
+
+    if (sharedAccumulators != "NONE") {
+        // The samples in a checkpoint may already have been folded
+        if (simulation.getCheckpointPeriod() > 0 ||
+            resumeFromCheckpoint != "NONE") {
+            throw GeneralException(
+                    "Shared accumulators are not supported in combination "
+                    "with checkpoints.");
+        }
+        if (sharedAccumulatorsEnsemble == "NONE") {
+            throw GeneralException(
+                    "Shared accumulators need a label of the ensemble in the "
+                    "parameter sharedAccumulatorsEnsemble.");
+        }
+        output.shareAccumulators(
+                sharedAccumulators,
+                sharedAccumulatorsEnsemble,
+                sharedAccumulatorsProcesses);
     }
 
-    double baseRateActivePartialHop;
-    input.copyParameter("baseRateActivePartialHop", baseRateActivePartialHop);
-    if (baseRateActivePartialHop < 0.0) {
-        throw GeneralException(
-                "The parameter baseRateActivePartialHop contains a wrong "
-                "value.");
-    }
+    //-----------------------------------------------------------------------------------------------------
+    // Get the parameters of the multilevel estimate
 
-    double baseRateActiveFullHop;
-    input.copyParameter("baseRateActiveFullHop", baseRateActiveFullHop);
-    if (baseRateActiveFullHop < 0.0) {
+    int32_t multilevelLevels;
+    input.copyParameter("multilevelLevels", multilevelLevels);
+    if (multilevelLevels < 0) {
         throw GeneralException(
-                "The parameter baseRateActiveFullHop contains a wrong value.");
-    }
-
-    double activeHopToPlusBiasEnergy;
-    input.copyParameter("activeHopToPlusBiasEnergy", activeHopToPlusBiasEnergy);
-
-    std::string cooperativityString;
-    input.copyParameter("cooperativity", cooperativityString);
-    const bool cooperativity = (cooperativityString == "TRUE");
-
-    double neighbourBiasEnergy;
-    input.copyParameter("neighbourBiasEnergy", neighbourBiasEnergy);
-    if (!cooperativity) {
-        neighbourBiasEnergy = 0.0;
+                "The parameter multilevelLevels contains a wrong value.");
     }
 
-    double baseRateZeroToOneExtremitiesConnected;
-    input.copyParameter(
-            "baseRateZeroToOneExtremitiesConnected",
-            baseRateZeroToOneExtremitiesConnected);
-    if (baseRateZeroToOneExtremitiesConnected < 0.0) {
+    int32_t multilevelPilotSamples;
+    input.copyParameter("multilevelPilotSamples", multilevelPilotSamples);
+    if (multilevelPilotSamples <= 1) {
         throw GeneralException(
-                "The parameter baseRateZeroToOneExtremitiesConnected contains "
-                "a wrong "
-                "value.");
+                "The parameter multilevelPilotSamples contains a wrong value.");
     }
 
-    double baseRateOneToZeroExtremitiesConnected;
-    input.copyParameter(
-            "baseRateOneToZeroExtremitiesConnected",
-            baseRateOneToZeroExtremitiesConnected);
-    if (baseRateOneToZeroExtremitiesConnected < 0.0) {
+    double multilevelPrecision;
+    input.copyParameter("multilevelPrecision", multilevelPrecision);
+    if (multilevelPrecision <= 0.0) {
         throw GeneralException(
-                "The parameter baseRateOneToZeroExtremitiesConnected contains "
-                "a wrong "
-                "value.");
+                "The parameter multilevelPrecision contains a wrong value.");
     }
 
-    double baseRateOneToTwoExtremitiesConnected;
-    input.copyParameter(
-            "baseRateOneToTwoExtremitiesConnected",
-            baseRateOneToTwoExtremitiesConnected);
-    if (baseRateOneToTwoExtremitiesConnected < 0.0) {
+    int32_t multilevelMaxSamples;
+    input.copyParameter("multilevelMaxSamples", multilevelMaxSamples);
+    if (multilevelMaxSamples < multilevelPilotSamples) {
         throw GeneralException(
-                "The parameter baseRateOneToTwoExtremitiesConnected "
-                "contains a wrong value.");
+                "The parameter multilevelMaxSamples contains a wrong value.");
     }
 
-    double baseRateTwoToOneExtremitiesConnected;
-    input.copyParameter(
-            "baseRateTwoToOneExtremitiesConnected",
-            baseRateTwoToOneExtremitiesConnected);
-    if (baseRateTwoToOneExtremitiesConnected < 0.0) {
+    int32_t multilevelSnapshots;
+    input.copyParameter("multilevelSnapshots", multilevelSnapshots);
+    if (multilevelSnapshots <= 0) {
         throw GeneralException(
-                "The parameter baseRateTwoToOneExtremitiesConnected "
-                "contains a wrong value.");
+                "The parameter multilevelSnapshots contains a wrong value.");
     }
 
-    // Force the (un)binding rates to zero when binding dynamics is turned off,
-    // because then the maximum number of full linkers can be properly set
-    // before
-    if (!bindingDynamics) {
-        baseRateZeroToOneExtremitiesConnected = 0.0;
-        baseRateOneToZeroExtremitiesConnected = 0.0;
-        baseRateOneToTwoExtremitiesConnected = 0.0;
-        baseRateTwoToOneExtremitiesConnected = 0.0;
-    }
-
-    if (bindingDynamics && cooperativity) {
+    // A copy of the equilibrated system checks that the journal of its
+    // changes returns it to the same configuration
+    std::string validateJournalString;
+    input.copyParameter("validateJournal", validateJournalString);
+    const bool validateJournal = (validateJournalString == "TRUE");
+    if (validateJournal && (replicaExchangeRungs > 1 || nReplicas > 1)) {
         throw GeneralException(
-                "Currently, cooperativity is only supported on a system with "
-                "hopping "
-                "crosslinkers, not on a system with binding dynamics.");
+                "The journal is only validated for a single system, not for a "
+                "replica exchange or an ensemble of replicas.");
     }
 
-    double headBindingBiasEnergy;
-    input.copyParameter("headBindingBiasEnergy", headBindingBiasEnergy);
-
-    Propagator propagator(
-            numberEquilibrationBlocks,
-            numberRunBlocks,
-            nTimeSteps,
-            calcTimeStep,
-            positionProbePeriod,
-            diffusionConstantMicrotubule,
-            springConstant,
-            latticeSpacing,
-            ratePassivePartialHop,
-            ratePassiveFullHop,
-            baseRateActivePartialHop,
-            baseRateActiveFullHop,
-            activeHopToPlusBiasEnergy,
-            neighbourBiasEnergy,
-            baseRateZeroToOneExtremitiesConnected,
-            baseRateOneToZeroExtremitiesConnected,
-            baseRateOneToTwoExtremitiesConnected,
-            baseRateTwoToOneExtremitiesConnected,
-            nPassiveCrosslinkers != 0,
-            nDualCrosslinkers != 0,
-            nActiveCrosslinkers != 0,
-            headBindingBiasEnergy,
-            generator,
-            samplePositionalDistribution,
-            recordTransitionPaths,
-            transitionPathProbePeriod,
-            addExternalForce,
-            estimateTimeEvolutionAtPeak,
-            log);
-
     //-----------------------------------------------------------------------------------------------------
     // Get the parameters needed for setting the Graphics
 
@@ -532,8 +265,121 @@ int main(int argc, char* argv[]) {
     //=====================================================================================================
     // Using the objects created so far, perform the actions
 
-    initialiser.initialise(
-            systemState, generator); // initialise the system state
+    // Every rung of a replica exchange writes its own output, the output of
+    // the run only holds the report of the exchanges
+    if (replicaExchangeRungs > 1) {
+        if (showGraphics || multilevelLevels > 0 || nReplicas > 1 ||
+            simulation.getCheckpointPeriod() > 0 ||
+            resumeFromCheckpoint != "NONE" || useEquilibrationCache) {
+            throw GeneralException(
+                    "A replica exchange is not supported in combination with "
+                    "graphics, a multilevel estimate, an ensemble of "
+                    "replicas, checkpoints or the equilibration cache.");
+        }
+
+        ReplicaExchange replicaExchange(
+                input.getParameterMap(),
+                runName,
+                replicaExchangeRungs,
+                replicaExchangeLastForceValue,
+                replicaExchangePeriod,
+                log);
+        replicaExchange.run(threadPool);
+        replicaExchange.writeReport();
+        return 0;
+    }
+
+    // Every replica of an ensemble is initialised, equilibrated and run on its
+    // own, with random numbers seeded by its number. Only the statistics are
+    // kept, and written as the output of the run
+    if (nReplicas > 1) {
+        if (showGraphics || multilevelLevels > 0 ||
+            simulation.getCheckpointPeriod() > 0 ||
+            resumeFromCheckpoint != "NONE" || useEquilibrationCache) {
+            throw GeneralException(
+                    "An ensemble of replicas is not supported in combination "
+                    "with graphics, a multilevel estimate, checkpoints or the "
+                    "equilibration cache.");
+        }
+
+        if (lockstepReplicas && !simulation.supportsLockstepReplicas()) {
+            throw GeneralException(
+                    "Lockstep replicas are not supported in combination with "
+                    "binding dynamics, periodic boundaries, a window on the "
+                    "fixed microtubule, coarse graining, a force that is not "
+                    "constant, or output and stopping criteria that need the "
+                    "system at every time step.");
+        }
+
+        std::vector<std::unique_ptr<Output>> replicaOutputs(nReplicas);
+        if (lockstepReplicas) {
+            // Every thread propagates a batch of replicas in lockstep
+            const int32_t nBatches = std::min(nThreads, nReplicas);
+            const auto runBatch = [&](const int32_t batch) {
+                std::vector<std::unique_ptr<RandomGenerator>> generators;
+                std::vector<RandomGenerator*> batchGenerators;
+                std::vector<Output*> batchOutputs;
+                for (int32_t replica = batch; replica < nReplicas;
+                     replica += nBatches) {
+                    generators.push_back(std::make_unique<RandomGenerator>(
+                            runName + " replica " + std::to_string(replica)));
+                    replicaOutputs[replica] = simulation.createOutput(false);
+                    batchGenerators.push_back(generators.back().get());
+                    batchOutputs.push_back(replicaOutputs[replica].get());
+                }
+                simulation.runLockstepReplicas(batchGenerators, batchOutputs);
+            };
+            threadPool.parallelFor(nBatches, runBatch);
+        }
+        else {
+            const auto runReplica = [&](const int32_t replica) {
+                RandomGenerator replicaGenerator(
+                        runName + " replica " + std::to_string(replica));
+                replicaOutputs[replica] = simulation.createOutput(false);
+                simulation.runReplica(
+                        replicaGenerator, *replicaOutputs[replica]);
+            };
+            threadPool.parallelFor(nReplicas, runReplica);
+        }
+
+        for (const std::unique_ptr<Output>& p_replicaOutput: replicaOutputs) {
+            output.merge(*p_replicaOutput);
+        }
+        return 0;
+    }
+
+    const std::unique_ptr<Propagator> p_propagator =
+            simulation.createPropagator(
+                    simulation.getCalcTimeStep(), generator, threadPool);
+    Propagator& propagator = *p_propagator;
+
+    // A checkpoint replaces the initialisation, and the equilibration and run
+    // blocks continue from it. A cached equilibrated state replaces the
+    // equilibration as well
+    Checkpoint::handleSignals();
+    bool storeEquilibratedState = false;
+    if (resumeFromCheckpoint != "NONE") {
+        propagator.readCheckpoint(
+                resumeFromCheckpoint, systemState, generator, output);
+    }
+    else if (useEquilibrationCache &&
+             simulation.getNEquilibrationBlocks() > 0) {
+        equilibrationCache.drawSlot(generator);
+        if (equilibrationCache.slotHasState()) {
+            equilibrationCache.readState(systemState);
+            propagator.skipEquilibration();
+            log.writeEquilibrationCache(
+                    equilibrationCache.getFileName(), true);
+        }
+        else {
+            initialiser.initialise(systemState, generator);
+            storeEquilibratedState = true;
+        }
+    }
+    else {
+        initialiser.initialise(
+                systemState, generator); // initialise the system state
+    }
 
     propagator.equilibrate(
             systemState,
@@ -542,6 +388,15 @@ int main(int argc, char* argv[]) {
                      // equilibrium distribution can be reached (not guaranteed
                      // to be done)
 
+    if (storeEquilibratedState && propagator.hasStationaryState()) {
+        equilibrationCache.writeState(systemState);
+        log.writeEquilibrationCache(equilibrationCache.getFileName(), false);
+    }
+
+    if (validateJournal) {
+        simulation.validateJournal(systemState, threadPool);
+    }
+
     if (showGraphics) {
         Graphics graphics(
                 runName,
@@ -554,6 +409,33 @@ int main(int argc, char* argv[]) {
 
         graphics.performMainLoop();
     }
+    else if (multilevelLevels > 0) {
+        // The coarsest propagator comes first, and the finest is the one that
+        // equilibrated the system
+        std::vector<std::unique_ptr<Propagator>> coarsePropagators;
+        std::vector<Propagator*> propagators;
+        for (int32_t level = multilevelLevels; level > 0; --level) {
+            coarsePropagators.push_back(simulation.createPropagator(
+                    simulation.getCalcTimeStep() * std::pow(2.0, level),
+                    generator,
+                    threadPool));
+            propagators.push_back(coarsePropagators.back().get());
+        }
+        propagators.push_back(&propagator);
+
+        MultilevelEstimator estimator(
+                runName,
+                propagators,
+                simulation.getNTimeStepsPerBlock(),
+                multilevelPilotSamples,
+                multilevelPrecision,
+                multilevelMaxSamples,
+                multilevelSnapshots);
+        const std::unique_ptr<SystemState> p_coarseSystemState =
+                simulation.createSystemState(threadPool);
+        estimator.estimate(systemState, *p_coarseSystemState, generator);
+        estimator.writeResults();
+    }
     else {
         propagator.run(systemState, generator, output);
     }
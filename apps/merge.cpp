@@ -0,0 +1,64 @@
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "filament-sliding/Clock.hpp"
+#include "filament-sliding/CommandArgumentHandler.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Input.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/Simulation.hpp"
+
+int main(int argc, char* argv[]) {
+    Clock clock; // Counts time from creation to destruction
+    CommandArgumentHandler invokerInputHandler(argc, argv);
+    Input input(invokerInputHandler); // Names the merged output, and holds the
+                                      // output settings of the merged runs
+
+    const std::string runName = input.getRunName();
+    std::cout << "This is merge " << runName << std::endl;
+
+    Log log(runName, clock);
+
+    //-----------------------------------------------------------------------------------------------------
+    // Get the runs that are merged
+
+    std::string mergeRuns;
+    input.copyParameter("mergeRuns", mergeRuns);
+    if (mergeRuns == "NONE") {
+        throw GeneralException(
+                "The parameter mergeRuns should name the list of runs to "
+                "merge.");
+    }
+
+    std::ifstream listFile(mergeRuns.c_str());
+    if (!listFile) {
+        throw GeneralException(
+                "The list of runs " + mergeRuns + " could not be opened.");
+    }
+
+    //-----------------------------------------------------------------------------------------------------
+    // Add the accumulators of every run to an output with the same settings,
+    // which writes the merged statistics and histograms when it is destroyed
+
+    const Simulation simulation(input.getParameterMap(), runName, log);
+    const std::unique_ptr<Output> p_output = simulation.createOutput(true);
+
+    std::string mergedRunName;
+    int32_t nMergedRuns = 0;
+    while (listFile >> mergedRunName) {
+        const std::string fileName = mergedRunName + ".accumulators.bin";
+        std::ifstream accumulatorFile(fileName.c_str(), std::ios::binary);
+        if (!accumulatorFile) {
+            throw GeneralException(
+                    "The accumulators " + fileName + " could not be opened.");
+        }
+        p_output->mergeAccumulators(accumulatorFile);
+        ++nMergedRuns;
+    }
+    std::cout << "Merged " << nMergedRuns << " runs" << std::endl;
+
+    return 0;
+}
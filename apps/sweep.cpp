@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "filament-sliding/Clock.hpp"
+#include "filament-sliding/CommandArgumentHandler.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Input.hpp"
+#include "filament-sliding/JobQueue.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/ParameterGrid.hpp"
+#include "filament-sliding/Sweep.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+int main(int argc, char* argv[]) {
+    Clock clock; // Counts time from creation to destruction
+    CommandArgumentHandler invokerInputHandler(argc, argv);
+    Input input(invokerInputHandler); // Names the sweep and its points, sets
+                                      // the threads, and holds the parameters
+                                      // the grid is expanded around
+
+    const std::string runName = input.getRunName();
+    std::cout << "This is sweep " << runName << std::endl;
+
+    Log log(runName, clock);
+
+    //-----------------------------------------------------------------------------------------------------
+    // Get the parameters of the sweep
+
+    int32_t nThreads;
+    input.copyParameter("numberThreads", nThreads);
+    if (nThreads <= 0) {
+        throw GeneralException(
+                "The parameter numberThreads contains a wrong value.");
+    }
+
+    std::string sweepPoints;
+    input.copyParameter("sweepPoints", sweepPoints);
+
+    std::string sweepGrid;
+    input.copyParameter("sweepGrid", sweepGrid);
+    if (sweepPoints == "NONE" && sweepGrid == "NONE") {
+        throw GeneralException(
+                "The parameters sweepPoints and sweepGrid should name the list "
+                "of parameter files or the specification of the sweep.");
+    }
+
+    std::string jobQueueDirectory;
+    input.copyParameter("jobQueueDirectory", jobQueueDirectory);
+
+    double jobClaimTimeout;
+    input.copyParameter("jobClaimTimeout", jobClaimTimeout);
+    if (jobClaimTimeout <= 0.0) {
+        throw GeneralException(
+                "The parameter jobClaimTimeout contains a wrong value.");
+    }
+
+    //-----------------------------------------------------------------------------------------------------
+    // Run the replicas of all points, and write the output of every point
+
+    Sweep sweep(runName, log);
+    if (sweepPoints != "NONE") {
+        sweep.readPointFiles(sweepPoints);
+    }
+    if (sweepGrid != "NONE") {
+        // The grid is expanded around the parameters of this sweep
+        sweep.addGridPoints(ParameterGrid(input.getParameterMap(), sweepGrid));
+    }
+    sweep.schedule(nThreads);
+
+    // The points are checked, and left to the workers of the queue
+    if (jobQueueDirectory != "NONE") {
+        JobQueue queue(jobQueueDirectory, jobClaimTimeout);
+        sweep.enqueue(queue);
+        return 0;
+    }
+
+    sweep.writeSchedule();
+
+    ThreadPool threadPool(nThreads); // Every thread runs whole replicas
+    sweep.run(threadPool);
+
+    return 0;
+}
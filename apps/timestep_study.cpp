@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unistd.h> // getcwd, only works on POSIX systems
+
+#include "filament-sliding/Clock.hpp"
+#include "filament-sliding/CommandArgumentHandler.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Input.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+#include "filament-sliding/TimeStepStudy.hpp"
+
+// The simulation program is installed next to this one. The rungs run in their
+// own directories, so a relative path is made absolute
+static std::string findSimulationProgram(const std::string& invokedName) {
+    const std::string programName = "filament-sliding";
+    const std::size_t slash = invokedName.rfind('/');
+    if (slash == std::string::npos) {
+        return programName; // Found on the PATH, like this program
+    }
+
+    std::string directory = invokedName.substr(0, slash + 1);
+    if (directory.front() != '/') {
+        char workingDirectory[4096];
+        if (getcwd(workingDirectory, sizeof(workingDirectory)) == nullptr) {
+            throw GeneralException(
+                    "The working directory could not be determined.");
+        }
+        directory = std::string(workingDirectory) + '/' + directory;
+    }
+    return directory + programName;
+}
+
+int main(int argc, char* argv[]) {
+    Clock clock; // Counts time from creation to destruction
+    CommandArgumentHandler invokerInputHandler(argc, argv);
+    Input input(invokerInputHandler); // The parameters of the system that is
+                                      // run at every time step
+
+    const std::string runName = input.getRunName();
+    std::cout << "This is time step study " << runName << std::endl;
+
+    Log log(runName, clock);
+
+    //-----------------------------------------------------------------------------------------------------
+    // Get the parameters of the study
+
+    int32_t nRungs;
+    input.copyParameter("timeStepStudyRungs", nRungs);
+    if (nRungs <= 1) {
+        throw GeneralException(
+                "The parameter timeStepStudyRungs contains a wrong value.");
+    }
+
+    double factor;
+    input.copyParameter("timeStepStudyFactor", factor);
+    if (factor <= 1.0) {
+        throw GeneralException(
+                "The parameter timeStepStudyFactor contains a wrong value.");
+    }
+
+    double tolerance;
+    input.copyParameter("timeStepStudyTolerance", tolerance);
+    if (tolerance <= 0.0) {
+        throw GeneralException(
+                "The parameter timeStepStudyTolerance contains a wrong value.");
+    }
+
+    int32_t nProcesses;
+    input.copyParameter("timeStepStudyProcesses", nProcesses);
+    if (nProcesses <= 0) {
+        throw GeneralException(
+                "The parameter timeStepStudyProcesses contains a wrong value.");
+    }
+
+    double calcTimeStep;
+    input.copyParameter("calcTimeStep", calcTimeStep);
+    if (calcTimeStep <= 0.0) {
+        throw GeneralException(
+                "The parameter calcTimeStep contains a wrong value.");
+    }
+
+    //-----------------------------------------------------------------------------------------------------
+    // Run the system at every time step, and compare the results
+
+    TimeStepStudy study(
+            runName,
+            findSimulationProgram(argv[0]),
+            nRungs,
+            factor,
+            tolerance,
+            calcTimeStep);
+    ThreadPool threadPool(nProcesses); // Every thread waits for a process
+
+    study.prepareRungs(input);
+    study.runRungs(threadPool);
+    study.readObservables();
+    study.writeReport();
+
+    return 0;
+}
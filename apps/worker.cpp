@@ -0,0 +1,82 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "filament-sliding/Clock.hpp"
+#include "filament-sliding/CommandArgumentHandler.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Input.hpp"
+#include "filament-sliding/JobQueue.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Sweep.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+int main(int argc, char* argv[]) {
+    Clock clock; // Counts time from creation to destruction
+    CommandArgumentHandler invokerInputHandler(argc, argv);
+    Input input(invokerInputHandler); // Names the worker, sets its threads and
+                                      // the queue it takes tasks from
+
+    const std::string runName = input.getRunName();
+    std::cout << "This is worker " << runName << std::endl;
+
+    Log log(runName, clock);
+
+    //-----------------------------------------------------------------------------------------------------
+    // Get the parameters of the worker
+
+    int32_t nThreads;
+    input.copyParameter("numberThreads", nThreads);
+    if (nThreads <= 0) {
+        throw GeneralException(
+                "The parameter numberThreads contains a wrong value.");
+    }
+
+    std::string jobQueueDirectory;
+    input.copyParameter("jobQueueDirectory", jobQueueDirectory);
+    if (jobQueueDirectory == "NONE") {
+        throw GeneralException(
+                "The parameter jobQueueDirectory should name the job queue.");
+    }
+
+    double jobClaimTimeout;
+    input.copyParameter("jobClaimTimeout", jobClaimTimeout);
+    if (jobClaimTimeout <= 0.0) {
+        throw GeneralException(
+                "The parameter jobClaimTimeout contains a wrong value.");
+    }
+
+    //-----------------------------------------------------------------------------------------------------
+    // Run the tasks of the queue until none is pending or claimed. Every task
+    // is a point of a sweep, which writes its output under its own run name.
+    // While other workers hold claims, this one waits to take over the claims
+    // of those that crash
+
+    JobQueue queue(jobQueueDirectory, jobClaimTimeout);
+    ThreadPool threadPool(nThreads); // Every thread runs whole replicas
+
+    std::string taskFileName;
+    bool hasTasks = true;
+    while (hasTasks) {
+        if (!queue.claimTask(taskFileName)) {
+            hasTasks = queue.waitForClaims();
+            continue;
+        }
+
+        // A task that fails is reported in the log, and not tried again
+        bool succeeded = true;
+        try {
+            Sweep sweep(runName, log);
+            sweep.addQueuedPoint(taskFileName);
+            sweep.schedule(nThreads);
+            sweep.run(threadPool);
+        } catch (const GeneralException&) {
+            succeeded = false;
+        }
+        if (!queue.finishTask(succeeded)) {
+            log.writeLostClaim(taskFileName);
+        }
+    }
+
+    return 0;
+}
@@ -2,6 +2,7 @@
 #define BINDPARTIALCROSSLINKER_HPP
 
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 #include "filament-sliding/Crosslinker.hpp"
@@ -50,6 +51,13 @@ class BindPartialCrosslinker: public Reaction {
 
     void performReaction(SystemState& systemState, RandomGenerator& generator)
             override;
+
+    // The domain of a connection is that of its site on the fixed microtubule
+    bool hasRatePerPossibility() const override;
+    std::function<void(SystemState&)> chooseReactionInDomain(
+            const SystemState& systemState,
+            RandomGenerator& generator,
+            const int32_t domain) const override;
 };
 
 #endif // BINDPARTIALCROSSLINKER_HPP
@@ -0,0 +1,85 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "filament-sliding/GeneralException.hpp"
+
+/* A checkpoint holds the complete state of a run in a binary file, such that a
+ * run that was stopped can continue exactly as it would have. The classes write
+ * and read their own state with the functions below. Values are stored as they
+ * are in memory, so a checkpoint can only be read by the same build of the
+ * program on the same kind of machine. Further, checkpoints can be requested by
+ * the signals SIGTERM (after which the run stops) and SIGUSR1.
+ */
+
+namespace Checkpoint {
+template <typename T> void write(std::ostream& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T> void read(std::istream& in, T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw GeneralException("A checkpoint ended unexpectedly.");
+    }
+}
+
+template <typename T>
+void writeVector(std::ostream& out, const std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    write(out, static_cast<int64_t>(values.size()));
+    out.write(
+            reinterpret_cast<const char*>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+// Reuses the storage of values
+template <typename T>
+void readVector(std::istream& in, std::vector<T>& values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    int64_t size;
+    read(in, size);
+    if (size < 0) {
+        throw GeneralException("A checkpoint contains a corrupted vector.");
+    }
+    values.resize(static_cast<std::size_t>(size));
+    if (!in.read(
+                reinterpret_cast<char*>(values.data()),
+                static_cast<std::streamsize>(values.size() * sizeof(T)))) {
+        throw GeneralException("A checkpoint ended unexpectedly.");
+    }
+}
+
+void writeString(std::ostream& out, const std::string& text);
+std::string readString(std::istream& in);
+
+// Identifies the file as a checkpoint of this build, in which values are
+// stored in the chosen precision. Reading throws for any other file
+void writeHeader(std::ostream& out);
+void readHeader(std::istream& in);
+
+// Throws when a size read from a checkpoint differs from the one of the system
+// that is restored
+void checkSize(
+        const int64_t sizeInCheckpoint,
+        const int64_t size,
+        const std::string& description);
+
+enum class Request { NONE, CONTINUE, STOP };
+
+// Lets SIGTERM request a checkpoint after which the run stops, and SIGUSR1 one
+// after which it continues
+void handleSignals();
+
+// Returns the request made by a signal since the last call, if any
+Request takeRequest();
+} // namespace Checkpoint
+
+#endif // CHECKPOINT_HPP
@@ -2,6 +2,8 @@
 #define CROSSLINKER_HPP
 
 #include <cstdint>
+#include <istream>
+#include <ostream>
 
 #include "filament-sliding/Extremity.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
@@ -67,6 +69,17 @@ class Crosslinker {
 
     SiteLocation getOneBoundLocationWhenFullyConnected(
             const Crosslinker::Terminus terminus) const;
+
+    // Takes over where the extremities of other are connected. The type of
+    // other should be the same
+    void copyConnectionsFrom(const Crosslinker& other);
+
+    // Whether other has the same type, with the same extremities connected to
+    // the same sites
+    bool isConnectedLike(const Crosslinker& other) const;
+
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
 };
 
 #endif // CROSSLINKER_HPP
@@ -1,15 +1,19 @@
 #ifndef CROSSLINKERCONTAINER_HPP
 #define CROSSLINKERCONTAINER_HPP
 #include <cstdint>
+#include <istream>
+#include <ostream>
 #include <utility> // for std::pair
 #include <vector>
 
 #include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 #include "filament-sliding/FullConnection.hpp"
 #include "filament-sliding/Microtubule.hpp"
 #include "filament-sliding/MobileMicrotubule.hpp"
 #include "filament-sliding/PossibleFullConnection.hpp"
 #include "filament-sliding/PossibleHop.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 
 /* CrosslinkerContainer has two main functions:
  * First, it holds the Crosslinkers of one type, and actively changes their
@@ -44,12 +48,25 @@ class CrosslinkerContainer {
                                         // position between which the current
                                         // possibilities remain valid
 
+    // Partial linkers on the fixed microtubule far away from the overlap can
+    // optionally be coarse grained: they get no individual hop possibilities,
+    // and are moved in aggregate by the Propagator instead. Whether a linker
+    // is distant is decided relative to the mobile position at the last reset
+    // of the possibilities, such that the decision is the same when hops are
+    // added and when the distant linkers are requested.
+    const bool m_coarseGrainDistantPartials;
+    double m_coarseGrainingReferencePosition;
+
     // Use pointers to crosslinkers as IDs: THIS IS DANGEROUS! It will break if
     // m_crosslinkers would ever resize, since that invalidates all pointers to
     // its elements. A possible fix for this (if it were required to resize the
     // m_crosslinkers sometimes) would be to store the labels
     // (0,...,nCrosslinkers-1) instead of pointers). Not the case for now
     std::vector<Crosslinker*> m_freeCrosslinkers;
+    // Free linkers that stand for the partial linkers on the sites outside of
+    // the window of the fixed microtubule, which only SystemState counts. They
+    // are kept apart, such that they cannot bind anywhere else
+    std::vector<Crosslinker*> m_storedCrosslinkers;
     std::vector<Crosslinker*> m_partialCrosslinkers;
     std::vector<Crosslinker*> m_fullCrosslinkers;
     // Keep track of the partial linkers that are bound by the head or tail.
@@ -74,6 +91,31 @@ class CrosslinkerContainer {
             m_fullConnections; // These are not possibilities, but actual
                                // connections
 
+    // In single precision, the extensions of the records above are stored
+    // minus m_extensionShift, the change in the mobile position since the
+    // possibilities were last reset. A move then only changes the shift, which
+    // is kept in double precision, such that the stored numbers are rounded
+    // once and cannot drift. In double precision, the records are updated
+    // instead, and the shift stays zero
+    double m_extensionShift;
+
+    // Subtract the shift from the records added from first on
+    void shiftNewPossibleConnections(
+            std::vector<PossibleFullConnection>& possibleConnections,
+            const std::size_t first) const;
+    void shiftNewPossibleFullHops(
+            std::vector<PossibleFullHop>& possibleFullHops,
+            const std::size_t first) const;
+
+    // When the possibilities are recalculated completely, the linkers can be
+    // divided into domains that are handled on different threads. Each domain
+    // writes to its own buffer, and the buffers are joined in the order of the
+    // domains, such that the result does not depend on the number of threads.
+    ThreadPool* mp_threadPool;
+    std::vector<std::vector<PossibleFullConnection>> m_connectionBuffers;
+    std::vector<std::vector<PossiblePartialHop>> m_partialHopBuffers;
+    std::vector<std::vector<PossibleFullHop>> m_fullHopBuffers;
+
     // The following functions are used internally; cannot be called by public,
     // m_possibleConnections is only altered through calls to (dis)connect
     // functions, or to findPossibleConnections add and remove functions are
@@ -81,6 +123,21 @@ class CrosslinkerContainer {
     // specific crosslinker (extremity).
     void addPossibleConnections(Crosslinker* const p_newPartialCrosslinker);
 
+    // The following overloads only read the state, and write the possibilities
+    // to the given vector instead of the member. This allows them to be
+    // called concurrently
+    void addPossibleConnections(
+            Crosslinker* const p_newPartialCrosslinker,
+            std::vector<PossibleFullConnection>& possibleConnections) const;
+
+    void addPossiblePartialHops(
+            Crosslinker* const p_newPartialCrosslinker,
+            std::vector<PossiblePartialHop>& possiblePartialHops) const;
+
+    void addPossibleFullHops(
+            Crosslinker* const p_newFullCrosslinker,
+            std::vector<PossibleFullHop>& possibleFullHops) const;
+
     void removePossibleConnections(Crosslinker* const p_oldPartialCrosslinker);
 
     void addPossiblePartialHops(Crosslinker* const p_newPartialCrosslinker);
@@ -125,6 +182,19 @@ class CrosslinkerContainer {
 
     void findPossibleFullHops();
 
+    bool isDistantPartial(const Crosslinker* const p_partialCrosslinker) const;
+
+    // Replaces possibilities by the ones found for all linkers, with the
+    // linkers divided over the threads if there are enough of them
+    template <typename Possibility>
+    void findPossibilitiesInDomains(
+            const std::vector<Crosslinker*>& linkers,
+            std::vector<Possibility>& possibilities,
+            std::vector<std::vector<Possibility>>& domainBuffers,
+            void (CrosslinkerContainer::*addPossibilities)(
+                    Crosslinker* const,
+                    std::vector<Possibility>&) const);
+
   public:
     CrosslinkerContainer(
             const int32_t nCrosslinkers,
@@ -133,13 +203,44 @@ class CrosslinkerContainer {
             const Microtubule& fixedMicrotubule,
             const MobileMicrotubule& mobileMicrotubule,
             const double latticeSpacing,
-            const double maxStretch);
+            const double maxStretch,
+            const bool coarseGrainDistantPartials);
     ~CrosslinkerContainer();
     // Delete the default copy constructor and assignment operator, there is no
     // use for them
     CrosslinkerContainer(const CrosslinkerContainer&) = delete;
     CrosslinkerContainer& operator=(const CrosslinkerContainer&) = delete;
 
+    void setThreadPool(ThreadPool* const p_threadPool);
+
+    // Lets relocation map the crosslinkers of other onto those of this
+    // container, which should hold as many crosslinkers
+    void addToRelocation(
+            const CrosslinkerContainer& other,
+            CrosslinkerRelocation& relocation);
+
+    // Only lets relocation give the indices of the crosslinkers of this
+    // container, which is all that is needed to write a checkpoint
+    void addToRelocation(CrosslinkerRelocation& relocation) const;
+
+    // Copies the connections of the crosslinkers and all stored possibilities
+    // from other. The relocation should map the crosslinkers of the whole
+    // system of other onto this system, since possibilities can refer to
+    // crosslinkers of other types
+    void copyStateFrom(
+            const CrosslinkerContainer& other,
+            const CrosslinkerRelocation& relocation);
+
+    // Writes the same state as copyStateFrom copies, with crosslinkers stored
+    // by their index in the relocation. The stored order of the possibilities
+    // is kept, such that a restored system evolves exactly like this one
+    void writeCheckpoint(
+            std::ostream& out,
+            const CrosslinkerRelocation& relocation) const;
+    void readCheckpoint(
+            std::istream& in,
+            const CrosslinkerRelocation& relocation);
+
     Crosslinker& at(const int32_t position);
 
     // The following four functions correspond to the reactions
@@ -159,8 +260,13 @@ class CrosslinkerContainer {
 
     void disconnectFromFullToPartial(Crosslinker& crosslinkerToDisconnect);
 
+    // Moves free linkers into the stored ones, or back, until nStored are
+    // stored. Throws a GeneralException when there are not enough free linkers
+    void setNStoredCrosslinkers(const int32_t nStored);
+
     int32_t getNCrosslinkers() const;
-    int32_t getNFreeCrosslinkers() const;
+    int32_t getNFreeCrosslinkers() const; // Without the stored ones
+    int32_t getNStoredCrosslinkers() const;
     int32_t getNPartialCrosslinkers() const;
     int32_t getNFullCrosslinkers() const;
 
@@ -202,6 +308,17 @@ class CrosslinkerContainer {
 
     std::pair<double, double> movementBordersSetByFullLinkers() const;
 
+    // The positions of the mobile microtubule between which the possibilities
+    // only change through their extensions
+    std::pair<double, double> getPossibilityBorders() const;
+
+    // Calculates the extension of a full linker from the positions of its
+    // extremities, in double precision
+    double findExtension(const Crosslinker& fullLinker) const;
+
+    // To be added to the extensions of the records below
+    double getExtensionShift() const;
+
     const std::vector<PossibleFullConnection>& getPossibleConnections() const;
 
     const std::vector<PossiblePartialHop>& getPossiblePartialHops() const;
@@ -214,6 +331,13 @@ class CrosslinkerContainer {
 
     const std::vector<Crosslinker*>& getFullLinkers() const;
 
+    // Whether a partial linker bound at location is coarse grained
+    bool isDistantSite(const SiteLocation& location) const;
+
+    // The partial linkers that are coarse grained. Returns a copy, since
+    // moving these linkers changes the administration
+    std::vector<Crosslinker*> getDistantPartialLinkers() const;
+
     std::pair<int32_t, int32_t> getNPartialsBoundWithHeadAndTail() const;
 
     const std::vector<Crosslinker*>& getPartialCrosslinkersBoundWithHead()
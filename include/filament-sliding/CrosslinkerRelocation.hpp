@@ -0,0 +1,99 @@
+#ifndef CROSSLINKERRELOCATION_HPP
+#define CROSSLINKERRELOCATION_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "filament-sliding/Checkpoint.hpp"
+#include "filament-sliding/Crosslinker.hpp"
+
+/* The state of a system refers to its crosslinkers by pointers. When the state
+ * is copied from one SystemState to another, these pointers have to be
+ * replaced by pointers to the crosslinkers of the copy. CrosslinkerRelocation
+ * does this, by mapping each crosslinker of the source onto the crosslinker
+ * with the same index in the corresponding vector of the target.
+ * The index of a crosslinker among all ranges also replaces its pointer in a
+ * checkpoint.
+ */
+
+class CrosslinkerRelocation {
+  private:
+    struct Range {
+        const Crosslinker* p_sourceBegin;
+        const Crosslinker* p_sourceEnd;
+        Crosslinker* p_targetBegin;
+    };
+    std::vector<Range> m_ranges;
+
+  public:
+    CrosslinkerRelocation();
+    ~CrosslinkerRelocation();
+
+    // The vectors should have the same size, and should not be resized while
+    // the relocation is used
+    void addRange(
+            const std::vector<Crosslinker>& source,
+            std::vector<Crosslinker>& target);
+
+    // Without a target, only the indices of the source can be found
+    void addRange(const std::vector<Crosslinker>& source);
+
+    // The index of a source crosslinker among all ranges, -1 for nullptr
+    int32_t getIndex(const Crosslinker* const p_sourceLinker) const;
+
+    // The target crosslinker with an index among all ranges
+    Crosslinker* getCrosslinker(const int32_t index) const;
+
+    // nullptr is relocated to nullptr
+    Crosslinker* relocate(const Crosslinker* const p_sourceLinker) const;
+
+    void relocate(
+            const std::vector<Crosslinker*>& sourceLinkers,
+            std::vector<Crosslinker*>& targetLinkers) const;
+
+    // Writes source crosslinkers to a checkpoint by their indices, and reads
+    // them back as target crosslinkers
+    void writeLinkers(
+            std::ostream& out,
+            const std::vector<Crosslinker*>& sourceLinkers) const;
+    void readLinkers(
+            std::istream& in,
+            std::vector<Crosslinker*>& targetLinkers) const;
+
+    // The elements are written as they are, followed by the indices of their
+    // crosslinkers, which replace the pointers when they are read back
+    template <typename T>
+    void writeWithLinkers(
+            std::ostream& out,
+            const std::vector<T>& elements,
+            Crosslinker* T::*p_linker) const {
+        Checkpoint::writeVector(out, elements);
+        std::vector<int32_t> indices;
+        indices.reserve(elements.size());
+        for (const T& element: elements) {
+            indices.push_back(getIndex(element.*p_linker));
+        }
+        Checkpoint::writeVector(out, indices);
+    }
+
+    template <typename T>
+    void readWithLinkers(
+            std::istream& in,
+            std::vector<T>& elements,
+            Crosslinker* T::*p_linker) const {
+        Checkpoint::readVector(in, elements);
+        std::vector<int32_t> indices;
+        Checkpoint::readVector(in, indices);
+        Checkpoint::checkSize(
+                static_cast<int64_t>(indices.size()),
+                static_cast<int64_t>(elements.size()),
+                "number of crosslinker indices");
+        for (std::size_t i = 0; i < elements.size(); ++i) {
+            elements[i].*p_linker = getCrosslinker(indices[i]);
+        }
+    }
+};
+
+#endif // CROSSLINKERRELOCATION_HPP
@@ -0,0 +1,52 @@
+#ifndef EQUILIBRATIONCACHE_HPP
+#define EQUILIBRATIONCACHE_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/SystemState.hpp"
+
+/* EquilibrationCache keeps equilibrated states in a directory, such that runs
+ * with the same physical parameters can start from one instead of
+ * equilibrating. The states are filed under a hash of the parameters that
+ * affect them, the settings of the equilibration and the build of the program,
+ * so a run never starts from a state that was equilibrated for a shorter time
+ * or with a looser criterion than its own. A number of slots is kept per
+ * set of parameters: a run draws a slot with its own random numbers, and fills
+ * it after equilibrating when it is still empty. A run that starts from a
+ * cached state continues with its own random numbers, so runs drawing the same
+ * slot share their initial state, but not their dynamics.
+ */
+
+class EquilibrationCache {
+  private:
+    const std::string m_directory;
+    const int32_t m_nSlots;
+    const std::string m_key; // The parameters and build the states belong to
+    std::string m_fileName; // Of the drawn slot
+
+    // FNV-1a, which unlike std::hash is the same for every build
+    static uint64_t hash(const std::string& text);
+
+  public:
+    EquilibrationCache(
+            const std::string& directory,
+            const int32_t nSlots,
+            const std::string& parameterValues);
+    ~EquilibrationCache();
+
+    void drawSlot(RandomGenerator& generator);
+
+    bool slotHasState() const;
+
+    std::string getFileName() const;
+
+    void readState(SystemState& systemState) const;
+
+    // Written under a temporary name first, such that runs that read the slot
+    // at the same time never see a partial state
+    void writeState(const SystemState& systemState) const;
+};
+
+#endif // EQUILIBRATIONCACHE_HPP
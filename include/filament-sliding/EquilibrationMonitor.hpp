@@ -0,0 +1,58 @@
+#ifndef EQUILIBRATIONMONITOR_HPP
+#define EQUILIBRATIONMONITOR_HPP
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/SystemState.hpp"
+
+/* EquilibrationMonitor decides whether the equilibration can be stopped, from
+ * time series of observables that relax to a stationary distribution: the
+ * energy, the numbers of full and right pulling linkers, and the fraction of
+ * the sites in the overlap on the fixed microtubule that is occupied. The first
+ * half of the series is discarded as the transient. The remainder is taken to
+ * be stationary when, for every observable, the mean of its first tenth and the
+ * mean of its last half differ by less than the tolerance times the standard
+ * error of their difference (the diagnostic of Geweke). Since consecutive
+ * samples are correlated, the standard errors are found from batch means.
+ */
+
+class EquilibrationMonitor {
+  private:
+    const double m_tolerance;
+
+    // Per observable, in the order of getObservableNames
+    std::vector<std::vector<double>> m_samples;
+    std::vector<double> m_zScores; // Found by the last test
+
+    // Returns the difference of the means of the first tenth and the last half
+    // of the samples from begin onwards, divided by its standard error
+    static double findZScore(
+            const std::vector<double>& samples,
+            const std::size_t begin);
+
+  public:
+    EquilibrationMonitor(const double tolerance);
+    ~EquilibrationMonitor();
+
+    static std::vector<std::string> getObservableNames();
+
+    void addSample(const SystemState& systemState);
+
+    int64_t getNumberOfSamples() const;
+
+    // Returns false as long as there are too few samples to tell
+    bool isStationary();
+
+    // Empty when there were too few samples at the last test
+    const std::vector<double>& getZScores() const;
+
+    // See Checkpoint
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
+};
+
+#endif // EQUILIBRATIONMONITOR_HPP
@@ -2,6 +2,8 @@
 #define EXTREMITY_HPP
 
 #include <cstdint>
+#include <istream>
+#include <ostream>
 
 #include "filament-sliding/MicrotubuleType.hpp"
 
@@ -30,6 +32,9 @@ class Extremity {
     void changePosition(const SiteLocation siteToConnectTo);
 
     MicrotubuleType getMicrotubuleConnectedTo() const;
+
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
 };
 
 #endif // EXTREMITY_HPP
@@ -3,16 +3,19 @@
 
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
+#include "filament-sliding/StoragePrecision.hpp"
 
 // Defined struct to group data about a fully connected crosslinker
-struct FullConnection {
+template <typename Scalar> struct BasicFullConnection {
     Crosslinker* p_fullLinker;
     // Extension is the position of the connection on the mobile microtubule
     // minus the position on the fixed microtubule. Hence, is positive if fixed
     // connection is closest to the origin
-    double extension;
+    Scalar extension;
 };
 
+using FullConnection = BasicFullConnection<StorageScalar>;
+
 // Used for checking if possible connections cross existing full connections
 struct FullConnectionLocations {
     Crosslinker* p_fullLinker;
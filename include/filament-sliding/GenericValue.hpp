@@ -64,6 +64,13 @@ class GenericValue {
 
     std::string getUnit() const;
 
+    AllowedTypes getType() const;
+
+    // Reads the value from text, keeping the type and unit. Returns false,
+    // and leaves the value undefined, when the whole text is not a value of
+    // the type
+    bool readValue(const std::string& text);
+
     /* The output operator can be implemented straightforwardly.
      * The input operator has to assume that the type of the right-hand-side is
      * correct. This can be done, because the type cannot change after
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <iostream>
+#include <istream>
+#include <ostream>
 #include <utility>
 #include <vector>
 
@@ -34,6 +36,10 @@ class Histogram: public Statistics {
 
     std::pair<double, double> calculateBinBounds(const int32_t binNumber) const;
 
+    // Throws when the bins that were serialized differ from the ones of this
+    // histogram
+    void readSerialized(std::istream& in);
+
   public:
     Histogram(
             const double binSize,
@@ -44,6 +50,20 @@ class Histogram: public Statistics {
     void addValue(
             const double value); // redefine behaviour of Statistics::addValue
 
+    // Adds the counts and statistics of other, which should have the same bins
+    void merge(const Histogram& other);
+
+    // Also writes the bins and their bounds, which mergeSerialized checks
+    void serialize(std::ostream& out) const;
+    void mergeSerialized(std::istream& in);
+
+    // Also stores the bins. The bins of the histogram that is read should be
+    // the same as in the checkpoint
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
+
+    friend class SharedAccumulators;
+
     friend std::ostream& operator<<(
             std::ostream& out,
             const Histogram& histogram);
@@ -1,6 +1,10 @@
 #ifndef HOPFULL_HPP
 #define HOPFULL_HPP
 
+#include <cstdint>
+#include <functional>
+#include <utility>
+
 #include "filament-sliding/Reaction.hpp"
 
 /* The Reaction that hops one of the connected termini of a fully connected
@@ -40,6 +44,8 @@ class HopFull: public Reaction {
             const SystemState& systemState,
             RandomGenerator& generator) const;
 
+    static void makeHop(SystemState& systemState, const PossibleFullHop& hop);
+
   public:
     HopFull(const double baseRateHead,
             const double baseRateTail,
@@ -52,8 +58,20 @@ class HopFull: public Reaction {
 
     void setCurrentRate(const SystemState& systemState) override;
 
+    // The current rate, split into the rates of the hops that increase and
+    // that decrease the extension of their linker
+    std::pair<double, double> getCurrentRatesByExtensionChange(
+            const SystemState& systemState) const;
+
     void performReaction(SystemState& systemState, RandomGenerator& generator)
             override;
+
+    // The domain of a hop is that of the site it hops to
+    bool hasRatePerPossibility() const override;
+    std::function<void(SystemState&)> chooseReactionInDomain(
+            const SystemState& systemState,
+            RandomGenerator& generator,
+            const int32_t domain) const override;
 };
 
 #endif // HOPFULL_HPP
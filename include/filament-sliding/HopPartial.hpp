@@ -1,6 +1,9 @@
 #ifndef HOPPARTIAL_HPP
 #define HOPPARTIAL_HPP
 
+#include <cstdint>
+#include <functional>
+
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/Reaction.hpp"
 
@@ -30,15 +33,12 @@ class HopPartial: public Reaction {
             m_individualRates; // store one rate for each member of the
                                // CrosslinkerContainer.m_possiblePartialHops
 
-    double getRateToHop(
-            const Crosslinker::Terminus terminusToHop,
-            const HopDirection directionToHop,
-            bool awayFromNeighbour) const;
-
     PossiblePartialHop whichHop(
             const SystemState& systemState,
             RandomGenerator& generator) const;
 
+    void makeHop(SystemState& systemState, const PossiblePartialHop& hop) const;
+
   public:
     HopPartial(
             const double baseRateHead,
@@ -51,8 +51,22 @@ class HopPartial: public Reaction {
 
     void setCurrentRate(const SystemState& systemState) override;
 
+    // Public, such that the Propagator can move coarse grained linkers with
+    // the same rates
+    double getRateToHop(
+            const Crosslinker::Terminus terminusToHop,
+            const HopDirection directionToHop,
+            bool awayFromNeighbour) const;
+
     void performReaction(SystemState& systemState, RandomGenerator& generator)
             override;
+
+    // The domain of a hop is that of the site it hops to
+    bool hasRatePerPossibility() const override;
+    std::function<void(SystemState&)> chooseReactionInDomain(
+            const SystemState& systemState,
+            RandomGenerator& generator,
+            const int32_t domain) const override;
 };
 
 #endif // HOPPARTIAL_HPP
@@ -27,7 +27,8 @@ class Input {
 
     bool askMakeDefault();
 
-    bool fileExists(const std::string& fileName);
+    // Creates the file, and returns false when it already existed
+    bool claimFile(const std::string& fileName);
 
     void setRunName();
 
@@ -45,6 +46,20 @@ class Input {
     void copyParameter(const std::string& name, T& variable) {
         m_parameterMap.copyParameter(name, variable);
     }
+
+    // Changing parameters after reading them allows writing the input files of
+    // related runs with writeParameters
+    template <typename T>
+    void overrideParameter(const std::string& name, const T& value) {
+        m_parameterMap.overrideParameter(name, value);
+    }
+
+    void writeParameters(const std::string& fileName) const;
+
+    const ParameterMap& getParameterMap() const;
+
+    // See ParameterMap::getValuesAffectingState
+    std::string getValuesAffectingState() const;
 };
 
 #endif // INPUT_HPP
@@ -0,0 +1,92 @@
+#ifndef JOBQUEUE_HPP
+#define JOBQUEUE_HPP
+
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "filament-sliding/ParameterMap.hpp"
+
+/* JobQueue is a queue of tasks in a directory, which processes on any node that
+ * shares the file system can take work from. A task is a parameter file, which
+ * moves from the subdirectory pending to claimed, and then to done or failed.
+ * A worker claims a task by renaming it from pending to claimed, under the name
+ * of the task followed by '@' and a name unique to the worker. Only one worker
+ * can do so, since a rename within a file system is atomic. While a task is
+ * claimed, a heartbeat thread refreshes the modification time of its file. A
+ * claim that was not refreshed within the claim timeout belongs to a worker
+ * that crashed or stalled, and is returned to pending by the next worker that
+ * looks for a task. Since every claim has its own name, a worker that lost its
+ * claim cannot move the claim of another worker on the same task: its
+ * heartbeat and finishTask find its own file gone instead. The modification
+ * times are compared to the time at which the file system marks a file of the
+ * worker, not to the clock of its node, such that the clocks of the nodes need
+ * not agree on file systems that set these times on the server, like NFS. The
+ * directories are only handled on POSIX systems.
+ */
+
+class JobQueue {
+  private:
+    const std::string m_directory;
+    const double m_claimTimeout; // In seconds
+    const std::string m_workerName; // Unique to this worker
+
+    // The heartbeat refreshes the claimed task until the claim is released
+    std::string m_claimedTask;
+    std::thread m_heartbeat;
+    std::mutex m_mutex;
+    std::condition_variable m_claimReleased;
+    bool m_isClaimed;
+    bool m_claimLost; // Found by the heartbeat
+
+    // The host name, process ID and a random number
+    static std::string createWorkerName();
+
+    std::string getPath(const std::string& state, const std::string& task)
+            const;
+
+    // The current time of the file system that holds the queue, found by
+    // marking a hidden file of this worker
+    std::time_t getFileSystemTime() const;
+
+    // The tasks in the subdirectory state, sorted by name
+    std::vector<std::string> listTasks(const std::string& state) const;
+
+    // Returns the claims of crashed workers to pending
+    void recoverStaleClaims() const;
+
+    void beatHeart();
+
+    void releaseClaim();
+
+  public:
+    // Creates the directory and its subdirectories when they do not exist
+    JobQueue(const std::string& directory, const double claimTimeout);
+    ~JobQueue();
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    // The task only becomes pending once its file is complete
+    void addTask(const std::string& task, const ParameterMap& parameters);
+
+    // Claims a pending task and gives the name of its parameter file. Returns
+    // false when no task is pending. A worker holds one claim at a time
+    bool claimTask(std::string& fileName);
+
+    // Moves the claimed task to done, or to failed, where it is not claimed
+    // again. Returns false when the claim was lost because it was taken as
+    // stale, in which case another worker repeats the task
+    bool finishTask(const bool succeeded);
+
+    // For a worker that found no pending task: while other workers still hold
+    // claims, which return to pending when these workers crash, waits a
+    // quarter of the claim timeout and returns true. Returns false once no
+    // task is pending or claimed
+    bool waitForClaims() const;
+};
+
+#endif // JOBQUEUE_HPP
@@ -0,0 +1,35 @@
+#ifndef JOURNALENTRY_HPP
+#define JOURNALENTRY_HPP
+
+#include <cstdint>
+
+#include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/MicrotubuleType.hpp"
+
+// Defined struct to record a single change of the SystemState, with the data
+// needed to undo it. Linkers are identified by the site they are bound to,
+// since undoing a disconnection may bind another (equivalent) linker
+struct JournalEntry {
+    enum class Change {
+        CONNECT_FREE,
+        DISCONNECT_PARTIAL,
+        CONNECT_PARTIAL,
+        DISCONNECT_FULL,
+        MOVE_MOBILE,
+        CROSS_BARRIER,
+        MOVE_WINDOW
+    };
+
+    Change change;
+    Crosslinker::Type type;
+    Crosslinker::Terminus terminus; // The terminus that was (dis)connected
+    SiteLocation location; // The site that was (dis)connected
+    SiteLocation remainingLocation; // The site that a linker stays bound to
+                                    // when disconnected from a full connection
+    double position; // Position of the mobile microtubule before the change
+    int32_t attractorPosition; // Also before the change
+    int32_t firstStoredSite; // Of the window on the fixed microtubule, before
+                             // it was moved
+};
+
+#endif // JOURNALENTRY_HPP
@@ -0,0 +1,146 @@
+#ifndef LOCKSTEPREPLICAS_HPP
+#define LOCKSTEPREPLICAS_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/Propagator.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/SystemState.hpp"
+
+/* LockstepReplicas propagates many replicas of a system without binding
+ * dynamics in lockstep, one time step for all of them at a time. Between two
+ * reactions, such a system only changes by the position of its mobile
+ * microtubule: the total extension of the full linkers follows it, and the
+ * rates of the full hops change by a factor exp(-+ k a dx / 2), with a the
+ * lattice spacing. The position, action and these few numbers of every replica
+ * are stored in arrays over the replicas (lanes), such that the rates, the
+ * Gaussian displacements and the moves are found in loops over the lanes that
+ * the compiler can vectorise. A lane that fires a reaction, meets a maximum
+ * stretch, crosses a barrier, or moves to where the possible hops change, is
+ * handled on its own by its SystemState and Propagator, after which its
+ * numbers are found again. The SystemStates are only moved along when they are
+ * needed, such as for the position probes of the output.
+ */
+
+class LockstepReplicas {
+  public:
+    // A replica is propagated with its own random numbers, and gathers its
+    // statistics in its own output
+    struct Replica {
+        SystemState& systemState;
+        Propagator& propagator;
+        RandomGenerator& generator;
+        Output& output;
+    };
+
+  private:
+    std::vector<Replica> m_replicas;
+
+    const int32_t m_nEquilibrationBlocks;
+    const int32_t m_nRunBlocks;
+    const int32_t m_nTimeSteps;
+    const double m_calcTimeStep;
+    const int32_t m_positionProbePeriod;
+    const double m_diffusionConstantMicrotubule;
+    const double m_springConstant;
+    const double m_latticeSpacing;
+    const double m_deviationMicrotubule; // sqrt(2 D t)
+    const double m_hopRateExponent; // -k a / 2, per unit of position change
+
+    double m_currentTime; // Time 0 is at the beginning of the run blocks
+    int32_t m_nDeterministicBoundaryCrossings;
+    int32_t m_nStochasticBoundaryCrossings;
+    Log& m_log;
+
+    // The state of every lane. The rates and the extension are those at
+    // m_synchronisedPosition, where the SystemState was last moved to
+    std::vector<double> m_position;
+    std::vector<double> m_synchronisedPosition;
+    std::vector<double> m_rateIncreasingExtension;
+    std::vector<double> m_rateDecreasingExtension;
+    std::vector<double> m_rateOtherReactions;
+    std::vector<double> m_action;
+    std::vector<double> m_reactionRateThreshold;
+    std::vector<double> m_totalExtension;
+    std::vector<double> m_nFullLinkers;
+    // The deterministic change is extensionFactor * totalExtension +
+    // forceChange, see Propagator::moveMicrotubule
+    std::vector<double> m_extensionFactor;
+    std::vector<double> m_forceChange;
+    // Exclusive borders to the position, set by the maximum stretch of the
+    // full linkers and by the validity of the possible hops
+    std::vector<double> m_lowerMovementBorder;
+    std::vector<double> m_upperMovementBorder;
+    std::vector<double> m_lowerPossibilityBorder;
+    std::vector<double> m_upperPossibilityBorder;
+    // The positions beyond which a barrier is crossed, see
+    // MobileMicrotubule::barrierCrossed
+    std::vector<int32_t> m_attractorPosition;
+    std::vector<double> m_lowerBarrier;
+    std::vector<double> m_upperBarrier;
+
+    // The Box-Muller transform gives two Gaussian numbers from two uniform
+    // ones, the second of which is used at the next time step
+    std::vector<double> m_uniform;
+    std::vector<double> m_gaussianChange;
+    std::vector<double> m_spareGaussianChange;
+    bool m_hasSpareGaussianChanges;
+
+    // Lanes that are handled on their own during the current time step: the
+    // ones that were not moved, since they would pass the borders of the
+    // linkers, and the ones that need attention after their move
+    static constexpr int32_t s_needsAttention = 1;
+    static constexpr int32_t s_beyondMovementBorders = 2;
+    std::vector<int32_t> m_isFlagged;
+
+    const double m_pi = std::acos(-1); // used for the Box-Muller transform
+
+    // Moves the SystemState of a lane to the position of the lane, and
+    // finds the rates and extension at that position
+    void synchroniseLane(const std::size_t lane);
+    void moveSystemToLane(const std::size_t lane);
+    void readLaneFromSystem(const std::size_t lane);
+
+    void setAttractorPosition(
+            const std::size_t lane,
+            const int32_t attractorPosition);
+
+    void performReaction(const std::size_t lane);
+
+    // Moves a lane whose deterministic or random change would take it beyond
+    // the maximum stretch of a linker, like Propagator::moveMicrotubule
+    void moveWithinBorders(const std::size_t lane);
+
+    void drawGaussianChanges();
+
+    void advanceTimeStep(const bool writeOutput);
+
+    void propagateBlock(const bool writeOutput);
+
+  public:
+    // The replicas should be initialised, and share their parameters
+    LockstepReplicas(
+            const std::vector<Replica>& replicas,
+            const int32_t numberEquilibrationBlocks,
+            const int32_t numberRunBlocks,
+            const int32_t nTimeSteps,
+            const double calcTimeStep,
+            const int32_t positionProbePeriod,
+            const double diffusionConstantMicrotubule,
+            const double springConstant,
+            const double latticeSpacing,
+            Log& log);
+    ~LockstepReplicas();
+
+    LockstepReplicas(const LockstepReplicas&) = delete;
+    LockstepReplicas& operator=(const LockstepReplicas&) = delete;
+
+    void equilibrate();
+    void run();
+};
+
+#endif // LOCKSTEPREPLICAS_HPP
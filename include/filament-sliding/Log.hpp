@@ -1,15 +1,26 @@
 #ifndef LOG_HPP
 #define LOG_HPP
 
+#include <cstdint>
 #include <fstream>
+#include <mutex>
+#include <streambuf>
 #include <string>
 
 #include "filament-sliding/Clock.hpp"
+#include "filament-sliding/EquilibrationMonitor.hpp"
+#include "filament-sliding/Statistics.hpp"
 
 class Log {
   private:
     const Clock& m_clock;
     std::ofstream m_logFile;
+    // The buffers of std::cout and std::cerr before they were redirected,
+    // which are restored before the log file closes
+    std::streambuf* const mp_coutBuffer;
+    std::streambuf* const mp_cerrBuffer;
+    std::mutex m_mutex; // The replicas of an ensemble or a sweep share the
+                        // log
 
   public:
     Log(const std::string& runName, const Clock& clock);
@@ -18,6 +29,87 @@ class Log {
     void writeBoundaryProtocolAppearance(
             const int32_t numberDeterministic,
             const int32_t numberStochastic);
+
+    // Reports how often the individual reaction rates were split over the
+    // threads, and how much faster this was than on the calling thread, as
+    // measured on the evaluations that were timed there. A speed-up that is
+    // not positive was not measured
+    void writeConcurrentRateEvaluation(
+            const int32_t nThreads,
+            const int64_t nRateEvaluations,
+            const int64_t nConcurrentRateEvaluations,
+            const int64_t nTimedSerialRateEvaluations,
+            const double speedUp);
+
+    // Reports how many reactions were made in the sublattice domains, and how
+    // much faster the domains chose them on all threads than on the calling
+    // thread, per phase of one colour. A speed-up that is not positive was not
+    // measured
+    void writeSublatticeDomains(
+            const int32_t nDomains,
+            const int32_t nThreads,
+            const int64_t nPhases,
+            const int64_t nReactions,
+            const int32_t maxNReactionsInPhase,
+            const int64_t nTimedSerialPhases,
+            const double speedUp);
+
+    // Reports the error in the force on the mobile microtubule caused by the
+    // precision in which the linker extensions are stored
+    void writeStoragePrecisionValidation(
+            const bool singlePrecision,
+            const Statistics& forceError);
+
+    // Reports whether rolling back the changes recorded in the journal while
+    // a copy of the system was propagated, returned it to the configuration
+    // it was copied from
+    void writeJournalValidation(
+            const int32_t nChanges,
+            const bool sameConfiguration,
+            const double forceDifference);
+
+    // Reports a checkpoint that was requested by a signal, and whether the run
+    // stopped after it
+    void writeRequestedCheckpoint(
+            const std::string& fileName,
+            const double time,
+            const bool stopped);
+
+    void writeResumedFromCheckpoint(
+            const std::string& fileName,
+            const double time);
+
+    // Reports whether the equilibrated state was taken from or stored in the
+    // cache
+    void writeEquilibrationCache(const std::string& fileName, const bool taken);
+
+    // Reports after how many blocks the adaptive equilibration found the
+    // observables to be stationary, or that it did not within the maximum
+    void writeEquilibrationDetection(
+            const bool stationary,
+            const int32_t nBlocks,
+            const int32_t maxNBlocks,
+            const double duration,
+            const EquilibrationMonitor& monitor);
+
+    // Reports after how many run blocks the relative standard error of the
+    // target statistic reached the target, or that it did not within the
+    // maximum
+    void writePrecisionTarget(
+            const bool reached,
+            const int32_t nBlocks,
+            const int32_t maxNBlocks,
+            const double time,
+            const double relativeSEM,
+            const double target);
+
+    // Reports that the output of a point of a sweep was written, after all
+    // its replicas finished
+    void writeSweepPoint(const std::string& runName, const int32_t nReplicas);
+
+    // Reports that the claim of a task of a job queue was taken as stale
+    // before the task finished, such that another worker repeats it
+    void writeLostClaim(const std::string& taskFileName);
 };
 
 #endif // LOG_HPP
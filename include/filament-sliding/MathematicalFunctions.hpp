@@ -3,10 +3,9 @@
 
 #include <cstdint>
 
-/* Define useful functions that are not present in the standard library or in
- * the GNU Scientific Library (GSL). Also, if a function defined in one of those
- * libraries does not behave as required in a program, a modified version of the
- * function can be defined here.
+/* Define useful functions that are not present in the standard library. Also,
+ * if a function defined in a library does not behave as required in a program,
+ * a modified version of the function can be defined here.
  */
 
 namespace MathematicalFunctions {
@@ -23,6 +22,16 @@ int32_t intFloor(const double arg);
 // the argument
 int32_t alternativeIntCeil(const double arg);
 int32_t alternativeIntFloor(const double arg);
+
+// The digamma function psi(x), for x > 0. The argument is raised with the
+// recurrence psi(x+1) = psi(x) + 1/x until the asymptotic series is accurate to
+// double precision.
+double digamma(const double x);
+
+// Difference psi(x + n) - psi(x) for x > 0 and integer n >= 0. By the
+// recurrence relation, this is the sum over 1/(x+k), k = 0, ..., n-1, which is
+// used directly for small n.
+double digammaDifference(const double x, const int32_t n);
 } // namespace MathematicalFunctions
 
 #endif // MATHEMATICALFUNCTIONS_HPP
@@ -3,10 +3,13 @@
 
 #include <cstdint>
 #include <deque>
+#include <istream>
+#include <ostream>
 #include <utility>
 #include <vector>
 
 #include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 #include "filament-sliding/FullConnection.hpp"
 #include "filament-sliding/Input.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
@@ -21,6 +24,12 @@
  * can bind. Finally, it has functions for adding possible connections or hops,
  * since it knows which sites are free, and it can find and remove which
  * possible full connections cross existing full connections.
+ * A periodic microtubule has no ends: the site after the last one is the first
+ * one again, with the same spacing. Positions given to it can lie outside of
+ * the microtubule, and are mapped back onto it when a site is accessed.
+ * Optionally, only a window of the sites is stored, in a ring buffer. Moving
+ * the window recycles the storage of the sites that leave it for the sites
+ * that enter it, such that a long microtubule costs no more than its window.
  */
 
 class Microtubule {
@@ -29,8 +38,14 @@ class Microtubule {
 
   private:
     const MicrotubuleType m_type;
+    const bool m_periodic;
     int32_t m_nSites;
-    double m_length;
+    double m_length; // For a periodic microtubule, this is the period
+
+    // The sites m_firstStoredSite, ..., m_firstStoredSite + m_nStoredSites - 1
+    // are stored. Without a window, these are all sites
+    const int32_t m_nStoredSites;
+    int32_t m_firstStoredSite;
 
     // Choose to focus on free instead of occupied sites, since functions may
     // ask if the site is free, not if it is occupied (otherwise completely
@@ -44,6 +59,23 @@ class Microtubule {
                                  // used. The order of the positions will NOT be
                                  // preserved.
 
+    // Maps a position onto the index of its site in m_sites
+    int32_t getStorageIndex(const int32_t position) const;
+
+    Site& getSite(const int32_t position);
+    const Site& getSite(const int32_t position) const;
+
+    // Whether there is no site close to position, because it lies outside of
+    // the (stored part of the) microtubule
+    bool isOutOfReach(const double position, const double maxStretch) const;
+
+    bool hasSiteBelow(const int32_t position) const;
+    bool hasSiteAbove(const int32_t position) const;
+
+    // The number of sites from one position to another, along the shortest way
+    // around a periodic microtubule
+    int32_t getSiteDistance(const int32_t from, const int32_t to) const;
+
     std::pair<double, double> getOldAndNewStretchFullHop(
             const int32_t oldPosition,
             const int32_t newPosition,
@@ -63,7 +95,9 @@ class Microtubule {
     Microtubule(
             const MicrotubuleType type,
             const double length,
-            const double latticeSpacing);
+            const double latticeSpacing,
+            const bool periodic,
+            const int32_t nSitesWindow); // 0 stores all sites
     virtual ~Microtubule();
 
     void connectSite(
@@ -73,6 +107,28 @@ class Microtubule {
 
     void disconnectSite(const int32_t sitePosition);
 
+    // Returns nullptr when the site is free
+    Crosslinker* whichCrosslinkerIsBoundTo(const int32_t sitePosition) const;
+
+    // Copies the occupation of the sites from a microtubule with the same
+    // number of (stored) sites. The crosslinkers are relocated to this system
+    void copyStateFrom(
+            const Microtubule& other,
+            const CrosslinkerRelocation& relocation);
+
+    // Whether the same (stored) sites are occupied by crosslinkers that are
+    // connected in the same way, see Crosslinker::isConnectedLike
+    bool hasSameOccupationAs(const Microtubule& other) const;
+
+    // The occupation of the sites, with the crosslinkers stored by their index
+    // in the relocation
+    void writeCheckpoint(
+            std::ostream& out,
+            const CrosslinkerRelocation& relocation) const;
+    void readCheckpoint(
+            std::istream& in,
+            const CrosslinkerRelocation& relocation);
+
     double getLength() const;
 
     int32_t getNSites() const;
@@ -81,6 +137,24 @@ class Microtubule {
 
     int32_t getNFreeSites() const;
 
+    bool isPeriodic() const;
+
+    bool hasWindow() const;
+    int32_t getFirstStoredSite() const;
+    int32_t getLastStoredSite() const;
+
+    // Moves the window of stored sites such that it starts at firstSite. The
+    // sites that leave the window should be free
+    void moveWindow(const int32_t firstSite);
+
+    // Maps a position outside of [0, m_nSites) back onto a periodic
+    // microtubule. Returns the position itself for a non-periodic microtubule
+    int32_t getPeriodicPosition(const int32_t position) const;
+
+    // The periodic image of displacement that is closest to zero, or the
+    // displacement itself for a non-periodic microtubule
+    double getMinimumImage(const double displacement) const;
+
     int32_t getFreeSitePosition(const int32_t whichFreeSite)
             const; // whichFreeSite labels the free sites, and can be 0 <=
                    // whichFreeSite < m_nFreeSites
@@ -96,6 +170,21 @@ class Microtubule {
     int32_t getNFreeSitesCloseTo(const double position, const double maxStretch)
             const;
 
+    // Counts the free sites from firstSite up to and including lastSite
+    int32_t getNFreeSitesBetween(
+            const int32_t firstSite,
+            const int32_t lastSite) const;
+
+    // Lets a partial linker that has moved from origin to position attempt a
+    // hop of one site in direction (+1 or -1), and returns the position where
+    // it ends. An attempt towards an occupied site, or beyond the end of the
+    // microtubule, is rejected. The linker still occupies origin, which it may
+    // return to
+    int32_t getPositionAfterHop(
+            const int32_t origin,
+            const int32_t position,
+            const int32_t direction) const;
+
     // The following functions are const, since they do not modify the
     // Microtubule in any way; only the CrosslinkerContainer is changed
     void addPossibleConnectionsCloseTo(
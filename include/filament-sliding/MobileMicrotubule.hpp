@@ -1,6 +1,10 @@
 #ifndef MOBILEMICROTUBULE_HPP
 #define MOBILEMICROTUBULE_HPP
 
+#include <istream>
+#include <ostream>
+
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 #include "filament-sliding/Microtubule.hpp"
 
 /* A derivative of Microtubule, this class adds extra functionality related to
@@ -26,6 +30,7 @@ class MobileMicrotubule: public Microtubule {
     MobileMicrotubule(
             const double length,
             const double latticeSpacing,
+            const bool periodic,
             const double initialPosition = 0.);
     // Default value such that it is possible to create a MobileMicrotubule
     // without setting the initial position explicitly.
@@ -35,8 +40,29 @@ class MobileMicrotubule: public Microtubule {
 
     void updatePosition(const double change);
 
+    // Also copies the position
+    void copyStateFrom(
+            const MobileMicrotubule& other,
+            const CrosslinkerRelocation& relocation);
+
+    // Also store the position
+    void writeCheckpoint(
+            std::ostream& out,
+            const CrosslinkerRelocation& relocation) const;
+    void readCheckpoint(
+            std::istream& in,
+            const CrosslinkerRelocation& relocation);
+
     double getPosition() const;
 
+    int32_t getAttractorPosition() const;
+
+    // Sets the position and attractor position back to earlier values, without
+    // the output of setPosition
+    void restorePosition(
+            const double position,
+            const int32_t attractorPosition);
+
     int32_t barrierCrossed(); // also updates m_currentAttractorPosition if
                               // necessary. Returns the direction, 0 if no step
                               // is taken
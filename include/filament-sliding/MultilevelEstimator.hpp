@@ -0,0 +1,112 @@
+#ifndef MULTILEVELESTIMATOR_HPP
+#define MULTILEVELESTIMATOR_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/Propagator.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/Statistics.hpp"
+#include "filament-sliding/SystemState.hpp"
+
+/* MultilevelEstimator estimates the barrier crossing rate at the finest time
+ * step with multilevel Monte Carlo. Level 0 is simulated at the coarsest time
+ * step, and every next level halves the time step. The rate at the finest time
+ * step is the rate at level 0, plus the differences between the rates at each
+ * level and the level below it. Those differences are sampled with coupled
+ * pairs of trajectories, which start from the same state and share the
+ * Brownian increments: every increment of the coarse trajectory is the sum of
+ * the two increments of the fine trajectory in its time step. The reactions
+ * are coupled by giving both trajectories the same random numbers. Since the
+ * coupled rates differ little, few of the expensive fine samples are needed,
+ * while most of the variance is taken by the cheap coarse level.
+ *
+ * Every sample covers the same time, and starts from a state drawn at random
+ * from a fixed ensemble of snapshots. The snapshots are taken once, every
+ * sample duration along a reference trajectory at the finest time step that
+ * starts from the equilibrated system. Since every level draws from the same
+ * ensemble, the corrections add up to the rate at the finest time step from
+ * that ensemble, and since every sample draws its own start and random numbers,
+ * the samples of a level are independent, such that their SEM holds. The
+ * ensemble should span many correlation times of the system. The numbers of
+ * samples per level are chosen such that the standard error of the estimate
+ * reaches the precision (relative) at the least cost (Giles, Operations
+ * Research 56, 607 (2008)), with a maximum per level.
+ */
+
+class MultilevelEstimator {
+  private:
+    struct Level {
+        Propagator* p_finePropagator;
+        Propagator* p_coarsePropagator; // nullptr at level 0
+        int32_t nFineTimeSteps; // per sample
+        Statistics corrections; // The rate at level 0
+        Statistics fineRates;
+        int64_t nSamplesNeeded;
+    };
+
+    const std::string m_runName;
+    const double m_sampleDuration;
+    const int32_t m_nPilotSamples;
+    const double m_precision;
+    const int64_t m_maxNSamples;
+    const int32_t m_nSnapshots;
+
+    // The starting states of the samples, as checkpoints
+    std::vector<std::string> m_snapshots;
+
+    // The Brownian increments are drawn apart from the reactions, such that
+    // they pair up in the same way at every level
+    RandomGenerator m_noiseGenerator;
+    std::vector<Level> m_levels; // From the coarsest to the finest time step
+
+    // Propagates systemState at the finest time step, and takes a snapshot
+    // after every sample duration
+    void takeSnapshots(SystemState& systemState, RandomGenerator& generator);
+
+    // The rate at level 0 and the corrections of the higher levels
+    void runSamples(
+            Level& level,
+            const int64_t nSamples,
+            SystemState& systemState,
+            SystemState& coarseSystemState,
+            RandomGenerator& generator);
+
+    // In time steps
+    double getCostPerSample(const Level& level) const;
+
+    double getEstimate() const;
+    double getSEM() const;
+
+    // Returns whether any level needs more samples than it has
+    bool findNSamplesNeeded();
+
+  public:
+    // The propagators go from the coarsest to the finest time step, which
+    // halves from one to the next. A sample takes nFineTimeSteps time steps
+    // of the finest propagator.
+    MultilevelEstimator(
+            const std::string& runName,
+            const std::vector<Propagator*>& propagators,
+            const int32_t nFineTimeSteps,
+            const int32_t nPilotSamples,
+            const double precision,
+            const int64_t maxNSamples,
+            const int32_t nSnapshots);
+    ~MultilevelEstimator();
+
+    // The snapshots are taken from systemState, which should be equilibrated.
+    // The fine trajectories are run in systemState, and the coarse ones in
+    // coarseSystemState, which should be constructed with the same parameters
+    void estimate(
+            SystemState& systemState,
+            SystemState& coarseSystemState,
+            RandomGenerator& generator);
+
+    // Writes the samples per level, the estimate and the cost to
+    // runName.multilevel_estimate.txt
+    void writeResults() const;
+};
+
+#endif // MULTILEVELESTIMATOR_HPP
@@ -3,11 +3,15 @@
 
 #include <cstdint>
 #include <fstream>
+#include <istream>
 #include <memory>
+#include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "filament-sliding/Histogram.hpp"
+#include "filament-sliding/SharedAccumulators.hpp"
 #include "filament-sliding/Statistics.hpp"
 #include "filament-sliding/SystemState.hpp"
 #include "filament-sliding/TransitionPath.hpp"
@@ -19,6 +23,10 @@
 
 class Output {
   private:
+    const std::string m_runName;
+    const bool m_writeFiles; // Without files, only the statistics are gathered
+    const bool m_recordTrajectory; // The position and the crossing times
+
     std::ofstream m_microtubulePositionFile;
     std::ofstream m_barrierCrossingTimeFile;
     std::ofstream m_positionalHistogramFile;
@@ -67,6 +75,9 @@ class Output {
     std::vector<Statistics> m_estimatePoints;
     Statistics m_diffusionTimeToFinalRegion;
 
+    // Set when the statistics and histograms are shared with other processes
+    std::unique_ptr<SharedAccumulators> mp_sharedAccumulators;
+
     double calculateReactionCoordinate(
             const double remainder,
             const int32_t nRightPullingCrosslinkers) const;
@@ -76,7 +87,28 @@ class Output {
     bool reactionCoordinateLeftPeakRegion(
             const double reactionCoordinate) const;
 
+    // Opens the file runName + suffix, unless no files are written
+    void openFile(std::ofstream& file, const std::string& suffix);
+
+    // Closes the file runName + suffix and removes it, when it was opened
+    void removeFile(std::ofstream& file, const std::string& suffix);
+
+    // The number of bytes written to a file, or -1 when it is not used
+    static int64_t getWrittenSize(std::ofstream& file);
+
+    // Replaces a file of this run by the first size bytes of the file with the
+    // same suffix of a previous run, and continues writing after those
+    void continueFile(
+            std::ofstream& file,
+            const std::string& suffix,
+            const std::string& previousRunName,
+            const int64_t size) const;
+
   public:
+    // The statistics of which a run can be continued until their relative
+    // standard error is small enough
+    enum class TargetStatistic { CROSSING_TIME, FINAL_REGION_TIME };
+
     Output(const std::string& runName,
            const bool writePositionalDistribution,
            const bool recordTransitionPaths,
@@ -92,7 +124,9 @@ class Output {
            const int32_t timeStepsPerDistributionEstimate,
            const int32_t nEstimatesDistribution,
            const double dynamicsEstimationInitialRegionWidth,
-           const double dynamicsEstimationFinalRegionWidth);
+           const double dynamicsEstimationFinalRegionWidth,
+           const bool recordTrajectory,
+           const bool writeFiles);
 
     ~Output();
 
@@ -130,6 +164,45 @@ class Output {
     void cleanTransitionPath();
 
     void finishWriting();
+
+    // The SEM divided by the magnitude of the mean, which is infinite as long
+    // as there are too few samples
+    double getRelativeSEM(const TargetStatistic statistic) const;
+
+    // Adds the statistics and histograms gathered by other, which should be
+    // constructed with the same parameters. Used to combine the replicas of an
+    // ensemble, which are written by this output when it finishes
+    void merge(const Output& other);
+
+    // Writes the statistics and histograms in binary, which finishWriting does
+    // to runName.accumulators.bin. Unlike a checkpoint, these files can be
+    // merged by another build of the program on the same kind of machine, to
+    // pool the results of separate runs (see filament-sliding-merge)
+    void writeAccumulators(std::ostream& out) const;
+    void mergeAccumulators(std::istream& in);
+
+    // The gathered statistics that have samples, named as in the statistical
+    // analysis and peak dynamics files (see filament-sliding-compare)
+    std::vector<std::pair<std::string, const Statistics*>>
+    getSampledStatistics() const;
+
+    // Gathers the statistics and histograms together with the other processes
+    // of the ensemble with the given label, in the shared memory segment name.
+    // The samples are folded into it every block, and the relative SEM is the
+    // one of the aggregate. Only the last of nProcesses processes to finish
+    // writes the aggregate, the others remove their statistics and histogram
+    // files and write no accumulators
+    void shareAccumulators(
+            const std::string& name,
+            const std::string& ensemble,
+            const int32_t nProcesses);
+
+    // Writes the gathered statistics to a checkpoint, together with how much
+    // was written to the files that are written during the run. Since a
+    // resumed run gets its own name, reading the checkpoint continues these
+    // files from the ones of the run that wrote it. Writing flushes the files
+    void writeCheckpoint(std::ostream& out);
+    void readCheckpoint(std::istream& in);
 };
 
 #endif // OUPUT_HPP
@@ -0,0 +1,74 @@
+#ifndef PARAMETERGRID_HPP
+#define PARAMETERGRID_HPP
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/ParameterMap.hpp"
+
+/* ParameterGrid expands a sweep specification into the parameters of the
+ * points of a sweep, which differ from a base set of parameters in the swept
+ * ones. Every line of the specification gives an axis, the values of one or
+ * more parameters:
+ *     list <name> <value> ...
+ *     range <name> <first> <last> <number>
+ *     logrange <name> <first> <last> <number>
+ *     latin <number> <name> <lowest> <highest> [<name> <lowest> <highest> ...]
+ * A range is evenly spaced and includes both ends, a logrange is evenly spaced
+ * in the logarithm, and latin draws a Latin hypercube sample of its parameters,
+ * seeded by its line such that it is the same every time. Integer parameters
+ * are rounded to the nearest integer. A line that starts with zip gives an axis
+ * that is zipped to the one above it: it should have as many values, which are
+ * taken together. The points are all combinations of the values of the axes,
+ * with the last axis varying fastest.
+ */
+
+class ParameterGrid {
+  private:
+    // Parameters whose values are taken together
+    struct Axis {
+        std::vector<std::string> names;
+        std::vector<std::vector<std::string>> values; // Per name
+    };
+
+    const ParameterMap m_baseParameters;
+    std::vector<Axis> m_axes;
+
+    // Reads the names and values of an axis from the rest of a line, and
+    // checks them on the base parameters. Throws an InputException mentioning
+    // lineName when the line is wrong
+    Axis readAxis(
+            const std::string& kind,
+            std::istringstream& line,
+            const std::string& lineText,
+            const std::string& lineName) const;
+
+    // The text of a generated value, rounded for an integer parameter. A real
+    // value is written with enough digits to be read back exactly
+    std::string formatValue(
+            const std::string& name,
+            const double value,
+            const std::string& lineName) const;
+
+    std::vector<int32_t> getAxisIndices(int32_t point) const;
+
+  public:
+    // Throws an InputException when the specification cannot be read, or
+    // gives a parameter a value that does not fit its type
+    ParameterGrid(
+            const ParameterMap& baseParameters,
+            const std::string& fileName);
+    ~ParameterGrid();
+
+    int32_t getNPoints() const;
+
+    // The base parameters with the values of the point
+    ParameterMap getPoint(const int32_t point) const;
+
+    // The swept parameters of the point, as name=value
+    std::string describePoint(const int32_t point) const;
+};
+
+#endif // PARAMETERGRID_HPP
@@ -5,6 +5,7 @@
 #include <stdexcept> // std::out_of_range
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "filament-sliding/GenericValue.hpp"
 #include "filament-sliding/InputException.hpp"
@@ -37,6 +38,21 @@ class ParameterMap {
         m_possibleValuesMap.insert({name, possibleValues});
     }
 
+    // The names of the parameters defined by defineRunParameter
+    std::unordered_set<std::string> m_runParameters;
+
+    // Defines a parameter that does not affect the state the system samples,
+    // but only the output, the length of the run or the way it is run
+    template <typename T>
+    void defineRunParameter(
+            const std::string name,
+            T value,
+            std::string unit = "unitless",
+            std::string possibleValues = "all") {
+        defineParameter(name, value, unit, possibleValues);
+        m_runParameters.insert(name);
+    }
+
   public:
     ParameterMap();
 
@@ -46,7 +62,7 @@ class ParameterMap {
      * type. Hence, no type has to be given calling this function
      */
     template <typename T>
-    void copyParameter(const std::string& name, T& variable) {
+    void copyParameter(const std::string& name, T& variable) const {
         GenericValue variableType {
                 variable, "unknown_unit"}; // Create a GenericValue with the
                                            // type of variable
@@ -84,6 +100,20 @@ class ParameterMap {
         }
     }
 
+    // Sets a parameter from the text of its value, as it is written in an
+    // input file. Throws an InputException for an unknown name, or a text that
+    // does not fit the type of the parameter
+    void overrideParameterFromText(
+            const std::string& name,
+            const std::string& text);
+
+    AllowedTypes getType(const std::string& name) const;
+
+    // Gives the names and values of all parameters but the run parameters, in
+    // the fixed order and with reals in full precision, such that equal texts
+    // mean equal states
+    std::string getValuesAffectingState() const;
+
     friend std::ostream& operator<<(
             std::ostream& out,
             const ParameterMap& parameterMap);
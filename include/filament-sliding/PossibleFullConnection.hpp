@@ -3,15 +3,18 @@
 
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
+#include "filament-sliding/StoragePrecision.hpp"
 
 // Defined struct to group data about possible connections for partial linkers
-struct PossibleFullConnection {
+template <typename Scalar> struct BasicPossibleFullConnection {
     Crosslinker* p_partialLinker;
     SiteLocation location;
-    double extension; // Is the position of the connection on the mobile
+    Scalar extension; // Is the position of the connection on the mobile
                       // microtubule minus the position on the fixed
                       // microtubule. Hence, is positive if fixed connection is
                       // closest to the origin
 };
 
+using PossibleFullConnection = BasicPossibleFullConnection<StorageScalar>;
+
 #endif // POSSIBLEFULLCONNECTION_HPP
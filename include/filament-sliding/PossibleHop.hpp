@@ -3,6 +3,7 @@
 
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
+#include "filament-sliding/StoragePrecision.hpp"
 
 enum class HopDirection { FORWARD, BACKWARD };
 
@@ -16,18 +17,20 @@ struct PossiblePartialHop {
     bool awayFromNeighbour;
 };
 
-struct PossibleFullHop {
+template <typename Scalar> struct BasicPossibleFullHop {
     Crosslinker* p_fullLinker;
     Crosslinker::Terminus terminusToHop;
     SiteLocation locationToHopTo;
     HopDirection direction;
     // Keep track of the extension, since this can be updated easily
-    double oldExtension; // positionOnMobile - positionOnFixed
-    double newExtension; // positionOnMobile - positionOnFixed, should differ
+    Scalar oldExtension; // positionOnMobile - positionOnFixed
+    Scalar newExtension; // positionOnMobile - positionOnFixed, should differ
                          // exactly one lattice spacing from oldExtension
     bool awayFromNeighbour;
 };
 
+using PossibleFullHop = BasicPossibleFullHop<StorageScalar>;
+
 struct FullExtremity {
     Crosslinker* p_fullLinker;
     Crosslinker::Terminus terminus;
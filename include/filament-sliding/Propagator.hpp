@@ -2,15 +2,25 @@
 #define PROPAGATOR_HPP
 
 #include <cstdint>
+#include <functional>
 #include <memory> // std::unique_ptr
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/EquilibrationMonitor.hpp"
+#include "filament-sliding/HopFull.hpp"
+#include "filament-sliding/HopPartial.hpp"
 #include "filament-sliding/Log.hpp"
 #include "filament-sliding/Output.hpp"
 #include "filament-sliding/RandomGenerator.hpp"
 #include "filament-sliding/Reaction.hpp"
+#include "filament-sliding/Statistics.hpp"
+#include "filament-sliding/SublatticeDomains.hpp"
 #include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 
 /* Propagator takes a SystemState, which is properly initialised, and propagates
  * its dynamics. In the process, it can report about the current SystemState,
@@ -67,10 +77,134 @@ class Propagator {
     // memory leaks
     std::unordered_map<std::string, std::unique_ptr<Reaction>> m_reactions;
 
-    void moveMicrotubule(SystemState& systemState, RandomGenerator& generator);
+    // Partial linkers far from the overlap are moved in aggregate every
+    // m_coarseGrainingPeriod time steps, with the rates of the HopPartial
+    // reactions (stored in the order passive, dual, active)
+    const bool m_coarseGrainDistantPartials;
+    const int32_t m_coarseGrainingPeriod;
+    int32_t m_timeStepsToCoarseGraining;
+    std::vector<std::pair<Crosslinker::Type, const HopPartial*>>
+            m_partialHopReactions;
+
+    // The HopFull reactions, whose rates LockstepReplicas follows as the
+    // mobile microtubule moves
+    std::vector<const HopFull*> m_fullHopReactions;
+
+    // At every position probe, the force of the linkers as found from the
+    // stored extensions is compared to the force in double precision
+    const bool m_validateStoragePrecision;
+    Statistics m_storagePrecisionForceError;
+
+    // The rates of the reactions are split over the threads of this pool for
+    // large systems. The pool is shared with the SystemState.
+    ThreadPool& m_threadPool;
+
+    // With sublattice domains (none for 0), the reactions with a rate per
+    // possibility fire on a clock per domain, with random numbers of its own.
+    // Every time step, the domains of one colour at which a reaction is due
+    // choose it concurrently, after which these are made in the order of the
+    // domains, and then the domains of the other colour do the same. The other
+    // reactions keep firing on the clock of the propagator, and the force is
+    // found once, before the mobile microtubule moves
+    std::unique_ptr<SublatticeDomains> mp_domains;
+    std::vector<Reaction*> m_domainReactions;
+    std::vector<Reaction*> m_systemReactions;
+    std::vector<double> m_domainActions;
+    std::vector<double> m_domainThresholds;
+    std::vector<RandomGenerator> m_domainGenerators;
+    std::vector<int32_t> m_dueDomains; // At which a reaction is due
+    std::vector<std::function<void(SystemState&)>> m_domainChanges;
+
+    // Counted for the log. The choices of one in every few phases in which
+    // several domains make a reaction are timed on the calling thread, to
+    // compare against
+    int64_t m_nDomainPhases;
+    int64_t m_nDomainReactions;
+    int32_t m_maxNDomainReactionsInPhase;
+    int64_t m_nConcurrentDomainPhases;
+    double m_concurrentDomainSeconds;
+    int64_t m_nTimedSerialDomainPhases;
+    double m_timedSerialDomainSeconds;
+
+    // The progress through the blocks is kept, such that a run that is resumed
+    // from a checkpoint continues in the middle of a block
+    int32_t m_nFinishedEquilibrationBlocks;
+    int32_t m_nFinishedRunBlocks;
+    int32_t m_timeStepInBlock;
+    int32_t m_timeStepsToNextPositionProbe;
+    int32_t m_nGraphicsIntervals; // Numbers the blocks shown by the graphics
+#ifdef MYDEBUG
+    int32_t m_nPerformedReactions = 0;
+#endif // MYDEBUG
+
+    // During the equilibration and run blocks, a checkpoint is written every
+    // m_checkpointPeriod time steps (never for 0), and when a signal requests
+    // one. After a request to stop, the blocks are left
+    const int32_t m_checkpointPeriod;
+    const std::string m_checkpointFileName;
+    int32_t m_timeStepsToCheckpoint;
+    bool m_stopRequested;
+
+    // With adaptive equilibration, the observables are sampled every
+    // m_equilibrationProbePeriod time steps of the equilibration, and the
+    // equilibration stops after the first block at which they are stationary.
+    // The number of equilibration blocks is then the maximum
+    const bool m_adaptiveEquilibration;
+    const int32_t m_equilibrationProbePeriod;
+    int32_t m_timeStepsToNextEquilibrationProbe;
+    EquilibrationMonitor m_equilibrationMonitor;
+    bool m_foundStationary; // Before the maximum number of blocks
+
+    // With a precision target (never for 0), the run stops after the first
+    // block, from m_minNRunBlocks onwards, at which the relative standard error
+    // of the target statistic is at most m_precisionTarget. The number of run
+    // blocks is then the maximum
+    const double m_precisionTarget;
+    Output::TargetStatistic m_targetStatistic;
+    const int32_t m_minNRunBlocks;
+
+    // Writes a checkpoint when one is due at the start of a time step, and
+    // returns whether the run should stop
+    bool handleCheckpoints(
+            SystemState& systemState,
+            RandomGenerator& generator,
+            Output& output);
+
+    // The Gaussian change is drawn by the caller, such that coupled
+    // propagators can share it
+    void moveMicrotubule(
+            SystemState& systemState,
+            RandomGenerator& generator,
+            const double gaussianChange);
+
+    void performReactionWhenDue(
+            SystemState& systemState,
+            RandomGenerator& generator);
 
     void performReaction(SystemState& systemState, RandomGenerator& generator);
 
+    // See mp_domains. Returns whether a reaction was made
+    bool performReactionsInDomainsWhenDue(
+            SystemState& systemState,
+            RandomGenerator& generator);
+    void setDomainRates(const SystemState& systemState);
+    bool performReactionsInDomainsOfColour(
+            SystemState& systemState,
+            const int32_t colour);
+
+    // The random generators of the domains are seeded by numbers drawn from
+    // generator, and the domains draw new thresholds with them
+    void restartDomainClocks(RandomGenerator& generator);
+
+    // Samples the hop attempts that each distant partial linker makes during
+    // m_coarseGrainingPeriod time steps, and performs them one at a time,
+    // rejecting those towards an occupied site. A linker that comes within
+    // reach of the overlap stops, and is handed back to the HopPartial
+    // reaction. The linkers are handled in a random order
+    void moveDistantPartialLinkers(
+            SystemState& systemState,
+            RandomGenerator& generator);
+
     void setNewReactionRateThreshold(const double probability);
 
     double getTotalAction() const; // The single actions are stored in the
@@ -88,15 +222,46 @@ class Propagator {
 
     void advanceTimeStep(SystemState& systemState, RandomGenerator& generator);
 
+    // Chooses the instantiation of propagateBlockWithObservers that matches
+    // the observers that are turned on, once per block. The block is
+    // propagated up to time step nTimeSteps, and is ended by the caller
     void propagateBlock(
             SystemState& systemState,
             RandomGenerator& generator,
             Output& output,
             const bool writeOutput,
+            const bool writeCheckpoints,
             const int32_t nTimeSteps);
 
+    // The observers are template parameters, such that the loop over time steps
+    // only contains the observers that are used. With writeOutput false, only
+    // the dynamics is propagated, and sampled for adaptive equilibration. A
+    // block that was left for a checkpoint is continued at m_timeStepInBlock.
+    template <
+            bool writeOutput,
+            bool samplePositionalDistribution,
+            bool estimateTimeEvolutionAtPeak,
+            bool recordTransitionPaths>
+    void propagateBlockWithObservers(
+            SystemState& systemState,
+            RandomGenerator& generator,
+            Output& output,
+            const bool writeCheckpoints,
+            const int32_t nTimeSteps);
+
+    // The next block starts at its first time step, with a position probe
+    void endBlock();
+
+    // Ends the equilibration after a block at which the observables are
+    // stationary, and logs when it ended
+    void checkStationarity();
+
+    // Returns whether the run can stop after this block, since the precision
+    // target was reached, and logs when the run ended
+    bool checkPrecision(const Output& output);
+
     bool inBasinOfAttraction(
-            const double mobilePosition,
+            const double remainder,
             const int32_t nRightPullingCrosslinkers,
             const int32_t nFullCrosslinkers) const;
 
@@ -130,12 +295,53 @@ class Propagator {
             const int32_t transitionPathProbePeriod,
             const bool addExternalForce,
             const bool estimateTimeEvolutionAtPeak,
+            const bool coarseGrainDistantPartials,
+            const int32_t coarseGrainingPeriod,
+            const bool validateStoragePrecision,
+            const int32_t checkpointPeriod,
+            const std::string& checkpointFileName,
+            const bool adaptiveEquilibration,
+            const int32_t equilibrationProbePeriod,
+            const double equilibrationTolerance,
+            const double precisionTarget,
+            const std::string& targetStatisticString,
+            const int32_t minNRunBlocks,
+            const int32_t nSublatticeDomains,
+            ThreadPool& threadPool,
             Log& log);
     ~Propagator();
 
     Propagator(const Propagator&) = delete;
     Propagator& operator=(const Propagator&) = delete;
 
+    // Copies the time, the action of the reactions and the threshold at which
+    // the next reaction fires (also those of the sublattice domains, with
+    // their random generators), and the counters, from a propagator with the
+    // same reactions. Together with SystemState::copyStateFrom and a copy of
+    // the RandomGenerator, this forks or restores a complete simulation.
+    void copyStateFrom(const Propagator& other);
+
+    // A checkpoint holds the state of the whole simulation: the propagator,
+    // including its progress through the blocks, the SystemState, the
+    // RandomGenerator and the statistics gathered by Output. The file is
+    // replaced at once, such that an interrupted write leaves the previous
+    // checkpoint intact. After reading it, equilibrate and run continue
+    // exactly where the run that wrote it was.
+    void writeCheckpoint(
+            const std::string& fileName,
+            const SystemState& systemState,
+            const RandomGenerator& generator,
+            Output& output) const;
+    void readCheckpoint(
+            const std::string& fileName,
+            SystemState& systemState,
+            RandomGenerator& generator,
+            Output& output);
+
+    // For a SystemState that was equilibrated before: the equilibration blocks
+    // are left out, and the run blocks start at time 0
+    void skipEquilibration();
+
     // Enter the SystemState as a reference into the run function, such that the
     // propagator can propagate it.
     void run(
@@ -146,11 +352,65 @@ class Propagator {
             SystemState& systemState,
             RandomGenerator& generator,
             Output& output);
+    bool isEquilibrated() const; // False when the run was stopped before
+    // Whether the state can be reused as an equilibrated one: with adaptive
+    // equilibration, only once the observables were found to be stationary,
+    // and not when the maximum number of blocks was reached without that
+    bool hasStationaryState() const;
     void propagateGraphicsInterval(
             SystemState& systemState,
             RandomGenerator& generator,
             Output& output,
             const int32_t nTimeStepsInterval);
+
+    // For estimators that couple propagators at different time steps, see
+    // MultilevelEstimator. A time step without observers, in which the random
+    // displacement of the mobile microtubule is the given standard normal
+    // number times its deviation. Returns the direction of a barrier crossing,
+    // 0 if there was none.
+    int32_t advanceCoupledTimeStep(
+            SystemState& systemState,
+            RandomGenerator& generator,
+            const double standardNormal);
+
+    // For ReplicaExchange, which interrupts the blocks to exchange the states
+    // of systems at different external forces. Propagates the next
+    // nTimeStepsInterval time steps of the equilibration and run blocks,
+    // without checkpoints, adaptive equilibration or a precision target.
+    // Returns false once the last run block has ended.
+    bool propagateInterval(
+            SystemState& systemState,
+            RandomGenerator& generator,
+            Output& output,
+            const int32_t nTimeStepsInterval);
+
+    // Discards the action accumulated towards the next reaction, and draws a
+    // new threshold. Since the waiting times are exponential, this does not
+    // change the dynamics, while propagators that draw the same probability
+    // wait equally long for their next reaction. The clocks of sublattice
+    // domains are restarted with random numbers seeded from generator, such
+    // that coupled propagators share these as well.
+    void restartReactionClock(RandomGenerator& generator);
+
+    double getCalcTimeStep() const;
+
+    // For LockstepReplicas, which accumulates the action of many systems at
+    // once. The rates are set for the current state of the system, and split
+    // into the full hops that increase or decrease the extension of their
+    // linker, and all other reactions
+    struct LockstepRates {
+        double fullHopsIncreasingExtension;
+        double fullHopsDecreasingExtension;
+        double otherReactions;
+    };
+    LockstepRates findLockstepRates(const SystemState& systemState);
+
+    // Performs one of the reactions, chosen with a probability proportional to
+    // its rate at the current state of the system. The action and threshold
+    // are left to the caller
+    void performLockstepReaction(
+            SystemState& systemState,
+            RandomGenerator& generator);
 };
 
 #endif // PROPAGATOR_HPP
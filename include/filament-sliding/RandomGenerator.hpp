@@ -2,11 +2,14 @@
 #define RANDOMGENERATOR_HPP
 
 #include <cstdint>
+#include <istream>
+#include <ostream>
 #include <random>
 
 // The class is made, such that the seeding, implementation etc. is shielded
 // from the user, and random numbers from certain distributions can be asked via
-// its methods
+// its methods. A copy continues with the same random numbers as the original,
+// since the distributions do not keep any state between calls
 class RandomGenerator {
   private:
     std::mt19937_64 m_generator;
@@ -19,6 +22,10 @@ class RandomGenerator {
     RandomGenerator(const std::string seedString);
     ~RandomGenerator();
 
+    // See Checkpoint
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
+
     std::mt19937_64& getBareGenerator(); // Return by reference, otherwise a
                                          // copy is made, and the generator is
                                          // not updated upon use
@@ -28,6 +35,8 @@ class RandomGenerator {
     bool getBernoulli(const double probability);
     double getProbability();
     double getUniform(const double lowerBound, const double upperBound);
+    // Returns 0 for a mean of zero, which std::poisson_distribution forbids
+    int32_t getPoisson(const double mean);
     int32_t getUniformInteger(
             const int32_t inclusiveLowerBound,
             const int32_t inclusiveUpperBound);
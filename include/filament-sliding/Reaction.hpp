@@ -1,8 +1,18 @@
 #ifndef REACTION_HPP
 #define REACTION_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "filament-sliding/MicrotubuleType.hpp"
 #include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/SublatticeDomains.hpp"
 #include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 
 /* Reactions set the rules by which the SystemState is changed.
  * It is a virtual class that contains the basic methods and members required
@@ -14,6 +24,19 @@
  */
 
 class Reaction {
+  public:
+    // The evaluations of the individual rates, and the time taken by those
+    // that were long enough to be split over the threads
+    struct RateEvaluationCounts {
+        int64_t nEvaluations = 0;
+        int64_t nConcurrentEvaluations = 0;
+        int64_t nConcurrentPossibilities = 0;
+        double concurrentSeconds = 0.0;
+        int64_t nTimedSerialEvaluations = 0;
+        int64_t nTimedSerialPossibilities = 0;
+        double timedSerialSeconds = 0.0;
+    };
+
   protected: // Protected, since the inherited classes need access to these.
     // Do not include an elementary rate, since there may be several (this is
     // the case for HopFull)
@@ -22,6 +45,50 @@ class Reaction {
     double m_action; // The summation of the rates at each time step, used for
                      // integrating the rate over time (time steps are assumed
                      // fixed)
+
+    // Reactions with one rate per possibility can split the evaluation of
+    // these rates into chunks of the possibility vector, which are handled
+    // concurrently by the thread pool. Only this evaluation is concurrent: the
+    // sum of the rates, and the reactions themselves, are handled on the
+    // calling thread. Without a pool, everything is done on the calling thread.
+    ThreadPool* mp_threadPool;
+    RateEvaluationCounts m_rateEvaluationCounts;
+
+    // With sublattice domains, reactions with one rate per possibility keep
+    // the domain of every possibility, and sum the rates per domain. Without
+    // them, mp_domains is nullptr
+    const SublatticeDomains* mp_domains;
+    std::vector<int32_t> m_possibilityDomains;
+    std::vector<double> m_domainRates;
+
+    // Calls setRatesInChunk(begin, end) on consecutive ranges covering
+    // [0, nPossibilities). The ranges are handled concurrently when there are
+    // enough possibilities to be worth the synchronisation, except for one in
+    // every few of these evaluations, which is timed on the calling thread to
+    // measure the speed-up.
+    void forEachRateChunk(
+            const std::size_t nPossibilities,
+            const std::function<void(std::size_t, std::size_t)>&
+                    setRatesInChunk);
+
+    // Stores the domain of the possibility with this label, found from the
+    // given site. Only for sublattice domains, from within setRatesInChunk
+    void setPossibilityDomain(
+            const std::size_t label,
+            const SiteLocation& location);
+
+    // Sums the individual rates in order, such that the total rate does not
+    // depend on the number of threads. With sublattice domains, the rates of
+    // the domains are summed as well
+    double sumRates(const std::vector<double>& individualRates);
+
+    // Chooses one of the possibilities in the domain, with a probability
+    // proportional to its rate, and returns its label
+    std::size_t chooseLabelInDomain(
+            const std::vector<double>& individualRates,
+            RandomGenerator& generator,
+            const int32_t domain) const;
+
   public:
     Reaction();
     virtual ~Reaction(); // Don't allow Reaction pointers to destroy derived
@@ -29,10 +96,41 @@ class Reaction {
 
     void resetAction();
 
+    // Copies the accumulated action and the current rate, such that a copied
+    // system continues the current time step like the original
+    void copyStateFrom(const Reaction& other);
+
+    // See Checkpoint
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
+
     double getAction() const; // does not have time step duration included
 
     double getCurrentRate() const;
 
+    void setThreadPool(ThreadPool* const p_threadPool);
+
+    const RateEvaluationCounts& getRateEvaluationCounts() const;
+
+    // Only reactions with one rate per possibility can be split over
+    // sublattice domains. The others depend on counts over the whole system,
+    // and keep firing on the clock of the Propagator
+    virtual bool hasRatePerPossibility() const;
+    void setSublatticeDomains(const SublatticeDomains* const p_domains);
+
+    // The summed rate of the possibilities in a domain, as found by
+    // setCurrentRate
+    double getDomainRate(const int32_t domain) const;
+
+    // Chooses one of the possibilities in a domain, with a
+    // probability proportional to its rate, and returns how it changes the
+    // SystemState. The domains of one colour choose concurrently, after which
+    // the Propagator makes their changes one by one
+    virtual std::function<void(SystemState&)> chooseReactionInDomain(
+            const SystemState& systemState,
+            RandomGenerator& generator,
+            const int32_t domain) const;
+
     void updateAction();
     // Action is updated by adding the current rate times the time step size to
     // it. Once the total action of all reactions reaches a (randomly set)
@@ -0,0 +1,87 @@
+#ifndef REPLICAEXCHANGE_HPP
+#define REPLICAEXCHANGE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/ParameterMap.hpp"
+#include "filament-sliding/Propagator.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/Simulation.hpp"
+#include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+/* ReplicaExchange runs a system at a ladder of amplitudes of a sinusoidal
+ * external force, evenly spaced from externalForceValue to a last value. Each
+ * rung has its own system, random numbers and output, with the run name
+ * runName.force_<rung>, and the rungs are propagated in parallel. Every
+ * exchange period, the states of neighbouring rungs are swapped with the
+ * Metropolis probability min(1, exp(-dU)), with dU the change in the potential
+ * energy of the external forces, the even pairs and the odd pairs in turns. A
+ * state that crosses a barrier easily at a small amplitude can so bring the
+ * rungs at large amplitudes to the barrier regions. Since an exchange
+ * replaces the trajectory of a rung by that of its neighbour, a rung only
+ * gathers the equilibrium histograms at its force: the position in time and
+ * the barrier crossing times are not recorded, and transition paths and the
+ * time evolution at the peak are refused. The exchanges are written to
+ * runName.replica_exchange.txt.
+ */
+
+class ReplicaExchange {
+  private:
+    struct Rung {
+        std::string runName;
+        double externalForceValue;
+        std::unique_ptr<Simulation> p_simulation;
+        std::unique_ptr<ThreadPool> p_threadPool; // The calling thread only
+        std::unique_ptr<RandomGenerator> p_generator;
+        std::unique_ptr<SystemState> p_systemState;
+        std::unique_ptr<Propagator> p_propagator;
+        std::unique_ptr<Output> p_output;
+        // The exchanges with the next rung
+        int64_t nExchangeAttempts;
+        int64_t nAcceptedExchanges;
+    };
+
+    const std::string m_runName;
+    const int32_t m_exchangePeriod;
+
+    std::vector<Rung> m_rungs;
+    std::unique_ptr<SystemState> mp_swapState; // Holds a state during a swap
+    RandomGenerator m_exchangeGenerator;
+    int64_t m_nExchangeRounds;
+
+    // Attempts to swap the states of a rung and the next one
+    void attemptExchange(const std::size_t rung);
+
+  public:
+    // Throws a GeneralException when the parameters do not allow an exchange:
+    // the external force should be sinusoidal, the blocks cannot
+    // be stopped early or shared with other processes, and no observable can
+    // follow a trajectory. The rungs write to log
+    ReplicaExchange(
+            const ParameterMap& parameters,
+            const std::string& runName,
+            const int32_t nRungs,
+            const double lastForceValue,
+            const int32_t exchangePeriod,
+            Log& log);
+    ~ReplicaExchange();
+
+    ReplicaExchange(const ReplicaExchange&) = delete;
+    ReplicaExchange& operator=(const ReplicaExchange&) = delete;
+
+    // Initialises the rungs, and propagates them through their equilibration
+    // and run blocks, as many rungs at the same time as the pool has threads
+    void run(ThreadPool& threadPool);
+
+    // Writes the forces and the acceptance of the exchanges between every pair
+    // of neighbouring rungs to runName.replica_exchange.txt
+    void writeReport() const;
+};
+
+#endif // REPLICAEXCHANGE_HPP
@@ -0,0 +1,113 @@
+#ifndef SHAREDACCUMULATORS_HPP
+#define SHAREDACCUMULATORS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h> // pthread_mutex_t, only works on POSIX systems
+#include <string>
+#include <vector>
+
+#include "filament-sliding/Histogram.hpp"
+#include "filament-sliding/Statistics.hpp"
+
+/* SharedAccumulators gathers the statistics and histograms of an ensemble of
+ * processes in a POSIX shared memory segment (under /dev/shm on Linux), which
+ * every process attaches to by its name. The statistics and histograms of each
+ * process are its own shard: it gathers samples in them as usual, and folds
+ * them into the segment every block, after which they are cleared. The bin
+ * counts are added with atomics, while the means and variances are combined
+ * under a mutex that is released when the process holding it crashes. The last
+ * of nProcesses processes to detach gets the aggregate of all processes in its
+ * statistics and histograms, and removes the segment. The segment holds the
+ * label of the ensemble that created it, and is refused by the processes of
+ * another ensemble, or once one of its processes has detached, such that a
+ * segment left by an ensemble that crashed is never mixed into a new aggregate.
+ * It should then be removed by hand.
+ */
+
+class SharedAccumulators {
+  private:
+    static constexpr std::size_t maxEnsembleLength = 63;
+
+    struct Header {
+        pthread_mutex_t mutex;
+        std::atomic<int32_t> isInitialised;
+        char ensemble[maxEnsembleLength + 1]; // Zero terminated
+        int32_t nProcesses;
+        int32_t nDetached;
+        int64_t nStatistics;
+        int64_t nBins;
+    };
+
+    // The samples of a Statistics, see Statistics::merge
+    struct Moments {
+        int64_t nSamples;
+        double mean;
+        double accumulatedSquaredDeviation;
+    };
+
+    struct BinBounds {
+        double binSize;
+        double lowestValue;
+    };
+
+    static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+    const std::string m_name;
+    const std::string m_ensemble;
+    std::vector<Statistics*> m_statistics; // Including the histograms
+    std::vector<Histogram*> m_histograms;
+    std::size_t m_size;
+    bool m_isLast;
+
+    void* mp_segment;
+    Header* mp_header;
+    Moments* mp_moments; // One for every statistics
+    BinBounds* mp_binBounds; // One for every histogram
+    std::atomic<int64_t>* mp_bins; // The bins of all histograms in a row
+
+    void lock() const;
+    void unlock() const;
+
+    // Creates the segment, or waits until the process that created it has
+    // initialised it
+    void attach(const int32_t nProcesses, const int64_t nBins);
+
+    // Whether the segment was created by the ensemble of this process, and
+    // holds the same statistics and bins
+    bool matchesSegment(const int32_t nProcesses, const int64_t nBins) const;
+
+    static Statistics toStatistics(const Moments& moments);
+    static Moments toMoments(const Statistics& statistics);
+
+  public:
+    // The statistics and histograms are the shards of this process. All
+    // processes should give the same ensemble label, and the same number of
+    // statistics and histograms, with the same bins. They should all have been
+    // constructed before the first one detaches
+    SharedAccumulators(
+            const std::string& name,
+            const std::string& ensemble,
+            const int32_t nProcesses,
+            const std::vector<Statistics*>& statistics,
+            const std::vector<Histogram*>& histograms);
+    ~SharedAccumulators();
+
+    SharedAccumulators(const SharedAccumulators&) = delete;
+    SharedAccumulators& operator=(const SharedAccumulators&) = delete;
+
+    // Adds the samples gathered since the last fold to the segment, and clears
+    // them from the shards
+    void fold();
+
+    // The samples of statistics, one of the shards, combined with the ones
+    // that all processes have folded
+    Statistics getAggregate(const Statistics& statistics) const;
+
+    // Folds, and returns true for the last process to detach, whose shards are
+    // then replaced by the aggregate of all processes
+    bool detach();
+};
+
+#endif // SHAREDACCUMULATORS_HPP
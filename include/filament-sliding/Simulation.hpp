@@ -0,0 +1,170 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/Initialiser.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/ParameterMap.hpp"
+#include "filament-sliding/Propagator.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/SystemModel.hpp"
+#include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+/* Simulation reads and checks the parameters of a run, and creates the objects
+ * that make up the run from them: the system, its output, the initialiser and
+ * the propagator. A run can need more than one of each, for the coarser time
+ * steps of the multilevel estimate, the replicas of an ensemble or the points
+ * of a sweep. The parameters that only decide what is done with these objects,
+ * such as the graphics or the equilibration cache, are read by the program.
+ */
+
+class Simulation {
+  private:
+    const std::string m_runName;
+    Log& m_log;
+
+    // The system
+    double m_lengthMobileMicrotubule;
+    double m_lengthFixedMicrotubule;
+    double m_latticeSpacing;
+    double m_maximumStretchPerLatticeSpacing;
+    bool m_periodicBoundaries;
+    bool m_fixedLatticeWindow;
+    double m_fixedLatticeWindowMargin;
+    int32_t m_nActiveCrosslinkers;
+    int32_t m_nDualCrosslinkers;
+    int32_t m_nPassiveCrosslinkers;
+    double m_springConstant;
+    bool m_addExternalForce;
+    std::string m_externalForceTypeString;
+    double m_externalForceValue;
+    bool m_coarseGrainDistantPartials;
+    int32_t m_coarseGrainingPeriod;
+    bool m_validateStoragePrecision;
+    std::shared_ptr<const SystemModel> mp_systemModel;
+
+    // The output
+    bool m_recordTransitionPaths;
+    bool m_samplePositionalDistribution;
+    double m_positionalHistogramBinSize;
+    double m_positionalHistogramLowestValue;
+    double m_positionalHistogramHighestValue;
+    int32_t m_maxNFullCrosslinkers;
+    int32_t m_transitionPathProbePeriod;
+    int32_t m_maxNumberTransitionPaths;
+    double m_maxPeriodPositionTracking;
+    bool m_estimateTimeEvolutionAtPeak;
+    int32_t m_timeStepsPerDistributionEstimate;
+    int32_t m_nEstimatesDistribution;
+    double m_dynamicsEstimationInitialRegionWidth;
+    double m_dynamicsEstimationFinalRegionWidth;
+
+    // The initial state
+    double m_initialPositionMicrotubule;
+    double m_fractionOverlapSitesConnected;
+    std::string m_initialCrosslinkerDistributionString;
+
+    // The propagator
+    int32_t m_nSublatticeDomains;
+    int32_t m_checkpointPeriod;
+    bool m_adaptiveEquilibration;
+    int32_t m_equilibrationProbePeriod;
+    double m_equilibrationTolerance;
+    int32_t m_numberEquilibrationBlocks;
+    int32_t m_numberRunBlocks;
+    double m_precisionTarget;
+    std::string m_precisionTargetStatistic;
+    int32_t m_minimumRunBlocks;
+    int32_t m_nTimeSteps;
+    double m_calcTimeStep;
+    int32_t m_positionProbePeriod;
+    double m_diffusionConstantMicrotubule;
+    double m_ratePassivePartialHop;
+    double m_ratePassiveFullHop;
+    double m_baseRateActivePartialHop;
+    double m_baseRateActiveFullHop;
+    double m_activeHopToPlusBiasEnergy;
+    double m_neighbourBiasEnergy;
+    double m_baseRateZeroToOneExtremitiesConnected;
+    double m_baseRateOneToZeroExtremitiesConnected;
+    double m_baseRateOneToTwoExtremitiesConnected;
+    double m_baseRateTwoToOneExtremitiesConnected;
+    double m_headBindingBiasEnergy;
+
+  public:
+    // Throws a GeneralException when a parameter contains a wrong value. The
+    // propagators write to log
+    Simulation(
+            const ParameterMap& parameters,
+            const std::string& runName,
+            Log& log);
+    ~Simulation();
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // The system divides its work over the threads of threadPool
+    std::unique_ptr<SystemState> createSystemState(
+            ThreadPool& threadPool) const;
+
+    // Without files, the output only gathers statistics, which can be merged
+    // into an output that writes them
+    std::unique_ptr<Output> createOutput(const bool writeFiles) const;
+
+    // An output that writes files, but neither the position in time nor the
+    // barrier crossing times, for a system whose state is exchanged with
+    // others, such that only its equilibrium distributions are meaningful
+    std::unique_ptr<Output> createEquilibriumOutput() const;
+
+    std::unique_ptr<Initialiser> createInitialiser() const;
+
+    // At a time step other than calcTimeStep, the distant partial linkers are
+    // still moved after the same time. The propagator should use the same
+    // generator and thread pool as the system it propagates
+    std::unique_ptr<Propagator> createPropagator(
+            const double timeStep,
+            RandomGenerator& generator,
+            ThreadPool& threadPool) const;
+
+    // Initialises, equilibrates and runs a system of its own on the calling
+    // thread, with the random numbers of generator. The statistics are
+    // gathered in output
+    void runReplica(RandomGenerator& generator, Output& output) const;
+
+    // Whether the replicas can be propagated in lockstep: without binding
+    // dynamics, periodic boundaries, a window on the fixed microtubule or
+    // coarse graining, with at most a constant external force, and without
+    // the observers and stopping criteria that need the system every time step
+    bool supportsLockstepReplicas() const;
+
+    // Like runReplica, for a replica per generator and output, which are
+    // propagated together on the calling thread, see LockstepReplicas
+    void runLockstepReplicas(
+            const std::vector<RandomGenerator*>& generators,
+            const std::vector<Output*>& outputs) const;
+
+    // Propagates a copy of systemState for a block while its journal records
+    // the changes, rolls the copy back, and reports to the log whether it
+    // returned to the configuration of systemState. The copy draws random
+    // numbers of its own, such that the run of systemState is not changed
+    void validateJournal(
+            const SystemState& systemState,
+            ThreadPool& threadPool) const;
+
+    // The settings that determine how long a system is equilibrated, which
+    // are part of the key of the equilibrated states it shares with other runs
+    std::string getEquilibrationSettings() const;
+
+    int32_t getNEquilibrationBlocks() const;
+    int32_t getNTimeStepsPerBlock() const;
+    double getCalcTimeStep() const;
+    int32_t getCheckpointPeriod() const;
+};
+
+#endif // SIMULATION_HPP
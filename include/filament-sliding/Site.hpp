@@ -2,8 +2,11 @@
 #define SITE_HPP
 
 #include <cstdint>
+#include <istream>
+#include <ostream>
 
 #include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 
 /* Site is a simple class that only keeps track whether it is occupied or not,
  * and if so, by which crosslinker and terminus. It does not keep track of the
@@ -39,6 +42,18 @@ class Site {
     bool isFull() const;
 
     Crosslinker* whichCrosslinkerIsBound() const;
+
+    // After the site was copied from another system, let it refer to the
+    // corresponding crosslinker of this system
+    void relocateCrosslinker(const CrosslinkerRelocation& relocation);
+
+    // The crosslinker is stored by its index in the relocation
+    void writeCheckpoint(
+            std::ostream& out,
+            const CrosslinkerRelocation& relocation) const;
+    void readCheckpoint(
+            std::istream& in,
+            const CrosslinkerRelocation& relocation);
 };
 
 #endif // SITE_HPP
@@ -2,6 +2,8 @@
 #define STATISTICS_HPP
 
 #include <cstdint>
+#include <istream>
+#include <ostream>
 
 class Statistics {
   private:
@@ -15,18 +17,37 @@ class Statistics {
     double m_previousMean;
     double m_accumulatedSquaredDeviation;
 
+  protected:
+    // Replaces the samples by the ones written by serialize
+    void readSerialized(std::istream& in);
+
   public:
     Statistics();
     virtual ~Statistics();
 
     void addValue(const double value);
 
+    // Adds the samples of other, as if they were added one by one (Chan et
+    // al., The American Statistician 37, 242 (1983))
+    void merge(const Statistics& other);
+
+    // Writes the samples in binary, such that the statistics gathered by
+    // separate runs can be merged later
+    void serialize(std::ostream& out) const;
+    void mergeSerialized(std::istream& in);
+
     int64_t getNumberOfSamples() const;
     double getMean() const;
     double getVariance() const;
     double getSEM() const;
 
     bool canReportStatistics() const;
+
+    // See Checkpoint
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
+
+    friend class SharedAccumulators;
 };
 
 #endif // STATISTICS_HPP
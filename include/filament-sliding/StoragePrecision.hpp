@@ -0,0 +1,19 @@
+#ifndef STORAGEPRECISION_HPP
+#define STORAGEPRECISION_HPP
+
+/* The extensions in the records of full connections, possible full connections
+ * and possible full hops are stored as a StorageScalar. Defining
+ * SINGLE_PRECISION_STORAGE makes this a float, which makes these records
+ * smaller on large overlaps. Positions and everything summed over the linkers,
+ * such as the force, are kept in double precision. In single precision, the
+ * extensions are stored relative to a shift in double precision (see
+ * CrosslinkerContainer), such that they do not drift as the microtubule moves.
+ */
+
+#ifdef SINGLE_PRECISION_STORAGE
+using StorageScalar = float;
+#else
+using StorageScalar = double;
+#endif // SINGLE_PRECISION_STORAGE
+
+#endif // STORAGEPRECISION_HPP
@@ -0,0 +1,44 @@
+#ifndef SUBLATTICEDOMAINS_HPP
+#define SUBLATTICEDOMAINS_HPP
+
+#include <cstdint>
+
+#include "filament-sliding/MicrotubuleType.hpp"
+#include "filament-sliding/SystemState.hpp"
+
+/* SublatticeDomains cuts the fixed microtubule into an even number of domains
+ * of (nearly) equal numbers of sites. A site on the mobile microtubule belongs
+ * to the domain of the fixed site across from it. The even domains have one
+ * colour, and the odd domains the other. As long as a domain is wider than
+ * twice the maximum stretch plus a few lattice spacings, a reaction in one
+ * domain cannot change the possibilities or rates in another domain of the
+ * same colour. The Propagator then lets the domains of one colour choose their
+ * reactions concurrently, and performs them before the domains of the other
+ * colour take their turn.
+ */
+
+class SublatticeDomains {
+  private:
+    const int32_t m_nDomains;
+
+    // Taken from the SystemState by setSystemState
+    int32_t m_nSitesFixed;
+    bool m_periodic;
+    int32_t m_mobileSiteOffset; // The fixed site across from mobile site 0
+
+  public:
+    explicit SublatticeDomains(const int32_t nDomains);
+    ~SublatticeDomains();
+
+    int32_t getNDomains() const;
+
+    // Takes the position of the mobile microtubule, which should be done
+    // before the domains of the sites are found
+    void setSystemState(const SystemState& systemState);
+
+    // Sites beyond the ends of the fixed microtubule belong to the domain at
+    // that end, or are wrapped with periodic boundaries
+    int32_t findDomain(const SiteLocation& location) const;
+};
+
+#endif // SUBLATTICEDOMAINS_HPP
@@ -0,0 +1,106 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/JobQueue.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/ParameterGrid.hpp"
+#include "filament-sliding/ParameterMap.hpp"
+#include "filament-sliding/Simulation.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+/* Sweep runs the systems of a set of parameters, the points of the sweep, in a
+ * single process. The points are read from parameter files, or expanded from a
+ * ParameterGrid. Every point is run as replicas, each of which is
+ * initialised, equilibrated and run on its own with its own random numbers:
+ * the numberReplicas of its file, times a split factor for the expensive
+ * points, whose run blocks are divided over more replicas such that no replica
+ * costs much more than an even share of a thread. When the run blocks cannot
+ * be divided evenly, the first replicas run one block more. The replicas of all
+ * points
+ * are handed out to the threads from the most expensive down, so that the
+ * threads are kept busy until the end. When the last replica of a point has
+ * finished, their statistics are merged and written as the output of the
+ * point, with the run name runName.point_<point>.
+ */
+
+class Sweep {
+  private:
+    struct Point {
+        std::string description; // The parameter file, or the swept values
+        std::string runName;
+        ParameterMap parameters;
+        int32_t nReplicas; // Including the ones the point was split into
+        // The first nLongReplicas replicas run one block more, such that the
+        // replicas run the run blocks of all unsplit replicas together
+        int32_t nRunBlocksPerReplica;
+        int32_t nLongReplicas;
+        double costPerReplica; // In time steps times particles
+        std::unique_ptr<Simulation> p_simulation;
+        std::unique_ptr<Simulation> p_longSimulation;
+        std::vector<std::unique_ptr<Output>> replicaOutputs;
+        int32_t nUnfinishedReplicas;
+    };
+
+    struct Task {
+        int32_t point;
+        int32_t replica;
+        double cost;
+    };
+
+    const std::string m_runName;
+    Log& m_log;
+
+    std::vector<Point> m_points;
+    std::vector<Task> m_tasks; // Ordered by decreasing cost
+    std::mutex m_mutex; // Guards the numbers of unfinished replicas
+
+    ParameterMap readParameterFile(const std::string& fileName) const;
+
+    // Refuses the parameters that cannot be run as replicas, and stores the
+    // parameters of the point
+    void addPoint(
+            ParameterMap parameters,
+            const std::string& runName,
+            const std::string& description);
+
+    // Runs a replica, and writes the output of its point when it was the last
+    // one to finish
+    void runTask(const Task& task);
+
+  public:
+    // The points write to log
+    Sweep(const std::string& runName, Log& log);
+    ~Sweep();
+
+    // Adds the parameter files listed in listFileName, one per line
+    void readPointFiles(const std::string& listFileName);
+
+    // Adds every point of grid
+    void addGridPoints(const ParameterGrid& grid);
+
+    // Adds a point that was taken from a job queue, which keeps the run name
+    // it was given when it was queued
+    void addQueuedPoint(const std::string& fileName);
+
+    // Adds every point to the job queue, instead of running it here
+    void enqueue(JobQueue& queue) const;
+
+    // Splits the points into replicas for the number of threads, and creates
+    // their simulations, which checks all parameters before anything is run
+    void schedule(const int32_t nThreads);
+
+    // Writes the replicas and run blocks of every point to
+    // runName.sweep.txt
+    void writeSchedule() const;
+
+    void run(ThreadPool& threadPool);
+};
+
+#endif // SWEEP_HPP
@@ -0,0 +1,98 @@
+#ifndef SYSTEMMODEL_HPP
+#define SYSTEMMODEL_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+/* SystemModel holds what does not change while a system evolves: the geometry
+ * of the microtubules and their lattices, the numbers of linkers, their spring
+ * constant and maximum stretch, and the external force. A SystemState only
+ * holds the occupancy and the position of the mobile microtubule, and refers
+ * to its model, which can be shared by the replicas of an ensemble.
+ */
+
+class SystemModel {
+  public:
+    enum class ExternalForceType { BARRIERFREE, SINUS, CONSTANT };
+
+  private:
+    const double m_lengthMobileMicrotubule;
+    const double m_lengthFixedMicrotubule;
+    const double m_latticeSpacing;
+
+    // With a stretch < 1.5 lattice spacing, there are maximally 3 types of
+    // stretch at a time (at exactly 1.5, there could be 4). The number is
+    // defined smaller than 1.5 to be sure that there are never 4 states
+    // possible, in which the state could become locked. 15 decimals seems to be
+    // the precision
+    const double m_maxStretchPerLatticeSpacing;
+    const int32_t m_maxNumberOfCloseSites;
+    const double m_maxStretch; // To be defined in terms of the lattice spacing
+                               // and m_maxStretchPerLatticeSpacing
+
+    const int32_t m_nActiveCrosslinkers;
+    const int32_t m_nDualCrosslinkers;
+    const int32_t m_nPassiveCrosslinkers;
+    const double m_springConstant;
+
+    const bool m_addExternalForce;
+    ExternalForceType m_externalForceType; // not const, has to be found in the
+                                           // constructor body
+    const double m_externalForceValue;
+
+    const bool m_coarseGrainDistantPartials;
+    const bool m_periodicBoundaries;
+    const bool m_fixedLatticeWindow;
+    // Number of sites stored on either side of the overlap, when only a window
+    // of the fixed microtubule is stored
+    const int32_t m_nSitesWindowMargin;
+
+    const double m_pi = std::acos(-1); // used for the energy of a sinusoidal
+                                       // external force
+
+  public:
+    SystemModel(
+            const double lengthMobileMicrotubule,
+            const double lengthFixedMicrotubule,
+            const double latticeSpacing,
+            const double maxStretchPerLatticeSpacing,
+            const int32_t nActiveCrosslinkers,
+            const int32_t nDualCrosslinkers,
+            const int32_t nPassiveCrosslinkers,
+            const double springConstant,
+            const bool addExternalForce,
+            const std::string& externalForceTypeString,
+            const double externalForceValue,
+            const bool coarseGrainDistantPartials,
+            const bool periodicBoundaries,
+            const bool fixedLatticeWindow,
+            const double fixedLatticeWindowMargin);
+    ~SystemModel();
+
+    double getLengthMobileMicrotubule() const;
+    double getLengthFixedMicrotubule() const;
+    double getLatticeSpacing() const;
+    double getMaxStretch() const;
+    int32_t getMaxNumberOfCloseSites() const;
+
+    int32_t getNActiveCrosslinkers() const;
+    int32_t getNDualCrosslinkers() const;
+    int32_t getNPassiveCrosslinkers() const;
+    double getSpringConstant() const;
+
+    bool addsExternalForce() const;
+    ExternalForceType getExternalForceType() const;
+    double getExternalForceValue() const;
+    // The potential energy of the external force on the mobile microtubule at
+    // the given position, in units of kT. A force that is not constant or
+    // sinusoidal has no potential, and throws a GeneralException
+    double findExternalEnergy(const double positionMicrotubule) const;
+
+    bool coarseGrainsDistantPartials() const;
+    bool hasPeriodicBoundaries() const;
+    bool hasFixedLatticeWindow() const;
+    int32_t getNSitesWindowMargin() const;
+};
+
+#endif // SYSTEMMODEL_HPP
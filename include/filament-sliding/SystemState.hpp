@@ -3,17 +3,26 @@
 
 #include <cmath>
 #include <cstdint>
+#include <istream>
+#include <map>
+#include <memory>
+#include <ostream>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/CrosslinkerContainer.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 #include "filament-sliding/FullConnection.hpp"
+#include "filament-sliding/JournalEntry.hpp"
 #include "filament-sliding/Microtubule.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
 #include "filament-sliding/MobileMicrotubule.hpp"
 #include "filament-sliding/PossibleFullConnection.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/SystemModel.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 
 /* SystemState is a class that keeps track of the current state of the system,
  * and manages the existence of Microtubules and Crosslinkers through its
@@ -22,34 +31,20 @@
  * that is on the mobile microtubule, and keeps track of the possible reactions
  * that can happen for certain (un)bindings and hoppings. The latter happens
  * through the CrosslinkerContainers.
+ * With a window on the fixed microtubule, only the sites around the overlap are
+ * stored. Beyond the window, only the number of partially connected linkers is
+ * kept, and linkers are redistributed over the sites that enter the window.
+ * What does not change while the system evolves is held by its SystemModel,
+ * which replicas of the same system share.
  */
 
 class SystemState {
-  public:
-    enum class ExternalForceType { BARRIERFREE, SINUS, CONSTANT };
-
   private:
-    // With a stretch < 1.5 lattice spacing, there are maximally 3 types of
-    // stretch at a time (at exactly 1.5, there could be 4). The number is
-    // defined smaller than 1.5 to be sure that there are never 4 states
-    // possible, in which the state could become locked. 15 decimals seems to be
-    // the precision
-    const double m_maxStretchPerLatticeSpacing;
-    const int32_t m_maxNumberOfCloseSites;
-    const double m_maxStretch; // To be defined in terms of the lattice spacing
-                               // and m_maxStretchPerLatticeSpacing
-    const double m_latticeSpacing;
-
-    const double m_springConstant;
+    const std::shared_ptr<const SystemModel> mp_model;
 
     Microtubule m_fixedMicrotubule;
     MobileMicrotubule m_mobileMicrotubule;
 
-    const int32_t m_nPassiveCrosslinkers;
-    const int32_t m_nDualCrosslinkers;
-    const int32_t m_nActiveCrosslinkers;
-    const int32_t m_nCrosslinkers;
-
     CrosslinkerContainer m_passiveCrosslinkers;
     CrosslinkerContainer m_dualCrosslinkers;
     CrosslinkerContainer m_activeCrosslinkers;
@@ -59,36 +54,118 @@ class SystemState {
     double m_forceMicrotubule;
     double m_energy;
     double m_totalExtensionLinkers;
-
-    const bool m_addExternalForce;
-    ExternalForceType m_externalForceType; // not const, has to be found in the
-                                           // constructor body
-    const double m_externalForceValue;
+    double m_externalForce; // Part of m_forceMicrotubule, stored separately
 
     double externalForceFlatOptimalPath() const;
 
+    // The part of the fixed microtubule below or above the window of stored
+    // sites, summarised by the number of partial linkers of each type and bound
+    // terminus on its sites
+    struct RegionOccupancy {
+        int32_t nSites;
+        std::map<std::pair<Crosslinker::Type, Crosslinker::Terminus>, int32_t>
+                nPartialLinkers;
+    };
+    RegionOccupancy m_occupancyBelowWindow;
+    RegionOccupancy m_occupancyAboveWindow;
+
+    // The first stored site for a window centred on the mobile microtubule
+    int32_t centredFixedLatticeWindowStart() const;
+
+    CrosslinkerContainer& getCrosslinkerContainer(const Crosslinker::Type type);
+
+    // Moves the partial linkers on the sites first, ..., last of the fixed
+    // microtubule into the occupancy of a region outside of the window. The
+    // linkers are stored by their containers, apart from the free ones
+    void storeOccupancy(
+            const int32_t firstSite,
+            const int32_t lastSite,
+            RegionOccupancy& occupancy);
+
+    // Draws the partial linkers on the sites first, ..., last of the fixed
+    // microtubule from the occupancy of a region outside of the window, and
+    // connects stored linkers for them. Throws a GeneralException when a
+    // container stores fewer linkers than the occupancy holds
+    void restoreOccupancy(
+            const int32_t firstSite,
+            const int32_t lastSite,
+            RegionOccupancy& occupancy,
+            RandomGenerator& generator);
+
+    // The partial linkers of a type that the occupancies of both regions
+    // hold, and which their container should store
+    int32_t getNLinkersOfOccupancies(const Crosslinker::Type type) const;
+    void storeLinkersOfOccupancies();
+
+    static void writeOccupancy(
+            std::ostream& out,
+            const RegionOccupancy& occupancy);
+    static void readOccupancy(std::istream& in, RegionOccupancy& occupancy);
+
+    // The changes made since the journal was started, and the occupancies
+    // outside of the window before each recorded move of the window
+    bool m_recordJournal = false;
+    std::vector<JournalEntry> m_journal;
+    std::vector<std::pair<RegionOccupancy, RegionOccupancy>>
+            m_journalOccupancies;
+
+    // Gives the linker bound to a site, which should not be free
+    Crosslinker& crosslinkerAt(const SiteLocation location);
+
+    void undoChange(const JournalEntry& entry);
+
     const double m_pi = std::acos(-1); // used for the calculation of sinus, for
                                        // a sinusoidal external force
   public:
-    SystemState(
-            const double lengthMobileMicrotubule,
-            const double lengthFixedMicrotubule,
-            const double latticeSpacing,
-            const double maxStretchPerLatticeSpacing,
-            const int32_t nActiveCrosslinkers,
-            const int32_t nDualCrosslinkers,
-            const int32_t nPassiveCrosslinkers,
-            const double springConstant,
-            const bool addExternalForce,
-            const std::string externalForceTypeString,
-            const double externalForceValue);
+    // The model should be the same for the states that are copied into each
+    // other, and can be shared by any number of them
+    SystemState(const std::shared_ptr<const SystemModel>& p_model);
     ~SystemState();
 
     SystemState(const SystemState&) = delete;
     SystemState& operator=(const SystemState&) = delete;
 
+    // Lets the CrosslinkerContainers recalculate their possibilities on the
+    // threads of the pool
+    void setThreadPool(ThreadPool* const p_threadPool);
+
     void setMicrotubulePosition(const double positionMicrotubule);
 
+    // Makes this system an exact copy of the state of other, which should have
+    // been constructed with the same microtubules and numbers of crosslinkers.
+    // The copy refers to its own crosslinkers, and has the same ordering of
+    // the possible reactions, such that it evolves exactly like other would
+    // with the same random numbers. Since the storage is reused, a state can
+    // be forked or restored many times without allocating memory. The force
+    // is recalculated, so other may have another external force. The journal
+    // of this system is cleared.
+    void copyStateFrom(const SystemState& other);
+
+    // Writes the state that copyStateFrom copies to a checkpoint, and reads
+    // it back into a system constructed with the same parameters. Like
+    // copyStateFrom, reading clears the journal and recalculates the force
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
+
+    // Once the journal is started, the changes made through the methods below
+    // are recorded together with what is needed to undo them. rollBack undoes
+    // the changes made after a mark, in a time proportional to their number
+    // rather than to the size of the system. The state it returns to is
+    // physically the same, but the ordering of the linkers and the rounding of
+    // the stored extensions can differ, such that it does not continue exactly
+    // as before; copyStateFrom gives an exact copy. The time and action of the
+    // Propagator are not part of the SystemState.
+    void startJournal();
+    void stopJournal(); // Also forgets the recorded changes
+    int32_t getJournalMark() const;
+    void rollBack(const int32_t mark);
+
+    // Whether other has the mobile microtubule at exactly the same position,
+    // and the same sites occupied by the same types of linkers, connected in
+    // the same way. The ordering of the linkers and their possibilities is not
+    // compared
+    bool hasSameConfigurationAs(const SystemState& other) const;
+
     void fullyConnectFreeCrosslinker(
             const Crosslinker::Type type,
             const Crosslinker::Terminus terminusToConnectToFixedMicrotubule,
@@ -112,12 +189,25 @@ class SystemState {
 
     void updateMobilePosition(const double changeMicrotubulePosition);
 
+    bool hasFixedLatticeWindow() const;
+
+    // Moves the window on the fixed microtubule along with the mobile
+    // microtubule, once the margin on one side has shrunk to less than half of
+    // its original size
+    void updateFixedLatticeWindow(RandomGenerator& generator);
+
     int32_t barrierCrossed();
 
     std::pair<double, double> movementBordersSetByFullLinkers() const;
 
+    // The positions of the mobile microtubule between which the possible
+    // reactions only change through the extensions of the linkers
+    std::pair<double, double> getPossibilityBorders() const;
+
     double getMicrotubulePosition() const;
 
+    const SystemModel& getModel() const;
+
     int32_t getNFreeCrosslinkersOfType(const Crosslinker::Type type) const;
     int32_t getNFreeCrosslinkers() const;
 
@@ -130,7 +220,9 @@ class SystemState {
     int32_t getNFullRightPullingCrosslinkers() const;
 
     // The following functions return the position of the overlap as measured
-    // from the origin at the beginning of the fixed microtubule
+    // from the origin at the beginning of the fixed microtubule. With periodic
+    // boundaries, the overlap covers the whole fixed microtubule, and its first
+    // site on the mobile microtubule is the one closest to the origin
     double beginningOverlap() const;
     double endOverlap() const;
     double overlapLength() const;
@@ -143,6 +235,17 @@ class SystemState {
     int32_t getNSitesOverlapFixed() const;
     int32_t getNSitesOverlapMobile() const;
 
+    // Loops over the sites in the overlap, so it is not meant for every time
+    // step
+    int32_t getNOccupiedSitesOverlapFixed() const;
+
+    bool hasPeriodicBoundaries() const;
+
+    // Maps a position outside of a periodic microtubule back onto it
+    int32_t getPeriodicPosition(
+            const MicrotubuleType microtubuleType,
+            const int32_t position) const;
+
     int32_t getNFreeSites() const;
     int32_t getNFreeSitesFixed() const;
     int32_t getNFreeSitesMobile() const;
@@ -169,8 +272,16 @@ class SystemState {
 
     double getTotalExtensionLinkers() const;
 
+    // Returns the external force stored by updateForceAndEnergy, while
+    // findExternalForce recalculates it
+    double getExternalForce() const;
+
     double findExternalForce() const;
 
+    // Recalculates the force of the linkers from their positions in double
+    // precision, to validate the force found from the stored extensions
+    double findLinkerForceInDoublePrecision() const;
+
 #ifdef MYDEBUG
     void TESTunbindAFullCrosslinker(
             const int32_t which,
@@ -190,6 +301,10 @@ class SystemState {
     const std::vector<FullConnection>& getFullConnections(
             const Crosslinker::Type type) const;
 
+    // To be added to the extensions of the possible connections, possible
+    // full hops and full connections above. Zero in double precision
+    double getExtensionShift(const Crosslinker::Type type) const;
+
     const std::vector<Crosslinker*>& getPartialLinkers(
             const Crosslinker::Type type) const;
 
@@ -202,6 +317,20 @@ class SystemState {
     const std::vector<Crosslinker*>& getPartialLinkersBoundWithTail(
             const Crosslinker::Type type) const;
 
+    std::vector<Crosslinker*> getDistantPartialLinkers(
+            const Crosslinker::Type type) const;
+
+    // See CrosslinkerContainer::isDistantSite
+    bool isDistantSite(
+            const Crosslinker::Type type,
+            const SiteLocation& location) const;
+
+    // See Microtubule::getPositionAfterHop
+    int32_t getPositionAfterHop(
+            const SiteLocation& origin,
+            const int32_t position,
+            const int32_t direction) const;
+
     int32_t getNSites(const MicrotubuleType microtubule) const;
 
     double getLatticeSpacing() const;
@@ -0,0 +1,61 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* ThreadPool keeps a number of worker threads alive, such that work can be
+ * divided over several cores without creating threads every time. Work is
+ * handed out with parallelFor, which runs a set of numbered tasks on the
+ * workers and on the calling thread, and returns when all of them have
+ * finished. Since the caller waits, the tasks can safely refer to its local
+ * variables.
+ */
+
+class ThreadPool {
+  private:
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex; // guards all of the members below
+    std::condition_variable m_tasksAvailable;
+    std::condition_variable m_tasksFinished;
+
+    const std::function<void(int32_t)>* mp_task;
+    int32_t m_nTasks;
+    int32_t m_nextTask;
+    int32_t m_nUnfinishedTasks;
+    int64_t m_generation; // Raised for every call to parallelFor, such that
+                          // the workers can tell new work from old work
+    bool m_stop;
+    std::exception_ptr m_taskException;
+
+    void workerLoop();
+
+    // Claims and runs tasks of the current parallelFor call, until none are
+    // left
+    void runTasks();
+
+  public:
+    // The calling thread takes part in the work, so nThreads - 1 workers are
+    // created
+    explicit ThreadPool(const int32_t nThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int32_t getNThreads() const;
+
+    // Calls task(0), ..., task(nTasks - 1), distributed over the threads. An
+    // exception thrown by a task is rethrown here, after all tasks finished.
+    void parallelFor(
+            const int32_t nTasks,
+            const std::function<void(int32_t)>& task);
+};
+
+#endif // THREADPOOL_HPP
@@ -0,0 +1,89 @@
+#ifndef TIMESTEPSTUDY_HPP
+#define TIMESTEPSTUDY_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/Input.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+/* TimeStepStudy runs the system of an input file at a ladder of time steps,
+ * calcTimeStep times the powers of a factor, with the numbers of time steps
+ * scaled such that every rung simulates the same time. Each rung is a run of
+ * the simulation program in its own directory, and the rungs are run in
+ * parallel. From their output, the barrier crossing rate, the diffusion
+ * constant of the mobile microtubule and the moments of the positional
+ * distribution are found. Since the integration of the microtubule movement is
+ * of first order, they are extrapolated linearly to a vanishing time step.
+ * The recommended time step is the largest one at which no observable deviates
+ * from its extrapolation by more than the tolerance (relative). A deviation
+ * only counts when the slope of the fit exceeds its standard error, such that
+ * the noise in the observables is not taken for a bias.
+ */
+
+class TimeStepStudy {
+  private:
+    struct Observable {
+        std::string name;
+        std::string unit;
+        std::vector<double> values; // Per rung, NaN when it was not measured
+        std::vector<double> SEMs; // Per rung, NaN when it is not known
+    };
+
+    // The fit of an observable to intercept + slope * timeStep
+    struct Extrapolation {
+        bool isValid;
+        double intercept;
+        double slope;
+        double interceptSEM;
+        double slopeSEM;
+    };
+
+    const std::string m_runName;
+    const std::string m_programName;
+    const double m_tolerance;
+
+    std::vector<double> m_timeSteps;
+    std::vector<std::string> m_directories;
+    std::vector<Observable> m_observables;
+
+    // Reads the barrier crossing time and the positional moments from the
+    // statistical analysis of a rung
+    void readStatisticalAnalysis(const int32_t rung);
+
+    // Finds the diffusion constant from the squared displacements between
+    // consecutive probes of the position
+    void readMicrotubulePosition(const int32_t rung);
+
+    Observable& getObservable(const std::string& name);
+
+    // Invalid when the observable was measured at fewer than two time steps
+    Extrapolation extrapolate(const Observable& observable) const;
+
+  public:
+    // The simulations are run by programName, which gets the runName "rung"
+    // in the directories runName.timestep_<rung>
+    TimeStepStudy(
+            const std::string& runName,
+            const std::string& programName,
+            const int32_t nRungs,
+            const double factor,
+            const double tolerance,
+            const double calcTimeStep);
+    ~TimeStepStudy();
+
+    // Writes the input file of every rung. The input is changed in the process
+    void prepareRungs(Input& input) const;
+
+    // Runs as many rungs at the same time as the pool has threads
+    void runRungs(ThreadPool& threadPool) const;
+
+    void readObservables();
+
+    // Writes the observables per time step, their extrapolation and the
+    // recommended time step to runName.timestep_study.txt
+    void writeReport() const;
+};
+
+#endif // TIMESTEPSTUDY_HPP
@@ -3,6 +3,8 @@
 
 #include <cstdint>
 #include <iostream>
+#include <istream>
+#include <ostream>
 #include <vector>
 
 class TransitionPath {
@@ -34,6 +36,10 @@ class TransitionPath {
 
     int32_t getNRightPullingLinkers(const int32_t label) const;
 
+    // See Checkpoint
+    void writeCheckpoint(std::ostream& out) const;
+    void readCheckpoint(std::istream& in);
+
     friend std::ostream& operator<<(
             std::ostream& out,
             const TransitionPath& transitionPath);
@@ -1,6 +1,8 @@
 #ifndef UNBINDFULLCROSSLINKER_HPP
 #define UNBINDFULLCROSSLINKER_HPP
 
+#include <cstdint>
+#include <functional>
 #include <vector>
 
 #include "filament-sliding/Crosslinker.hpp"
@@ -43,6 +45,14 @@ class UnbindFullCrosslinker: public Reaction {
 
     void performReaction(SystemState& systemState, RandomGenerator& generator)
             override;
+
+    // The domain of a full linker is that of its site on the fixed
+    // microtubule
+    bool hasRatePerPossibility() const override;
+    std::function<void(SystemState&)> chooseReactionInDomain(
+            const SystemState& systemState,
+            RandomGenerator& generator,
+            const int32_t domain) const override;
 };
 
 #endif // UNBINDFULLCROSSLINKER_HPP
@@ -1,6 +1,7 @@
 #include <cmath> // exp
 #include <cstddef> // size_t
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 #include "filament-sliding/BindPartialCrosslinker.hpp"
@@ -25,31 +26,50 @@ BindPartialCrosslinker::BindPartialCrosslinker(
 
 BindPartialCrosslinker::~BindPartialCrosslinker() {}
 
+// Either the partial linker or the site it connects to is on the fixed
+// microtubule
+static SiteLocation fixedSiteOf(const PossibleFullConnection& connection) {
+    return (connection.location.microtubule == MicrotubuleType::FIXED) ?
+                   connection.location :
+                   connection.p_partialLinker
+                           ->getBoundLocationWhenPartiallyConnected();
+}
+
 // Energy dependent rate
 void BindPartialCrosslinker::setCurrentRate(const SystemState& systemState) {
     const std::vector<PossibleFullConnection>& possibleConnections =
             systemState.getPossibleConnections(m_typeToBind);
-    m_individualRates.clear();
-    m_individualRates.reserve(possibleConnections.size());
+    const double extensionShift = systemState.getExtensionShift(m_typeToBind);
+    m_individualRates.resize(possibleConnections.size());
 
-    double sum = 0;
-    for (const PossibleFullConnection& possibleConnection:
-         possibleConnections) {
-        // spread the effect of extension evenly over connecting and
-        // disconnecting: rate scales with exp(-k x^2 / (4 k_B T))
-        double rate = m_rateOneTerminusToOneSite *
-                      std::exp(
-                              -m_springConstant * possibleConnection.extension *
-                              possibleConnection.extension * 0.25);
-        rate *= (possibleConnection.p_partialLinker
-                         ->getFreeTerminusWhenPartiallyConnected() ==
-                 Crosslinker::Terminus::HEAD) ?
-                        m_headBindingFactor :
-                        m_tailBindingFactor;
-        m_individualRates.push_back(rate);
-        sum += rate;
-    }
-    m_currentRate = sum;
+    forEachRateChunk(
+            possibleConnections.size(),
+            [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t label = begin; label < end; ++label) {
+                    const PossibleFullConnection& possibleConnection =
+                            possibleConnections[label];
+                    if (mp_domains != nullptr) {
+                        setPossibilityDomain(
+                                label, fixedSiteOf(possibleConnection));
+                    }
+                    const double extension =
+                            possibleConnection.extension + extensionShift;
+                    // spread the effect of extension evenly over connecting and
+                    // disconnecting: rate scales with exp(-k x^2 / (4 k_B T))
+                    double rate = m_rateOneTerminusToOneSite *
+                                  std::exp(
+                                          -m_springConstant * extension *
+                                          extension * 0.25);
+                    const Crosslinker::Terminus freeTerminus =
+                            possibleConnection.p_partialLinker
+                                    ->getFreeTerminusWhenPartiallyConnected();
+                    rate *= (freeTerminus == Crosslinker::Terminus::HEAD) ?
+                                    m_headBindingFactor :
+                                    m_tailBindingFactor;
+                    m_individualRates[label] = rate;
+                }
+            });
+    m_currentRate = sumRates(m_individualRates);
 }
 
 // This function uses the current (individual) rates, make sure they are
@@ -97,3 +117,20 @@ void BindPartialCrosslinker::performReaction(
     systemState.connectPartiallyConnectedCrosslinker(
             *(connectionToMake.p_partialLinker), connectionToMake.location);
 }
+
+bool BindPartialCrosslinker::hasRatePerPossibility() const { return true; }
+
+std::function<void(SystemState&)> BindPartialCrosslinker::
+        chooseReactionInDomain(
+                const SystemState& systemState,
+                RandomGenerator& generator,
+                const int32_t domain) const {
+    const PossibleFullConnection connectionToMake =
+            systemState.getPossibleConnections(
+                    m_typeToBind)[chooseLabelInDomain(
+                    m_individualRates, generator, domain)];
+    return [connectionToMake](SystemState& changedSystemState) {
+        changedSystemState.connectPartiallyConnectedCrosslinker(
+                *(connectionToMake.p_partialLinker), connectionToMake.location);
+    };
+}
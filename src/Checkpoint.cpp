@@ -0,0 +1,86 @@
+#include <csignal>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "filament-sliding/Checkpoint.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/StoragePrecision.hpp"
+#include "filament-sliding/version.hpp"
+
+namespace Checkpoint {
+// Only set by the signal handler, and taken by the propagation loop
+static volatile std::sig_atomic_t s_requestedSignal = 0;
+
+static void requestCheckpoint(int signal) { s_requestedSignal = signal; }
+
+void writeString(std::ostream& out, const std::string& text) {
+    write(out, static_cast<int64_t>(text.size()));
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+std::string readString(std::istream& in) {
+    int64_t size;
+    read(in, size);
+    if (size < 0) {
+        throw GeneralException("A checkpoint contains a corrupted string.");
+    }
+    std::string text(static_cast<std::size_t>(size), ' ');
+    if (!in.read(&text[0], static_cast<std::streamsize>(size))) {
+        throw GeneralException("A checkpoint ended unexpectedly.");
+    }
+    return text;
+}
+
+void writeHeader(std::ostream& out) {
+    writeString(out, "filament-sliding checkpoint");
+    writeString(out, GIT_COMMIT);
+    write(out, static_cast<int32_t>(sizeof(StorageScalar)));
+}
+
+void readHeader(std::istream& in) {
+    if (readString(in) != "filament-sliding checkpoint") {
+        throw GeneralException("The file is not a checkpoint.");
+    }
+    if (readString(in) != GIT_COMMIT) {
+        throw GeneralException(
+                "The checkpoint was written by another version of the "
+                "program.");
+    }
+    int32_t storageScalarSize;
+    read(in, storageScalarSize);
+    if (storageScalarSize != static_cast<int32_t>(sizeof(StorageScalar))) {
+        throw GeneralException(
+                "The checkpoint was written by a build with another storage "
+                "precision.");
+    }
+}
+
+void checkSize(
+        const int64_t sizeInCheckpoint,
+        const int64_t size,
+        const std::string& description) {
+    if (sizeInCheckpoint != size) {
+        throw GeneralException(
+                "The checkpoint does not match the parameters of this run: "
+                "the " +
+                description + " is " + std::to_string(sizeInCheckpoint) +
+                " instead of " + std::to_string(size) + ".");
+    }
+}
+
+void handleSignals() {
+    std::signal(SIGTERM, requestCheckpoint);
+    std::signal(SIGUSR1, requestCheckpoint);
+}
+
+Request takeRequest() {
+    const std::sig_atomic_t signal = s_requestedSignal;
+    if (signal == 0) {
+        return Request::NONE;
+    }
+    s_requestedSignal = 0;
+    return (signal == SIGTERM) ? Request::STOP : Request::CONTINUE;
+}
+} // namespace Checkpoint
@@ -1,3 +1,7 @@
+#include <istream>
+#include <ostream>
+
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/Extremity.hpp"
 #include "filament-sliding/GeneralException.hpp"
@@ -268,3 +272,51 @@ SiteLocation Crosslinker::getOneBoundLocationWhenFullyConnected(
                 ") was passed a wrong Terminus.");
     }
 }
+
+void Crosslinker::copyConnectionsFrom(const Crosslinker& other) {
+#ifdef MYDEBUG
+    if (other.m_type != m_type) {
+        throw GeneralException(
+                "Crosslinker::copyConnectionsFrom() was called with a "
+                "crosslinker of another type");
+    }
+#endif // MYDEBUG
+    m_head = other.m_head;
+    m_tail = other.m_tail;
+}
+
+// Whether both extremities are free, or connected to the same site
+static bool areConnectedAlike(
+        const Extremity& extremity,
+        const Extremity& otherExtremity) {
+    if (!extremity.isConnected() || !otherExtremity.isConnected()) {
+        return extremity.isConnected() == otherExtremity.isConnected();
+    }
+    const SiteLocation location = extremity.getSiteLocation();
+    const SiteLocation otherLocation = otherExtremity.getSiteLocation();
+    return location.microtubule == otherLocation.microtubule &&
+           location.position == otherLocation.position;
+}
+
+bool Crosslinker::isConnectedLike(const Crosslinker& other) const {
+    return other.m_type == m_type && areConnectedAlike(m_head, other.m_head) &&
+           areConnectedAlike(m_tail, other.m_tail);
+}
+
+void Crosslinker::writeCheckpoint(std::ostream& out) const {
+    Checkpoint::write(out, m_type);
+    m_head.writeCheckpoint(out);
+    m_tail.writeCheckpoint(out);
+}
+
+void Crosslinker::readCheckpoint(std::istream& in) {
+    Type type;
+    Checkpoint::read(in, type);
+    if (type != m_type) {
+        throw GeneralException(
+                "The checkpoint does not match the parameters of this run: it "
+                "holds a crosslinker of another type.");
+    }
+    m_head.readCheckpoint(in);
+    m_tail.readCheckpoint(in);
+}
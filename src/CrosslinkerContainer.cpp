@@ -1,19 +1,28 @@
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <istream>
 #include <limits>
+#include <ostream>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/CrosslinkerContainer.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 #include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/MathematicalFunctions.hpp"
 #include "filament-sliding/Microtubule.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
 #include "filament-sliding/MobileMicrotubule.hpp"
 #include "filament-sliding/PossibleFullConnection.hpp"
+#include "filament-sliding/StoragePrecision.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 
 CrosslinkerContainer::CrosslinkerContainer(
         const int32_t nCrosslinkers,
@@ -22,7 +31,8 @@ CrosslinkerContainer::CrosslinkerContainer(
         const Microtubule& fixedMicrotubule,
         const MobileMicrotubule& mobileMicrotubule,
         const double latticeSpacing,
-        const double maxStretch):
+        const double maxStretch,
+        const bool coarseGrainDistantPartials):
         m_linkerType(linkerType),
         m_crosslinkers(nCrosslinkers, defaultCrosslinker),
         m_fixedMicrotubule(fixedMicrotubule),
@@ -30,7 +40,11 @@ CrosslinkerContainer::CrosslinkerContainer(
         m_latticeSpacing(latticeSpacing),
         m_maxStretch(maxStretch),
         m_mod1(MathematicalFunctions::mod(m_maxStretch, m_latticeSpacing)),
-        m_mod2(MathematicalFunctions::mod(-m_maxStretch, m_latticeSpacing)) {
+        m_mod2(MathematicalFunctions::mod(-m_maxStretch, m_latticeSpacing)),
+        m_coarseGrainDistantPartials(coarseGrainDistantPartials),
+        m_coarseGrainingReferencePosition(0.0),
+        m_extensionShift(0.0),
+        mp_threadPool(nullptr) {
 #ifdef MYDEBUG
     // The number of partials and fulls is initially assumed to be zero, so the
     // crosslinkers should not be connected yet.
@@ -64,6 +78,149 @@ CrosslinkerContainer::CrosslinkerContainer(
 
 CrosslinkerContainer::~CrosslinkerContainer() {}
 
+void CrosslinkerContainer::setThreadPool(ThreadPool* const p_threadPool) {
+    mp_threadPool = p_threadPool;
+}
+
+void CrosslinkerContainer::addToRelocation(
+        const CrosslinkerContainer& other,
+        CrosslinkerRelocation& relocation) {
+    relocation.addRange(other.m_crosslinkers, m_crosslinkers);
+}
+
+void CrosslinkerContainer::addToRelocation(
+        CrosslinkerRelocation& relocation) const {
+    relocation.addRange(m_crosslinkers);
+}
+
+void CrosslinkerContainer::copyStateFrom(
+        const CrosslinkerContainer& other,
+        const CrosslinkerRelocation& relocation) {
+    if (other.m_linkerType != m_linkerType ||
+        other.m_crosslinkers.size() != m_crosslinkers.size()) {
+        throw GeneralException(
+                "CrosslinkerContainer::copyStateFrom() was called with a "
+                "container of another type or size");
+    }
+
+    for (std::size_t i = 0; i < m_crosslinkers.size(); ++i) {
+        m_crosslinkers[i].copyConnectionsFrom(other.m_crosslinkers[i]);
+    }
+
+    m_lowerBorderPossibilities = other.m_lowerBorderPossibilities;
+    m_upperBorderPossibilities = other.m_upperBorderPossibilities;
+    m_coarseGrainingReferencePosition = other.m_coarseGrainingReferencePosition;
+    m_extensionShift = other.m_extensionShift;
+
+    relocation.relocate(other.m_freeCrosslinkers, m_freeCrosslinkers);
+    relocation.relocate(other.m_storedCrosslinkers, m_storedCrosslinkers);
+    relocation.relocate(other.m_partialCrosslinkers, m_partialCrosslinkers);
+    relocation.relocate(other.m_fullCrosslinkers, m_fullCrosslinkers);
+    relocation.relocate(
+            other.m_partialCrosslinkersBoundWithHead,
+            m_partialCrosslinkersBoundWithHead);
+    relocation.relocate(
+            other.m_partialCrosslinkersBoundWithTail,
+            m_partialCrosslinkersBoundWithTail);
+
+    // Copy the possibilities as a whole, such that their order, and with that
+    // the outcome of the reactions, is the same as in other
+    m_possibleConnections = other.m_possibleConnections;
+    for (PossibleFullConnection& connection: m_possibleConnections) {
+        connection.p_partialLinker =
+                relocation.relocate(connection.p_partialLinker);
+    }
+    m_possiblePartialHops = other.m_possiblePartialHops;
+    for (PossiblePartialHop& hop: m_possiblePartialHops) {
+        hop.p_partialLinker = relocation.relocate(hop.p_partialLinker);
+    }
+    m_possibleFullHops = other.m_possibleFullHops;
+    for (PossibleFullHop& hop: m_possibleFullHops) {
+        hop.p_fullLinker = relocation.relocate(hop.p_fullLinker);
+    }
+    m_fullConnections = other.m_fullConnections;
+    for (FullConnection& connection: m_fullConnections) {
+        connection.p_fullLinker = relocation.relocate(connection.p_fullLinker);
+    }
+}
+
+void CrosslinkerContainer::writeCheckpoint(
+        std::ostream& out,
+        const CrosslinkerRelocation& relocation) const {
+    Checkpoint::write(out, m_linkerType);
+    Checkpoint::write(out, static_cast<int64_t>(m_crosslinkers.size()));
+    for (const Crosslinker& linker: m_crosslinkers) {
+        linker.writeCheckpoint(out);
+    }
+
+    Checkpoint::write(out, m_lowerBorderPossibilities);
+    Checkpoint::write(out, m_upperBorderPossibilities);
+    Checkpoint::write(out, m_coarseGrainingReferencePosition);
+    Checkpoint::write(out, m_extensionShift);
+
+    relocation.writeLinkers(out, m_freeCrosslinkers);
+    relocation.writeLinkers(out, m_storedCrosslinkers);
+    relocation.writeLinkers(out, m_partialCrosslinkers);
+    relocation.writeLinkers(out, m_fullCrosslinkers);
+    relocation.writeLinkers(out, m_partialCrosslinkersBoundWithHead);
+    relocation.writeLinkers(out, m_partialCrosslinkersBoundWithTail);
+
+    relocation.writeWithLinkers(
+            out,
+            m_possibleConnections,
+            &PossibleFullConnection::p_partialLinker);
+    relocation.writeWithLinkers(
+            out, m_possiblePartialHops, &PossiblePartialHop::p_partialLinker);
+    relocation.writeWithLinkers(
+            out, m_possibleFullHops, &PossibleFullHop::p_fullLinker);
+    relocation.writeWithLinkers(
+            out, m_fullConnections, &FullConnection::p_fullLinker);
+}
+
+void CrosslinkerContainer::readCheckpoint(
+        std::istream& in,
+        const CrosslinkerRelocation& relocation) {
+    Crosslinker::Type linkerType;
+    int64_t nCrosslinkers;
+    Checkpoint::read(in, linkerType);
+    Checkpoint::read(in, nCrosslinkers);
+    if (linkerType != m_linkerType) {
+        throw GeneralException(
+                "The checkpoint does not match the parameters of this run: it "
+                "holds the crosslinkers in another order.");
+    }
+    Checkpoint::checkSize(
+            nCrosslinkers,
+            static_cast<int64_t>(m_crosslinkers.size()),
+            "number of crosslinkers of a type");
+    for (Crosslinker& linker: m_crosslinkers) {
+        linker.readCheckpoint(in);
+    }
+
+    Checkpoint::read(in, m_lowerBorderPossibilities);
+    Checkpoint::read(in, m_upperBorderPossibilities);
+    Checkpoint::read(in, m_coarseGrainingReferencePosition);
+    Checkpoint::read(in, m_extensionShift);
+
+    relocation.readLinkers(in, m_freeCrosslinkers);
+    relocation.readLinkers(in, m_storedCrosslinkers);
+    relocation.readLinkers(in, m_partialCrosslinkers);
+    relocation.readLinkers(in, m_fullCrosslinkers);
+    relocation.readLinkers(in, m_partialCrosslinkersBoundWithHead);
+    relocation.readLinkers(in, m_partialCrosslinkersBoundWithTail);
+
+    relocation.readWithLinkers(
+            in,
+            m_possibleConnections,
+            &PossibleFullConnection::p_partialLinker);
+    relocation.readWithLinkers(
+            in, m_possiblePartialHops, &PossiblePartialHop::p_partialLinker);
+    relocation.readWithLinkers(
+            in, m_possibleFullHops, &PossibleFullHop::p_fullLinker);
+    relocation.readWithLinkers(
+            in, m_fullConnections, &FullConnection::p_fullLinker);
+}
+
 Crosslinker& CrosslinkerContainer::at(const int32_t position) {
     // Convert the std::out_of_range error into a GeneralException, such that a
     // text is printed when it goes wrong.
@@ -141,6 +298,26 @@ void CrosslinkerContainer::disconnectFromFullToPartial(
     m_partialCrosslinkers.push_back(&crosslinkerToDisconnect);
 }
 
+void CrosslinkerContainer::setNStoredCrosslinkers(const int32_t nStored) {
+    if (nStored < 0 ||
+        nStored > static_cast<int32_t>(
+                          m_freeCrosslinkers.size() +
+                          m_storedCrosslinkers.size())) {
+        throw GeneralException(
+                "CrosslinkerContainer::setNStoredCrosslinkers() was asked to "
+                "store more linkers than are free.");
+    }
+
+    while (static_cast<int32_t>(m_storedCrosslinkers.size()) < nStored) {
+        m_storedCrosslinkers.push_back(m_freeCrosslinkers.back());
+        m_freeCrosslinkers.pop_back();
+    }
+    while (static_cast<int32_t>(m_storedCrosslinkers.size()) > nStored) {
+        m_freeCrosslinkers.push_back(m_storedCrosslinkers.back());
+        m_storedCrosslinkers.pop_back();
+    }
+}
+
 int32_t CrosslinkerContainer::getNCrosslinkers() const {
     return m_crosslinkers.size();
 }
@@ -149,6 +326,10 @@ int32_t CrosslinkerContainer::getNFreeCrosslinkers() const {
     return m_freeCrosslinkers.size();
 }
 
+int32_t CrosslinkerContainer::getNStoredCrosslinkers() const {
+    return m_storedCrosslinkers.size();
+}
+
 int32_t CrosslinkerContainer::getNPartialCrosslinkers() const {
     return m_partialCrosslinkers.size();
 }
@@ -171,8 +352,12 @@ int32_t CrosslinkerContainer::getNFullRightPullingCrosslinkers() const {
         const SiteLocation mobileLocation =
                 p_linker->getLocationOfFullOn(MicrotubuleType::MOBILE);
 
-        if (fixedLocation.position * m_latticeSpacing >
-            mobileLocation.position * m_latticeSpacing + mobilePosition) {
+        // With periodic boundaries, the mobile extremity can be at any
+        // periodic image of its position, so compare the shortest distance
+        if (m_fixedMicrotubule.getMinimumImage(
+                    fixedLocation.position * m_latticeSpacing -
+                    (mobileLocation.position * m_latticeSpacing +
+                     mobilePosition)) > 0.0) {
             ++nRightPulling;
         }
     }
@@ -218,41 +403,85 @@ int32_t CrosslinkerContainer::getNSitesToBindPartial() const {
 #endif // MYDEBUG
 
 void CrosslinkerContainer::findPossibleConnections() {
-    // Empty the container, the following will recalculate the whole vector
-    // The capacity of the vector does not change (not defined by standard)
-    m_possibleConnections.clear();
-
-    // If there are no partially connected crosslinkers, the for body will not
-    // execute, which is how it should be
-    for (Crosslinker* const p_linker: m_partialCrosslinkers) {
-        addPossibleConnections(p_linker);
-    }
+    // If there are no partially connected crosslinkers, the vector is only
+    // emptied, which is how it should be
+    findPossibilitiesInDomains(
+            m_partialCrosslinkers,
+            m_possibleConnections,
+            m_connectionBuffers,
+            &CrosslinkerContainer::addPossibleConnections);
 }
 
 void CrosslinkerContainer::findPossiblePartialHops() {
-    // Empty the container, the following will recalculate the whole vector
-    // The capacity of the vector does probably not change (not defined by
-    // standard)
-    m_possiblePartialHops.clear();
-
-    // If there are no partially connected crosslinkers, the for body will not
-    // execute, which is how it should be
-    for (Crosslinker* const p_linker: m_partialCrosslinkers) {
-        addPossiblePartialHops(p_linker);
-    }
+    findPossibilitiesInDomains(
+            m_partialCrosslinkers,
+            m_possiblePartialHops,
+            m_partialHopBuffers,
+            &CrosslinkerContainer::addPossiblePartialHops);
 }
 
 void CrosslinkerContainer::findPossibleFullHops() {
+    // Adds the possible hops for both extremities of each full linker
+    findPossibilitiesInDomains(
+            m_fullCrosslinkers,
+            m_possibleFullHops,
+            m_fullHopBuffers,
+            &CrosslinkerContainer::addPossibleFullHops);
+}
+
+template <typename Possibility>
+void CrosslinkerContainer::findPossibilitiesInDomains(
+        const std::vector<Crosslinker*>& linkers,
+        std::vector<Possibility>& possibilities,
+        std::vector<std::vector<Possibility>>& domainBuffers,
+        void (CrosslinkerContainer::*addPossibilities)(
+                Crosslinker* const,
+                std::vector<Possibility>&) const) {
     // Empty the container, the following will recalculate the whole vector
-    // The capacity of the vector does probably not change (not defined by
-    // standard)
-    m_possibleFullHops.clear();
+    // The capacity of the vector does not change (not defined by standard)
+    possibilities.clear();
 
-    // If there are no partially connected crosslinkers, the for body will not
-    // execute, which is how it should be
-    for (Crosslinker* const p_linker: m_fullCrosslinkers) {
-        addPossibleFullHops(p_linker); // Adds the possible hops for both
-                                       // extremities of the full linker
+    // Below this number of linkers per domain, waking up the threads takes
+    // longer than the search itself
+    constexpr std::size_t minLinkersPerDomain = 256;
+
+    if (mp_threadPool == nullptr || mp_threadPool->getNThreads() == 1 ||
+        linkers.size() < 2 * minLinkersPerDomain) {
+        for (Crosslinker* const p_linker: linkers) {
+            (this->*addPossibilities)(p_linker, possibilities);
+        }
+        return;
+    }
+
+    const std::size_t nDomains = std::min(
+            static_cast<std::size_t>(mp_threadPool->getNThreads()),
+            linkers.size() / minLinkersPerDomain);
+    // The buffers are kept between calls, such that their memory is reused
+    if (domainBuffers.size() < nDomains) {
+        domainBuffers.resize(nDomains);
+    }
+
+    const std::function<void(int32_t)> findInDomain =
+            [&](const int32_t domain) {
+                std::vector<Possibility>& buffer = domainBuffers[domain];
+                buffer.clear();
+                const std::size_t end =
+                        linkers.size() * (domain + 1) / nDomains;
+                for (std::size_t i = linkers.size() * domain / nDomains;
+                     i < end;
+                     ++i) {
+                    (this->*addPossibilities)(linkers[i], buffer);
+                }
+            };
+    mp_threadPool->parallelFor(static_cast<int32_t>(nDomains), findInDomain);
+
+    // Join the buffers in the order of the domains, which gives the same
+    // order as the serial search
+    for (std::size_t domain = 0; domain < nDomains; ++domain) {
+        possibilities.insert(
+                possibilities.end(),
+                domainBuffers[domain].begin(),
+                domainBuffers[domain].end());
     }
 }
 
@@ -264,6 +493,13 @@ void CrosslinkerContainer::findPossibleFullHops() {
  */
 void CrosslinkerContainer::addPossibleConnections(
         Crosslinker* const p_newPartialCrosslinker) {
+    addPossibleConnections(p_newPartialCrosslinker, m_possibleConnections);
+}
+
+void CrosslinkerContainer::addPossibleConnections(
+        Crosslinker* const p_newPartialCrosslinker,
+        std::vector<PossibleFullConnection>& possibleConnections) const {
+    const std::size_t firstNew = possibleConnections.size();
     SiteLocation locationConnectedTo =
             p_newPartialCrosslinker->getBoundLocationWhenPartiallyConnected();
     // Check the free sites on the opposite microtubule!
@@ -272,7 +508,7 @@ void CrosslinkerContainer::addPossibleConnections(
     switch (locationConnectedTo.microtubule) {
     case MicrotubuleType::FIXED:
         m_mobileMicrotubule.addPossibleConnectionsCloseTo(
-                m_possibleConnections,
+                possibleConnections,
                 p_newPartialCrosslinker,
                 locationConnectedTo.position * m_latticeSpacing -
                         m_mobileMicrotubule.getPosition(),
@@ -281,7 +517,7 @@ void CrosslinkerContainer::addPossibleConnections(
         break;
     case MicrotubuleType::MOBILE:
         m_fixedMicrotubule.addPossibleConnectionsCloseTo(
-                m_possibleConnections,
+                possibleConnections,
                 p_newPartialCrosslinker,
                 locationConnectedTo.position * m_latticeSpacing +
                         m_mobileMicrotubule.getPosition(),
@@ -293,6 +529,20 @@ void CrosslinkerContainer::addPossibleConnections(
                 "Wrong location stored and encountered in "
                 "CrosslinkerContainer::addPossibleConnections()");
     }
+    shiftNewPossibleConnections(possibleConnections, firstNew);
+}
+
+void CrosslinkerContainer::shiftNewPossibleConnections(
+        std::vector<PossibleFullConnection>& possibleConnections,
+        const std::size_t first) const {
+    if (m_extensionShift == 0.0) {
+        return;
+    }
+    for (std::size_t i = first; i < possibleConnections.size(); ++i) {
+        PossibleFullConnection& connection = possibleConnections[i];
+        connection.extension = static_cast<StorageScalar>(
+                connection.extension - m_extensionShift);
+    }
 }
 
 void CrosslinkerContainer::removePossibleConnections(
@@ -319,17 +569,28 @@ void CrosslinkerContainer::removePossibleConnections(
 
 void CrosslinkerContainer::addPossiblePartialHops(
         Crosslinker* const p_newPartialCrosslinker) {
+    addPossiblePartialHops(p_newPartialCrosslinker, m_possiblePartialHops);
+}
+
+void CrosslinkerContainer::addPossiblePartialHops(
+        Crosslinker* const p_newPartialCrosslinker,
+        std::vector<PossiblePartialHop>& possiblePartialHops) const {
+    // Distant linkers are moved in aggregate instead
+    if (isDistantPartial(p_newPartialCrosslinker)) {
+        return;
+    }
+
     SiteLocation locationConnectedTo =
             p_newPartialCrosslinker->getBoundLocationWhenPartiallyConnected();
 
     switch (locationConnectedTo.microtubule) {
     case MicrotubuleType::FIXED:
         m_fixedMicrotubule.addPossiblePartialHopsCloseTo(
-                m_possiblePartialHops, p_newPartialCrosslinker);
+                possiblePartialHops, p_newPartialCrosslinker);
         break;
     case MicrotubuleType::MOBILE:
         m_mobileMicrotubule.addPossiblePartialHopsCloseTo(
-                m_possiblePartialHops, p_newPartialCrosslinker);
+                possiblePartialHops, p_newPartialCrosslinker);
         break;
     default:
         throw GeneralException(
@@ -362,6 +623,13 @@ void CrosslinkerContainer::removePossiblePartialHops(
 
 void CrosslinkerContainer::addPossibleFullHops(
         Crosslinker* const p_newFullCrosslinker) {
+    addPossibleFullHops(p_newFullCrosslinker, m_possibleFullHops);
+}
+
+void CrosslinkerContainer::addPossibleFullHops(
+        Crosslinker* const p_newFullCrosslinker,
+        std::vector<PossibleFullHop>& possibleFullHops) const {
+    const std::size_t firstNew = possibleFullHops.size();
     SiteLocation headLocation = p_newFullCrosslinker->getSiteLocationOf(
             Crosslinker::Terminus::HEAD);
     SiteLocation tailLocation = p_newFullCrosslinker->getSiteLocationOf(
@@ -379,14 +647,14 @@ void CrosslinkerContainer::addPossibleFullHops(
     switch (headLocation.microtubule) {
     case MicrotubuleType::FIXED:
         m_fixedMicrotubule.addPossibleFullHopsCloseTo(
-                m_possibleFullHops,
+                possibleFullHops,
                 FullExtremity {
                         p_newFullCrosslinker, Crosslinker::Terminus::HEAD},
                 tailLocation.position * m_latticeSpacing +
                         m_mobileMicrotubule.getPosition(),
                 m_maxStretch);
         m_mobileMicrotubule.addPossibleFullHopsCloseTo(
-                m_possibleFullHops,
+                possibleFullHops,
                 FullExtremity {
                         p_newFullCrosslinker, Crosslinker::Terminus::TAIL},
                 headLocation.position * m_latticeSpacing -
@@ -395,14 +663,14 @@ void CrosslinkerContainer::addPossibleFullHops(
         break;
     case MicrotubuleType::MOBILE:
         m_mobileMicrotubule.addPossibleFullHopsCloseTo(
-                m_possibleFullHops,
+                possibleFullHops,
                 FullExtremity {
                         p_newFullCrosslinker, Crosslinker::Terminus::HEAD},
                 tailLocation.position * m_latticeSpacing -
                         m_mobileMicrotubule.getPosition(),
                 m_maxStretch);
         m_fixedMicrotubule.addPossibleFullHopsCloseTo(
-                m_possibleFullHops,
+                possibleFullHops,
                 FullExtremity {
                         p_newFullCrosslinker, Crosslinker::Terminus::TAIL},
                 headLocation.position * m_latticeSpacing +
@@ -414,6 +682,22 @@ void CrosslinkerContainer::addPossibleFullHops(
                 "Wrong location stored and encountered in "
                 "CrosslinkerContainer::addPossiblePartialHops()");
     }
+    shiftNewPossibleFullHops(possibleFullHops, firstNew);
+}
+
+void CrosslinkerContainer::shiftNewPossibleFullHops(
+        std::vector<PossibleFullHop>& possibleFullHops,
+        const std::size_t first) const {
+    if (m_extensionShift == 0.0) {
+        return;
+    }
+    for (std::size_t i = first; i < possibleFullHops.size(); ++i) {
+        PossibleFullHop& hop = possibleFullHops[i];
+        hop.oldExtension = static_cast<StorageScalar>(
+                hop.oldExtension - m_extensionShift);
+        hop.newExtension = static_cast<StorageScalar>(
+                hop.newExtension - m_extensionShift);
+    }
 }
 
 void CrosslinkerContainer::removePossibleFullHops(
@@ -772,9 +1056,26 @@ std::pair<double, double> CrosslinkerContainer::
             largestStretch = connection.extension;
         }
     }
+    smallestStretch += m_extensionShift;
+    largestStretch += m_extensionShift;
+
+    // In single precision, the stored extensions are rounded. The borders are
+    // narrowed by more than the rounding error, such that a linker is never
+    // stretched beyond the maximum stretch
+    const double roundingMargin =
+            std::is_same_v<StorageScalar, double> ?
+                    0.0 :
+                    8 * std::numeric_limits<StorageScalar>::epsilon() *
+                            (m_maxStretch + 2 * m_latticeSpacing);
+
+    return std::pair<double, double>(
+            (-m_maxStretch - smallestStretch + roundingMargin),
+            (m_maxStretch - largestStretch - roundingMargin));
+}
 
+std::pair<double, double> CrosslinkerContainer::getPossibilityBorders() const {
     return std::pair<double, double>(
-            (-m_maxStretch - smallestStretch), (m_maxStretch - largestStretch));
+            m_lowerBorderPossibilities, m_upperBorderPossibilities);
 }
 
 void CrosslinkerContainer::findPossibilityBorders() {
@@ -804,60 +1105,58 @@ void CrosslinkerContainer::findPossibilityBorders() {
 void CrosslinkerContainer::updateConnectionDataMobilePositionChange(
         const double positionChange) {
     // This function assumes that the change is possible and has already
-    // happened, in the sense that mobileMicrotubule.position has changed Update
-    // extension of the full linkers
-    for (FullConnection& connection: m_fullConnections) {
-        connection.extension += positionChange;
-    }
+    // happened, in the sense that mobileMicrotubule.position has changed
 
     // Calculate the boundaries over which possibilities could change.
     // This is done because possibilities change either through 1) some not
     // possible any more 2) new possibilities. The former can be checked, the
     // latter can only be done through recalculation Hence, we just always
     // recalculate is the change could make new possibilities available.
-
-    double newPosition = m_mobileMicrotubule.getPosition();
-
-    if (newPosition > m_lowerBorderPossibilities &&
-        newPosition < m_upperBorderPossibilities) // is in the region where the
-                                                  // connection data is valid:
-    {
-        for (PossibleFullConnection& connection: m_possibleConnections) {
+    const double newPosition = m_mobileMicrotubule.getPosition();
+    const bool possibilitiesAreValid =
+            newPosition > m_lowerBorderPossibilities &&
+            newPosition < m_upperBorderPossibilities;
+
+    // Update the extensions of the full linkers, and of the possibilities if
+    // these stay valid. In single precision, only the shift is updated
+    if constexpr (std::is_same_v<StorageScalar, double>) {
+        for (FullConnection& connection: m_fullConnections) {
             connection.extension += positionChange;
         }
-        for (PossibleFullHop& hop: m_possibleFullHops) {
-            hop.oldExtension += positionChange;
-            hop.newExtension += positionChange;
+        if (possibilitiesAreValid) {
+            for (PossibleFullConnection& connection: m_possibleConnections) {
+                connection.extension += positionChange;
+            }
+            for (PossibleFullHop& hop: m_possibleFullHops) {
+                hop.oldExtension += positionChange;
+                hop.newExtension += positionChange;
+            }
         }
     }
     else {
+        m_extensionShift += positionChange;
+    }
+
+    if (!possibilitiesAreValid) {
         // Recalculate all possibilities completely to get rid of outdated ones
         // and include new ones. Also resets the borders
         resetPossibilities();
     }
 }
 
-void CrosslinkerContainer::addFullConnection(
-        Crosslinker* const p_newFullCrosslinker) {
-#ifdef MYDEBUG
-    if (!p_newFullCrosslinker->isFull()) {
-        throw GeneralException(
-                "CrosslinkerContainer::addFullConnection() was called with a "
-                "crosslinker that is not fully connected");
-    }
-#endif // MYDEBUG
-
-    SiteLocation headLocation =
-            p_newFullCrosslinker->getOneBoundLocationWhenFullyConnected(
+double CrosslinkerContainer::findExtension(
+        const Crosslinker& fullLinker) const {
+    const SiteLocation headLocation =
+            fullLinker.getOneBoundLocationWhenFullyConnected(
                     Crosslinker::Terminus::HEAD);
-    SiteLocation tailLocation =
-            p_newFullCrosslinker->getOneBoundLocationWhenFullyConnected(
+    const SiteLocation tailLocation =
+            fullLinker.getOneBoundLocationWhenFullyConnected(
                     Crosslinker::Terminus::TAIL);
 
 #ifdef MYDEBUG
     if (headLocation.microtubule == tailLocation.microtubule) {
         throw GeneralException(
-                "CrosslinkerContainer::addFullConnection() was called with a "
+                "CrosslinkerContainer::findExtension() was called with a "
                 "crosslinker that was doubly connected to one microtubule");
     }
 #endif // MYDEBUG
@@ -878,8 +1177,22 @@ void CrosslinkerContainer::addFullConnection(
     default:
         throw GeneralException(
                 "A wrong microtubule type encountered in "
-                "CrosslinkerContainer::addFullConnection()");
+                "CrosslinkerContainer::findExtension()");
     }
+    return m_fixedMicrotubule.getMinimumImage(extension);
+}
+
+void CrosslinkerContainer::addFullConnection(
+        Crosslinker* const p_newFullCrosslinker) {
+#ifdef MYDEBUG
+    if (!p_newFullCrosslinker->isFull()) {
+        throw GeneralException(
+                "CrosslinkerContainer::addFullConnection() was called with a "
+                "crosslinker that is not fully connected");
+    }
+#endif // MYDEBUG
+
+    const double extension = findExtension(*p_newFullCrosslinker);
 
 #ifdef MYDEBUG
     if (std::abs(extension) >= m_maxStretch) {
@@ -889,8 +1202,9 @@ void CrosslinkerContainer::addFullConnection(
     }
 #endif // MYDEBUG
 
-    m_fullConnections.push_back(
-            FullConnection {p_newFullCrosslinker, extension});
+    m_fullConnections.push_back(FullConnection {
+            p_newFullCrosslinker,
+            static_cast<StorageScalar>(extension - m_extensionShift)});
 }
 
 void CrosslinkerContainer::removeFullConnection(
@@ -915,6 +1229,10 @@ void CrosslinkerContainer::removeFullConnection(
             m_fullConnections.end());
 }
 
+double CrosslinkerContainer::getExtensionShift() const {
+    return m_extensionShift;
+}
+
 const std::vector<PossibleFullConnection>& CrosslinkerContainer::
         getPossibleConnections() const {
     return m_possibleConnections;
@@ -945,8 +1263,20 @@ const std::vector<Crosslinker*>& CrosslinkerContainer::getFullLinkers() const {
 }
 
 void CrosslinkerContainer::resetPossibilities() {
+    // In single precision, the extensions of the full linkers are found anew,
+    // such that the shift starts again from zero
+    if (m_extensionShift != 0.0) {
+        for (FullConnection& connection: m_fullConnections) {
+            connection.extension = static_cast<StorageScalar>(
+                    findExtension(*connection.p_fullLinker));
+        }
+        m_extensionShift = 0.0;
+    }
+
     findPossibilityBorders();
 
+    m_coarseGrainingReferencePosition = m_mobileMicrotubule.getPosition();
+
     findPossibleConnections();
 
     findPossiblePartialHops();
@@ -954,6 +1284,42 @@ void CrosslinkerContainer::resetPossibilities() {
     findPossibleFullHops();
 }
 
+bool CrosslinkerContainer::isDistantPartial(
+        const Crosslinker* const p_partialCrosslinker) const {
+    return isDistantSite(
+            p_partialCrosslinker->getBoundLocationWhenPartiallyConnected());
+}
+
+// Until the next reset, the mobile microtubule moves less than a lattice
+// spacing, so with a margin of two lattice spacings on top of the maximum
+// stretch, distant linkers can never connect to the mobile microtubule
+bool CrosslinkerContainer::isDistantSite(const SiteLocation& location) const {
+    if (!m_coarseGrainDistantPartials) {
+        return false;
+    }
+
+    if (location.microtubule != MicrotubuleType::FIXED) {
+        return false;
+    }
+
+    const double position = location.position * m_latticeSpacing;
+    const double margin = m_maxStretch + 2 * m_latticeSpacing;
+    return (position < m_coarseGrainingReferencePosition - margin) ||
+           (position > m_coarseGrainingReferencePosition +
+                               m_mobileMicrotubule.getLength() + margin);
+}
+
+std::vector<Crosslinker*> CrosslinkerContainer::getDistantPartialLinkers()
+        const {
+    std::vector<Crosslinker*> distantPartialLinkers;
+    for (Crosslinker* const p_linker: m_partialCrosslinkers) {
+        if (isDistantPartial(p_linker)) {
+            distantPartialLinkers.push_back(p_linker);
+        }
+    }
+    return distantPartialLinkers;
+}
+
 std::pair<int32_t, int32_t> CrosslinkerContainer::
         getNPartialsBoundWithHeadAndTail() const {
 #ifdef MYDEBUG
@@ -0,0 +1,131 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional> // less
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "filament-sliding/Checkpoint.hpp"
+
+#include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
+#include "filament-sliding/GeneralException.hpp"
+
+CrosslinkerRelocation::CrosslinkerRelocation() {}
+
+CrosslinkerRelocation::~CrosslinkerRelocation() {}
+
+void CrosslinkerRelocation::addRange(
+        const std::vector<Crosslinker>& source,
+        std::vector<Crosslinker>& target) {
+    if (source.size() != target.size()) {
+        throw GeneralException(
+                "CrosslinkerRelocation::addRange() was called with vectors of "
+                "different sizes");
+    }
+    m_ranges.push_back(Range {
+            source.data(), source.data() + source.size(), target.data()});
+}
+
+void CrosslinkerRelocation::addRange(const std::vector<Crosslinker>& source) {
+    m_ranges.push_back(
+            Range {source.data(), source.data() + source.size(), nullptr});
+}
+
+int32_t CrosslinkerRelocation::getIndex(
+        const Crosslinker* const p_sourceLinker) const {
+    if (p_sourceLinker == nullptr) {
+        return -1;
+    }
+
+    const std::less<const Crosslinker*> less;
+    int32_t firstIndex = 0;
+    for (const Range& range: m_ranges) {
+        if (!less(p_sourceLinker, range.p_sourceBegin) &&
+            less(p_sourceLinker, range.p_sourceEnd)) {
+            return firstIndex +
+                   static_cast<int32_t>(p_sourceLinker - range.p_sourceBegin);
+        }
+        firstIndex += static_cast<int32_t>(
+                range.p_sourceEnd - range.p_sourceBegin);
+    }
+
+    throw GeneralException(
+            "CrosslinkerRelocation::getIndex() encountered a crosslinker "
+            "outside of all ranges");
+}
+
+Crosslinker* CrosslinkerRelocation::getCrosslinker(const int32_t index) const {
+    if (index == -1) {
+        return nullptr;
+    }
+
+    int32_t firstIndex = 0;
+    for (const Range& range: m_ranges) {
+        const int32_t size =
+                static_cast<int32_t>(range.p_sourceEnd - range.p_sourceBegin);
+        if (index >= firstIndex && index < firstIndex + size &&
+            range.p_targetBegin != nullptr) {
+            return range.p_targetBegin + (index - firstIndex);
+        }
+        firstIndex += size;
+    }
+
+    throw GeneralException(
+            "CrosslinkerRelocation::getCrosslinker() was called with an index "
+            "outside of all target ranges");
+}
+
+Crosslinker* CrosslinkerRelocation::relocate(
+        const Crosslinker* const p_sourceLinker) const {
+    if (p_sourceLinker == nullptr) {
+        return nullptr;
+    }
+
+    // Pointers into different arrays can only be ordered with std::less
+    const std::less<const Crosslinker*> less;
+    for (const Range& range: m_ranges) {
+        if (!less(p_sourceLinker, range.p_sourceBegin) &&
+            less(p_sourceLinker, range.p_sourceEnd)) {
+            if (range.p_targetBegin == nullptr) {
+                break;
+            }
+            return range.p_targetBegin + (p_sourceLinker - range.p_sourceBegin);
+        }
+    }
+
+    throw GeneralException(
+            "CrosslinkerRelocation::relocate() encountered a crosslinker "
+            "outside of all target ranges");
+}
+
+void CrosslinkerRelocation::relocate(
+        const std::vector<Crosslinker*>& sourceLinkers,
+        std::vector<Crosslinker*>& targetLinkers) const {
+    targetLinkers.resize(sourceLinkers.size());
+    for (std::size_t i = 0; i < sourceLinkers.size(); ++i) {
+        targetLinkers[i] = relocate(sourceLinkers[i]);
+    }
+}
+
+void CrosslinkerRelocation::writeLinkers(
+        std::ostream& out,
+        const std::vector<Crosslinker*>& sourceLinkers) const {
+    std::vector<int32_t> indices;
+    indices.reserve(sourceLinkers.size());
+    for (const Crosslinker* const p_linker: sourceLinkers) {
+        indices.push_back(getIndex(p_linker));
+    }
+    Checkpoint::writeVector(out, indices);
+}
+
+void CrosslinkerRelocation::readLinkers(
+        std::istream& in,
+        std::vector<Crosslinker*>& targetLinkers) const {
+    std::vector<int32_t> indices;
+    Checkpoint::readVector(in, indices);
+    targetLinkers.resize(indices.size());
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        targetLinkers[i] = getCrosslinker(indices[i]);
+    }
+}
@@ -16,18 +16,135 @@ ParameterMap::ParameterMap() {
      * floating point (e.g. "4.") to make it double The strings (for example the
      * unit or the allowed parameters!) are NOT allowed to contain white space,
      * since reading will then try to read the next field
+     * Parameters that only concern the output, the length of the run or the way
+     * the program is run, and not the state it samples, are defined with
+     * defineRunParameter. All others are part of the key of the equilibration
+     * cache (see getValuesAffectingState)
      */
     // Run parameters
-    defineParameter(
+    defineRunParameter(
             "runName",
             "run",
             "unitless"); // The code relies on this parameter being called
                          // "runName"
-    defineParameter("numberEquilibrationBlocks", 0, "blocks", ">=0");
-    defineParameter("numberRunBlocks", 1, "blocks", ">=0");
+    defineRunParameter("numberEquilibrationBlocks", 0, "blocks", ">=0");
+    defineRunParameter("numberRunBlocks", 1, "blocks", ">=0");
     defineParameter("calcTimeStep", 1.e-10, "s", ">0");
-    defineParameter("timeStepsPerBlock", 1000000, "steps", ">0");
-    defineParameter("positionProbePeriod", 1000000, "steps", ">0");
+    defineRunParameter("timeStepsPerBlock", 1000000, "steps", ">0");
+    defineRunParameter("positionProbePeriod", 1000000, "steps", ">0");
+    defineRunParameter(
+            "numberThreads",
+            1,
+            "threads",
+            ">0"); // Threads over which the evaluation of the individual
+                   // reaction rates of a large system is split
+    // With an even number of sublattice domains (none for 0), the hops and
+    // the binding and unbinding of second heads in domains of one colour are
+    // chosen concurrently, each domain on its own clock. A domain should be
+    // wider than twice the maximum stretch plus six lattice spacings
+    defineRunParameter("numberSublatticeDomains", 0, "domains", ">=0");
+    // Independent copies of the system, run on the threads and combined into
+    // a single output
+    defineRunParameter("numberReplicas", 1, "replicas", ">0");
+    // Propagates the replicas of each thread together, one time step for all
+    // of them at a time. Only for systems without binding dynamics
+    defineRunParameter("lockstepReplicas", "FALSE", "unitless", "TRUE,FALSE");
+    // Runs the system at a ladder of amplitudes of a sinusoidal external force,
+    // from externalForceValue to the last value, and exchanges the states of
+    // neighbouring rungs every period. One rung means no exchange
+    defineRunParameter("replicaExchangeRungs", 1, "rungs", ">0");
+    defineRunParameter(
+            "replicaExchangeLastForceValue", 0.0, "kT/micron", "all");
+    defineRunParameter("replicaExchangePeriod", 1000, "steps", ">0");
+    // Used by filament-sliding-sweep: a file that lists the parameter files of
+    // the points of the sweep, one per line, and a sweep specification that
+    // is expanded into points around these parameters (see ParameterGrid)
+    defineRunParameter("sweepPoints", "NONE", "unitless");
+    defineRunParameter("sweepGrid", "NONE", "unitless");
+    // With a job queue directory, filament-sliding-sweep adds its points to
+    // the queue, and filament-sliding-worker processes take them from it. A
+    // claim that was not refreshed for jobClaimTimeout is taken over
+    defineRunParameter("jobQueueDirectory", "NONE", "unitless");
+    defineRunParameter("jobClaimTimeout", 600., "s", ">0");
+    // A file listing the run names of which filament-sliding-merge merges the
+    // accumulators, one per line
+    defineRunParameter("mergeRuns", "NONE", "unitless");
+    // A file listing the run names that filament-sliding-compare compares,
+    // one per line, each followed by the name of one of two groups
+    defineRunParameter("compareRuns", "NONE", "unitless");
+    // The name of a shared memory segment in which the statistics and
+    // histograms of sharedAccumulatorsProcesses runs are gathered, of which
+    // the last one to finish writes them. The runs of one launch of the
+    // ensemble share a label, such as the id of the job, which distinguishes
+    // them from a crashed launch that left the segment behind
+    defineRunParameter("sharedAccumulators", "NONE", "unitless");
+    defineRunParameter("sharedAccumulatorsProcesses", 1, "processes", ">0");
+    defineRunParameter("sharedAccumulatorsEnsemble", "NONE", "unitless");
+    // Partial linkers on the fixed microtubule far from the overlap do not hop
+    // individually, but are moved together every coarseGrainingPeriod steps
+    defineParameter(
+            "coarseGrainDistantPartials", "FALSE", "unitless", "TRUE,FALSE");
+    defineParameter("coarseGrainingPeriod", 10000, "steps", ">0");
+    // Compares the force on the mobile microtubule, found from the stored
+    // extensions, to the force in double precision at every position probe
+    defineRunParameter(
+            "validateStoragePrecision", "FALSE", "unitless", "TRUE,FALSE");
+    // After the equilibration, a copy of the system is propagated for a block
+    // with the journal of its changes, rolled back, and compared to the system
+    defineRunParameter("validateJournal", "FALSE", "unitless", "TRUE,FALSE");
+    // A checkpoint of the run is written every checkpointPeriod steps (never
+    // for 0), and when the signal SIGTERM or SIGUSR1 is received. With a file
+    // name in resumeFromCheckpoint, the run continues from that checkpoint
+    defineRunParameter("checkpointPeriod", 0, "steps", ">=0");
+    defineRunParameter("resumeFromCheckpoint", "NONE", "unitless");
+    // Equilibrated states are kept in equilibrationCacheDirectory (not for
+    // NONE), in equilibrationCacheSlots slots per set of physical parameters
+    // and length of the equilibration. A run takes the state in a random slot
+    // instead of equilibrating, or stores its equilibrated state there when
+    // the slot is empty and, with adaptive equilibration, it was stationary
+    defineRunParameter("equilibrationCacheDirectory", "NONE", "unitless");
+    defineRunParameter("equilibrationCacheSlots", 8, "states", ">0");
+    // With adaptive equilibration, numberEquilibrationBlocks is the maximum.
+    // The equilibration stops after the first block at which the observables,
+    // sampled every equilibrationProbePeriod steps, are stationary: the means
+    // at the start and end of the second half of the samples differ by less
+    // than equilibrationTolerance standard errors
+    defineRunParameter(
+            "adaptiveEquilibration", "FALSE", "unitless", "TRUE,FALSE");
+    defineRunParameter("equilibrationProbePeriod", 1000, "steps", ">0");
+    defineRunParameter("equilibrationTolerance", 2., "SEM", ">0");
+    // With a precisionTarget above 0, numberRunBlocks is the maximum. The run
+    // stops after the first block, from minimumRunBlocks onwards, at which the
+    // SEM of precisionTargetStatistic is at most precisionTarget times its
+    // mean. Since the SEM of the first blocks can be small by chance, a few
+    // blocks are always run
+    defineRunParameter("precisionTarget", 0., "relativeSEM", ">=0");
+    defineRunParameter(
+            "precisionTargetStatistic",
+            "CROSSING_TIME",
+            "unitless",
+            "CROSSING_TIME,FINAL_REGION_TIME");
+    defineRunParameter("minimumRunBlocks", 3, "blocks", ">0");
+    // Used by filament-sliding-timestep-study, which runs the system at
+    // timeStepStudyRungs time steps, calcTimeStep times the powers of
+    // timeStepStudyFactor, and recommends the largest one at which the
+    // observables deviate from their extrapolation to a vanishing time step by
+    // at most timeStepStudyTolerance (relative)
+    defineRunParameter("timeStepStudyRungs", 4, "rungs", ">1");
+    defineRunParameter("timeStepStudyFactor", 2., "unitless", ">1");
+    defineRunParameter("timeStepStudyTolerance", 0.05, "relative", ">0");
+    defineRunParameter("timeStepStudyProcesses", 4, "processes", ">0");
+    // With multilevelLevels above 0, the run blocks are replaced by a
+    // multilevel Monte Carlo estimate of the barrier crossing rate at
+    // calcTimeStep, with levels at calcTimeStep times the powers of two. Every
+    // sample covers a block, and the samples per level are raised from the
+    // pilot samples until the relative SEM is multilevelPrecision. The samples
+    // start from multilevelSnapshots states, taken a block apart
+    defineRunParameter("multilevelLevels", 0, "levels", ">=0");
+    defineRunParameter("multilevelPilotSamples", 10, "samples", ">1");
+    defineRunParameter("multilevelPrecision", 0.05, "relativeSEM", ">0");
+    defineRunParameter("multilevelMaxSamples", 10000, "samples", ">1");
+    defineRunParameter("multilevelSnapshots", 100, "states", ">0");
 
     // General state parameters
     defineParameter("lengthMobileMicrotubule", 1., "micron", ">0");
@@ -35,6 +152,14 @@ ParameterMap::ParameterMap() {
     defineParameter("latticeSpacing", 8.e-3, "micron", ">0");
     defineParameter(
             "maximumStretch", 1.499999999999999, "latticeSpacing", ">0");
+    // With periodic boundaries, both microtubules wrap around and overlap
+    // completely, which mimics the bulk of a long overlap. Their lengths should
+    // then be equal
+    defineParameter("periodicBoundaries", "FALSE", "unitless", "TRUE,FALSE");
+    // With a window, only the sites of the fixed microtubule within a margin
+    // around the mobile microtubule are stored, and the window moves along
+    defineParameter("fixedLatticeWindow", "FALSE", "unitless", "TRUE,FALSE");
+    defineParameter("fixedLatticeWindowMargin", 0.2, "micron", ">0");
 
     defineParameter("numberActiveCrosslinkers", 0, "crosslinkers", ">=0");
     defineParameter("numberDualCrosslinkers", 0, "crosslinkers", ">=0");
@@ -138,36 +263,37 @@ ParameterMap::ParameterMap() {
             "unitless",
             "BARRIERFREE,SINUS,CONSTANT");
     defineParameter("externalForceValue", 0.0, "kT/micron", "all");
-    defineParameter(
+    defineRunParameter(
             "samplePositionalDistribution", "FALSE", "unitless", "TRUE,FALSE");
-    defineParameter("positionalHistogramBinSize", 8.e-7, "micron", ">0");
-    defineParameter("positionalHistogramLowestValue", 0.0, "micron", ">=0");
-    defineParameter(
+    defineRunParameter("positionalHistogramBinSize", 8.e-7, "micron", ">0");
+    defineRunParameter("positionalHistogramLowestValue", 0.0, "micron", ">=0");
+    defineRunParameter(
             "positionalHistogramHighestValue",
             8.e-3,
             "micron",
             ">positionalHistogramLowestValue");
-    defineParameter("showGraphics", "FALSE", "unitless", "TRUE,FALSE");
-    defineParameter("timeStepsDisplayInterval", 100000, "steps", ">0");
-    defineParameter("updateDelayInMilliseconds", 100, "milliseconds", ">=0");
-    defineParameter("recordTransitionPaths", "FALSE", "unitless", "TRUE,FALSE");
-    defineParameter(
+    defineRunParameter("showGraphics", "FALSE", "unitless", "TRUE,FALSE");
+    defineRunParameter("timeStepsDisplayInterval", 100000, "steps", ">0");
+    defineRunParameter("updateDelayInMilliseconds", 100, "milliseconds", ">=0");
+    defineRunParameter(
+            "recordTransitionPaths", "FALSE", "unitless", "TRUE,FALSE");
+    defineRunParameter(
             "transitionPathProbePeriod",
             10000,
             "steps",
             ">0"); // The probe period is used for writing, not for
                    // recording in the histogram
-    defineParameter("maxNumberTransitionPaths", 100, "paths", ">=0");
-    defineParameter("maxPeriodPositionTracking", 10.0, "s", ">=0");
-    defineParameter(
+    defineRunParameter("maxNumberTransitionPaths", 100, "paths", ">=0");
+    defineRunParameter("maxPeriodPositionTracking", 10.0, "s", ">=0");
+    defineRunParameter(
             "estimateTimeEvolutionAtPeak", "FALSE", "unitless", "TRUE,FALSE");
-    defineParameter("timeStepsPerDistributionEstimate", 25, "steps", ">0");
-    defineParameter("nEstimatesDistribution", 200, "sets", ">0");
-    defineParameter(
+    defineRunParameter("timeStepsPerDistributionEstimate", 25, "steps", ">0");
+    defineRunParameter("nEstimatesDistribution", 200, "sets", ">0");
+    defineRunParameter(
             "dynamicsEstimationInitialRegionWidth",
             0.0002,
             "unitless",
             "(0,1]");
-    defineParameter(
+    defineRunParameter(
             "dynamicsEstimationFinalRegionWidth", 0.05, "unitless", "(0,1]");
 }
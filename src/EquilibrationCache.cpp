@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <cstdio> // std::rename
+#include <fstream>
+#include <iomanip> // std::setw, std::setfill
+#include <random> // std::random_device
+#include <sstream>
+#include <string>
+
+#include "filament-sliding/Checkpoint.hpp"
+#include "filament-sliding/EquilibrationCache.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/StoragePrecision.hpp"
+#include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/version.hpp"
+
+EquilibrationCache::EquilibrationCache(
+        const std::string& directory,
+        const int32_t nSlots,
+        const std::string& parameterValues):
+        m_directory(directory),
+        m_nSlots(nSlots),
+        m_key(std::string(GIT_COMMIT) + '\n' + "storage precision " +
+              std::to_string(sizeof(StorageScalar)) + '\n' + parameterValues) {
+    if (m_nSlots <= 0) {
+        throw GeneralException(
+                "EquilibrationCache was constructed without slots");
+    }
+}
+
+EquilibrationCache::~EquilibrationCache() {}
+
+uint64_t EquilibrationCache::hash(const std::string& text) {
+    uint64_t value = 14695981039346656037ull;
+    for (const char character: text) {
+        value ^= static_cast<uint64_t>(static_cast<unsigned char>(character));
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+void EquilibrationCache::drawSlot(RandomGenerator& generator) {
+    const int32_t slot = generator.getUniformInteger(0, m_nSlots - 1);
+    std::ostringstream fileName;
+    fileName << m_directory << "/equilibrated_state." << std::hex
+             << std::setw(16) << std::setfill('0') << hash(m_key) << std::dec
+             << '.' << slot << ".bin";
+    m_fileName = fileName.str();
+}
+
+bool EquilibrationCache::slotHasState() const {
+    return std::ifstream(m_fileName.c_str()).good();
+}
+
+std::string EquilibrationCache::getFileName() const { return m_fileName; }
+
+void EquilibrationCache::readState(SystemState& systemState) const {
+    std::ifstream file(m_fileName.c_str(), std::ios::binary);
+    Checkpoint::readHeader(file);
+    if (Checkpoint::readString(file) != m_key) {
+        throw GeneralException(
+                "The equilibrated state " + m_fileName +
+                " belongs to other parameters.");
+    }
+    systemState.readCheckpoint(file);
+}
+
+void EquilibrationCache::writeState(const SystemState& systemState) const {
+    const std::string temporaryFileName =
+            m_fileName + '.' + std::to_string(std::random_device {}()) + ".tmp";
+    std::ofstream file(temporaryFileName.c_str(), std::ios::binary);
+    Checkpoint::writeHeader(file);
+    Checkpoint::writeString(file, m_key);
+    systemState.writeCheckpoint(file);
+
+    file.close();
+    if (!file ||
+        std::rename(temporaryFileName.c_str(), m_fileName.c_str()) != 0) {
+        throw GeneralException(
+                "The equilibrated state could not be written to " +
+                m_fileName + ". Does the directory exist?");
+    }
+}
@@ -0,0 +1,153 @@
+#include <algorithm> // std::minmax_element
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/Checkpoint.hpp"
+#include "filament-sliding/EquilibrationMonitor.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Statistics.hpp"
+#include "filament-sliding/SystemState.hpp"
+
+// Each segment of a time series is cut into s_nBatches batches. The variance of
+// the batch means then estimates the variance of the mean of the segment, as
+// long as the batches are longer than the correlation time.
+static constexpr int32_t s_nBatches = 10;
+static constexpr int32_t s_minBatchSize = 2;
+
+// The samples that do not fill a batch are left out at the beginning of the
+// segment
+static void addBatchMeans(
+        const std::vector<double>& samples,
+        const std::size_t begin,
+        const std::size_t end,
+        Statistics& batchMeans) {
+    const std::size_t batchSize = (end - begin) / s_nBatches;
+    std::size_t batchBegin = end - s_nBatches * batchSize;
+    for (int32_t batch = 0; batch < s_nBatches; ++batch) {
+        double sum = 0.0;
+        for (std::size_t i = batchBegin; i < batchBegin + batchSize; ++i) {
+            sum += samples[i];
+        }
+        batchMeans.addValue(sum / static_cast<double>(batchSize));
+        batchBegin += batchSize;
+    }
+}
+
+EquilibrationMonitor::EquilibrationMonitor(const double tolerance):
+        m_tolerance(tolerance), m_samples(getObservableNames().size()) {
+    if (m_tolerance <= 0.0) {
+        throw GeneralException(
+                "EquilibrationMonitor was constructed with a tolerance that "
+                "is not positive");
+    }
+}
+
+EquilibrationMonitor::~EquilibrationMonitor() {}
+
+std::vector<std::string> EquilibrationMonitor::getObservableNames() {
+    return {"energy",
+            "number of full linkers",
+            "number of right pulling linkers",
+            "overlap occupancy"};
+}
+
+void EquilibrationMonitor::addSample(const SystemState& systemState) {
+    const int32_t nSitesOverlap = systemState.getNSitesOverlapFixed();
+    const double overlapOccupancy =
+            (nSitesOverlap > 0)
+                    ? static_cast<double>(
+                              systemState.getNOccupiedSitesOverlapFixed()) /
+                              nSitesOverlap
+                    : 0.0;
+
+    m_samples[0].push_back(systemState.getEnergy());
+    m_samples[1].push_back(systemState.getNFullCrosslinkers());
+    m_samples[2].push_back(systemState.getNFullRightPullingCrosslinkers());
+    m_samples[3].push_back(overlapOccupancy);
+}
+
+int64_t EquilibrationMonitor::getNumberOfSamples() const {
+    return static_cast<int64_t>(m_samples.front().size());
+}
+
+double EquilibrationMonitor::findZScore(
+        const std::vector<double>& samples,
+        const std::size_t begin) {
+    const std::size_t nSamples = samples.size() - begin;
+
+    Statistics firstBatchMeans;
+    addBatchMeans(samples, begin, begin + nSamples / 10, firstBatchMeans);
+    Statistics lastBatchMeans;
+    addBatchMeans(
+            samples,
+            samples.size() - nSamples / 2,
+            samples.size(),
+            lastBatchMeans);
+
+    const double difference =
+            firstBatchMeans.getMean() - lastBatchMeans.getMean();
+    const double varianceDifference =
+            (firstBatchMeans.getVariance() + lastBatchMeans.getVariance()) /
+            s_nBatches;
+    // An observable that did not change at all, such as the number of full
+    // linkers without binding, is stationary. Its batch means can still differ
+    // by rounding, so the samples themselves are compared
+    if (varianceDifference == 0.0) {
+        const auto range = std::minmax_element(
+                samples.begin() + static_cast<std::ptrdiff_t>(begin),
+                samples.end());
+        return (*range.first == *range.second)
+                       ? 0.0
+                       : std::numeric_limits<double>::infinity();
+    }
+    return difference / std::sqrt(varianceDifference);
+}
+
+bool EquilibrationMonitor::isStationary() {
+    m_zScores.clear();
+    const std::size_t nSamples = m_samples.front().size();
+    const std::size_t begin = nSamples / 2;
+    if ((nSamples - begin) / 10 <
+        static_cast<std::size_t>(s_nBatches * s_minBatchSize)) {
+        return false;
+    }
+
+    bool isStationary = true;
+    for (const std::vector<double>& samples: m_samples) {
+        m_zScores.push_back(findZScore(samples, begin));
+        if (!(std::abs(m_zScores.back()) < m_tolerance)) {
+            isStationary = false;
+        }
+    }
+    return isStationary;
+}
+
+const std::vector<double>& EquilibrationMonitor::getZScores() const {
+    return m_zScores;
+}
+
+void EquilibrationMonitor::writeCheckpoint(std::ostream& out) const {
+    Checkpoint::write(out, static_cast<int64_t>(m_samples.size()));
+    for (const std::vector<double>& samples: m_samples) {
+        Checkpoint::writeVector(out, samples);
+    }
+}
+
+void EquilibrationMonitor::readCheckpoint(std::istream& in) {
+    int64_t nObservables;
+    Checkpoint::read(in, nObservables);
+    Checkpoint::checkSize(
+            nObservables,
+            static_cast<int64_t>(m_samples.size()),
+            "number of equilibration observables");
+    for (std::vector<double>& samples: m_samples) {
+        Checkpoint::readVector(in, samples);
+    }
+    m_zScores.clear();
+}
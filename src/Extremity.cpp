@@ -1,4 +1,8 @@
 #include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "filament-sliding/Checkpoint.hpp"
 
 #include "filament-sliding/Extremity.hpp"
 #include "filament-sliding/GeneralException.hpp"
@@ -73,3 +77,15 @@ MicrotubuleType Extremity::getMicrotubuleConnectedTo() const {
 #endif // MYDEBUG
     return m_connectedTo;
 }
+
+void Extremity::writeCheckpoint(std::ostream& out) const {
+    Checkpoint::write(out, m_connected);
+    Checkpoint::write(out, m_connectedTo);
+    Checkpoint::write(out, m_sitePosition);
+}
+
+void Extremity::readCheckpoint(std::istream& in) {
+    Checkpoint::read(in, m_connected);
+    Checkpoint::read(in, m_connectedTo);
+    Checkpoint::read(in, m_sitePosition);
+}
@@ -1,6 +1,7 @@
 #include <cstdint> // For int32_t
 #include <iomanip> // For std::setw()
 #include <iostream> // For overloading the IO operators
+#include <sstream> // For reading and writing values as text
 #include <string>
 
 #include "filament-sliding/GenericValue.hpp"
@@ -95,26 +96,59 @@ std::string GenericValue::getUnit() const {
     return m_unit;
 }
 
+AllowedTypes GenericValue::getType() const { return m_currentType; }
+
+bool GenericValue::readValue(const std::string& text) {
+    std::istringstream in(text);
+    switch (m_currentType) {
+    case AllowedTypes::TEXT:
+        in >> m_stringValue;
+        break;
+    case AllowedTypes::INTEGER:
+        in >> m_integerValue;
+        break;
+    case AllowedTypes::REAL:
+        in >> m_realValue;
+        break;
+    default:
+        throw InputException {
+                "A value was tried to be read into a GenericValue with no "
+                "type."};
+        break;
+    }
+
+    std::string remainder;
+    return !in.fail() && !(in >> remainder);
+}
+
 // IO operators
 
 std::ostream& operator<<(std::ostream& out, const GenericValue& genericValue) {
     out << std::left;
-    out << std::setw(InputFileGeometry::valueWidth); // Column size for value
+    // The value is written in the precision of out, and is kept apart from the
+    // unit when it is longer than its column
+    std::ostringstream value;
+    value.precision(out.precision());
     switch (genericValue.m_currentType) {
     case AllowedTypes::TEXT:
-        out << genericValue.m_stringValue;
+        value << genericValue.m_stringValue;
         break;
     case AllowedTypes::INTEGER:
-        out << genericValue.m_integerValue;
+        value << genericValue.m_integerValue;
         break;
     case AllowedTypes::REAL:
-        out << genericValue.m_realValue;
+        value << genericValue.m_realValue;
         break;
     case AllowedTypes::NONE:
         throw InputException {
                 "A GenericValue with no type was tried to be output."};
         break;
     }
+    const std::string valueText = value.str();
+    out << std::setw(InputFileGeometry::valueWidth) << valueText;
+    if (static_cast<int>(valueText.size()) >= InputFileGeometry::valueWidth) {
+        out << ' ';
+    }
     out << std::setw(InputFileGeometry::unitWidth) << genericValue.m_unit;
     out << std::setw(InputFileGeometry::typeWidth);
     switch (genericValue.m_currentType) {
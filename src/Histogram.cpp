@@ -1,9 +1,11 @@
 #include <iomanip>
 #include <iostream>
+#include <istream>
 #include <limits>
 #include <string>
 #include <utility>
 
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/Histogram.hpp"
 #include "filament-sliding/MathematicalFunctions.hpp"
@@ -63,6 +65,62 @@ void Histogram::addValue(const double value) {
     ++m_bins.at(binNumber);
 }
 
+void Histogram::merge(const Histogram& other) {
+    if (other.m_bins.size() != m_bins.size() ||
+        other.m_binSize != m_binSize || other.m_lowestValue != m_lowestValue) {
+        throw GeneralException(
+                "Histogram::merge() was called with a histogram that has "
+                "different bins.");
+    }
+    Statistics::merge(other);
+    for (std::size_t binNumber = 0; binNumber < m_bins.size(); ++binNumber) {
+        m_bins[binNumber] += other.m_bins[binNumber];
+    }
+}
+
+void Histogram::serialize(std::ostream& out) const {
+    Statistics::serialize(out);
+    Checkpoint::write(out, m_binSize);
+    Checkpoint::write(out, m_lowestValue);
+    Checkpoint::writeVector(out, m_bins);
+}
+
+void Histogram::readSerialized(std::istream& in) {
+    Statistics::readSerialized(in);
+    double binSize, lowestValue;
+    Checkpoint::read(in, binSize);
+    Checkpoint::read(in, lowestValue);
+    const std::size_t nBins = m_bins.size();
+    Checkpoint::readVector(in, m_bins);
+    if (binSize != m_binSize || lowestValue != m_lowestValue ||
+        m_bins.size() != nBins) {
+        throw GeneralException(
+                "A serialized histogram has different bins than the one it "
+                "should be merged into.");
+    }
+}
+
+void Histogram::mergeSerialized(std::istream& in) {
+    Histogram other(*this); // Has the same bins
+    other.readSerialized(in);
+    merge(other);
+}
+
+void Histogram::writeCheckpoint(std::ostream& out) const {
+    Statistics::writeCheckpoint(out);
+    Checkpoint::writeVector(out, m_bins);
+}
+
+void Histogram::readCheckpoint(std::istream& in) {
+    Statistics::readCheckpoint(in);
+    const std::size_t nBins = m_bins.size();
+    Checkpoint::readVector(in, m_bins);
+    Checkpoint::checkSize(
+            static_cast<int64_t>(m_bins.size()),
+            static_cast<int64_t>(nBins),
+            "number of bins of a histogram");
+}
+
 std::pair<double, double> Histogram::calculateBinBounds(
         const int32_t binNumber) const {
 #ifdef MYDEBUG
@@ -1,5 +1,8 @@
 #include <cmath> // exp
 #include <cstddef> // size_t
+#include <cstdint>
+#include <functional>
+#include <utility> // pair
 #include <vector>
 
 #include "filament-sliding/HopFull.hpp"
@@ -31,29 +34,64 @@ void HopFull::setCurrentRate(const SystemState& systemState) {
     const std::vector<PossibleFullHop>& possibleFullHops =
             systemState.getPossibleFullHops(m_typeToHop);
 
-    m_individualRates.clear();
-    m_individualRates.reserve(possibleFullHops.size());
+    const double extensionShift = systemState.getExtensionShift(m_typeToHop);
+    m_individualRates.resize(possibleFullHops.size());
 
-    double sum = 0;
-    for (const PossibleFullHop& possibleFullHop: possibleFullHops) {
-        // Two energetic effects influence the rate of hopping:
-        // First, there can be a non-equilibrium driving in one direction,
-        // causing causing the rate to be biased. Second, the rate depends on
-        // the energy of stretching, 0.5*springConstant*extension^2 The
-        // influence of this energy is spread evenly over the forward and
-        // backward reactions, explaining the extra factor 0.5 in the exponent.
-        double rate = getBaseRateToHop(
-                possibleFullHop.terminusToHop,
-                possibleFullHop.direction,
-                possibleFullHop.awayFromNeighbour);
-        rate *= std::exp(
-                0.25 * m_springConstant *
-                (possibleFullHop.oldExtension * possibleFullHop.oldExtension -
-                 possibleFullHop.newExtension * possibleFullHop.newExtension));
-        m_individualRates.push_back(rate);
-        sum += rate;
+    // The rates are independent of each other, so they can be found in chunks
+    // concurrently
+    forEachRateChunk(
+            possibleFullHops.size(),
+            [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t label = begin; label < end; ++label) {
+                    const PossibleFullHop& possibleFullHop =
+                            possibleFullHops[label];
+                    if (mp_domains != nullptr) {
+                        setPossibilityDomain(
+                                label, possibleFullHop.locationToHopTo);
+                    }
+                    // Two energetic effects influence the rate of hopping:
+                    // First, there can be a non-equilibrium driving in one
+                    // direction, causing causing the rate to be biased. Second,
+                    // the rate depends on the energy of stretching,
+                    // 0.5*springConstant*extension^2 The influence of this
+                    // energy is spread evenly over the forward and backward
+                    // reactions, explaining the extra factor 0.5 in the
+                    // exponent.
+                    double rate = getBaseRateToHop(
+                            possibleFullHop.terminusToHop,
+                            possibleFullHop.direction,
+                            possibleFullHop.awayFromNeighbour);
+                    const double oldExtension =
+                            possibleFullHop.oldExtension + extensionShift;
+                    const double newExtension =
+                            possibleFullHop.newExtension + extensionShift;
+                    rate *= std::exp(
+                            0.25 * m_springConstant *
+                            (oldExtension * oldExtension -
+                             newExtension * newExtension));
+                    m_individualRates[label] = rate;
+                }
+            });
+    m_currentRate = sumRates(m_individualRates);
+}
+
+std::pair<double, double> HopFull::getCurrentRatesByExtensionChange(
+        const SystemState& systemState) const {
+    const std::vector<PossibleFullHop>& possibleFullHops =
+            systemState.getPossibleFullHops(m_typeToHop);
+
+    double rateIncreasing = 0.0;
+    double rateDecreasing = 0.0;
+    for (std::size_t label = 0; label < m_individualRates.size(); ++label) {
+        const PossibleFullHop& possibleFullHop = possibleFullHops[label];
+        if (possibleFullHop.newExtension > possibleFullHop.oldExtension) {
+            rateIncreasing += m_individualRates[label];
+        }
+        else {
+            rateDecreasing += m_individualRates[label];
+        }
     }
-    m_currentRate = sum;
+    return std::pair<double, double>(rateIncreasing, rateDecreasing);
 }
 
 double HopFull::getBaseRateToHop(
@@ -119,14 +157,33 @@ const PossibleFullHop& HopFull::whichHop(
     throw GeneralException("The end of HopFull::whichHop() was reached");
 }
 
-void HopFull::performReaction(
-        SystemState& systemState,
-        RandomGenerator& generator) {
-    PossibleFullHop hopToMake = whichHop(systemState, generator);
+void HopFull::makeHop(SystemState& systemState, const PossibleFullHop& hop) {
     // A hop consists of disconnecting the crosslinker at one terminus, and then
     // connecting that terminus again
     systemState.disconnectFullyConnectedCrosslinker(
-            *hopToMake.p_fullLinker, hopToMake.terminusToHop);
+            *hop.p_fullLinker, hop.terminusToHop);
     systemState.connectPartiallyConnectedCrosslinker(
-            *hopToMake.p_fullLinker, hopToMake.locationToHopTo);
+            *hop.p_fullLinker, hop.locationToHopTo);
+}
+
+void HopFull::performReaction(
+        SystemState& systemState,
+        RandomGenerator& generator) {
+    // Copied, since the possible hops change during the hop
+    const PossibleFullHop hopToMake = whichHop(systemState, generator);
+    makeHop(systemState, hopToMake);
+}
+
+bool HopFull::hasRatePerPossibility() const { return true; }
+
+std::function<void(SystemState&)> HopFull::chooseReactionInDomain(
+        const SystemState& systemState,
+        RandomGenerator& generator,
+        const int32_t domain) const {
+    const PossibleFullHop hopToMake =
+            systemState.getPossibleFullHops(m_typeToHop)[chooseLabelInDomain(
+                    m_individualRates, generator, domain)];
+    return [hopToMake](SystemState& changedSystemState) {
+        makeHop(changedSystemState, hopToMake);
+    };
 }
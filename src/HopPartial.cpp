@@ -1,5 +1,7 @@
 #include <cmath> // exp
 #include <cstddef> // size_t
+#include <cstdint>
+#include <functional>
 #include <vector>
 
 #include "filament-sliding/Crosslinker.hpp"
@@ -31,20 +33,25 @@ HopPartial::~HopPartial() {}
 void HopPartial::setCurrentRate(const SystemState& systemState) {
     const std::vector<PossiblePartialHop>& possiblePartialHops =
             systemState.getPossiblePartialHops(m_typeToHop);
+    m_individualRates.resize(possiblePartialHops.size());
 
-    m_individualRates.clear();
-    m_individualRates.reserve(possiblePartialHops.size());
-
-    double sum = 0;
-    for (const PossiblePartialHop& possiblePartialHop: possiblePartialHops) {
-        const double rate = getRateToHop(
-                possiblePartialHop.terminusToHop,
-                possiblePartialHop.direction,
-                possiblePartialHop.awayFromNeighbour);
-        m_individualRates.push_back(rate);
-        sum += rate;
-    }
-    m_currentRate = sum;
+    forEachRateChunk(
+            possiblePartialHops.size(),
+            [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t label = begin; label < end; ++label) {
+                    const PossiblePartialHop& possiblePartialHop =
+                            possiblePartialHops[label];
+                    if (mp_domains != nullptr) {
+                        setPossibilityDomain(
+                                label, possiblePartialHop.locationToHopTo);
+                    }
+                    m_individualRates[label] = getRateToHop(
+                            possiblePartialHop.terminusToHop,
+                            possiblePartialHop.direction,
+                            possiblePartialHop.awayFromNeighbour);
+                }
+            });
+    m_currentRate = sumRates(m_individualRates);
 }
 
 double HopPartial::getRateToHop(
@@ -110,14 +117,32 @@ PossiblePartialHop HopPartial::whichHop(
     throw GeneralException("The end of HopPartial::whichHop() was reached");
 }
 
+void HopPartial::makeHop(
+        SystemState& systemState,
+        const PossiblePartialHop& hop) const {
+    // Implement the hop as a combination of binding and unbinding
+    systemState.disconnectPartiallyConnectedCrosslinker(*hop.p_partialLinker);
+    systemState.connectFreeCrosslinker(
+            m_typeToHop, hop.terminusToHop, hop.locationToHopTo);
+}
+
 void HopPartial::performReaction(
         SystemState& systemState,
         RandomGenerator& generator) {
-    PossiblePartialHop hopToMake = whichHop(systemState, generator);
+    makeHop(systemState, whichHop(systemState, generator));
+}
 
-    // Implement the hop as a combination of binding and unbinding
-    systemState.disconnectPartiallyConnectedCrosslinker(
-            *hopToMake.p_partialLinker);
-    systemState.connectFreeCrosslinker(
-            m_typeToHop, hopToMake.terminusToHop, hopToMake.locationToHopTo);
+bool HopPartial::hasRatePerPossibility() const { return true; }
+
+std::function<void(SystemState&)> HopPartial::chooseReactionInDomain(
+        const SystemState& systemState,
+        RandomGenerator& generator,
+        const int32_t domain) const {
+    const PossiblePartialHop hopToMake =
+            systemState.getPossiblePartialHops(
+                    m_typeToHop)[chooseLabelInDomain(
+                    m_individualRates, generator, domain)];
+    return [this, hopToMake](SystemState& changedSystemState) {
+        makeHop(changedSystemState, hopToMake);
+    };
 }
@@ -11,6 +11,7 @@
 #include "filament-sliding/Extremity.hpp"
 #include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/Initialiser.hpp"
+#include "filament-sliding/MicrotubuleType.hpp"
 #include "filament-sliding/RandomGenerator.hpp"
 #include "filament-sliding/SystemState.hpp"
 
@@ -55,6 +56,9 @@ void Initialiser::initialise(
     systemState.setMicrotubulePosition(m_initialPositionMicrotubule);
 
     initialiseCrosslinkers(systemState, generator);
+
+    // The propagator expects the force on the microtubule to be up to date
+    systemState.updateForceAndEnergy();
 }
 
 void Initialiser::initialiseCrosslinkers(
@@ -238,22 +242,28 @@ void Initialiser::initialiseCrosslinkers(
         systemState.fullyConnectFreeCrosslinker(
                 Crosslinker::Type::PASSIVE,
                 terminusToConnectToFixedMicrotubule(generator),
-                firstSiteOverlapFixed +
-                        positionsToConnect.at(
-                                connectedSoFar), // The position on the fixed
-                                                 // microtubule
-                firstSiteOverlapMobile + positionsToConnect.at(connectedSoFar));
+                systemState.getPeriodicPosition(
+                        MicrotubuleType::FIXED,
+                        firstSiteOverlapFixed +
+                                positionsToConnect.at(connectedSoFar)),
+                systemState.getPeriodicPosition(
+                        MicrotubuleType::MOBILE,
+                        firstSiteOverlapMobile +
+                                positionsToConnect.at(connectedSoFar)));
     }
 
     for (int32_t i = 0; i < nDualCrosslinkersToConnect; ++connectedSoFar, ++i) {
         systemState.fullyConnectFreeCrosslinker(
                 Crosslinker::Type::DUAL,
                 terminusToConnectToFixedMicrotubule(generator),
-                firstSiteOverlapFixed +
-                        positionsToConnect.at(
-                                connectedSoFar), // The position on the fixed
-                                                 // microtubule
-                firstSiteOverlapMobile + positionsToConnect.at(connectedSoFar));
+                systemState.getPeriodicPosition(
+                        MicrotubuleType::FIXED,
+                        firstSiteOverlapFixed +
+                                positionsToConnect.at(connectedSoFar)),
+                systemState.getPeriodicPosition(
+                        MicrotubuleType::MOBILE,
+                        firstSiteOverlapMobile +
+                                positionsToConnect.at(connectedSoFar)));
     }
 
     for (int32_t i = 0; i < nActiveCrosslinkersToConnect;
@@ -261,11 +271,14 @@ void Initialiser::initialiseCrosslinkers(
         systemState.fullyConnectFreeCrosslinker(
                 Crosslinker::Type::ACTIVE,
                 terminusToConnectToFixedMicrotubule(generator),
-                firstSiteOverlapFixed +
-                        positionsToConnect.at(
-                                connectedSoFar), // The position on the fixed
-                                                 // microtubule
-                firstSiteOverlapMobile + positionsToConnect.at(connectedSoFar));
+                systemState.getPeriodicPosition(
+                        MicrotubuleType::FIXED,
+                        firstSiteOverlapFixed +
+                                positionsToConnect.at(connectedSoFar)),
+                systemState.getPeriodicPosition(
+                        MicrotubuleType::MOBILE,
+                        firstSiteOverlapMobile +
+                                positionsToConnect.at(connectedSoFar)));
     }
 
 #ifdef MYDEBUG
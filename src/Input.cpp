@@ -1,8 +1,10 @@
+#include <cerrno>
+#include <fcntl.h> // Only works on POSIX systems (probably not windows)
 #include <fstream>
 #include <iostream> // For user interaction
 #include <limits> // For std::numeric_limits<std::streamsize>::max()
 #include <string>
-#include <sys/stat.h> // Only works on POSIX systems (probably not windows)
+#include <unistd.h> // Only works on POSIX systems (probably not windows)
 
 #include "filament-sliding/CommandArgumentHandler.hpp"
 #include "filament-sliding/GenericValue.hpp" // Defines the overloaded operator >>
@@ -161,15 +163,22 @@ bool Input::askMakeDefault() {
     return answerBool;
 }
 
-bool Input::fileExists(const std::string& fileName) {
-    /* Taken from
-     * "https://stackoverflow.com/questions/4316442/stdofstream-check-if-file-exists-before-writing"
-     * Uses stat, which is defined on POSIX systems
-     */
-
-    struct stat buf; // Contains information about files (?)
-    return (stat(fileName.c_str(), &buf) !=
-            -1); // stat returns -1 if a file doesn't exist (0 if it does)
+bool Input::claimFile(const std::string& fileName) {
+    // Creating the file fails when it exists, in a single step, such that two
+    // runs that start at the same time, also on different nodes that share the
+    // file system, cannot both claim it. Uses open, which is defined on POSIX
+    // systems
+    const int fileDescriptor =
+            open(fileName.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fileDescriptor == -1) {
+        if (errno != EEXIST) {
+            throw InputException(
+                    "The file " + fileName + " could not be created.");
+        }
+        return false;
+    }
+    close(fileDescriptor);
+    return true;
 }
 
 void Input::setRunName() {
@@ -189,11 +198,27 @@ void Input::setRunName() {
     // log file with the name m_runName+".log.txt" Use the log file, and not the
     // copied parameter file, since the latter depends on m_fileName, which can
     // vary and which means that other files that do not depend on m_fileName
-    // (such as the log file) are overridden
-    while (fileExists(m_runName + ".log.txt")) {
+    // (such as the log file) are overridden. The log file is created here, and
+    // written by Log
+    while (!claimFile(m_runName + ".log.txt")) {
         ++label;
         m_runName = runName + "." + std::to_string(label);
     }
 }
 
 std::string Input::getRunName() { return m_runName; }
+
+void Input::writeParameters(const std::string& fileName) const {
+    std::ofstream file(fileName.c_str());
+    if (!file) {
+        throw InputException(
+                "The parameters could not be written to " + fileName + ".");
+    }
+    file << m_parameterMap;
+}
+
+std::string Input::getValuesAffectingState() const {
+    return m_parameterMap.getValuesAffectingState();
+}
+
+const ParameterMap& Input::getParameterMap() const { return m_parameterMap; }
@@ -0,0 +1,225 @@
+#include <algorithm> // std::sort
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio> // std::rename, std::remove
+#include <ctime> // std::difftime
+#include <dirent.h> // opendir, only works on POSIX systems
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <random> // std::random_device
+#include <string>
+#include <sys/stat.h> // mkdir, stat, only works on POSIX systems
+#include <thread>
+#include <unistd.h> // gethostname, getpid, only works on POSIX systems
+#include <utime.h> // utime, only works on POSIX systems
+#include <vector>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/JobQueue.hpp"
+#include "filament-sliding/ParameterMap.hpp"
+
+JobQueue::JobQueue(const std::string& directory, const double claimTimeout):
+        m_directory(directory),
+        m_claimTimeout(claimTimeout),
+        m_workerName(createWorkerName()),
+        m_isClaimed(false),
+        m_claimLost(false) {
+    if (m_claimTimeout <= 0.0) {
+        throw GeneralException(
+                "JobQueue was constructed with a claim timeout that is not "
+                "positive.");
+    }
+
+    // Other workers can create the same directories at the same time
+    for (const std::string& path:
+         {m_directory,
+          m_directory + "/pending",
+          m_directory + "/claimed",
+          m_directory + "/done",
+          m_directory + "/failed"}) {
+        if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+            throw GeneralException(
+                    "The directory " + path +
+                    " of the job queue could not be created.");
+        }
+    }
+}
+
+JobQueue::~JobQueue() {
+    releaseClaim();
+    std::remove((m_directory + "/.clock." + m_workerName).c_str());
+}
+
+std::string JobQueue::createWorkerName() {
+    char hostName[256] = {};
+    gethostname(hostName, sizeof(hostName) - 1);
+    return std::string(hostName) + '.' + std::to_string(getpid()) + '.' +
+           std::to_string(std::random_device {}());
+}
+
+std::string JobQueue::getPath(
+        const std::string& state,
+        const std::string& task) const {
+    return m_directory + '/' + state + '/' + task;
+}
+
+std::time_t JobQueue::getFileSystemTime() const {
+    const std::string path = m_directory + "/.clock." + m_workerName;
+    if (utime(path.c_str(), nullptr) != 0) {
+        std::ofstream file(path.c_str()); // Created with the current time
+    }
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0) {
+        throw GeneralException(
+                "The time of the file system of the job queue " + m_directory +
+                " could not be found.");
+    }
+    return status.st_mtime;
+}
+
+std::vector<std::string> JobQueue::listTasks(const std::string& state) const {
+    const std::string path = m_directory + '/' + state;
+    DIR* const p_directory = opendir(path.c_str());
+    if (p_directory == nullptr) {
+        throw GeneralException(
+                "The directory " + path +
+                " of the job queue could not be read.");
+    }
+
+    std::vector<std::string> tasks;
+    while (const dirent* const p_entry = readdir(p_directory)) {
+        const std::string name = p_entry->d_name;
+        if (name.front() != '.') {
+            tasks.push_back(name);
+        }
+    }
+    closedir(p_directory);
+
+    // All workers go through the tasks in the same order
+    std::sort(tasks.begin(), tasks.end());
+    return tasks;
+}
+
+void JobQueue::recoverStaleClaims() const {
+    const std::time_t now = getFileSystemTime();
+    for (const std::string& claim: listTasks("claimed")) {
+        const std::size_t separator = claim.rfind('@');
+        struct stat status;
+        if (separator != std::string::npos &&
+            stat(getPath("claimed", claim).c_str(), &status) == 0 &&
+            std::difftime(now, status.st_mtime) > m_claimTimeout) {
+            // When another worker recovers the claim first, this fails. When
+            // the worker that holds it refreshes it after the stat, it still
+            // loses the claim, which it finds at its next heartbeat
+            std::rename(
+                    getPath("claimed", claim).c_str(),
+                    getPath("pending", claim.substr(0, separator)).c_str());
+        }
+    }
+}
+
+void JobQueue::beatHeart() {
+    const std::chrono::duration<double> period(m_claimTimeout / 4.0);
+    const std::string claimPath =
+            getPath("claimed", m_claimedTask + '@' + m_workerName);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_claimReleased.wait_for(
+            lock, period, [this] { return !m_isClaimed; })) {
+        // The claim was recovered by another worker
+        if (utime(claimPath.c_str(), nullptr) != 0) {
+            m_claimLost = true;
+            return;
+        }
+    }
+}
+
+void JobQueue::releaseClaim() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isClaimed = false;
+    }
+    m_claimReleased.notify_all();
+    if (m_heartbeat.joinable()) {
+        m_heartbeat.join();
+    }
+}
+
+void JobQueue::addTask(
+        const std::string& task,
+        const ParameterMap& parameters) {
+    // Workers do not look at hidden files
+    const std::string temporaryPath = m_directory + "/." + task;
+    {
+        // The reals are written in full precision, such that the task runs
+        // with exactly the parameters that were queued
+        std::ofstream file(temporaryPath.c_str());
+        file.precision(std::numeric_limits<double>::max_digits10);
+        file << parameters;
+        if (!file) {
+            throw GeneralException(
+                    "The task " + task +
+                    " could not be written to the job queue.");
+        }
+    }
+    if (std::rename(
+                temporaryPath.c_str(), getPath("pending", task).c_str()) !=
+        0) {
+        throw GeneralException(
+                "The task " + task + " could not be added to the job queue.");
+    }
+}
+
+bool JobQueue::claimTask(std::string& fileName) {
+    if (m_isClaimed) {
+        throw GeneralException(
+                "JobQueue::claimTask() was called while a task was claimed.");
+    }
+
+    recoverStaleClaims();
+    for (const std::string& task: listTasks("pending")) {
+        // The modification time is refreshed before the rename, such that the
+        // fresh claim is never taken as stale. Of the workers that race for
+        // the same task, only one renames it
+        const std::string pendingPath = getPath("pending", task);
+        const std::string claimPath =
+                getPath("claimed", task + '@' + m_workerName);
+        if (utime(pendingPath.c_str(), nullptr) == 0 &&
+            std::rename(pendingPath.c_str(), claimPath.c_str()) == 0) {
+            m_claimedTask = task;
+            m_isClaimed = true;
+            m_claimLost = false;
+            m_heartbeat = std::thread(&JobQueue::beatHeart, this);
+            fileName = claimPath;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobQueue::waitForClaims() const {
+    if (listTasks("claimed").empty() && listTasks("pending").empty()) {
+        return false;
+    }
+    std::this_thread::sleep_for(
+            std::chrono::duration<double>(m_claimTimeout / 4.0));
+    return true;
+}
+
+bool JobQueue::finishTask(const bool succeeded) {
+    if (!m_isClaimed) {
+        throw GeneralException(
+                "JobQueue::finishTask() was called without a claimed task.");
+    }
+    releaseClaim();
+
+    // When the claim was taken as stale, its file is gone, and the worker that
+    // repeats the task moves its own claim
+    return !m_claimLost &&
+           std::rename(
+                   getPath("claimed", m_claimedTask + '@' + m_workerName)
+                           .c_str(),
+                   getPath(succeeded ? "done" : "failed", m_claimedTask)
+                           .c_str()) == 0;
+}
@@ -0,0 +1,378 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility> // pair
+#include <vector>
+
+#include "filament-sliding/LockstepReplicas.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/Propagator.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/SystemState.hpp"
+
+LockstepReplicas::LockstepReplicas(
+        const std::vector<Replica>& replicas,
+        const int32_t numberEquilibrationBlocks,
+        const int32_t numberRunBlocks,
+        const int32_t nTimeSteps,
+        const double calcTimeStep,
+        const int32_t positionProbePeriod,
+        const double diffusionConstantMicrotubule,
+        const double springConstant,
+        const double latticeSpacing,
+        Log& log):
+        m_replicas(replicas),
+        m_nEquilibrationBlocks(numberEquilibrationBlocks),
+        m_nRunBlocks(numberRunBlocks),
+        m_nTimeSteps(nTimeSteps),
+        m_calcTimeStep(calcTimeStep),
+        m_positionProbePeriod(positionProbePeriod),
+        m_diffusionConstantMicrotubule(diffusionConstantMicrotubule),
+        m_springConstant(springConstant),
+        m_latticeSpacing(latticeSpacing),
+        m_deviationMicrotubule(
+                std::sqrt(2 * m_diffusionConstantMicrotubule * m_calcTimeStep)),
+        m_hopRateExponent(-0.5 * m_springConstant * m_latticeSpacing),
+        m_currentTime(-m_nEquilibrationBlocks * m_nTimeSteps * m_calcTimeStep),
+        m_nDeterministicBoundaryCrossings(0),
+        m_nStochasticBoundaryCrossings(0),
+        m_log(log),
+        m_hasSpareGaussianChanges(false) {
+    const std::size_t nLanes = m_replicas.size();
+    for (std::vector<double>* const p_laneValues:
+         {&m_position,
+          &m_synchronisedPosition,
+          &m_rateIncreasingExtension,
+          &m_rateDecreasingExtension,
+          &m_rateOtherReactions,
+          &m_action,
+          &m_reactionRateThreshold,
+          &m_totalExtension,
+          &m_nFullLinkers,
+          &m_extensionFactor,
+          &m_forceChange,
+          &m_lowerMovementBorder,
+          &m_upperMovementBorder,
+          &m_lowerPossibilityBorder,
+          &m_upperPossibilityBorder,
+          &m_lowerBarrier,
+          &m_upperBarrier,
+          &m_uniform,
+          &m_gaussianChange,
+          &m_spareGaussianChange}) {
+        p_laneValues->resize(nLanes, 0.0);
+    }
+    m_attractorPosition.resize(nLanes, 0);
+    m_isFlagged.resize(nLanes, 0);
+
+    for (std::size_t lane = 0; lane < nLanes; ++lane) {
+        Replica& replica = m_replicas[lane];
+        replica.systemState.updateForceAndEnergy();
+        m_position[lane] = replica.systemState.getMicrotubulePosition();
+        m_reactionRateThreshold[lane] =
+                -std::log(replica.generator.getProbability()) / m_calcTimeStep;
+        setAttractorPosition(
+                lane,
+                static_cast<int32_t>(
+                        std::round(m_position[lane] / m_latticeSpacing)));
+        readLaneFromSystem(lane);
+    }
+}
+
+LockstepReplicas::~LockstepReplicas() {
+    m_log.writeBoundaryProtocolAppearance(
+            m_nDeterministicBoundaryCrossings, m_nStochasticBoundaryCrossings);
+}
+
+void LockstepReplicas::moveSystemToLane(const std::size_t lane) {
+    SystemState& systemState = m_replicas[lane].systemState;
+    const double change =
+            m_position[lane] - systemState.getMicrotubulePosition();
+    if (change != 0.0) {
+        // Beyond the possibility borders, the SystemState finds its possible
+        // reactions anew
+        systemState.updateMobilePosition(change);
+        systemState.updateForceAndEnergy();
+    }
+    m_position[lane] = systemState.getMicrotubulePosition();
+}
+
+void LockstepReplicas::readLaneFromSystem(const std::size_t lane) {
+    Replica& replica = m_replicas[lane];
+    const SystemState& systemState = replica.systemState;
+
+    const Propagator::LockstepRates rates =
+            replica.propagator.findLockstepRates(systemState);
+    m_rateIncreasingExtension[lane] = rates.fullHopsIncreasingExtension;
+    m_rateDecreasingExtension[lane] = rates.fullHopsDecreasingExtension;
+    m_rateOtherReactions[lane] = rates.otherReactions;
+
+    m_synchronisedPosition[lane] = systemState.getMicrotubulePosition();
+    m_totalExtension[lane] = systemState.getTotalExtensionLinkers();
+    const int32_t nFullLinkers = systemState.getNFullCrosslinkers();
+    m_nFullLinkers[lane] = nFullLinkers;
+
+    // The external force is constant, see Simulation::supportsLockstepReplicas
+    const double externalForce = systemState.getExternalForce();
+    if (nFullLinkers != 0) {
+        m_extensionFactor[lane] =
+                std::expm1(
+                        -nFullLinkers * m_springConstant *
+                        m_diffusionConstantMicrotubule * m_calcTimeStep) /
+                nFullLinkers;
+        m_forceChange[lane] =
+                -externalForce / m_springConstant * m_extensionFactor[lane];
+    }
+    else {
+        m_extensionFactor[lane] = 0.0;
+        m_forceChange[lane] =
+                externalForce * m_diffusionConstantMicrotubule * m_calcTimeStep;
+    }
+
+    const std::pair<double, double> movementBorders =
+            systemState.movementBordersSetByFullLinkers();
+    m_lowerMovementBorder[lane] =
+            m_synchronisedPosition[lane] + movementBorders.first;
+    m_upperMovementBorder[lane] =
+            m_synchronisedPosition[lane] + movementBorders.second;
+
+    const std::pair<double, double> possibilityBorders =
+            systemState.getPossibilityBorders();
+    m_lowerPossibilityBorder[lane] = possibilityBorders.first;
+    m_upperPossibilityBorder[lane] = possibilityBorders.second;
+}
+
+void LockstepReplicas::synchroniseLane(const std::size_t lane) {
+    moveSystemToLane(lane);
+    readLaneFromSystem(lane);
+}
+
+void LockstepReplicas::setAttractorPosition(
+        const std::size_t lane,
+        const int32_t attractorPosition) {
+    m_attractorPosition[lane] = attractorPosition;
+    m_lowerBarrier[lane] = (attractorPosition - 1) * m_latticeSpacing;
+    m_upperBarrier[lane] = (attractorPosition + 1) * m_latticeSpacing;
+}
+
+void LockstepReplicas::performReaction(const std::size_t lane) {
+    Replica& replica = m_replicas[lane];
+    moveSystemToLane(lane);
+    replica.propagator.performLockstepReaction(
+            replica.systemState, replica.generator);
+
+    m_action[lane] = 0.0;
+    m_reactionRateThreshold[lane] =
+            -std::log(replica.generator.getProbability()) / m_calcTimeStep;
+    readLaneFromSystem(lane);
+}
+
+void LockstepReplicas::moveWithinBorders(const std::size_t lane) {
+    // The borders are taken from the linkers themselves, such that they are
+    // exact
+    moveSystemToLane(lane);
+    const SystemState& systemState = m_replicas[lane].systemState;
+    std::pair<double, double> exclusiveMovementBorders =
+            systemState.movementBordersSetByFullLinkers();
+
+    double deterministicChange =
+            m_extensionFactor[lane] * systemState.getTotalExtensionLinkers() +
+            m_forceChange[lane];
+    if (deterministicChange <= exclusiveMovementBorders.first) {
+        deterministicChange = std::nextafter(
+                exclusiveMovementBorders.first,
+                exclusiveMovementBorders.second);
+        ++m_nDeterministicBoundaryCrossings;
+    }
+    else if (deterministicChange >= exclusiveMovementBorders.second) {
+        deterministicChange = std::nextafter(
+                exclusiveMovementBorders.second,
+                exclusiveMovementBorders.first);
+        ++m_nDeterministicBoundaryCrossings;
+    }
+    exclusiveMovementBorders.first -= deterministicChange;
+    exclusiveMovementBorders.second -= deterministicChange;
+
+    double randomChange = m_gaussianChange[lane];
+    while (randomChange <= exclusiveMovementBorders.first ||
+           randomChange >= exclusiveMovementBorders.second) {
+        if (randomChange <= exclusiveMovementBorders.first) {
+            randomChange = 2 * exclusiveMovementBorders.first - randomChange;
+        }
+        if (randomChange >= exclusiveMovementBorders.second) {
+            randomChange = 2 * exclusiveMovementBorders.second - randomChange;
+        }
+        ++m_nStochasticBoundaryCrossings;
+    }
+
+    m_position[lane] += deterministicChange + randomChange;
+}
+
+void LockstepReplicas::drawGaussianChanges() {
+    if (m_hasSpareGaussianChanges) {
+        m_gaussianChange.swap(m_spareGaussianChange);
+        m_hasSpareGaussianChanges = false;
+        return;
+    }
+
+    // Every lane draws from its own generator, after which the transform is
+    // done for all lanes at once
+    const std::size_t nLanes = m_replicas.size();
+    for (std::size_t lane = 0; lane < nLanes; ++lane) {
+        m_uniform[lane] = m_replicas[lane].generator.getProbability();
+        m_spareGaussianChange[lane] =
+                m_replicas[lane].generator.getProbability();
+    }
+    for (std::size_t lane = 0; lane < nLanes; ++lane) {
+        const double radius = m_deviationMicrotubule *
+                              std::sqrt(-2.0 * std::log(m_uniform[lane]));
+        const double angle = 2.0 * m_pi * m_spareGaussianChange[lane];
+        m_gaussianChange[lane] = radius * std::cos(angle);
+        m_spareGaussianChange[lane] = radius * std::sin(angle);
+    }
+    m_hasSpareGaussianChanges = true;
+}
+
+void LockstepReplicas::advanceTimeStep(const bool writeOutput) {
+    const std::size_t nLanes = m_replicas.size();
+
+    // Like Propagator::performReactionWhenDue, with the rates at the current
+    // positions
+    for (std::size_t lane = 0; lane < nLanes; ++lane) {
+        const double hopRateFactor = std::exp(
+                m_hopRateExponent *
+                (m_position[lane] - m_synchronisedPosition[lane]));
+        m_action[lane] += m_rateIncreasingExtension[lane] * hopRateFactor +
+                          m_rateDecreasingExtension[lane] / hopRateFactor +
+                          m_rateOtherReactions[lane];
+    }
+    for (std::size_t lane = 0; lane < nLanes; ++lane) {
+        if (m_action[lane] > m_reactionRateThreshold[lane]) {
+            performReaction(lane);
+        }
+    }
+
+    // Like Propagator::moveMicrotubule, for the lanes that stay within the
+    // borders of the linkers. The other lanes are flagged, as are the lanes
+    // that cross a barrier or leave the borders of their possible hops
+    drawGaussianChanges();
+    // The arrays are reached through pointers, which the stores cannot change,
+    // and every loop makes a single choice per lane without branches, such
+    // that the loops vectorise
+    double* const p_position = m_position.data();
+    int32_t* const p_isFlagged = m_isFlagged.data();
+    const double* const p_synchronisedPosition = m_synchronisedPosition.data();
+    const double* const p_totalExtension = m_totalExtension.data();
+    const double* const p_nFullLinkers = m_nFullLinkers.data();
+    const double* const p_extensionFactor = m_extensionFactor.data();
+    const double* const p_forceChange = m_forceChange.data();
+    const double* const p_gaussianChange = m_gaussianChange.data();
+    const double* const p_lowerMovementBorder = m_lowerMovementBorder.data();
+    const double* const p_upperMovementBorder = m_upperMovementBorder.data();
+    for (std::size_t lane = 0; lane < nLanes; ++lane) {
+        const double position = p_position[lane];
+        const double totalExtension =
+                p_totalExtension[lane] +
+                p_nFullLinkers[lane] *
+                        (position - p_synchronisedPosition[lane]);
+        const double deterministicPosition =
+                position + p_extensionFactor[lane] * totalExtension +
+                p_forceChange[lane];
+        const double newPosition =
+                deterministicPosition + p_gaussianChange[lane];
+
+        const bool isWithinMovementBorders =
+                (deterministicPosition > p_lowerMovementBorder[lane]) &
+                (deterministicPosition < p_upperMovementBorder[lane]) &
+                (newPosition > p_lowerMovementBorder[lane]) &
+                (newPosition < p_upperMovementBorder[lane]);
+        p_position[lane] = isWithinMovementBorders ? newPosition : position;
+        p_isFlagged[lane] =
+                isWithinMovementBorders ? 0 : s_beyondMovementBorders;
+    }
+
+    const double* const p_lowerPossibilityBorder =
+            m_lowerPossibilityBorder.data();
+    const double* const p_upperPossibilityBorder =
+            m_upperPossibilityBorder.data();
+    const double* const p_lowerBarrier = m_lowerBarrier.data();
+    const double* const p_upperBarrier = m_upperBarrier.data();
+    for (std::size_t lane = 0; lane < nLanes; ++lane) {
+        const double position = p_position[lane];
+        const bool isUnremarkable =
+                (position > p_lowerPossibilityBorder[lane]) &
+                (position < p_upperPossibilityBorder[lane]) &
+                (position >= p_lowerBarrier[lane]) &
+                (position <= p_upperBarrier[lane]);
+        p_isFlagged[lane] = isUnremarkable ? p_isFlagged[lane]
+                                           : (p_isFlagged[lane] |
+                                              s_needsAttention);
+    }
+    m_currentTime += m_calcTimeStep;
+
+    for (std::size_t lane = 0; lane < nLanes; ++lane) {
+        if (m_isFlagged[lane] == 0) {
+            continue;
+        }
+        if ((m_isFlagged[lane] & s_beyondMovementBorders) != 0) {
+            moveWithinBorders(lane);
+        }
+
+        // See MobileMicrotubule::barrierCrossed
+        int32_t barrierCrossingDirection = 0;
+        if (m_position[lane] > m_upperBarrier[lane]) {
+            barrierCrossingDirection = +1;
+        }
+        else if (m_position[lane] < m_lowerBarrier[lane]) {
+            barrierCrossingDirection = -1;
+        }
+        if (barrierCrossingDirection != 0) {
+            setAttractorPosition(
+                    lane, m_attractorPosition[lane] + barrierCrossingDirection);
+            if (writeOutput) {
+                m_replicas[lane].output.writeBarrierCrossingTime(
+                        m_currentTime, barrierCrossingDirection);
+            }
+        }
+
+        if (m_position[lane] <= m_lowerPossibilityBorder[lane] ||
+            m_position[lane] >= m_upperPossibilityBorder[lane]) {
+            synchroniseLane(lane);
+        }
+    }
+}
+
+void LockstepReplicas::propagateBlock(const bool writeOutput) {
+    // A probe is taken at time step 0 of each block
+    int32_t timeStepsToNextPositionProbe = 0;
+    for (int32_t timeStep = 0; timeStep < m_nTimeSteps; ++timeStep) {
+        if (writeOutput) {
+            if (timeStepsToNextPositionProbe == 0) {
+                for (std::size_t lane = 0; lane < m_replicas.size(); ++lane) {
+                    moveSystemToLane(lane);
+                    m_replicas[lane].output.writeMicrotubulePosition(
+                            m_currentTime, m_replicas[lane].systemState);
+                }
+                timeStepsToNextPositionProbe = m_positionProbePeriod;
+            }
+            --timeStepsToNextPositionProbe;
+        }
+        advanceTimeStep(writeOutput);
+    }
+}
+
+void LockstepReplicas::equilibrate() {
+    for (int32_t block = 0; block < m_nEquilibrationBlocks; ++block) {
+        propagateBlock(false);
+    }
+}
+
+void LockstepReplicas::run() {
+    for (int32_t block = 0; block < m_nRunBlocks; ++block) {
+        for (Replica& replica: m_replicas) {
+            replica.output.newBlock(block + 1);
+        }
+        propagateBlock(true);
+    }
+}
@@ -1,12 +1,20 @@
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <vector>
 
+#include "filament-sliding/EquilibrationMonitor.hpp"
 #include "filament-sliding/Log.hpp"
+#include "filament-sliding/Statistics.hpp"
 #include "filament-sliding/version.hpp"
 
 Log::Log(const std::string& runName, const Clock& clock):
-        m_clock(clock), m_logFile((runName + ".log.txt").c_str()) {
+        m_clock(clock),
+        m_logFile((runName + ".log.txt").c_str()),
+        mp_coutBuffer(std::cout.rdbuf()),
+        mp_cerrBuffer(std::cerr.rdbuf()) {
     m_logFile
             << "The git hash of the commit that was used to create the current "
                "program is:\n"
@@ -20,11 +28,14 @@ Log::Log(const std::string& runName, const Clock& clock):
 
 Log::~Log() {
     m_logFile << "\nExecution time: " << m_clock.now() << " seconds\n";
+    std::cout.rdbuf(mp_coutBuffer);
+    std::cerr.rdbuf(mp_cerrBuffer);
 }
 
 void Log::writeBoundaryProtocolAppearance(
         const int32_t numberDeterministic,
         const int32_t numberStochastic) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
     m_logFile << "\nThe deterministic boundary protocol was invoked "
               << numberDeterministic
               << ((numberDeterministic == 1) ? (" time.\n") : (" times.\n"));
@@ -32,3 +43,198 @@ void Log::writeBoundaryProtocolAppearance(
               << numberStochastic
               << ((numberStochastic == 1) ? (" time.\n") : (" times.\n"));
 }
+
+void Log::writeConcurrentRateEvaluation(
+        const int32_t nThreads,
+        const int64_t nRateEvaluations,
+        const int64_t nConcurrentRateEvaluations,
+        const int64_t nTimedSerialRateEvaluations,
+        const double speedUp) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_logFile << "\n" << nConcurrentRateEvaluations << " out of "
+              << nRateEvaluations
+              << " evaluations of the individual reaction rates were split "
+                 "over "
+              << nThreads
+              << " threads. The sums of the rates and the reactions were "
+                 "handled on one thread.\n";
+    if (speedUp <= 0.0) {
+        m_logFile << "Too few evaluations were timed on one thread to measure "
+                     "the speed-up.\n";
+        return;
+    }
+    m_logFile << "Per possibility, the split evaluations were " << speedUp
+              << " times as fast as the " << nTimedSerialRateEvaluations
+              << " evaluations timed on one thread.\n";
+}
+
+void Log::writeSublatticeDomains(
+        const int32_t nDomains,
+        const int32_t nThreads,
+        const int64_t nPhases,
+        const int64_t nReactions,
+        const int32_t maxNReactionsInPhase,
+        const int64_t nTimedSerialPhases,
+        const double speedUp) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_logFile << "\nThe lattice was split into " << nDomains
+              << " sublattice domains. In " << nPhases
+              << " phases of one colour, the domains made " << nReactions
+              << " reactions, at most " << maxNReactionsInPhase
+              << " in one phase.\n";
+    if (nThreads == 1) {
+        return;
+    }
+    if (speedUp <= 0.0) {
+        m_logFile << "Too few phases were timed on one thread to measure the "
+                     "speed-up of the domains.\n";
+        return;
+    }
+    m_logFile << "On " << nThreads
+              << " threads, the domains chose their reactions " << speedUp
+              << " times as fast as in the " << nTimedSerialPhases
+              << " phases timed on one thread.\n";
+}
+
+void Log::writeStoragePrecisionValidation(
+        const bool singlePrecision,
+        const Statistics& forceError) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_logFile << "\nThe linker extensions were stored in "
+              << (singlePrecision ? "single" : "double") << " precision.\n";
+    if (!forceError.canReportStatistics()) {
+        m_logFile << "Too few position probes were taken to compare the force "
+                     "to its double precision value.\n";
+        return;
+    }
+    m_logFile << "Compared to double precision, the force of the linkers "
+                 "differed by\n"
+              << "mean: " << forceError.getMean()
+              << " kT/micron, variance: " << forceError.getVariance()
+              << " (kT/micron)^2, SEM: " << forceError.getSEM()
+              << " kT/micron, over " << forceError.getNumberOfSamples()
+              << " position probes.\n";
+}
+
+void Log::writeJournalValidation(
+        const int32_t nChanges,
+        const bool sameConfiguration,
+        const double forceDifference) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_logFile << "\nThe journal recorded " << nChanges
+              << " changes while a copy of the equilibrated system was "
+                 "propagated for a block. Rolled back, the copy "
+              << (sameConfiguration ? "had" : "did NOT have")
+              << " the configuration it was copied from, and its force "
+                 "differed by "
+              << forceDifference << " kT/micron.\n";
+}
+
+void Log::writeRequestedCheckpoint(
+        const std::string& fileName,
+        const double time,
+        const bool stopped) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_logFile << "\nA checkpoint was requested at time " << time
+              << " s, and written to " << fileName << ".\n";
+    if (stopped) {
+        m_logFile << "The run was stopped after the checkpoint, so the "
+                     "statistics only cover the time until then.\n";
+    }
+}
+
+void Log::writeResumedFromCheckpoint(
+        const std::string& fileName,
+        const double time) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_logFile << "The run was resumed from the checkpoint " << fileName
+              << " at time " << time << " s.\n\n";
+}
+
+void Log::writeEquilibrationCache(
+        const std::string& fileName,
+        const bool taken) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (taken) {
+        m_logFile << "The equilibration was skipped: the run started from the "
+                     "equilibrated state "
+                  << fileName << ".\n\n";
+    }
+    else {
+        m_logFile << "The equilibrated state was stored as " << fileName
+                  << ".\n";
+    }
+}
+
+void Log::writeEquilibrationDetection(
+        const bool stationary,
+        const int32_t nBlocks,
+        const int32_t maxNBlocks,
+        const double duration,
+        const EquilibrationMonitor& monitor) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (stationary) {
+        m_logFile << "The equilibration was stationary after " << nBlocks
+                  << " out of at most " << maxNBlocks << " blocks ("
+                  << duration << " s).\n";
+    }
+    else {
+        m_logFile << "The equilibration was not found to be stationary within "
+                     "the maximum of "
+                  << maxNBlocks << " blocks (" << duration << " s).\n";
+    }
+
+    const std::vector<double>& zScores = monitor.getZScores();
+    if (zScores.empty()) {
+        m_logFile << "Too few samples were taken ("
+                  << monitor.getNumberOfSamples()
+                  << ") to test for stationarity.\n\n";
+        return;
+    }
+    m_logFile << "The means at the start and at the end of the second half of "
+                 "the "
+              << monitor.getNumberOfSamples()
+              << " samples differed by the following numbers of standard "
+                 "errors:\n";
+    const std::vector<std::string> names =
+            EquilibrationMonitor::getObservableNames();
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        m_logFile << names[i] << ": " << zScores[i] << '\n';
+    }
+    m_logFile << '\n';
+}
+
+void Log::writePrecisionTarget(
+        const bool reached,
+        const int32_t nBlocks,
+        const int32_t maxNBlocks,
+        const double time,
+        const double relativeSEM,
+        const double target) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (reached) {
+        m_logFile << "The precision target was reached after " << nBlocks
+                  << " out of at most " << maxNBlocks << " run blocks, at time "
+                  << time << " s.\n";
+    }
+    else {
+        m_logFile << "The precision target was not reached within the "
+                     "maximum of "
+                  << maxNBlocks << " run blocks.\n";
+    }
+    m_logFile << "The relative standard error was " << relativeSEM
+              << ", for a target of " << target << ".\n";
+}
+
+void Log::writeSweepPoint(const std::string& runName, const int32_t nReplicas) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_logFile << "The output of sweep point " << runName << " was written "
+              << "after its " << nReplicas << " replicas finished, at "
+              << m_clock.now() << " seconds.\n";
+}
+
+void Log::writeLostClaim(const std::string& taskFileName) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_logFile << "The claim of task " << taskFileName << " was lost before it "
+              << "finished, at " << m_clock.now() << " seconds.\n";
+}
@@ -1,3 +1,4 @@
+#include <array>
 #include <cmath>
 #include <cstdint>
 
@@ -25,3 +26,52 @@ int32_t MathematicalFunctions::alternativeIntCeil(const double arg) {
 int32_t MathematicalFunctions::alternativeIntFloor(const double arg) {
     return intCeil(arg) - 1;
 }
+
+double MathematicalFunctions::digamma(const double x) {
+    // Below this argument, the asymptotic series is not accurate enough
+    constexpr double minimumAsymptoticArgument = 10.0;
+
+    double argument = x;
+    double result = 0.0;
+    while (argument < minimumAsymptoticArgument) {
+        result -= 1.0 / argument;
+        argument += 1.0;
+    }
+
+    // psi(x) ~ ln(x) - 1/(2x) - sum_k B_2k / (2k x^2k), with B_2k the Bernoulli
+    // numbers. Up to x^-14, the truncation error is below 1e-16 for x >= 10.
+    // The series is evaluated with Horner's method in 1/x^2.
+    constexpr std::array<double, 7> seriesCoefficients{
+            -1.0 / 12.0,
+            1.0 / 120.0,
+            -1.0 / 252.0,
+            1.0 / 240.0,
+            -1.0 / 132.0,
+            691.0 / 32760.0,
+            -1.0 / 12.0};
+    const double inverseSquare = 1.0 / (argument * argument);
+    double series = 0.0;
+    for (auto it = seriesCoefficients.rbegin(); it != seriesCoefficients.rend();
+         ++it) {
+        series = (series + *it) * inverseSquare;
+    }
+
+    return result + std::log(argument) - 0.5 / argument + series;
+}
+
+double MathematicalFunctions::digammaDifference(
+        const double x,
+        const int32_t n) {
+    // For longer sums, two digamma evaluations are cheaper
+    constexpr int32_t maxTermsToSum = 32;
+
+    if (n > maxTermsToSum) {
+        return digamma(x + n) - digamma(x);
+    }
+
+    double difference = 0.0;
+    for (int32_t k = 0; k < n; ++k) {
+        difference += 1.0 / (x + k);
+    }
+    return difference;
+}
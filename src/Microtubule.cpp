@@ -1,40 +1,62 @@
 #include <algorithm> // max/min
 #include <cmath> // ceil/floor
 #include <cstdint>
+#include <istream>
 #include <numeric>
+#include <ostream>
 #include <stdexcept>
 #include <utility> // pair
 #include <vector>
 
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
+#include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/Microtubule.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
 #include "filament-sliding/PossibleFullConnection.hpp"
 #include "filament-sliding/PossibleHop.hpp"
 #include "filament-sliding/Site.hpp"
+#include "filament-sliding/StoragePrecision.hpp"
 
 Microtubule::Microtubule(
         const MicrotubuleType type,
         const double length,
-        const double latticeSpacing):
+        const double latticeSpacing,
+        const bool periodic,
+        const int32_t nSitesWindow):
         m_latticeSpacing(latticeSpacing),
         m_type(type),
+        m_periodic(periodic),
         m_nSites(
                 static_cast<int32_t>(std::floor(length / m_latticeSpacing)) +
-                1), // Choose such that microtubule always starts and ends with
-                    // a site
+                (m_periodic ? 0 : 1)), // Choose such that microtubule always
+                                       // starts and ends with a site. When it
+                                       // is periodic, the end is the start
         m_length(
                 m_latticeSpacing *
-                (m_nSites -
-                 1)), // Can be different than length: is rounded down
-                      // to the closest multiple of lattice spacings
-        m_nFreeSites(m_nSites),
-        m_sites(m_nSites,
+                (m_periodic ? m_nSites :
+                              (m_nSites - 1))), // Can be different than
+                                                // length: is rounded down to
+                                                // the closest multiple of
+                                                // lattice spacings
+        m_nStoredSites(
+                (nSitesWindow > 0) ? std::min(nSitesWindow, m_nSites) :
+                                     m_nSites),
+        m_firstStoredSite(0),
+        m_nFreeSites(m_nStoredSites),
+        m_sites(m_nStoredSites,
                 Site(true)), // Create a copy of Site which is free
                              // (isFree=true), and copy it into the vector
-        m_freeSitePositions(m_nSites) // Set the number of sites, but fill it in
-                                      // the body of the constructor
+        m_freeSitePositions(
+                m_nStoredSites) // Set the number of sites, but fill it in the
+                                // body of the constructor
 {
+    if (m_periodic && hasWindow()) {
+        throw GeneralException(
+                "A periodic microtubule cannot have a window of stored sites");
+    }
+
     std::iota(
             m_freeSitePositions.begin(),
             m_freeSitePositions.end(),
@@ -50,7 +72,7 @@ void Microtubule::connectSite(
 #ifdef MYDEBUG
     try {
 #endif // MYDEBUG
-        m_sites.at(sitePosition)
+        getSite(sitePosition)
                 .connectCrosslinker(crosslinkerToConnect, terminusToConnect);
 
         m_freeSitePositions.erase(
@@ -73,7 +95,7 @@ void Microtubule::disconnectSite(const int32_t sitePosition) {
 #ifdef MYDEBUG
     try {
 #endif // MYDEBUG
-        m_sites.at(sitePosition).disconnectCrosslinker();
+        getSite(sitePosition).disconnectCrosslinker();
 
         m_freeSitePositions.push_back(sitePosition);
         ++m_nFreeSites;
@@ -86,6 +108,89 @@ void Microtubule::disconnectSite(const int32_t sitePosition) {
 #endif // MYDEBUG
 }
 
+Crosslinker*
+Microtubule::whichCrosslinkerIsBoundTo(const int32_t sitePosition) const {
+    return getSite(sitePosition).whichCrosslinkerIsBound();
+}
+
+void Microtubule::copyStateFrom(
+        const Microtubule& other,
+        const CrosslinkerRelocation& relocation) {
+    if (other.m_nSites != m_nSites || other.m_nStoredSites != m_nStoredSites) {
+        throw GeneralException(
+                "Microtubule::copyStateFrom() was called with a microtubule "
+                "of another size");
+    }
+
+    m_firstStoredSite = other.m_firstStoredSite;
+    m_nFreeSites = other.m_nFreeSites;
+    m_sites = other.m_sites;
+    for (Site& site: m_sites) {
+        site.relocateCrosslinker(relocation);
+    }
+    m_freeSitePositions = other.m_freeSitePositions;
+}
+
+bool Microtubule::hasSameOccupationAs(const Microtubule& other) const {
+    if (other.m_nSites != m_nSites || other.m_nStoredSites != m_nStoredSites ||
+        other.m_firstStoredSite != m_firstStoredSite ||
+        other.m_nFreeSites != m_nFreeSites) {
+        return false;
+    }
+    for (std::size_t i = 0; i < m_sites.size(); ++i) {
+        const Crosslinker* const p_linker =
+                m_sites[i].whichCrosslinkerIsBound();
+        const Crosslinker* const p_otherLinker =
+                other.m_sites[i].whichCrosslinkerIsBound();
+        if (p_linker == nullptr || p_otherLinker == nullptr) {
+            if (p_linker != p_otherLinker) {
+                return false;
+            }
+        }
+        else if (!p_linker->isConnectedLike(*p_otherLinker)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Microtubule::writeCheckpoint(
+        std::ostream& out,
+        const CrosslinkerRelocation& relocation) const {
+    Checkpoint::write(out, static_cast<int64_t>(m_nSites));
+    Checkpoint::write(out, static_cast<int64_t>(m_nStoredSites));
+    Checkpoint::write(out, m_firstStoredSite);
+    Checkpoint::write(out, m_nFreeSites);
+    for (const Site& site: m_sites) {
+        site.writeCheckpoint(out, relocation);
+    }
+    Checkpoint::writeVector(
+            out,
+            std::vector<int32_t>(
+                    m_freeSitePositions.begin(), m_freeSitePositions.end()));
+}
+
+void Microtubule::readCheckpoint(
+        std::istream& in,
+        const CrosslinkerRelocation& relocation) {
+    int64_t nSites, nStoredSites;
+    Checkpoint::read(in, nSites);
+    Checkpoint::checkSize(nSites, m_nSites, "number of sites of a microtubule");
+    Checkpoint::read(in, nStoredSites);
+    Checkpoint::checkSize(
+            nStoredSites, m_nStoredSites, "number of stored sites");
+
+    Checkpoint::read(in, m_firstStoredSite);
+    Checkpoint::read(in, m_nFreeSites);
+    for (Site& site: m_sites) {
+        site.readCheckpoint(in, relocation);
+    }
+    std::vector<int32_t> freeSitePositions;
+    Checkpoint::readVector(in, freeSitePositions);
+    m_freeSitePositions.assign(
+            freeSitePositions.begin(), freeSitePositions.end());
+}
+
 double Microtubule::getLength() const { return m_length; }
 
 int32_t Microtubule::getNSites() const { return m_nSites; }
@@ -94,6 +199,128 @@ double Microtubule::getLatticeSpacing() const { return m_latticeSpacing; }
 
 int32_t Microtubule::getNFreeSites() const { return m_nFreeSites; }
 
+bool Microtubule::isPeriodic() const { return m_periodic; }
+
+bool Microtubule::hasWindow() const { return m_nStoredSites != m_nSites; }
+
+int32_t Microtubule::getFirstStoredSite() const { return m_firstStoredSite; }
+
+int32_t Microtubule::getLastStoredSite() const {
+    return m_firstStoredSite + m_nStoredSites - 1;
+}
+
+void Microtubule::moveWindow(const int32_t firstSite) {
+    if (firstSite < 0 || firstSite > m_nSites - m_nStoredSites) {
+        throw GeneralException(
+                "Microtubule::moveWindow() was asked to move the window off "
+                "the microtubule");
+    }
+
+    const int32_t oldFirstSite = m_firstStoredSite;
+    const int32_t oldLastSite = getLastStoredSite();
+    const int32_t newLastSite = firstSite + m_nStoredSites - 1;
+
+    // The sites that leave the window share their storage with the sites that
+    // enter it, and are free, so only the free site positions change
+    for (int32_t position = oldFirstSite; position <= oldLastSite; ++position) {
+        if ((position < firstSite || position > newLastSite) &&
+            !getSite(position).isFree()) {
+            throw GeneralException(
+                    "Microtubule::moveWindow() encountered an occupied site "
+                    "leaving the window");
+        }
+    }
+    m_firstStoredSite = firstSite;
+
+    m_freeSitePositions.erase(
+            std::remove_if(
+                    m_freeSitePositions.begin(),
+                    m_freeSitePositions.end(),
+                    [this](const int32_t position) {
+                        return position < m_firstStoredSite ||
+                               position > getLastStoredSite();
+                    }),
+            m_freeSitePositions.end());
+    for (int32_t position = m_firstStoredSite; position <= getLastStoredSite();
+         ++position) {
+        if (position < oldFirstSite || position > oldLastSite) {
+            m_freeSitePositions.push_back(position);
+        }
+    }
+}
+
+Site& Microtubule::getSite(const int32_t position) {
+    return m_sites.at(getStorageIndex(position));
+}
+
+const Site& Microtubule::getSite(const int32_t position) const {
+    return m_sites.at(getStorageIndex(position));
+}
+
+int32_t Microtubule::getPeriodicPosition(const int32_t position) const {
+    if (!m_periodic) {
+        return position;
+    }
+    const int32_t remainder = position % m_nSites;
+    return (remainder < 0) ? (remainder + m_nSites) : remainder;
+}
+
+double Microtubule::getMinimumImage(const double displacement) const {
+    if (!m_periodic) {
+        return displacement;
+    }
+    return displacement - m_length * std::round(displacement / m_length);
+}
+
+int32_t Microtubule::getStorageIndex(const int32_t position) const {
+    if (m_periodic) {
+        return getPeriodicPosition(position);
+    }
+    if (!hasWindow()) {
+        return position;
+    }
+#ifdef MYDEBUG
+    if (position < m_firstStoredSite || position > getLastStoredSite()) {
+        throw GeneralException(
+                "Microtubule::getStorageIndex() was asked for a site outside "
+                "of the window");
+    }
+#endif // MYDEBUG
+    const int32_t remainder = position % m_nStoredSites;
+    return (remainder < 0) ? (remainder + m_nStoredSites) : remainder;
+}
+
+bool Microtubule::isOutOfReach(
+        const double position,
+        const double maxStretch) const {
+    // A periodic microtubule is everywhere
+    if (m_periodic) {
+        return false;
+    }
+    if (hasWindow()) {
+        return position <= m_firstStoredSite * m_latticeSpacing - maxStretch ||
+               position >= getLastStoredSite() * m_latticeSpacing + maxStretch;
+    }
+    return position <= -maxStretch || position >= m_length + maxStretch;
+}
+
+bool Microtubule::hasSiteBelow(const int32_t position) const {
+    return m_periodic || position != m_firstStoredSite;
+}
+
+bool Microtubule::hasSiteAbove(const int32_t position) const {
+    return m_periodic || position != getLastStoredSite();
+}
+
+int32_t Microtubule::getSiteDistance(const int32_t from, const int32_t to)
+        const {
+    if (!m_periodic) {
+        return to - from;
+    }
+    const int32_t distance = getPeriodicPosition(to - from);
+    return (2 * distance >= m_nSites) ? (distance - m_nSites) : distance;
+}
+
 int32_t Microtubule::getFreeSitePosition(const int32_t whichFreeSite) const {
 #ifdef MYDEBUG
     if (whichFreeSite < 0 || whichFreeSite >= m_nFreeSites) {
@@ -117,11 +344,17 @@ int32_t Microtubule::getFirstPositionCloseTo(
         const double maxStretch) const {
     int32_t estimatedSite = static_cast<int32_t>(
             std::floor((position - maxStretch) / m_latticeSpacing + 1));
+    // On a periodic microtubule, every label is valid, and it is mapped back
+    // onto the microtubule when the site is accessed
+    if (m_periodic) {
+        return estimatedSite;
+    }
     // The first position cannot be smaller than 0, and not bigger than
-    // (NSites-1), since counting starts at 0
+    // (NSites-1), since counting starts at 0. With a window, it has to be a
+    // stored site
     return std::min(
-            std::max(static_cast<int32_t>(0), estimatedSite),
-            m_nSites - 1); // m_nSites >=1, so this is always good
+            std::max(m_firstStoredSite, estimatedSite),
+            getLastStoredSite()); // m_nSites >=1, so this is always good
 }
 
 int32_t Microtubule::getLastPositionCloseTo(
@@ -129,32 +362,57 @@ int32_t Microtubule::getLastPositionCloseTo(
         const double maxStretch) const {
     int32_t estimatedSite = static_cast<int32_t>(
             std::ceil((position + maxStretch) / m_latticeSpacing - 1));
+    if (m_periodic) {
+        return estimatedSite;
+    }
     // The first position cannot be smaller than 0, and not bigger than
-    // (NSites-1), since counting starts at 0
+    // (NSites-1), since counting starts at 0. With a window, it has to be a
+    // stored site
     return std::min(
-            std::max(static_cast<int32_t>(0), estimatedSite), m_nSites - 1);
+            std::max(m_firstStoredSite, estimatedSite), getLastStoredSite());
 }
 
 int32_t Microtubule::getNFreeSitesCloseTo(
         const double position,
         const double maxStretch) const {
-    if (position <= -maxStretch || position >= m_length + maxStretch) {
+    if (isOutOfReach(position, maxStretch)) {
         return 0;
     }
     else {
         // Now, we can assume there is at least one site (does not have to be
         // free) within reach
-        int32_t nFreeSites = 0;
-        int32_t lowerSiteLabel = getFirstPositionCloseTo(position, maxStretch);
-        int32_t upperSiteLabel = getLastPositionCloseTo(position, maxStretch);
-        for (int32_t posToCheck = lowerSiteLabel; posToCheck <= upperSiteLabel;
-             ++posToCheck) {
-            if (m_sites.at(posToCheck).isFree()) {
-                ++nFreeSites;
-            }
+        return getNFreeSitesBetween(
+                getFirstPositionCloseTo(position, maxStretch),
+                getLastPositionCloseTo(position, maxStretch));
+    }
+}
+
+int32_t Microtubule::getNFreeSitesBetween(
+        const int32_t firstSite,
+        const int32_t lastSite) const {
+    int32_t nFreeSites = 0;
+    for (int32_t posToCheck = firstSite; posToCheck <= lastSite; ++posToCheck) {
+        if (getSite(posToCheck).isFree()) {
+            ++nFreeSites;
         }
-        return nFreeSites;
     }
+    return nFreeSites;
+}
+
+int32_t Microtubule::getPositionAfterHop(
+        const int32_t origin,
+        const int32_t position,
+        const int32_t direction) const {
+    const bool hasNextSite = (direction > 0) ? hasSiteAbove(position) :
+                                               hasSiteBelow(position);
+    if (!hasNextSite) {
+        return position;
+    }
+    const int32_t nextPosition = getPeriodicPosition(position + direction);
+    if (nextPosition == origin || getSite(nextPosition).isFree()) {
+        return nextPosition;
+    }
+    return position;
 }
 
 // position is the position relative to the start of THIS microtubule, not the
@@ -179,9 +437,8 @@ void Microtubule::addPossibleConnectionsCloseTo(
     }
 #endif // MYDEBUG
 
-    if (!(position <= -maxStretch ||
-          position >= m_length + maxStretch)) // Definitely no sites close if
-                                              // there is no microtubule there
+    if (!isOutOfReach(position, maxStretch)) // Definitely no sites close if
+                                             // there is no microtubule there
     {
         // Now, we can assume there is at least one site (does not have to be
         // free) within reach
@@ -196,8 +453,9 @@ void Microtubule::addPossibleConnectionsCloseTo(
             // mobile microtubule, minus the position on the fixed microtubule.
             // The sign matters! This is done such that the stretch can be
             // easily updated after a change in the microtubule position, and
-            // the force can be easily calculated
-            if (m_sites.at(posToCheck).isFree()) {
+            // the force can be easily calculated. On a periodic microtubule,
+            // posToCheck is the image of the site closest to position
+            if (getSite(posToCheck).isFree()) {
                 double stretch;
                 switch (m_type) {
                 case MicrotubuleType::FIXED:
@@ -241,8 +499,8 @@ void Microtubule::addPossibleConnectionsCloseTo(
 
                 newPossibleConnections.push_back(PossibleFullConnection {
                         p_oppositeCrosslinker,
-                        SiteLocation {m_type, posToCheck},
-                        stretch});
+                        SiteLocation {m_type, getPeriodicPosition(posToCheck)},
+                        static_cast<StorageScalar>(stretch)});
             }
         }
         cleanPossibleCrossings(
@@ -281,34 +539,37 @@ void Microtubule::addPossiblePartialHopsCloseTo(
     // For the fixed microtubule, the plus tip is at (m_nSites-1), the minus tip
     // is at 0. For the mobile microtubule this is opposite: plus @ 0, minus @
     // (m_nSites-1) The hop direction is forward when towards the plus tip, and
-    // backwards otherwise
-    if (partialLocation.position != 0 &&
-        m_sites.at(partialLocation.position - 1).isFree()) {
+    // backwards otherwise. A periodic microtubule has no tips, but the
+    // directions are the same
+    const int32_t positionBelow =
+            getPeriodicPosition(partialLocation.position - 1);
+    const int32_t positionAbove =
+            getPeriodicPosition(partialLocation.position + 1);
+    if (hasSiteBelow(partialLocation.position) &&
+        getSite(positionBelow).isFree()) {
         HopDirection direction = (m_type == MicrotubuleType::FIXED) ?
                                          (HopDirection::BACKWARD) :
                                          (HopDirection::FORWARD);
-        bool awayFromNeighbour =
-                (partialLocation.position != (m_nSites - 1)) &&
-                (!m_sites.at(partialLocation.position + 1).isFree());
+        bool awayFromNeighbour = hasSiteAbove(partialLocation.position) &&
+                                 (!getSite(positionAbove).isFree());
         possiblePartialHops.push_back(PossiblePartialHop {
                 p_partialLinker,
                 terminusToHop,
-                SiteLocation {m_type, partialLocation.position - 1},
+                SiteLocation {m_type, positionBelow},
                 direction,
                 awayFromNeighbour});
     }
-    if (partialLocation.position != (m_nSites - 1) &&
-        m_sites.at(partialLocation.position + 1).isFree()) {
+    if (hasSiteAbove(partialLocation.position) &&
+        getSite(positionAbove).isFree()) {
         HopDirection direction = (m_type == MicrotubuleType::FIXED) ?
                                          (HopDirection::FORWARD) :
                                          (HopDirection::BACKWARD);
-        bool awayFromNeighbour =
-                (partialLocation.position != 0) &&
-                (!m_sites.at(partialLocation.position - 1).isFree());
+        bool awayFromNeighbour = hasSiteBelow(partialLocation.position) &&
+                                 (!getSite(positionBelow).isFree());
         possiblePartialHops.push_back(PossiblePartialHop {
                 p_partialLinker,
                 terminusToHop,
-                SiteLocation {m_type, partialLocation.position + 1},
+                SiteLocation {m_type, positionAbove},
                 direction,
                 awayFromNeighbour});
     }
@@ -339,6 +600,13 @@ std::pair<double, double> Microtubule::getOldAndNewStretchFullHop(
                 "encountered a wrong microtubule type");
     }
 
+    // On a periodic microtubule, the opposite extremity can be at any periodic
+    // image of its position. Shift both stretches by the same amount, such
+    // that the old one is the shortest
+    const double periodicShift = oldStretch - getMinimumImage(oldStretch);
+    oldStretch -= periodicShift;
+    newStretch -= periodicShift;
+
 #ifdef MYDEBUG
     if (std::abs(oldStretch) >= maxStretch) {
         throw GeneralException(
@@ -380,8 +648,14 @@ void Microtubule::addPossibleFullHopsCloseTo(
     }
 #endif // MYDEBUG
 
-    if (originLocation.position != 0 &&
-        m_sites.at(originLocation.position - 1).isFree()) {
+    // The new positions are passed as labels next to the origin, such that the
+    // stretch is found correctly on a periodic microtubule
+    const int32_t positionBelow =
+            getPeriodicPosition(originLocation.position - 1);
+    const int32_t positionAbove =
+            getPeriodicPosition(originLocation.position + 1);
+    if (hasSiteBelow(originLocation.position) &&
+        getSite(positionBelow).isFree()) {
         std::pair<double, double> oldAndNewStretch = getOldAndNewStretchFullHop(
                 originLocation.position,
                 originLocation.position - 1,
@@ -392,21 +666,20 @@ void Microtubule::addPossibleFullHopsCloseTo(
             HopDirection direction = (m_type == MicrotubuleType::FIXED) ?
                                              (HopDirection::BACKWARD) :
                                              (HopDirection::FORWARD);
-            bool awayFromNeighbour =
-                    (originLocation.position != (m_nSites - 1)) &&
-                    (!m_sites.at(originLocation.position + 1).isFree());
+            bool awayFromNeighbour = hasSiteAbove(originLocation.position) &&
+                                     (!getSite(positionAbove).isFree());
             possibleFullHops.push_back(PossibleFullHop {
                     fullLinkerExtremity.p_fullLinker,
                     fullLinkerExtremity.terminus,
-                    SiteLocation {m_type, originLocation.position - 1},
+                    SiteLocation {m_type, positionBelow},
                     direction,
-                    oldAndNewStretch.first,
-                    oldAndNewStretch.second,
+                    static_cast<StorageScalar>(oldAndNewStretch.first),
+                    static_cast<StorageScalar>(oldAndNewStretch.second),
                     awayFromNeighbour});
         }
     }
-    if (originLocation.position != (m_nSites - 1) &&
-        m_sites.at(originLocation.position + 1).isFree()) {
+    if (hasSiteAbove(originLocation.position) &&
+        getSite(positionAbove).isFree()) {
         std::pair<double, double> oldAndNewStretch = getOldAndNewStretchFullHop(
                 originLocation.position,
                 originLocation.position + 1,
@@ -417,16 +690,15 @@ void Microtubule::addPossibleFullHopsCloseTo(
             HopDirection direction = (m_type == MicrotubuleType::FIXED) ?
                                              (HopDirection::FORWARD) :
                                              (HopDirection::BACKWARD);
-            bool awayFromNeighbour =
-                    (originLocation.position != 0) &&
-                    (!m_sites.at(originLocation.position - 1).isFree());
+            bool awayFromNeighbour = hasSiteBelow(originLocation.position) &&
+                                     (!getSite(positionBelow).isFree());
             possibleFullHops.push_back(PossibleFullHop {
                     fullLinkerExtremity.p_fullLinker,
                     fullLinkerExtremity.terminus,
-                    SiteLocation {m_type, originLocation.position + 1},
+                    SiteLocation {m_type, positionAbove},
                     direction,
-                    oldAndNewStretch.first,
-                    oldAndNewStretch.second,
+                    static_cast<StorageScalar>(oldAndNewStretch.first),
+                    static_cast<StorageScalar>(oldAndNewStretch.second),
                     awayFromNeighbour});
         }
     }
@@ -525,35 +797,43 @@ void Microtubule::cleanPossibleCrossings(
 
         // erase-remove idiom erasing all possibleConnections from
         // possibleConnectionsToCheck that have a full linker in the
-        // surroundings that crosses the possibleConnection
+        // surroundings that crosses the possibleConnection. Both microtubules
+        // have the same number of sites when they are periodic, so the site
+        // distances can be found here for both
         possibleConnectionsToCheck.erase(
                 std::remove_if(
                         possibleConnectionsToCheck.begin(),
                         possibleConnectionsToCheck.end(),
                         // lambda expression
-                        [&fullConnections,
-                         &locationPartialLinker](const PossibleFullConnection&
-                                                         possibleConnection) {
+                        [this, &fullConnections, &locationPartialLinker](
+                                const PossibleFullConnection&
+                                        possibleConnection) {
                             for (const FullConnectionLocations& fullConnection:
                                  fullConnections) {
                                 // Compare the integers labeling the sites on
                                 // each microtubule with each other
-                                if ((locationPartialLinker.position <
-                                     fullConnection.locationNextToPartial
-                                             .position) &&
-                                    (possibleConnection.location.position >
-                                     fullConnection.locationOppositeToPartial
-                                             .position)) {
+                                const int32_t distanceNextToPartial =
+                                        getSiteDistance(
+                                                locationPartialLinker.position,
+                                                fullConnection
+                                                        .locationNextToPartial
+                                                        .position);
+                                const SiteLocation& locationOppositeToPartial =
+                                        fullConnection
+                                                .locationOppositeToPartial;
+                                const int32_t distanceOppositeToPartial =
+                                        getSiteDistance(
+                                                possibleConnection.location
+                                                        .position,
+                                                locationOppositeToPartial
+                                                        .position);
+                                if ((distanceNextToPartial > 0) &&
+                                    (distanceOppositeToPartial < 0)) {
                                     return true;
                                 }
                                 else if (
-                                        (locationPartialLinker.position >
-                                         fullConnection.locationNextToPartial
-                                                 .position) &&
-                                        (possibleConnection.location.position <
-                                         fullConnection
-                                                 .locationOppositeToPartial
-                                                 .position)) {
+                                        (distanceNextToPartial < 0) &&
+                                        (distanceOppositeToPartial > 0)) {
                                     return true;
                                 }
                             }
@@ -568,9 +848,8 @@ void Microtubule::cleanPossibleCrossings(
 std::vector<FullConnectionLocations> Microtubule::getFullCrosslinkersCloseTo(
         const double position,
         const double maxStretch) const {
-    if (position <= -maxStretch ||
-        position >= m_length + maxStretch) // No sites close to a point outside
-                                           // of the microtubule
+    if (isOutOfReach(position, maxStretch)) // No sites close to a point
+                                            // outside of the microtubule
     {
         return {}; // empty vector
     }
@@ -582,9 +861,10 @@ std::vector<FullConnectionLocations> Microtubule::getFullCrosslinkersCloseTo(
         std::vector<FullConnectionLocations> fullsCloseby;
         for (int32_t posToCheck = lowerSiteLabel; posToCheck <= upperSiteLabel;
              ++posToCheck) {
-            if ((m_sites.at(posToCheck).isFull())) {
+            const Site& site = getSite(posToCheck);
+            if (site.isFull()) {
                 Crosslinker* const p_fullLinker =
-                        m_sites.at(posToCheck).whichCrosslinkerIsBound();
+                        site.whichCrosslinkerIsBound();
                 SiteLocation headLocation =
                         p_fullLinker->getOneBoundLocationWhenFullyConnected(
                                 Crosslinker::Terminus::HEAD);
@@ -620,9 +900,8 @@ std::vector<Crosslinker*> Microtubule::getPartialCrosslinkersCloseTo(
         const double position,
         const double maxStretch,
         const Crosslinker::Type typeToCheck) const {
-    if (position <= -maxStretch ||
-        position >= m_length + maxStretch) // No sites close to a point outside
-                                           // of the microtubule
+    if (isOutOfReach(position, maxStretch)) // No sites close to a point
+                                            // outside of the microtubule
     {
         return {}; // empty vector
     }
@@ -634,11 +913,10 @@ std::vector<Crosslinker*> Microtubule::getPartialCrosslinkersCloseTo(
         std::vector<Crosslinker*> partialsCloseby;
         for (int32_t posToCheck = lowerSiteLabel; posToCheck <= upperSiteLabel;
              ++posToCheck) {
-            if ((m_sites.at(posToCheck).isPartial()) &&
-                (m_sites.at(posToCheck).whichCrosslinkerIsBound()->getType() ==
-                 typeToCheck)) {
-                partialsCloseby.push_back(
-                        m_sites.at(posToCheck).whichCrosslinkerIsBound());
+            const Site& site = getSite(posToCheck);
+            if ((site.isPartial()) &&
+                (site.whichCrosslinkerIsBound()->getType() == typeToCheck)) {
+                partialsCloseby.push_back(site.whichCrosslinkerIsBound());
             }
         }
         return partialsCloseby;
@@ -660,23 +938,20 @@ std::vector<Crosslinker*> Microtubule::getNeighbouringPartialCrosslinkersOf(
 
     std::vector<Crosslinker*> partialNeighbours;
 
-    if ((originLocation.position != 0) &&
-        (m_sites.at(originLocation.position - 1).isPartial()) &&
-        (m_sites.at(originLocation.position - 1)
-                 .whichCrosslinkerIsBound()
-                 ->getType() == typeToCheck)) {
-        partialNeighbours.push_back(m_sites.at(originLocation.position - 1)
-                                            .whichCrosslinkerIsBound());
+    if (hasSiteBelow(originLocation.position)) {
+        const Site& site = getSite(originLocation.position - 1);
+        if (site.isPartial() &&
+            (site.whichCrosslinkerIsBound()->getType() == typeToCheck)) {
+            partialNeighbours.push_back(site.whichCrosslinkerIsBound());
+        }
     }
 
-    //
-    if ((originLocation.position != (m_nSites - 1)) &&
-        (m_sites.at(originLocation.position + 1).isPartial()) &&
-        (m_sites.at(originLocation.position + 1)
-                 .whichCrosslinkerIsBound()
-                 ->getType() == typeToCheck)) {
-        partialNeighbours.push_back(m_sites.at(originLocation.position + 1)
-                                            .whichCrosslinkerIsBound());
+    if (hasSiteAbove(originLocation.position)) {
+        const Site& site = getSite(originLocation.position + 1);
+        if (site.isPartial() &&
+            (site.whichCrosslinkerIsBound()->getType() == typeToCheck)) {
+            partialNeighbours.push_back(site.whichCrosslinkerIsBound());
+        }
     }
 
     return partialNeighbours;
@@ -697,26 +972,24 @@ std::vector<FullExtremity> Microtubule::getNeighbouringFullCrosslinkersOf(
 
     std::vector<FullExtremity> fullNeighbours;
 
-    if ((originLocation.position != 0) &&
-        (m_sites.at(originLocation.position - 1).isFull()) &&
-        (m_sites.at(originLocation.position - 1)
-                 .whichCrosslinkerIsBound()
-                 ->getType() == typeToCheck)) {
-        Crosslinker* const p_linker = m_sites.at(originLocation.position - 1)
-                                              .whichCrosslinkerIsBound();
-        fullNeighbours.push_back(FullExtremity {
-                p_linker, p_linker->getTerminusOfFullOn(m_type)});
-    }
-
-    if ((originLocation.position != (m_nSites - 1)) &&
-        (m_sites.at(originLocation.position + 1).isFull()) &&
-        (m_sites.at(originLocation.position + 1)
-                 .whichCrosslinkerIsBound()
-                 ->getType() == typeToCheck)) {
-        Crosslinker* const p_linker = m_sites.at(originLocation.position + 1)
-                                              .whichCrosslinkerIsBound();
-        fullNeighbours.push_back(FullExtremity {
-                p_linker, p_linker->getTerminusOfFullOn(m_type)});
+    if (hasSiteBelow(originLocation.position)) {
+        const Site& site = getSite(originLocation.position - 1);
+        if (site.isFull() &&
+            (site.whichCrosslinkerIsBound()->getType() == typeToCheck)) {
+            Crosslinker* const p_linker = site.whichCrosslinkerIsBound();
+            fullNeighbours.push_back(FullExtremity {
+                    p_linker, p_linker->getTerminusOfFullOn(m_type)});
+        }
+    }
+
+    if (hasSiteAbove(originLocation.position)) {
+        const Site& site = getSite(originLocation.position + 1);
+        if (site.isFull() &&
+            (site.whichCrosslinkerIsBound()->getType() == typeToCheck)) {
+            Crosslinker* const p_linker = site.whichCrosslinkerIsBound();
+            fullNeighbours.push_back(FullExtremity {
+                    p_linker, p_linker->getTerminusOfFullOn(m_type)});
+        }
     }
 
     return fullNeighbours;
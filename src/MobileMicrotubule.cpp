@@ -1,17 +1,23 @@
 #include <cmath>
+#include <istream>
+#include <ostream>
 
 #ifdef MYDEBUG
 #include <iostream>
 #endif
 
+#include "filament-sliding/Checkpoint.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
 #include "filament-sliding/MobileMicrotubule.hpp"
 
 MobileMicrotubule::MobileMicrotubule(
         const double length,
         const double latticeSpacing,
+        const bool periodic,
         const double initialPosition):
-        Microtubule(MicrotubuleType::MOBILE, length, latticeSpacing),
+        Microtubule(
+                MicrotubuleType::MOBILE, length, latticeSpacing, periodic, 0),
         m_position(initialPosition) {
     m_currentAttractorPosition =
             static_cast<int32_t>(std::round(m_position / m_latticeSpacing));
@@ -27,8 +33,43 @@ void MobileMicrotubule::updatePosition(const double change) {
     m_position += change;
 }
 
+void MobileMicrotubule::copyStateFrom(
+        const MobileMicrotubule& other,
+        const CrosslinkerRelocation& relocation) {
+    Microtubule::copyStateFrom(other, relocation);
+    m_position = other.m_position;
+    m_currentAttractorPosition = other.m_currentAttractorPosition;
+}
+
+void MobileMicrotubule::writeCheckpoint(
+        std::ostream& out,
+        const CrosslinkerRelocation& relocation) const {
+    Microtubule::writeCheckpoint(out, relocation);
+    Checkpoint::write(out, m_position);
+    Checkpoint::write(out, m_currentAttractorPosition);
+}
+
+void MobileMicrotubule::readCheckpoint(
+        std::istream& in,
+        const CrosslinkerRelocation& relocation) {
+    Microtubule::readCheckpoint(in, relocation);
+    Checkpoint::read(in, m_position);
+    Checkpoint::read(in, m_currentAttractorPosition);
+}
+
 double MobileMicrotubule::getPosition() const { return m_position; }
 
+int32_t MobileMicrotubule::getAttractorPosition() const {
+    return m_currentAttractorPosition;
+}
+
+void MobileMicrotubule::restorePosition(
+        const double position,
+        const int32_t attractorPosition) {
+    m_position = position;
+    m_currentAttractorPosition = attractorPosition;
+}
+
 void MobileMicrotubule::setPosition(const double initialPosition) {
     m_position = initialPosition;
 
@@ -0,0 +1,285 @@
+#include <algorithm> // std::min
+#include <cmath>
+#include <cstdint>
+#include <cstdlib> // std::abs
+#include <fstream>
+#include <iomanip> // std::setw
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/MultilevelEstimator.hpp"
+#include "filament-sliding/OutputParameters.hpp"
+#include "filament-sliding/Propagator.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/Statistics.hpp"
+#include "filament-sliding/SystemState.hpp"
+
+MultilevelEstimator::MultilevelEstimator(
+        const std::string& runName,
+        const std::vector<Propagator*>& propagators,
+        const int32_t nFineTimeSteps,
+        const int32_t nPilotSamples,
+        const double precision,
+        const int64_t maxNSamples,
+        const int32_t nSnapshots):
+        m_runName(runName),
+        m_sampleDuration(
+                nFineTimeSteps * propagators.back()->getCalcTimeStep()),
+        m_nPilotSamples(nPilotSamples),
+        m_precision(precision),
+        m_maxNSamples(maxNSamples),
+        m_nSnapshots(nSnapshots),
+        m_noiseGenerator(runName + " Brownian increments") {
+    if (m_nPilotSamples < 2 || m_maxNSamples < m_nPilotSamples ||
+        m_precision <= 0.0 || m_nSnapshots < 1) {
+        throw GeneralException(
+                "MultilevelEstimator was constructed with a wrong number of "
+                "samples, snapshots or precision");
+    }
+
+    // The number of time steps per sample halves with every coarser level
+    int32_t nTimeSteps = nFineTimeSteps;
+    for (std::size_t i = propagators.size(); i-- > 0;) {
+        if (nTimeSteps % 2 != 0 && i > 0) {
+            throw GeneralException(
+                    "For the multilevel estimate, the number of time steps "
+                    "per sample should be divisible by two for every coarser "
+                    "level.");
+        }
+        Propagator* const p_coarsePropagator =
+                (i > 0) ? propagators[i - 1] : nullptr;
+        m_levels.push_back(
+                {propagators[i],
+                 p_coarsePropagator,
+                 nTimeSteps,
+                 Statistics(),
+                 Statistics(),
+                 0});
+        nTimeSteps /= 2;
+    }
+    std::reverse(m_levels.begin(), m_levels.end());
+}
+
+MultilevelEstimator::~MultilevelEstimator() {}
+
+void MultilevelEstimator::takeSnapshots(
+        SystemState& systemState,
+        RandomGenerator& generator) {
+    const Level& finestLevel = m_levels.back();
+    Propagator& propagator = *finestLevel.p_finePropagator;
+    propagator.restartReactionClock(generator);
+
+    m_snapshots.clear();
+    for (int32_t snapshot = 0; snapshot < m_nSnapshots; ++snapshot) {
+        for (int32_t step = 0; step < finestLevel.nFineTimeSteps; ++step) {
+            propagator.advanceCoupledTimeStep(
+                    systemState, generator, generator.getGaussian(0.0, 1.0));
+        }
+        std::ostringstream state;
+        systemState.writeCheckpoint(state);
+        m_snapshots.push_back(state.str());
+    }
+}
+
+void MultilevelEstimator::runSamples(
+        Level& level,
+        const int64_t nSamples,
+        SystemState& systemState,
+        SystemState& coarseSystemState,
+        RandomGenerator& generator) {
+    const double sqrtHalf = std::sqrt(0.5);
+    Propagator& finePropagator = *level.p_finePropagator;
+
+    for (int64_t sample = 0; sample < nSamples; ++sample) {
+        // Every sample starts from its own draw from the snapshots
+        std::istringstream snapshot(m_snapshots[static_cast<std::size_t>(
+                generator.getUniformInteger(0, m_nSnapshots - 1))]);
+        systemState.readCheckpoint(snapshot);
+
+        int32_t nFineCrossings = 0;
+        int32_t nCoarseCrossings = 0;
+        finePropagator.restartReactionClock(generator);
+
+        if (level.p_coarsePropagator == nullptr) {
+            for (int32_t step = 0; step < level.nFineTimeSteps; ++step) {
+                nFineCrossings +=
+                        std::abs(finePropagator.advanceCoupledTimeStep(
+                                systemState,
+                                generator,
+                                m_noiseGenerator.getGaussian(0.0, 1.0)));
+            }
+        }
+        else {
+            // The coarse trajectory starts as an exact copy, and draws the
+            // same random numbers for its reactions as long as it makes the
+            // same reactions
+            Propagator& coarsePropagator = *level.p_coarsePropagator;
+            coarseSystemState.copyStateFrom(systemState);
+            RandomGenerator coarseGenerator = generator;
+            coarsePropagator.restartReactionClock(coarseGenerator);
+
+            for (int32_t step = 0; step < level.nFineTimeSteps; step += 2) {
+                const double firstIncrement =
+                        m_noiseGenerator.getGaussian(0.0, 1.0);
+                nFineCrossings +=
+                        std::abs(finePropagator.advanceCoupledTimeStep(
+                                systemState, generator, firstIncrement));
+                const double secondIncrement =
+                        m_noiseGenerator.getGaussian(0.0, 1.0);
+                nFineCrossings +=
+                        std::abs(finePropagator.advanceCoupledTimeStep(
+                                systemState, generator, secondIncrement));
+
+                // The sum of the fine increments, normalised to a standard
+                // normal number
+                nCoarseCrossings +=
+                        std::abs(coarsePropagator.advanceCoupledTimeStep(
+                                coarseSystemState,
+                                coarseGenerator,
+                                (firstIncrement + secondIncrement) *
+                                        sqrtHalf));
+            }
+        }
+
+        const double fineRate = nFineCrossings / m_sampleDuration;
+        const double coarseRate = nCoarseCrossings / m_sampleDuration;
+        level.fineRates.addValue(fineRate);
+        level.corrections.addValue(fineRate - coarseRate);
+    }
+}
+
+double MultilevelEstimator::getCostPerSample(const Level& level) const {
+    return (level.p_coarsePropagator == nullptr) ? level.nFineTimeSteps
+                                                 : 1.5 * level.nFineTimeSteps;
+}
+
+double MultilevelEstimator::getEstimate() const {
+    double estimate = 0.0;
+    for (const Level& level: m_levels) {
+        estimate += level.corrections.getMean();
+    }
+    return estimate;
+}
+
+double MultilevelEstimator::getSEM() const {
+    double variance = 0.0;
+    for (const Level& level: m_levels) {
+        variance += level.corrections.getVariance() /
+                    static_cast<double>(level.corrections.getNumberOfSamples());
+    }
+    return std::sqrt(variance);
+}
+
+bool MultilevelEstimator::findNSamplesNeeded() {
+    // The numbers of samples that give the target variance of the estimate at
+    // the least cost are proportional to sqrt(variance/cost) per level
+    double sumSqrtVarianceTimesCost = 0.0;
+    for (const Level& level: m_levels) {
+        sumSqrtVarianceTimesCost += std::sqrt(
+                level.corrections.getVariance() * getCostPerSample(level));
+    }
+    const double targetSEM = m_precision * std::abs(getEstimate());
+
+    bool needsSamples = false;
+    for (Level& level: m_levels) {
+        // Without crossings, the target cannot be set, and the maximum is used
+        const double nSamplesNeeded =
+                (targetSEM > 0.0)
+                        ? std::ceil(
+                                  std::sqrt(
+                                          level.corrections.getVariance() /
+                                          getCostPerSample(level)) *
+                                  sumSqrtVarianceTimesCost /
+                                  (targetSEM * targetSEM))
+                        : static_cast<double>(m_maxNSamples);
+        level.nSamplesNeeded = static_cast<int64_t>(
+                std::min(nSamplesNeeded, static_cast<double>(m_maxNSamples)));
+        if (level.nSamplesNeeded > level.corrections.getNumberOfSamples()) {
+            needsSamples = true;
+        }
+    }
+    return needsSamples;
+}
+
+void MultilevelEstimator::estimate(
+        SystemState& systemState,
+        SystemState& coarseSystemState,
+        RandomGenerator& generator) {
+    takeSnapshots(systemState, generator);
+
+    // The variances found from the pilot samples set the numbers of samples,
+    // which are raised as the variances get more accurate
+    for (Level& level: m_levels) {
+        runSamples(
+                level,
+                m_nPilotSamples,
+                systemState,
+                coarseSystemState,
+                generator);
+    }
+    while (findNSamplesNeeded()) {
+        for (Level& level: m_levels) {
+            const int64_t nMissingSamples =
+                    level.nSamplesNeeded -
+                    level.corrections.getNumberOfSamples();
+            if (nMissingSamples > 0) {
+                runSamples(
+                        level,
+                        nMissingSamples,
+                        systemState,
+                        coarseSystemState,
+                        generator);
+            }
+        }
+    }
+}
+
+void MultilevelEstimator::writeResults() const {
+    const int width = OutputParameters::collumnWidth;
+    std::ofstream file((m_runName + ".multilevel_estimate.txt").c_str());
+    file << std::left << std::setw(width) << "TIME STEP (s)"
+         << std::setw(width) << "NUMBER OF SAMPLES" << std::setw(width)
+         << "MEAN CORRECTION (s^(-1))" << std::setw(width)
+         << "VARIANCE CORRECTION (s^(-2))" << std::setw(width)
+         << "COST PER SAMPLE (time steps)" << '\n';
+
+    // Including the reference trajectory of the snapshots
+    double cost = static_cast<double>(m_nSnapshots) *
+                  m_levels.back().nFineTimeSteps;
+    for (const Level& level: m_levels) {
+        file << std::setw(width) << level.p_finePropagator->getCalcTimeStep()
+             << std::setw(width) << level.corrections.getNumberOfSamples()
+             << std::setw(width) << level.corrections.getMean()
+             << std::setw(width) << level.corrections.getVariance()
+             << std::setw(width) << getCostPerSample(level) << '\n';
+        cost += static_cast<double>(level.corrections.getNumberOfSamples()) *
+                getCostPerSample(level);
+    }
+
+    const Level& finestLevel = m_levels.back();
+    const double SEM = getSEM();
+    file << "\nThe barrier crossing rate at time step "
+         << finestLevel.p_finePropagator->getCalcTimeStep()
+         << " s is estimated at " << getEstimate() << " s^(-1), with standard "
+         << "error " << SEM << " s^(-1).\n"
+         << "Every sample covers " << m_sampleDuration << " s, and starts "
+         << "from one of " << m_nSnapshots << " snapshots taken every sample "
+         << "duration. The standard error does not include the spread from "
+         << "the finite number of snapshots. The estimate took " << cost
+         << " time steps.";
+    // A plain estimate at the finest time step, with the variance found at
+    // the finest level, would need variance/SEM^2 samples for the same error
+    if (SEM > 0.0) {
+        file << " Simulating at the finest time step alone would take about "
+             << finestLevel.fineRates.getVariance() / (SEM * SEM) *
+                        finestLevel.nFineTimeSteps
+             << " time steps.";
+    }
+    file << '\n';
+    if (!(SEM <= m_precision * std::abs(getEstimate()))) {
+        file << "The precision " << m_precision << " (relative) was not "
+             << "reached within the maximum number of samples.\n";
+    }
+}
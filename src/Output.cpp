@@ -1,16 +1,24 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio> // std::remove
 #include <fstream>
 #include <iomanip> // For std::setw()
 #include <iostream>
+#include <limits>
 #include <memory> // std::unique_ptr
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <utility> // std::move
+#include <vector>
 
+#include "filament-sliding/Checkpoint.hpp"
+#include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/Histogram.hpp"
 #include "filament-sliding/MathematicalFunctions.hpp"
 #include "filament-sliding/Output.hpp"
 #include "filament-sliding/OutputParameters.hpp"
+#include "filament-sliding/SharedAccumulators.hpp"
 #include "filament-sliding/SystemState.hpp"
 
 Output::Output(
@@ -29,13 +37,12 @@ Output::Output(
         const int32_t timeStepsPerDistributionEstimate,
         const int32_t nEstimatesDistribution,
         const double dynamicsEstimationInitialRegionWidth,
-        const double dynamicsEstimationFinalRegionWidth):
-        m_microtubulePositionFile(
-                (runName + ".microtubule_position.txt").c_str()),
-        m_barrierCrossingTimeFile(
-                (runName + ".times_barrier_crossings.txt").c_str()),
-        m_statisticalAnalysisFile(
-                (runName + ".statistical_analysis.txt").c_str()),
+        const double dynamicsEstimationFinalRegionWidth,
+        const bool recordTrajectory,
+        const bool writeFiles):
+        m_runName(runName),
+        m_writeFiles(writeFiles),
+        m_recordTrajectory(recordTrajectory),
         m_collumnWidth(OutputParameters::collumnWidth),
         m_lastCrossingTime(0), // Time 0 indicates the beginning of the run
                                // blocks, after which we start writing data
@@ -65,6 +72,14 @@ Output::Output(
                                           // after passing a point, a Statistics
                                           // estimates the variance
 {
+    // Without a trajectory, these files stay closed, and nothing is written
+    // to them
+    if (m_recordTrajectory) {
+        openFile(m_microtubulePositionFile, ".microtubule_position.txt");
+        openFile(m_barrierCrossingTimeFile, ".times_barrier_crossings.txt");
+    }
+    openFile(m_statisticalAnalysisFile, ".statistical_analysis.txt");
+
     m_microtubulePositionFile
             << std::left << std::setw(m_collumnWidth) << "TIME"
             << std::setw(m_collumnWidth) << "POSITION"
@@ -95,8 +110,7 @@ Output::Output(
         // Only open the file here, not in the constructor initialization list,
         // since the file should only be created if
         // m_writePositionalDistribution is set to true.
-        m_positionalHistogramFile.open(
-                (runName + ".positional_histogram.txt").c_str());
+        openFile(m_positionalHistogramFile, ".positional_histogram.txt");
         m_positionalHistogramFile
                 << std::left << std::setw(m_collumnWidth) << "LOWER BIN BOUND"
                 << std::setw(m_collumnWidth) << "UPPER BIN BOUND"
@@ -114,8 +128,9 @@ Output::Output(
         // Only open the file here, not in the constructor initialization list,
         // since the file should only be created if
         // m_writePositionalDistribution is set to true.
-        m_reactionCoordinateHistogramFile.open(
-                (runName + ".reaction_coordinate_histogram.txt").c_str());
+        openFile(
+                m_reactionCoordinateHistogramFile,
+                ".reaction_coordinate_histogram.txt");
         m_reactionCoordinateHistogramFile
                 << std::left << std::setw(m_collumnWidth) << "LOWER BIN BOUND"
                 << std::setw(m_collumnWidth) << "UPPER BIN BOUND"
@@ -132,8 +147,9 @@ Output::Output(
                     positionalHistogramHighestValue));
         }
 
-        m_positionAndConfigurationHistogramFile.open(
-                (runName + ".position_configuration_histogram.txt").c_str());
+        openFile(
+                m_positionAndConfigurationHistogramFile,
+                ".position_configuration_histogram.txt");
         m_positionAndConfigurationHistogramFile
                 << std::left << std::setw(m_collumnWidth) << "LOWER BIN BOUND"
                 << std::setw(m_collumnWidth) << "UPPER BIN BOUND"
@@ -146,7 +162,7 @@ Output::Output(
         // Only open the file here, not in the constructor initialization list,
         // since the file should only be created if m_recordTransitionPaths is
         // set to true.
-        m_transitionPathFile.open((runName + ".transition_paths.txt").c_str());
+        openFile(m_transitionPathFile, ".transition_paths.txt");
         m_transitionPathFile
                 << std::left << std::setw(m_collumnWidth) << "TIME"
                 << std::setw(m_collumnWidth) << "POSITION"
@@ -166,8 +182,9 @@ Output::Output(
                     positionalHistogramHighestValue));
         }
 
-        m_transitionPathHistogramFile.open(
-                (runName + ".transition_path_histogram.txt").c_str());
+        openFile(
+                m_transitionPathHistogramFile,
+                ".transition_path_histogram.txt");
         m_transitionPathHistogramFile
                 << std::left << std::setw(m_collumnWidth) << "LOWER BIN BOUND"
                 << std::setw(m_collumnWidth) << "UPPER BIN BOUND"
@@ -177,8 +194,7 @@ Output::Output(
     }
 
     if (m_estimateTimeEvolutionAtPeak) {
-        m_peakDynamicsFile.open(
-                (runName + ".peak_dynamics_statistics.txt").c_str());
+        openFile(m_peakDynamicsFile, ".peak_dynamics_statistics.txt");
         m_peakDynamicsFile << std::left << std::setw(m_collumnWidth)
                            << "ALPHA: TIME STEPS AFTER PEAK PASSAGE"
                            << std::setw(m_collumnWidth) << "NUMBER OF SAMPLES"
@@ -319,6 +335,10 @@ void Output::addTimeStepToPeakAnalysis(
 void Output::writeBarrierCrossingTime(
         const double time,
         const int32_t direction) {
+    if (!m_recordTrajectory) {
+        return;
+    }
+
     const double interval = time - m_lastCrossingTime;
     m_lastCrossingTime = time;
     m_barrierCrossingTimeFile << std::setw(m_collumnWidth) << time
@@ -337,6 +357,10 @@ void Output::newBlock(const int32_t blockNumber) {
     message << blockNumber << '\n';
     m_microtubulePositionFile << message.str();
     m_barrierCrossingTimeFile << message.str();
+
+    if (mp_sharedAccumulators) {
+        mp_sharedAccumulators->fold();
+    }
 }
 
 void Output::addPointTransitionPath(
@@ -436,7 +460,249 @@ void Output::toggleTracking() { m_isTrackingPath = !m_isTrackingPath; }
 
 void Output::cleanTransitionPath() { m_currentTransitionPath.clean(); }
 
+double Output::getRelativeSEM(const TargetStatistic statistic) const {
+    const Statistics* p_statistics = nullptr;
+    switch (statistic) {
+    case TargetStatistic::CROSSING_TIME:
+        p_statistics = &m_crossingTimeStatistics;
+        break;
+    case TargetStatistic::FINAL_REGION_TIME:
+        p_statistics = &m_diffusionTimeToFinalRegion;
+        break;
+    default:
+        throw GeneralException(
+                "Output::getRelativeSEM() was called with an unknown "
+                "statistic");
+    }
+
+    // The samples of this process are combined with the folded ones of all
+    const Statistics statistics =
+            mp_sharedAccumulators ?
+                    mp_sharedAccumulators->getAggregate(*p_statistics) :
+                    *p_statistics;
+    if (!statistics.canReportStatistics() || statistics.getMean() == 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return statistics.getSEM() / std::abs(statistics.getMean());
+}
+
+void Output::merge(const Output& other) {
+    if (other.m_writePositionalDistribution != m_writePositionalDistribution ||
+        other.m_recordTransitionPaths != m_recordTransitionPaths ||
+        other.m_estimateTimeEvolutionAtPeak != m_estimateTimeEvolutionAtPeak ||
+        other.m_positionAndConfigurationHistogram.size() !=
+                m_positionAndConfigurationHistogram.size() ||
+        other.m_estimatePoints.size() != m_estimatePoints.size()) {
+        throw GeneralException(
+                "Output::merge() was called with an output that gathers "
+                "different statistics.");
+    }
+
+    m_crossingTimeStatistics.merge(other.m_crossingTimeStatistics);
+    if (m_writePositionalDistribution) {
+        mp_positionalHistogram->merge(*other.mp_positionalHistogram);
+        mp_reactionCoordinateHistogram->merge(
+                *other.mp_reactionCoordinateHistogram);
+        for (std::size_t nR = 0;
+             nR < m_positionAndConfigurationHistogram.size();
+             ++nR) {
+            m_positionAndConfigurationHistogram[nR].merge(
+                    other.m_positionAndConfigurationHistogram[nR]);
+        }
+    }
+    if (m_writePositionalDistribution && m_recordTransitionPaths) {
+        for (std::size_t nR = 0; nR < m_transitionPathHistogram.size(); ++nR) {
+            m_transitionPathHistogram[nR].merge(
+                    other.m_transitionPathHistogram[nR]);
+        }
+    }
+    if (m_estimateTimeEvolutionAtPeak) {
+        for (std::size_t i = 0; i < m_estimatePoints.size(); ++i) {
+            m_estimatePoints[i].merge(other.m_estimatePoints[i]);
+        }
+        m_diffusionTimeToFinalRegion.merge(other.m_diffusionTimeToFinalRegion);
+    }
+}
+
+void Output::writeAccumulators(std::ostream& out) const {
+    Checkpoint::writeString(out, "filament-sliding accumulators");
+    Checkpoint::write(out, static_cast<int32_t>(1)); // The format version
+    Checkpoint::write(out, m_writePositionalDistribution);
+    Checkpoint::write(out, m_recordTransitionPaths);
+    Checkpoint::write(out, m_estimateTimeEvolutionAtPeak);
+    Checkpoint::write(
+            out,
+            static_cast<int64_t>(m_positionAndConfigurationHistogram.size()));
+    Checkpoint::write(out, static_cast<int64_t>(m_estimatePoints.size()));
+
+    // In the order of merge
+    m_crossingTimeStatistics.serialize(out);
+    if (m_writePositionalDistribution) {
+        mp_positionalHistogram->serialize(out);
+        mp_reactionCoordinateHistogram->serialize(out);
+        for (const Histogram& histogram: m_positionAndConfigurationHistogram) {
+            histogram.serialize(out);
+        }
+    }
+    if (m_writePositionalDistribution && m_recordTransitionPaths) {
+        for (const Histogram& histogram: m_transitionPathHistogram) {
+            histogram.serialize(out);
+        }
+    }
+    if (m_estimateTimeEvolutionAtPeak) {
+        for (const Statistics& statistics: m_estimatePoints) {
+            statistics.serialize(out);
+        }
+        m_diffusionTimeToFinalRegion.serialize(out);
+    }
+}
+
+void Output::mergeAccumulators(std::istream& in) {
+    if (Checkpoint::readString(in) != "filament-sliding accumulators") {
+        throw GeneralException("The file does not hold accumulators.");
+    }
+    int32_t version;
+    Checkpoint::read(in, version);
+    if (version != 1) {
+        throw GeneralException(
+                "The accumulators were written in an unknown format.");
+    }
+
+    bool writePositionalDistribution, recordTransitionPaths,
+            estimateTimeEvolutionAtPeak;
+    int64_t nHistograms, nEstimatePoints;
+    Checkpoint::read(in, writePositionalDistribution);
+    Checkpoint::read(in, recordTransitionPaths);
+    Checkpoint::read(in, estimateTimeEvolutionAtPeak);
+    Checkpoint::read(in, nHistograms);
+    Checkpoint::read(in, nEstimatePoints);
+    if (writePositionalDistribution != m_writePositionalDistribution ||
+        recordTransitionPaths != m_recordTransitionPaths ||
+        estimateTimeEvolutionAtPeak != m_estimateTimeEvolutionAtPeak ||
+        nHistograms !=
+                static_cast<int64_t>(
+                        m_positionAndConfigurationHistogram.size()) ||
+        nEstimatePoints != static_cast<int64_t>(m_estimatePoints.size())) {
+        throw GeneralException(
+                "The accumulators were gathered with other output settings.");
+    }
+
+    m_crossingTimeStatistics.mergeSerialized(in);
+    if (m_writePositionalDistribution) {
+        mp_positionalHistogram->mergeSerialized(in);
+        mp_reactionCoordinateHistogram->mergeSerialized(in);
+        for (Histogram& histogram: m_positionAndConfigurationHistogram) {
+            histogram.mergeSerialized(in);
+        }
+    }
+    if (m_writePositionalDistribution && m_recordTransitionPaths) {
+        for (Histogram& histogram: m_transitionPathHistogram) {
+            histogram.mergeSerialized(in);
+        }
+    }
+    if (m_estimateTimeEvolutionAtPeak) {
+        for (Statistics& statistics: m_estimatePoints) {
+            statistics.mergeSerialized(in);
+        }
+        m_diffusionTimeToFinalRegion.mergeSerialized(in);
+    }
+}
+
+std::vector<std::pair<std::string, const Statistics*>>
+Output::getSampledStatistics() const {
+    std::vector<std::pair<std::string, const Statistics*>> statistics;
+    const auto addIfSampled = [&statistics](
+                                      const std::string& name,
+                                      const Statistics& statistic) {
+        if (statistic.getNumberOfSamples() > 0) {
+            statistics.emplace_back(name, &statistic);
+        }
+    };
+
+    addIfSampled("BARRIER CROSSING TIME", m_crossingTimeStatistics);
+    if (m_writePositionalDistribution) {
+        addIfSampled(
+                "REMAINDER TOP MICROTUBULE POSITION", *mp_positionalHistogram);
+        addIfSampled("REACTION COORDINATE", *mp_reactionCoordinateHistogram);
+        for (uint32_t nR = 0; nR < m_positionAndConfigurationHistogram.size();
+             ++nR) {
+            addIfSampled(
+                    "REMAINDER WITH NR=" + std::to_string(nR),
+                    m_positionAndConfigurationHistogram[nR]);
+        }
+    }
+    if (m_writePositionalDistribution && m_recordTransitionPaths) {
+        for (uint32_t nR = 0; nR < m_transitionPathHistogram.size(); ++nR) {
+            addIfSampled(
+                    "TRANSITION PATH REMAINDER WITH NR=" + std::to_string(nR),
+                    m_transitionPathHistogram[nR]);
+        }
+    }
+    if (m_estimateTimeEvolutionAtPeak) {
+        int32_t timeStepsToPoint = 0;
+        for (const Statistics& statPoint: m_estimatePoints) {
+            addIfSampled(
+                    "PEAK ESTIMATE AFTER " + std::to_string(timeStepsToPoint) +
+                            " TIME STEPS",
+                    statPoint);
+            timeStepsToPoint += m_timeStepsPerDistributionEstimate;
+        }
+        addIfSampled(
+                "TIME STEPS TO LEAVE BARRIER", m_diffusionTimeToFinalRegion);
+    }
+    return statistics;
+}
+
+void Output::shareAccumulators(
+        const std::string& name,
+        const std::string& ensemble,
+        const int32_t nProcesses) {
+    std::vector<Statistics*> statistics {&m_crossingTimeStatistics};
+    for (Statistics& estimatePoint: m_estimatePoints) {
+        statistics.push_back(&estimatePoint);
+    }
+    statistics.push_back(&m_diffusionTimeToFinalRegion);
+
+    std::vector<Histogram*> histograms;
+    if (m_writePositionalDistribution) {
+        histograms.push_back(mp_positionalHistogram.get());
+        histograms.push_back(mp_reactionCoordinateHistogram.get());
+    }
+    for (Histogram& histogram: m_positionAndConfigurationHistogram) {
+        histograms.push_back(&histogram);
+    }
+    for (Histogram& histogram: m_transitionPathHistogram) {
+        histograms.push_back(&histogram);
+    }
+
+    mp_sharedAccumulators.reset(
+            new SharedAccumulators(
+                    name, ensemble, nProcesses, statistics, histograms));
+}
+
 void Output::finishWriting() {
+    // Only the last process of the ensemble writes the aggregate, the
+    // accumulators of the others are left empty
+    if (mp_sharedAccumulators) {
+        const bool isLast = mp_sharedAccumulators->detach();
+        mp_sharedAccumulators.reset();
+        if (!isLast) {
+            removeFile(m_statisticalAnalysisFile, ".statistical_analysis.txt");
+            removeFile(m_positionalHistogramFile, ".positional_histogram.txt");
+            removeFile(
+                    m_reactionCoordinateHistogramFile,
+                    ".reaction_coordinate_histogram.txt");
+            removeFile(
+                    m_positionAndConfigurationHistogramFile,
+                    ".position_configuration_histogram.txt");
+            removeFile(
+                    m_transitionPathHistogramFile,
+                    ".transition_path_histogram.txt");
+            removeFile(m_peakDynamicsFile, ".peak_dynamics_statistics.txt");
+            return;
+        }
+    }
+
     if (m_crossingTimeStatistics.canReportStatistics()) {
         m_statisticalAnalysisFile
                 << std::setw(m_collumnWidth) << "BARRIER CROSSING TIME"
@@ -570,4 +836,183 @@ void Output::finishWriting() {
                     << m_diffusionTimeToFinalRegion.getSEM() << '\n';
         }
     }
+
+    // Lets the results of this run be pooled with those of others
+    if (m_writeFiles) {
+        std::ofstream accumulatorFile(
+                (m_runName + ".accumulators.bin").c_str(), std::ios::binary);
+        writeAccumulators(accumulatorFile);
+    }
+}
+
+void Output::openFile(std::ofstream& file, const std::string& suffix) {
+    if (m_writeFiles) {
+        file.open((m_runName + suffix).c_str());
+    }
+}
+
+void Output::removeFile(std::ofstream& file, const std::string& suffix) {
+    if (file.is_open()) {
+        file.close();
+        std::remove((m_runName + suffix).c_str());
+    }
+}
+
+int64_t Output::getWrittenSize(std::ofstream& file) {
+    if (!file.is_open()) {
+        return -1;
+    }
+    file.flush();
+    return static_cast<int64_t>(file.tellp());
+}
+
+void Output::continueFile(
+        std::ofstream& file,
+        const std::string& suffix,
+        const std::string& previousRunName,
+        const int64_t size) const {
+    if (size < 0 || !file.is_open()) {
+        return;
+    }
+
+    const std::string previousFileName = previousRunName + suffix;
+    std::ifstream previousFile(previousFileName.c_str(), std::ios::binary);
+    std::string writtenText(static_cast<std::size_t>(size), ' ');
+    if (!previousFile.read(
+                &writtenText[0], static_cast<std::streamsize>(size))) {
+        throw GeneralException(
+                "The checkpoint could not be resumed, since the file " +
+                previousFileName +
+                " of the run that wrote it is missing or shorter than it "
+                "was then.");
+    }
+
+    file.close();
+    file.open((m_runName + suffix).c_str(), std::ios::binary);
+    file.write(writtenText.data(), static_cast<std::streamsize>(size));
+    file.close();
+    file.open((m_runName + suffix).c_str(), std::ios::app);
+}
+
+void Output::writeCheckpoint(std::ostream& out) {
+    Checkpoint::writeString(out, m_runName);
+    Checkpoint::write(out, getWrittenSize(m_microtubulePositionFile));
+    Checkpoint::write(out, getWrittenSize(m_barrierCrossingTimeFile));
+    Checkpoint::write(out, getWrittenSize(m_transitionPathFile));
+
+    Checkpoint::write(out, m_writePositionalDistribution);
+    Checkpoint::write(out, m_recordTransitionPaths);
+    Checkpoint::write(out, m_estimateTimeEvolutionAtPeak);
+
+    m_crossingTimeStatistics.writeCheckpoint(out);
+    Checkpoint::write(out, m_lastCrossingTime);
+    Checkpoint::write(out, m_nWrittenTransitionPaths);
+    m_currentTransitionPath.writeCheckpoint(out);
+    Checkpoint::write(out, m_isTrackingPath);
+
+    if (m_writePositionalDistribution) {
+        mp_positionalHistogram->writeCheckpoint(out);
+        mp_reactionCoordinateHistogram->writeCheckpoint(out);
+    }
+    Checkpoint::write(
+            out,
+            static_cast<int64_t>(m_positionAndConfigurationHistogram.size()));
+    for (const Histogram& histogram: m_positionAndConfigurationHistogram) {
+        histogram.writeCheckpoint(out);
+    }
+    Checkpoint::write(
+            out, static_cast<int64_t>(m_transitionPathHistogram.size()));
+    for (const Histogram& histogram: m_transitionPathHistogram) {
+        histogram.writeCheckpoint(out);
+    }
+
+    Checkpoint::write(out, m_currentlyTrackingPeakPos);
+    Checkpoint::write(out, m_currentlyTrackingPeakTime);
+    Checkpoint::write(out, m_timeStepsTrackingPos);
+    Checkpoint::write(out, m_timeStepsTrackingTime);
+    Checkpoint::write(out, static_cast<int64_t>(m_estimatePoints.size()));
+    for (const Statistics& statistics: m_estimatePoints) {
+        statistics.writeCheckpoint(out);
+    }
+    m_diffusionTimeToFinalRegion.writeCheckpoint(out);
+}
+
+void Output::readCheckpoint(std::istream& in) {
+    const std::string previousRunName = Checkpoint::readString(in);
+    int64_t positionFileSize, crossingFileSize, transitionPathFileSize;
+    Checkpoint::read(in, positionFileSize);
+    Checkpoint::read(in, crossingFileSize);
+    Checkpoint::read(in, transitionPathFileSize);
+
+    bool writePositionalDistribution, recordTransitionPaths,
+            estimateTimeEvolutionAtPeak;
+    Checkpoint::read(in, writePositionalDistribution);
+    Checkpoint::read(in, recordTransitionPaths);
+    Checkpoint::read(in, estimateTimeEvolutionAtPeak);
+    if (writePositionalDistribution != m_writePositionalDistribution ||
+        recordTransitionPaths != m_recordTransitionPaths ||
+        estimateTimeEvolutionAtPeak != m_estimateTimeEvolutionAtPeak) {
+        throw GeneralException(
+                "The checkpoint does not match the parameters of this run: it "
+                "was written with other output settings.");
+    }
+
+    m_crossingTimeStatistics.readCheckpoint(in);
+    Checkpoint::read(in, m_lastCrossingTime);
+    Checkpoint::read(in, m_nWrittenTransitionPaths);
+    m_currentTransitionPath.readCheckpoint(in);
+    Checkpoint::read(in, m_isTrackingPath);
+
+    if (m_writePositionalDistribution) {
+        mp_positionalHistogram->readCheckpoint(in);
+        mp_reactionCoordinateHistogram->readCheckpoint(in);
+    }
+    int64_t nHistograms;
+    Checkpoint::read(in, nHistograms);
+    Checkpoint::checkSize(
+            nHistograms,
+            static_cast<int64_t>(m_positionAndConfigurationHistogram.size()),
+            "number of position and configuration histograms");
+    for (Histogram& histogram: m_positionAndConfigurationHistogram) {
+        histogram.readCheckpoint(in);
+    }
+    Checkpoint::read(in, nHistograms);
+    Checkpoint::checkSize(
+            nHistograms,
+            static_cast<int64_t>(m_transitionPathHistogram.size()),
+            "number of transition path histograms");
+    for (Histogram& histogram: m_transitionPathHistogram) {
+        histogram.readCheckpoint(in);
+    }
+
+    Checkpoint::read(in, m_currentlyTrackingPeakPos);
+    Checkpoint::read(in, m_currentlyTrackingPeakTime);
+    Checkpoint::read(in, m_timeStepsTrackingPos);
+    Checkpoint::read(in, m_timeStepsTrackingTime);
+    int64_t nEstimatePoints;
+    Checkpoint::read(in, nEstimatePoints);
+    Checkpoint::checkSize(
+            nEstimatePoints,
+            static_cast<int64_t>(m_estimatePoints.size()),
+            "number of peak dynamics estimates");
+    for (Statistics& statistics: m_estimatePoints) {
+        statistics.readCheckpoint(in);
+    }
+    m_diffusionTimeToFinalRegion.readCheckpoint(in);
+
+    continueFile(
+            m_microtubulePositionFile,
+            ".microtubule_position.txt",
+            previousRunName,
+            positionFileSize);
+    continueFile(
+            m_barrierCrossingTimeFile,
+            ".times_barrier_crossings.txt",
+            previousRunName,
+            crossingFileSize);
+    continueFile(
+            m_transitionPathFile,
+            ".transition_paths.txt",
+            previousRunName,
+            transitionPathFileSize);
 }
@@ -0,0 +1,263 @@
+#include <algorithm> // std::find, std::swap
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/GenericValue.hpp"
+#include "filament-sliding/InputException.hpp"
+#include "filament-sliding/ParameterGrid.hpp"
+#include "filament-sliding/ParameterMap.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+
+ParameterGrid::ParameterGrid(
+        const ParameterMap& baseParameters,
+        const std::string& fileName):
+        m_baseParameters(baseParameters) {
+    std::ifstream file(fileName.c_str());
+    if (!file) {
+        throw InputException(
+                "The sweep specification " + fileName +
+                " could not be opened.");
+    }
+
+    std::vector<std::string> sweptNames;
+    std::string lineText;
+    for (int32_t lineNumber = 1; std::getline(file, lineText); ++lineNumber) {
+        std::istringstream line(lineText);
+        std::string kind;
+        if (!(line >> kind)) {
+            continue; // An empty line
+        }
+        const std::string lineName =
+                "line " + std::to_string(lineNumber) + " of " + fileName;
+
+        const bool zipped = (kind == "zip");
+        if (zipped && !(line >> kind)) {
+            throw InputException("Nothing is zipped on " + lineName + ".");
+        }
+        const Axis axis = readAxis(kind, line, lineText, lineName);
+
+        for (const std::string& name: axis.names) {
+            if (name == "runName" ||
+                std::find(sweptNames.begin(), sweptNames.end(), name) !=
+                        sweptNames.end()) {
+                throw InputException(
+                        "The parameter " + name + " on " + lineName +
+                        " cannot be swept, or is swept twice.");
+            }
+            sweptNames.push_back(name);
+        }
+
+        if (zipped) {
+            if (m_axes.empty() ||
+                m_axes.back().values.front().size() !=
+                        axis.values.front().size()) {
+                throw InputException(
+                        "The axis on " + lineName +
+                        " is zipped to an axis with a different number of "
+                        "values, or to none.");
+            }
+            Axis& previousAxis = m_axes.back();
+            previousAxis.names.insert(
+                    previousAxis.names.end(),
+                    axis.names.begin(),
+                    axis.names.end());
+            previousAxis.values.insert(
+                    previousAxis.values.end(),
+                    axis.values.begin(),
+                    axis.values.end());
+        }
+        else {
+            m_axes.push_back(axis);
+        }
+    }
+
+    // The points are numbered with int32_t
+    double nPoints = 1.0;
+    for (const Axis& axis: m_axes) {
+        nPoints *= static_cast<double>(axis.values.front().size());
+    }
+    if (nPoints > std::numeric_limits<int32_t>::max()) {
+        throw InputException(
+                "The sweep specification " + fileName +
+                " gives too many points.");
+    }
+}
+
+ParameterGrid::~ParameterGrid() {}
+
+ParameterGrid::Axis ParameterGrid::readAxis(
+        const std::string& kind,
+        std::istringstream& line,
+        const std::string& lineText,
+        const std::string& lineName) const {
+    Axis axis;
+    if (kind == "list") {
+        std::string name;
+        line >> name;
+        axis.names.push_back(name);
+        axis.values.emplace_back();
+        std::string value;
+        while (line >> value) {
+            axis.values.back().push_back(value);
+        }
+    }
+    else if (kind == "range" || kind == "logrange") {
+        std::string name;
+        double first;
+        double last;
+        int32_t number;
+        std::string remainder;
+        line >> name >> first >> last >> number;
+        if (line.fail() || (line >> remainder) || number < 1 ||
+            (kind == "logrange" && (first <= 0.0 || last <= 0.0))) {
+            throw InputException(
+                    "The " + kind + " on " + lineName +
+                    " is not of the form " + kind +
+                    " <name> <first> <last> <number>, with positive ends for "
+                    "a logrange.");
+        }
+        axis.names.push_back(name);
+        axis.values.emplace_back();
+        for (int32_t i = 0; i < number; ++i) {
+            const double fraction =
+                    (number == 1) ? 0.0 : static_cast<double>(i) / (number - 1);
+            const double value =
+                    (kind == "range")
+                            ? first + fraction * (last - first)
+                            : first * std::pow(last / first, fraction);
+            axis.values.back().push_back(formatValue(name, value, lineName));
+        }
+    }
+    else if (kind == "latin") {
+        int32_t number;
+        if (!(line >> number) || number < 1) {
+            throw InputException(
+                    "The latin on " + lineName +
+                    " does not start with a positive number of samples.");
+        }
+
+        // Every parameter takes a value from each of the number strata of its
+        // interval once, in an order of its own
+        RandomGenerator generator(lineText);
+        std::string name;
+        double lowest;
+        double highest;
+        while (line >> name) {
+            if (!(line >> lowest >> highest)) {
+                throw InputException(
+                        "The parameter " + name + " of the latin on " +
+                        lineName + " does not have a lowest and highest "
+                                   "value.");
+            }
+            std::vector<int32_t> strata(number);
+            for (int32_t i = 0; i < number; ++i) {
+                strata[i] = i;
+            }
+            for (int32_t i = number - 1; i > 0; --i) {
+                std::swap(strata[i], strata[generator.getUniformInteger(0, i)]);
+            }
+
+            axis.names.push_back(name);
+            axis.values.emplace_back();
+            for (int32_t i = 0; i < number; ++i) {
+                const double fraction =
+                        (strata[i] + generator.getProbability()) / number;
+                const double value = lowest + fraction * (highest - lowest);
+                axis.values.back().push_back(
+                        formatValue(name, value, lineName));
+            }
+        }
+    }
+    else {
+        throw InputException(
+                "The axis " + kind + " on " + lineName +
+                " is not a list, range, logrange or latin.");
+    }
+
+    if (axis.names.empty() || axis.values.front().empty()) {
+        throw InputException(
+                "The " + kind + " on " + lineName +
+                " has a wrong format, or no values.");
+    }
+
+    // Every value is checked on a copy of the base parameters
+    ParameterMap checkedParameters = m_baseParameters;
+    for (std::size_t i = 0; i < axis.names.size(); ++i) {
+        for (const std::string& value: axis.values[i]) {
+            checkedParameters.overrideParameterFromText(axis.names[i], value);
+        }
+    }
+    return axis;
+}
+
+std::string ParameterGrid::formatValue(
+        const std::string& name,
+        const double value,
+        const std::string& lineName) const {
+    switch (m_baseParameters.getType(name)) {
+    case AllowedTypes::INTEGER:
+        return std::to_string(std::lround(value));
+    case AllowedTypes::REAL: {
+        std::ostringstream text;
+        text.precision(std::numeric_limits<double>::max_digits10);
+        text << value;
+        return text.str();
+    }
+    default:
+        throw InputException(
+                "The text parameter " + name + " on " + lineName +
+                " can only be swept by a list.");
+    }
+}
+
+std::vector<int32_t> ParameterGrid::getAxisIndices(int32_t point) const {
+    std::vector<int32_t> indices(m_axes.size());
+    for (std::size_t axis = m_axes.size(); axis-- > 0;) {
+        const int32_t nValues =
+                static_cast<int32_t>(m_axes[axis].values.front().size());
+        indices[axis] = point % nValues;
+        point /= nValues;
+    }
+    return indices;
+}
+
+int32_t ParameterGrid::getNPoints() const {
+    int32_t nPoints = 1;
+    for (const Axis& axis: m_axes) {
+        nPoints *= static_cast<int32_t>(axis.values.front().size());
+    }
+    return nPoints;
+}
+
+ParameterMap ParameterGrid::getPoint(const int32_t point) const {
+    ParameterMap parameters = m_baseParameters;
+    const std::vector<int32_t> indices = getAxisIndices(point);
+    for (std::size_t axis = 0; axis < m_axes.size(); ++axis) {
+        for (std::size_t i = 0; i < m_axes[axis].names.size(); ++i) {
+            parameters.overrideParameterFromText(
+                    m_axes[axis].names[i],
+                    m_axes[axis].values[i][indices[axis]]);
+        }
+    }
+    return parameters;
+}
+
+std::string ParameterGrid::describePoint(const int32_t point) const {
+    std::string description;
+    const std::vector<int32_t> indices = getAxisIndices(point);
+    for (std::size_t axis = 0; axis < m_axes.size(); ++axis) {
+        for (std::size_t i = 0; i < m_axes[axis].names.size(); ++i) {
+            if (!description.empty()) {
+                description += ' ';
+            }
+            description += m_axes[axis].names[i] + '=' +
+                           m_axes[axis].values[i][indices[axis]];
+        }
+    }
+    return description;
+}
@@ -1,6 +1,8 @@
 #include <iomanip> // For std::setw()
 #include <iostream> // For overloading the IO operators
 #include <limits> // For std::numeric_limits
+#include <sstream>
+#include <string>
 
 #include "filament-sliding/GenericValue.hpp" // For overloaded IO operators
 #include "filament-sliding/InputException.hpp"
@@ -35,10 +37,52 @@ std::ostream& operator<<(std::ostream& out, const ParameterMap& parameterMap) {
     return out;
 }
 
+std::string ParameterMap::getValuesAffectingState() const {
+    std::ostringstream values;
+    values.precision(std::numeric_limits<double>::max_digits10);
+    for (const std::string& name: m_parameterOrder) {
+        if (m_runParameters.count(name) == 0) {
+            values << name << ' ' << m_parameterMap.at(name) << '\n';
+        }
+    }
+    return values.str();
+}
+
+void ParameterMap::overrideParameterFromText(
+        const std::string& name,
+        const std::string& text) {
+    const auto parameter = m_parameterMap.find(name);
+    if (parameter == m_parameterMap.end()) {
+        throw InputException {
+                "The parameterMap does not contain a variable with the name " +
+                name + ", which overrideParameterFromText() is trying to "
+                       "access.\n"};
+    }
+    if (!parameter->second.readValue(text)) {
+        throw InputException {
+                "The value " + text + " does not fit the parameter " + name +
+                ".\n"};
+    }
+}
+
+AllowedTypes ParameterMap::getType(const std::string& name) const {
+    const auto parameter = m_parameterMap.find(name);
+    if (parameter == m_parameterMap.end()) {
+        throw InputException {
+                "The parameterMap does not contain a variable with the name " +
+                name + ".\n"};
+    }
+    return parameter->second.getType();
+}
+
 std::istream& operator>>(std::istream& in, ParameterMap& parameterMap) {
     std::string titleLine;
     std::getline(in, titleLine); // Throw this away
 
+    // The possible values are checked against the defaults. Constructing them
+    // once, not for every parameter, keeps reading fast
+    const ParameterMap defaultMap;
+
     for (auto parameterName:
          parameterMap.m_parameterOrder) // For input, the order is also fixed.
                                         // This could be changed
@@ -60,7 +104,7 @@ std::istream& operator>>(std::istream& in, ParameterMap& parameterMap) {
         in >> possibleValues;
 
         if (possibleValues !=
-            ParameterMap().m_possibleValuesMap.at(
+            defaultMap.m_possibleValuesMap.at(
                     parameterName)) // Check if the default ParameterMap
                                     // contains the same possibleValues as the
                                     // one read
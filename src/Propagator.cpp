@@ -1,12 +1,20 @@
+#include <algorithm> // std::find, std::max, std::min
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstdio> // std::rename
+#include <fstream>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <random>
 #include <string>
+#include <type_traits>
 #include <utility> // pair
 
 #include "filament-sliding/BindFreeCrosslinker.hpp"
 #include "filament-sliding/BindPartialCrosslinker.hpp"
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/HopFull.hpp"
 #include "filament-sliding/HopPartial.hpp"
@@ -15,7 +23,11 @@
 #include "filament-sliding/Propagator.hpp"
 #include "filament-sliding/RandomGenerator.hpp"
 #include "filament-sliding/Reaction.hpp"
+#include "filament-sliding/Statistics.hpp"
+#include "filament-sliding/StoragePrecision.hpp"
+#include "filament-sliding/SublatticeDomains.hpp"
 #include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 #include "filament-sliding/UnbindFullCrosslinker.hpp"
 #include "filament-sliding/UnbindPartialCrosslinker.hpp"
 
@@ -48,6 +60,19 @@ Propagator::Propagator(
         const int32_t transitionPathProbePeriod,
         const bool addExternalForce,
         const bool estimateTimeEvolutionAtPeak,
+        const bool coarseGrainDistantPartials,
+        const int32_t coarseGrainingPeriod,
+        const bool validateStoragePrecision,
+        const int32_t checkpointPeriod,
+        const std::string& checkpointFileName,
+        const bool adaptiveEquilibration,
+        const int32_t equilibrationProbePeriod,
+        const double equilibrationTolerance,
+        const double precisionTarget,
+        const std::string& targetStatisticString,
+        const int32_t minNRunBlocks,
+        const int32_t nSublatticeDomains,
+        ThreadPool& threadPool,
         Log& log):
         m_nEquilibrationBlocks(numberEquilibrationBlocks),
         m_nRunBlocks(numberRunBlocks),
@@ -74,7 +99,48 @@ Propagator::Propagator(
                 0), // Counts the number of times diffusion of the mobile
                     // microtubule was reflected at a maximum stretch barrier
         m_log(log),
-        m_basinOfAttractionHalfWidth(0.3 * m_latticeSpacing) {
+        m_basinOfAttractionHalfWidth(0.3 * m_latticeSpacing),
+        m_coarseGrainDistantPartials(coarseGrainDistantPartials),
+        m_coarseGrainingPeriod(coarseGrainingPeriod),
+        m_timeStepsToCoarseGraining(coarseGrainingPeriod),
+        m_validateStoragePrecision(validateStoragePrecision),
+        m_threadPool(threadPool),
+        m_nDomainPhases(0),
+        m_nDomainReactions(0),
+        m_maxNDomainReactionsInPhase(0),
+        m_nConcurrentDomainPhases(0),
+        m_concurrentDomainSeconds(0.0),
+        m_nTimedSerialDomainPhases(0),
+        m_timedSerialDomainSeconds(0.0),
+        m_nFinishedEquilibrationBlocks(0),
+        m_nFinishedRunBlocks(0),
+        m_timeStepInBlock(0),
+        m_timeStepsToNextPositionProbe(0), // A probe is taken at time step 0
+                                           // of each block
+        m_nGraphicsIntervals(0),
+        m_checkpointPeriod(checkpointPeriod),
+        m_checkpointFileName(checkpointFileName),
+        m_timeStepsToCheckpoint(checkpointPeriod),
+        m_stopRequested(false),
+        m_adaptiveEquilibration(adaptiveEquilibration),
+        m_equilibrationProbePeriod(equilibrationProbePeriod),
+        m_timeStepsToNextEquilibrationProbe(0),
+        m_equilibrationMonitor(equilibrationTolerance),
+        m_foundStationary(false),
+        m_precisionTarget(precisionTarget),
+        m_minNRunBlocks(minNRunBlocks) {
+    if (targetStatisticString == "CROSSING_TIME") {
+        m_targetStatistic = Output::TargetStatistic::CROSSING_TIME;
+    }
+    else if (targetStatisticString == "FINAL_REGION_TIME") {
+        m_targetStatistic = Output::TargetStatistic::FINAL_REGION_TIME;
+    }
+    else {
+        throw GeneralException(
+                "In the Propagator constructor, the given "
+                "targetStatisticString does not hold a recognised value.");
+    }
+
     // If no active/dual/partial linkers were set (their number is zero), then
     // set the binding rate to zero.
     const double rateToOneSitePassive =
@@ -210,6 +276,30 @@ Propagator::Propagator(
                     activeHopToPlusBiasEnergy,
                     neighbourBiasEnergy));
 
+    for (auto& reaction: m_reactions) {
+        reaction.second->setThreadPool(&m_threadPool);
+    }
+
+    // The HopPartial reactions are known to be of that type, since they were
+    // created above
+    m_partialHopReactions = {
+            {Crosslinker::Type::PASSIVE,
+             static_cast<const HopPartial*>(
+                     m_reactions.at("hoppingPartialPassiveCrosslinker").get())},
+            {Crosslinker::Type::DUAL,
+             static_cast<const HopPartial*>(
+                     m_reactions.at("hoppingPartialDualCrosslinker").get())},
+            {Crosslinker::Type::ACTIVE,
+             static_cast<const HopPartial*>(
+                     m_reactions.at("hoppingPartialActiveCrosslinker").get())}};
+    m_fullHopReactions = {
+            static_cast<const HopFull*>(
+                    m_reactions.at("hoppingFullPassiveCrosslinker").get()),
+            static_cast<const HopFull*>(
+                    m_reactions.at("hoppingFullDualCrosslinker").get()),
+            static_cast<const HopFull*>(
+                    m_reactions.at("hoppingFullActiveCrosslinker").get())};
+
     // The standard deviation of the average microtubule position update should
     // be much smaller (orders of magnitude smaller) than the lattice spacing,
     // since that sets a scale over which force differences definitely emerge.
@@ -228,6 +318,23 @@ Propagator::Propagator(
     // probability: map probabilities to survival times. Then, draw a random
     // probability to get the survival time.
     setNewReactionRateThreshold(generator.getProbability());
+
+    if (nSublatticeDomains > 0) {
+        mp_domains = std::make_unique<SublatticeDomains>(nSublatticeDomains);
+        for (auto& reaction: m_reactions) {
+            Reaction* const p_reaction = reaction.second.get();
+            if (p_reaction->hasRatePerPossibility()) {
+                p_reaction->setSublatticeDomains(mp_domains.get());
+                m_domainReactions.push_back(p_reaction);
+            }
+            else {
+                m_systemReactions.push_back(p_reaction);
+            }
+        }
+        m_domainActions.assign(nSublatticeDomains, 0.0);
+        m_domainChanges.resize(nSublatticeDomains / 2);
+        restartDomainClocks(generator);
+    }
 }
 
 Propagator::~Propagator() {
@@ -236,6 +343,214 @@ Propagator::~Propagator() {
     // valid:
     m_log.writeBoundaryProtocolAppearance(
             m_nDeterministicBoundaryCrossings, m_nStochasticBoundaryCrossings);
+
+    if (m_threadPool.getNThreads() > 1) {
+        Reaction::RateEvaluationCounts total;
+        for (const auto& reaction: m_reactions) {
+            const Reaction::RateEvaluationCounts& counts =
+                    reaction.second->getRateEvaluationCounts();
+            total.nEvaluations += counts.nEvaluations;
+            total.nConcurrentEvaluations += counts.nConcurrentEvaluations;
+            total.nConcurrentPossibilities += counts.nConcurrentPossibilities;
+            total.concurrentSeconds += counts.concurrentSeconds;
+            total.nTimedSerialEvaluations += counts.nTimedSerialEvaluations;
+            total.nTimedSerialPossibilities +=
+                    counts.nTimedSerialPossibilities;
+            total.timedSerialSeconds += counts.timedSerialSeconds;
+        }
+        // Compared per possibility, since the timed evaluations can be
+        // shorter or longer than the others
+        double speedUp = 0.0;
+        if (total.nConcurrentEvaluations > 0 &&
+            total.nTimedSerialEvaluations > 0 &&
+            total.concurrentSeconds > 0.0) {
+            speedUp = (total.timedSerialSeconds /
+                       static_cast<double>(total.nTimedSerialPossibilities)) /
+                      (total.concurrentSeconds /
+                       static_cast<double>(total.nConcurrentPossibilities));
+        }
+        m_log.writeConcurrentRateEvaluation(
+                m_threadPool.getNThreads(),
+                total.nEvaluations,
+                total.nConcurrentEvaluations,
+                total.nTimedSerialEvaluations,
+                speedUp);
+    }
+
+    if (mp_domains != nullptr) {
+        double speedUp = 0.0;
+        if (m_nConcurrentDomainPhases > 0 && m_nTimedSerialDomainPhases > 0 &&
+            m_concurrentDomainSeconds > 0.0) {
+            speedUp = (m_timedSerialDomainSeconds /
+                       static_cast<double>(m_nTimedSerialDomainPhases)) /
+                      (m_concurrentDomainSeconds /
+                       static_cast<double>(m_nConcurrentDomainPhases));
+        }
+        m_log.writeSublatticeDomains(
+                mp_domains->getNDomains(),
+                m_threadPool.getNThreads(),
+                m_nDomainPhases,
+                m_nDomainReactions,
+                m_maxNDomainReactionsInPhase,
+                m_nTimedSerialDomainPhases,
+                speedUp);
+    }
+
+    if (m_validateStoragePrecision) {
+        m_log.writeStoragePrecisionValidation(
+                std::is_same_v<StorageScalar, float>,
+                m_storagePrecisionForceError);
+    }
+}
+
+void Propagator::copyStateFrom(const Propagator& other) {
+    if (other.m_reactions.size() != m_reactions.size()) {
+        throw GeneralException(
+                "Propagator::copyStateFrom() was called with a propagator "
+                "with other reactions");
+    }
+
+    m_currentTime = other.m_currentTime;
+    m_currentReactionRateThreshold = other.m_currentReactionRateThreshold;
+    m_nDeterministicBoundaryCrossings = other.m_nDeterministicBoundaryCrossings;
+    m_nStochasticBoundaryCrossings = other.m_nStochasticBoundaryCrossings;
+    m_previousBasinOfAttraction = other.m_previousBasinOfAttraction;
+    m_timeStepsToCoarseGraining = other.m_timeStepsToCoarseGraining;
+    m_storagePrecisionForceError = other.m_storagePrecisionForceError;
+
+    for (const auto& reaction: other.m_reactions) {
+        m_reactions.at(reaction.first)->copyStateFrom(*reaction.second);
+    }
+
+    if (other.m_domainActions.size() != m_domainActions.size()) {
+        throw GeneralException(
+                "Propagator::copyStateFrom() was called with a propagator "
+                "with other sublattice domains");
+    }
+    m_domainActions = other.m_domainActions;
+    m_domainThresholds = other.m_domainThresholds;
+    m_domainGenerators = other.m_domainGenerators;
+}
+
+void Propagator::writeCheckpoint(
+        const std::string& fileName,
+        const SystemState& systemState,
+        const RandomGenerator& generator,
+        Output& output) const {
+    const std::string temporaryFileName = fileName + ".tmp";
+    std::ofstream file(temporaryFileName.c_str(), std::ios::binary);
+
+    Checkpoint::writeHeader(file);
+    generator.writeCheckpoint(file);
+    systemState.writeCheckpoint(file);
+
+    Checkpoint::write(file, m_nFinishedEquilibrationBlocks);
+    Checkpoint::write(file, m_nFinishedRunBlocks);
+    Checkpoint::write(file, m_timeStepInBlock);
+    Checkpoint::write(file, m_timeStepsToNextPositionProbe);
+    Checkpoint::write(file, m_timeStepsToCheckpoint);
+    Checkpoint::write(file, m_currentTime);
+    Checkpoint::write(file, m_currentReactionRateThreshold);
+    Checkpoint::write(file, m_nDeterministicBoundaryCrossings);
+    Checkpoint::write(file, m_nStochasticBoundaryCrossings);
+    Checkpoint::write(file, m_previousBasinOfAttraction);
+    Checkpoint::write(file, m_timeStepsToCoarseGraining);
+    Checkpoint::write(file, m_timeStepsToNextEquilibrationProbe);
+    m_equilibrationMonitor.writeCheckpoint(file);
+    m_storagePrecisionForceError.writeCheckpoint(file);
+    Checkpoint::write(file, static_cast<int64_t>(m_reactions.size()));
+    for (const auto& reaction: m_reactions) {
+        Checkpoint::writeString(file, reaction.first);
+        reaction.second->writeCheckpoint(file);
+    }
+    Checkpoint::write(file, static_cast<int64_t>(m_domainActions.size()));
+    for (std::size_t domain = 0; domain < m_domainActions.size(); ++domain) {
+        Checkpoint::write(file, m_domainActions[domain]);
+        Checkpoint::write(file, m_domainThresholds[domain]);
+        m_domainGenerators[domain].writeCheckpoint(file);
+    }
+
+    output.writeCheckpoint(file);
+
+    file.close();
+    if (!file || std::rename(temporaryFileName.c_str(), fileName.c_str())) {
+        throw GeneralException(
+                "The checkpoint " + fileName + " could not be written.");
+    }
+}
+
+void Propagator::readCheckpoint(
+        const std::string& fileName,
+        SystemState& systemState,
+        RandomGenerator& generator,
+        Output& output) {
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    if (!file) {
+        throw GeneralException(
+                "The checkpoint " + fileName + " could not be opened.");
+    }
+
+    Checkpoint::readHeader(file);
+    generator.readCheckpoint(file);
+    systemState.readCheckpoint(file);
+
+    Checkpoint::read(file, m_nFinishedEquilibrationBlocks);
+    Checkpoint::read(file, m_nFinishedRunBlocks);
+    Checkpoint::read(file, m_timeStepInBlock);
+    Checkpoint::read(file, m_timeStepsToNextPositionProbe);
+    Checkpoint::read(file, m_timeStepsToCheckpoint);
+    Checkpoint::read(file, m_currentTime);
+    Checkpoint::read(file, m_currentReactionRateThreshold);
+    Checkpoint::read(file, m_nDeterministicBoundaryCrossings);
+    Checkpoint::read(file, m_nStochasticBoundaryCrossings);
+    Checkpoint::read(file, m_previousBasinOfAttraction);
+    Checkpoint::read(file, m_timeStepsToCoarseGraining);
+    Checkpoint::read(file, m_timeStepsToNextEquilibrationProbe);
+    m_equilibrationMonitor.readCheckpoint(file);
+    m_storagePrecisionForceError.readCheckpoint(file);
+    int64_t nReactions;
+    Checkpoint::read(file, nReactions);
+    Checkpoint::checkSize(
+            nReactions,
+            static_cast<int64_t>(m_reactions.size()),
+            "number of reactions");
+    for (int64_t i = 0; i < nReactions; ++i) {
+        const std::string name = Checkpoint::readString(file);
+        const auto reaction = m_reactions.find(name);
+        if (reaction == m_reactions.end()) {
+            throw GeneralException(
+                    "The checkpoint holds the unknown reaction " + name + ".");
+        }
+        reaction->second->readCheckpoint(file);
+    }
+    int64_t nDomains;
+    Checkpoint::read(file, nDomains);
+    Checkpoint::checkSize(
+            nDomains,
+            static_cast<int64_t>(m_domainActions.size()),
+            "number of sublattice domains");
+    for (std::size_t domain = 0; domain < m_domainActions.size(); ++domain) {
+        Checkpoint::read(file, m_domainActions[domain]);
+        Checkpoint::read(file, m_domainThresholds[domain]);
+        m_domainGenerators[domain].readCheckpoint(file);
+    }
+
+    output.readCheckpoint(file);
+
+    // The blocks of the run in which the checkpoint was written are continued,
+    // while the number of blocks and time steps are those of this run
+    if (m_nFinishedEquilibrationBlocks > m_nEquilibrationBlocks ||
+        m_nFinishedRunBlocks > m_nRunBlocks ||
+        m_timeStepInBlock >= m_nTimeSteps) {
+        throw GeneralException(
+                "The checkpoint was written beyond the blocks of this run.");
+    }
+    // This run may write checkpoints more often
+    if (m_timeStepsToCheckpoint > m_checkpointPeriod) {
+        m_timeStepsToCheckpoint = m_checkpointPeriod;
+    }
+
+    m_log.writeResumedFromCheckpoint(fileName, m_currentTime);
 }
 
 void Propagator::propagateBlock(
@@ -243,42 +558,138 @@ void Propagator::propagateBlock(
         RandomGenerator& generator,
         Output& output,
         const bool writeOutput,
+        const bool writeCheckpoints,
         const int32_t nTimeSteps) {
-    for (int32_t timeStep = 0; timeStep < nTimeSteps; ++timeStep) {
-        if (writeOutput) {
-            if (timeStep % m_positionProbePeriod == 0) {
+    // Decide once per block which observers are active, such that the loop over
+    // the time steps does not need to check the flags every time step. Without
+    // output, none of the observers are needed and a pure physics loop is run.
+    if (!writeOutput) {
+        propagateBlockWithObservers<false, false, false, false>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        return;
+    }
+
+    const int32_t observerCombination =
+            (m_samplePositionalDistribution ? 1 : 0) +
+            (m_estimateTimeEvolutionAtPeak ? 2 : 0) +
+            (m_recordTransitionPaths ? 4 : 0);
+
+    switch (observerCombination) {
+    case 0:
+        propagateBlockWithObservers<true, false, false, false>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        break;
+    case 1:
+        propagateBlockWithObservers<true, true, false, false>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        break;
+    case 2:
+        propagateBlockWithObservers<true, false, true, false>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        break;
+    case 3:
+        propagateBlockWithObservers<true, true, true, false>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        break;
+    case 4:
+        propagateBlockWithObservers<true, false, false, true>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        break;
+    case 5:
+        propagateBlockWithObservers<true, true, false, true>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        break;
+    case 6:
+        propagateBlockWithObservers<true, false, true, true>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        break;
+    case 7:
+        propagateBlockWithObservers<true, true, true, true>(
+                systemState, generator, output, writeCheckpoints, nTimeSteps);
+        break;
+    default:
+        throw GeneralException(
+                "Propagator::propagateBlock() encountered an unknown "
+                "combination of observers");
+    }
+}
+
+template <
+        bool writeOutput,
+        bool samplePositionalDistribution,
+        bool estimateTimeEvolutionAtPeak,
+        bool recordTransitionPaths>
+void Propagator::propagateBlockWithObservers(
+        SystemState& systemState,
+        RandomGenerator& generator,
+        Output& output,
+        const bool writeCheckpoints,
+        const int32_t nTimeSteps) {
+    constexpr bool needsObservables = samplePositionalDistribution ||
+                                      estimateTimeEvolutionAtPeak ||
+                                      recordTransitionPaths;
+
+    // Count down to the next probe of the position, instead of taking the
+    // modulo of the time step every time step.
+    for (; m_timeStepInBlock < nTimeSteps; ++m_timeStepInBlock) {
+        if (writeCheckpoints &&
+            handleCheckpoints(systemState, generator, output)) {
+            return;
+        }
+
+        if constexpr (writeOutput) {
+            if (m_timeStepsToNextPositionProbe == 0) {
                 output.writeMicrotubulePosition(
                         m_currentTime,
                         systemState); // writes the position and the number of
                                       // crosslinkers (the order parameters)
+                if (m_validateStoragePrecision) {
+                    const double linkerForce = systemState.getForce() -
+                                               systemState.getExternalForce();
+                    m_storagePrecisionForceError.addValue(
+                            linkerForce -
+                            systemState.findLinkerForceInDoublePrecision());
+                }
+                m_timeStepsToNextPositionProbe = m_positionProbePeriod;
+            }
+            --m_timeStepsToNextPositionProbe;
+        }
+        else if (m_adaptiveEquilibration) {
+            // Only the equilibration blocks are run without output
+            if (m_timeStepsToNextEquilibrationProbe == 0) {
+                m_equilibrationMonitor.addSample(systemState);
+                m_timeStepsToNextEquilibrationProbe =
+                        m_equilibrationProbePeriod;
             }
+            --m_timeStepsToNextEquilibrationProbe;
+        }
+
+        if constexpr (needsObservables) {
+            // The observables are shared by all observers, so calculate them
+            // once per time step. Counting the right pulling linkers loops over
+            // all full linkers, so it should not be repeated either.
+            const double position = systemState.getMicrotubulePosition();
+            const double remainder =
+                    MathematicalFunctions::mod(position, m_latticeSpacing);
+            const int32_t nRightLinkers =
+                    systemState.getNFullRightPullingCrosslinkers();
+
             // Add the microtubule positions more often than the
             // m_positionProbePeriod, since it is not directly written to a file
             // (not slow), and it requires much data.
-            if (m_samplePositionalDistribution) {
-                output.addPositionAndConfiguration(
-                        MathematicalFunctions::mod(
-                                systemState.getMicrotubulePosition(),
-                                m_latticeSpacing),
-                        systemState.getNFullRightPullingCrosslinkers());
+            if constexpr (samplePositionalDistribution) {
+                output.addPositionAndConfiguration(remainder, nRightLinkers);
             }
 
-            if (m_estimateTimeEvolutionAtPeak) {
-                output.addTimeStepToPeakAnalysis(
-                        MathematicalFunctions::mod(
-                                systemState.getMicrotubulePosition(),
-                                m_latticeSpacing),
-                        systemState.getNFullRightPullingCrosslinkers());
+            if constexpr (estimateTimeEvolutionAtPeak) {
+                output.addTimeStepToPeakAnalysis(remainder, nRightLinkers);
             }
 
-            if (m_recordTransitionPaths) {
-                const double position = systemState.getMicrotubulePosition();
-                const int32_t nRightLinkers =
-                        systemState.getNFullRightPullingCrosslinkers();
+            if constexpr (recordTransitionPaths) {
                 const int32_t nFullLinkers = systemState.getNFullCrosslinkers();
 
                 if (!inBasinOfAttraction(
-                            position, nRightLinkers, nFullLinkers)) {
+                            remainder, nRightLinkers, nFullLinkers)) {
                     if (!output.isTrackingPath()) {
                         output.toggleTracking();
                         // At the first m_transitionPathProbePeriod out of the
@@ -318,12 +729,20 @@ void Propagator::propagateBlock(
 
         advanceTimeStep(systemState, generator);
 
-        // Check if a barrier crossing took place
+        if (m_coarseGrainDistantPartials &&
+            --m_timeStepsToCoarseGraining == 0) {
+            moveDistantPartialLinkers(systemState, generator);
+            m_timeStepsToCoarseGraining = m_coarseGrainingPeriod;
+        }
+
+        // Check if a barrier crossing took place. This needs to be called also
+        // when no output is written, since it keeps track of the current
+        // attractor of the mobile microtubule.
         const int32_t barrierCrossingDirection =
                 systemState
                         .barrierCrossed(); // returns 0 if no barrier is crossed
-        if (barrierCrossingDirection != 0) {
-            if (writeOutput) {
+        if constexpr (writeOutput) {
+            if (barrierCrossingDirection != 0) {
                 output.writeBarrierCrossingTime(
                         m_currentTime, barrierCrossingDirection);
             }
@@ -331,12 +750,44 @@ void Propagator::propagateBlock(
     }
 }
 
+void Propagator::endBlock() {
+    m_timeStepInBlock = 0;
+    m_timeStepsToNextPositionProbe = 0;
+}
+
+bool Propagator::handleCheckpoints(
+        SystemState& systemState,
+        RandomGenerator& generator,
+        Output& output) {
+    // The checkpoint is written before the counter is decremented for this
+    // time step, which the resumed run starts with
+    const bool checkpointIsDue =
+            (m_checkpointPeriod > 0 && m_timeStepsToCheckpoint == 0);
+    const Checkpoint::Request request = Checkpoint::takeRequest();
+    if (checkpointIsDue) {
+        m_timeStepsToCheckpoint = m_checkpointPeriod;
+    }
+    if (checkpointIsDue || request != Checkpoint::Request::NONE) {
+        writeCheckpoint(m_checkpointFileName, systemState, generator, output);
+    }
+    if (m_checkpointPeriod > 0) {
+        --m_timeStepsToCheckpoint;
+    }
+
+    if (request != Checkpoint::Request::NONE) {
+        m_stopRequested = (request == Checkpoint::Request::STOP);
+        m_log.writeRequestedCheckpoint(
+                m_checkpointFileName, m_currentTime, m_stopRequested);
+    }
+    return m_stopRequested;
+}
+
+// The remainder is the position of the mobile microtubule modulo the lattice
+// spacing, which the caller has already calculated
 bool Propagator::inBasinOfAttraction(
-        const double mobilePosition,
+        const double remainder,
         const int32_t nRightPullingCrosslinkers,
         const int32_t nFullCrosslinkers) const {
-    const double remainder =
-            MathematicalFunctions::mod(mobilePosition, m_latticeSpacing);
     return ((remainder < m_basinOfAttractionHalfWidth) &&
             (nRightPullingCrosslinkers <= 1)) ||
            ((remainder > m_latticeSpacing - m_basinOfAttractionHalfWidth) &&
@@ -348,44 +799,259 @@ void Propagator::equilibrate(
         RandomGenerator& generator,
         Output& output) {
     constexpr bool writeOutput = false;
-    for (int32_t blockNumber = 0; blockNumber < m_nEquilibrationBlocks;
-         ++blockNumber) {
+    constexpr bool writeCheckpoints = true;
+    while (!m_stopRequested &&
+           m_nFinishedEquilibrationBlocks < m_nEquilibrationBlocks) {
         propagateBlock(
-                systemState, generator, output, writeOutput, m_nTimeSteps);
+                systemState,
+                generator,
+                output,
+                writeOutput,
+                writeCheckpoints,
+                m_nTimeSteps);
+        if (!m_stopRequested) {
+            endBlock();
+            ++m_nFinishedEquilibrationBlocks;
+            if (m_adaptiveEquilibration) {
+                checkStationarity();
+            }
+        }
     }
 }
 
+void Propagator::checkStationarity() {
+    const bool isStationary = m_equilibrationMonitor.isStationary();
+    if (isStationary ||
+        m_nFinishedEquilibrationBlocks == m_nEquilibrationBlocks) {
+        m_log.writeEquilibrationDetection(
+                isStationary,
+                m_nFinishedEquilibrationBlocks,
+                m_nEquilibrationBlocks,
+                static_cast<double>(m_nFinishedEquilibrationBlocks) *
+                        m_nTimeSteps * m_calcTimeStep,
+                m_equilibrationMonitor);
+    }
+    // The run blocks start right away, at time 0
+    if (isStationary) {
+        m_foundStationary = true;
+        skipEquilibration();
+    }
+}
+
+void Propagator::skipEquilibration() {
+    m_nFinishedEquilibrationBlocks = m_nEquilibrationBlocks;
+    m_timeStepInBlock = 0;
+    m_currentTime = 0.0;
+}
+
+bool Propagator::isEquilibrated() const {
+    return m_nFinishedEquilibrationBlocks == m_nEquilibrationBlocks;
+}
+
+bool Propagator::hasStationaryState() const {
+    return isEquilibrated() && (!m_adaptiveEquilibration || m_foundStationary);
+}
+
 void Propagator::run(
         SystemState& systemState,
         RandomGenerator& generator,
         Output& output) {
     constexpr bool writeOutput = true;
-    for (int32_t blockNumber = 0; blockNumber < m_nRunBlocks; ++blockNumber) {
-        output.newBlock(blockNumber + 1);
+    constexpr bool writeCheckpoints = true;
+    while (!m_stopRequested && m_nFinishedRunBlocks < m_nRunBlocks) {
+        // A block that is continued from a checkpoint has already started
+        if (m_timeStepInBlock == 0) {
+            output.newBlock(m_nFinishedRunBlocks + 1);
+        }
         propagateBlock(
-                systemState, generator, output, writeOutput, m_nTimeSteps);
+                systemState,
+                generator,
+                output,
+                writeOutput,
+                writeCheckpoints,
+                m_nTimeSteps);
+        if (!m_stopRequested) {
+            endBlock();
+            ++m_nFinishedRunBlocks;
+            if (m_precisionTarget > 0.0 && checkPrecision(output)) {
+                break;
+            }
+        }
     }
 }
 
+bool Propagator::checkPrecision(const Output& output) {
+    if (m_nFinishedRunBlocks < m_minNRunBlocks) {
+        return false;
+    }
+    const double relativeSEM = output.getRelativeSEM(m_targetStatistic);
+    const bool isReached = (relativeSEM <= m_precisionTarget);
+    if (isReached || m_nFinishedRunBlocks == m_nRunBlocks) {
+        m_log.writePrecisionTarget(
+                isReached,
+                m_nFinishedRunBlocks,
+                m_nRunBlocks,
+                m_currentTime,
+                relativeSEM,
+                m_precisionTarget);
+    }
+    return isReached;
+}
+
 void Propagator::propagateGraphicsInterval(
         SystemState& systemState,
         RandomGenerator& generator,
         Output& output,
         const int32_t nTimeStepsInterval) {
     constexpr bool writeOutput = true;
-    static int32_t intervalNumber = 0;
-    ++intervalNumber;
-    output.newBlock(intervalNumber);
+    constexpr bool writeCheckpoints = false;
+    ++m_nGraphicsIntervals;
+    output.newBlock(m_nGraphicsIntervals);
     propagateBlock(
-            systemState, generator, output, writeOutput, nTimeStepsInterval);
+            systemState,
+            generator,
+            output,
+            writeOutput,
+            writeCheckpoints,
+            nTimeStepsInterval);
+    endBlock();
+}
+
+bool Propagator::propagateInterval(
+        SystemState& systemState,
+        RandomGenerator& generator,
+        Output& output,
+        const int32_t nTimeStepsInterval) {
+    constexpr bool writeCheckpoints = false;
+    int32_t nTimeStepsLeft = nTimeStepsInterval;
+    while (nTimeStepsLeft > 0 && m_nFinishedRunBlocks < m_nRunBlocks) {
+        const bool writeOutput =
+                (m_nFinishedEquilibrationBlocks == m_nEquilibrationBlocks);
+        if (writeOutput && m_timeStepInBlock == 0) {
+            output.newBlock(m_nFinishedRunBlocks + 1);
+        }
+
+        const int32_t stopTimeStep =
+                std::min(m_nTimeSteps, m_timeStepInBlock + nTimeStepsLeft);
+        nTimeStepsLeft -= stopTimeStep - m_timeStepInBlock;
+        propagateBlock(
+                systemState,
+                generator,
+                output,
+                writeOutput,
+                writeCheckpoints,
+                stopTimeStep);
+        if (stopTimeStep == m_nTimeSteps) {
+            endBlock();
+            if (writeOutput) {
+                ++m_nFinishedRunBlocks;
+            }
+            else {
+                ++m_nFinishedEquilibrationBlocks;
+            }
+        }
+    }
+    return m_nFinishedRunBlocks < m_nRunBlocks;
 }
 
 void Propagator::advanceTimeStep(
         SystemState& systemState,
         RandomGenerator& generator) {
-    // First, update the reaction rates and actions, and perform a reaction when
-    // the total action surpasses the threshold. Then, move the mobile
+    // First, perform a reaction when it is due. Then, move the mobile
     // microtubule at the end of the time step
+    performReactionWhenDue(systemState, generator);
+    moveMicrotubule(
+            systemState,
+            generator,
+            generator.getGaussian(0.0, m_deviationMicrotubule));
+    m_currentTime += m_calcTimeStep;
+}
+
+int32_t Propagator::advanceCoupledTimeStep(
+        SystemState& systemState,
+        RandomGenerator& generator,
+        const double standardNormal) {
+    performReactionWhenDue(systemState, generator);
+    moveMicrotubule(
+            systemState, generator, standardNormal * m_deviationMicrotubule);
+    m_currentTime += m_calcTimeStep;
+
+    if (m_coarseGrainDistantPartials && --m_timeStepsToCoarseGraining == 0) {
+        moveDistantPartialLinkers(systemState, generator);
+        m_timeStepsToCoarseGraining = m_coarseGrainingPeriod;
+    }
+    return systemState.barrierCrossed();
+}
+
+void Propagator::restartReactionClock(RandomGenerator& generator) {
+    resetAction();
+    setNewReactionRateThreshold(generator.getProbability());
+    if (mp_domains != nullptr) {
+        restartDomainClocks(generator);
+    }
+}
+
+void Propagator::restartDomainClocks(RandomGenerator& generator) {
+    const int32_t nDomains = mp_domains->getNDomains();
+    m_domainGenerators.clear();
+    m_domainThresholds.clear();
+    for (int32_t domain = 0; domain < nDomains; ++domain) {
+        const int32_t seed = generator.getUniformInteger(
+                0, std::numeric_limits<int32_t>::max());
+        m_domainGenerators.emplace_back(std::to_string(seed));
+        m_domainActions[domain] = 0.0;
+        // See setNewReactionRateThreshold
+        m_domainThresholds.push_back(
+                -std::log(m_domainGenerators.back().getProbability()) /
+                m_calcTimeStep);
+    }
+}
+
+double Propagator::getCalcTimeStep() const { return m_calcTimeStep; }
+
+Propagator::LockstepRates Propagator::findLockstepRates(
+        const SystemState& systemState) {
+    setRates(systemState);
+
+    LockstepRates rates {0.0, 0.0, 0.0};
+    for (const auto& reaction: m_reactions) {
+        const Reaction* const p_reaction = reaction.second.get();
+        if (std::find(
+                    m_fullHopReactions.begin(),
+                    m_fullHopReactions.end(),
+                    p_reaction) == m_fullHopReactions.end()) {
+            rates.otherReactions += p_reaction->getCurrentRate();
+        }
+    }
+    for (const HopFull* const p_hopReaction: m_fullHopReactions) {
+        const std::pair<double, double> fullHopRates =
+                p_hopReaction->getCurrentRatesByExtensionChange(systemState);
+        rates.fullHopsIncreasingExtension += fullHopRates.first;
+        rates.fullHopsDecreasingExtension += fullHopRates.second;
+    }
+    return rates;
+}
+
+void Propagator::performLockstepReaction(
+        SystemState& systemState,
+        RandomGenerator& generator) {
+    setRates(systemState);
+    getReactionToHappen(generator).performReaction(systemState, generator);
+    systemState.updateForceAndEnergy();
+}
+
+void Propagator::performReactionWhenDue(
+        SystemState& systemState,
+        RandomGenerator& generator) {
+    if (mp_domains != nullptr) {
+        if (performReactionsInDomainsWhenDue(systemState, generator)) {
+            systemState.updateForceAndEnergy();
+        }
+        return;
+    }
+
+    // Update the reaction rates and actions, and perform a reaction when the
+    // total action surpasses the threshold
     setRates(systemState);
     updateAction();
     if (getTotalAction() > m_currentReactionRateThreshold) {
@@ -393,13 +1059,164 @@ void Propagator::advanceTimeStep(
                 systemState,
                 generator); // also updates the force and action
     }
-    moveMicrotubule(systemState, generator);
-    m_currentTime += m_calcTimeStep;
 }
 
-void Propagator::moveMicrotubule(
+bool Propagator::performReactionsInDomainsWhenDue(
         SystemState& systemState,
         RandomGenerator& generator) {
+    // The reactions without a rate per possibility fire as without domains,
+    // but only among themselves
+    double totalAction = 0.0;
+    double totalRate = 0.0;
+    for (Reaction* const p_reaction: m_systemReactions) {
+        p_reaction->setCurrentRate(systemState);
+        p_reaction->updateAction();
+        totalAction += p_reaction->getAction();
+        totalRate += p_reaction->getCurrentRate();
+    }
+    bool reactionMade = false;
+    if (totalAction > m_currentReactionRateThreshold) {
+        const double randomNumber = generator.getUniform(0.0, totalRate);
+        double accumulatedRate = 0.0;
+        for (Reaction* const p_reaction: m_systemReactions) {
+            accumulatedRate += p_reaction->getCurrentRate();
+            if (accumulatedRate > randomNumber) {
+                p_reaction->performReaction(systemState, generator);
+                reactionMade = true;
+                break;
+            }
+        }
+        if (!reactionMade) {
+            throw GeneralException(
+                    "Something went wrong in "
+                    "Propagator::performReactionsInDomainsWhenDue()");
+        }
+        for (Reaction* const p_reaction: m_systemReactions) {
+            p_reaction->resetAction();
+        }
+        setNewReactionRateThreshold(generator.getProbability());
+    }
+
+    // A reaction in a domain of one colour changes the rates in the
+    // neighbouring domains, which are found anew before those take their turn
+    setDomainRates(systemState);
+    const bool evenDomainReactionMade =
+            performReactionsInDomainsOfColour(systemState, 0);
+    if (evenDomainReactionMade) {
+        setDomainRates(systemState);
+    }
+    const bool oddDomainReactionMade =
+            performReactionsInDomainsOfColour(systemState, 1);
+    return reactionMade || evenDomainReactionMade || oddDomainReactionMade;
+}
+
+void Propagator::setDomainRates(const SystemState& systemState) {
+    mp_domains->setSystemState(systemState);
+    for (Reaction* const p_reaction: m_domainReactions) {
+        p_reaction->setCurrentRate(systemState);
+    }
+}
+
+bool Propagator::performReactionsInDomainsOfColour(
+        SystemState& systemState,
+        const int32_t colour) {
+    // One in this many phases that can be split over the threads is timed on
+    // the calling thread, to compare against
+    constexpr int64_t serialTimingPeriod = 64;
+
+    // The clocks are advanced first. Only the domains at which a reaction is
+    // due need to choose one
+    m_dueDomains.clear();
+    for (int32_t domain = colour; domain < mp_domains->getNDomains();
+         domain += 2) {
+        for (const Reaction* const p_reaction: m_domainReactions) {
+            m_domainActions[domain] += p_reaction->getDomainRate(domain);
+        }
+        if (m_domainActions[domain] > m_domainThresholds[domain]) {
+            m_dueDomains.push_back(domain);
+        }
+    }
+    ++m_nDomainPhases;
+    if (m_dueDomains.empty()) {
+        return false;
+    }
+
+    // Each domain only reads the SystemState, and has random numbers of its
+    // own, such that the choices do not depend on the threads
+    const std::function<void(int32_t)> chooseInDomain =
+            [&](const int32_t due) {
+                const int32_t domain = m_dueDomains[due];
+                RandomGenerator& domainGenerator = m_domainGenerators[domain];
+                double domainRate = 0.0;
+                for (const Reaction* const p_reaction: m_domainReactions) {
+                    domainRate += p_reaction->getDomainRate(domain);
+                }
+                const double randomNumber =
+                        domainGenerator.getUniform(0.0, domainRate);
+                double accumulatedRate = 0.0;
+                for (const Reaction* const p_reaction: m_domainReactions) {
+                    accumulatedRate += p_reaction->getDomainRate(domain);
+                    if (accumulatedRate > randomNumber) {
+                        m_domainChanges[due] =
+                                p_reaction->chooseReactionInDomain(
+                                        systemState, domainGenerator, domain);
+                        break;
+                    }
+                }
+                m_domainActions[domain] = 0.0;
+                // See setNewReactionRateThreshold
+                m_domainThresholds[domain] =
+                        -std::log(domainGenerator.getProbability()) /
+                        m_calcTimeStep;
+            };
+
+    const int32_t nDueDomains = static_cast<int32_t>(m_dueDomains.size());
+    const bool concurrent = (m_threadPool.getNThreads() > 1 && nDueDomains > 1);
+    const bool timeSerially =
+            concurrent &&
+            ((m_nConcurrentDomainPhases + m_nTimedSerialDomainPhases) %
+                     serialTimingPeriod ==
+             0);
+    const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    if (concurrent && !timeSerially) {
+        m_threadPool.parallelFor(nDueDomains, chooseInDomain);
+    }
+    else {
+        for (int32_t due = 0; due < nDueDomains; ++due) {
+            chooseInDomain(due);
+        }
+    }
+    if (concurrent) {
+        const double seconds = std::chrono::duration<double>(
+                                       std::chrono::steady_clock::now() - start)
+                                       .count();
+        if (timeSerially) {
+            ++m_nTimedSerialDomainPhases;
+            m_timedSerialDomainSeconds += seconds;
+        }
+        else {
+            ++m_nConcurrentDomainPhases;
+            m_concurrentDomainSeconds += seconds;
+        }
+    }
+
+    // The reactions in domains of one colour do not interfere, and are made in
+    // the order of the domains
+    for (int32_t due = 0; due < nDueDomains; ++due) {
+        m_domainChanges[due](systemState);
+        m_domainChanges[due] = nullptr;
+    }
+    m_nDomainReactions += nDueDomains;
+    m_maxNDomainReactionsInPhase =
+            std::max(m_maxNDomainReactionsInPhase, nDueDomains);
+    return true;
+}
+
+void Propagator::moveMicrotubule(
+        SystemState& systemState,
+        RandomGenerator& generator,
+        const double gaussianChange) {
     std::pair<double, double> exclusiveMovementBorders =
             systemState.movementBordersSetByFullLinkers();
 
@@ -430,12 +1247,12 @@ void Propagator::moveMicrotubule(
     double deterministicChange =
             (numberFullLinkers != 0) ?
                     ((totalExtension -
-                      systemState.findExternalForce() / m_springConstant) /
+                      systemState.getExternalForce() / m_springConstant) /
                      numberFullLinkers *
                      std::expm1(
                              -numberFullLinkers * m_springConstant *
                              m_diffusionConstantMicrotubule * m_calcTimeStep)) :
-                    (systemState.findExternalForce() *
+                    (systemState.getExternalForce() *
                      m_diffusionConstantMicrotubule * m_calcTimeStep);
 
     // Check if the deterministic change is breaking the boundaries; if so:
@@ -468,9 +1285,9 @@ void Propagator::moveMicrotubule(
     exclusiveMovementBorders.first -= deterministicChange;
     exclusiveMovementBorders.second -= deterministicChange;
 
-    // Use a reflecting boundary condition for the random change. First,
-    // calculate the Gaussian change.
-    double randomChange = generator.getGaussian(0.0, m_deviationMicrotubule);
+    // Use a reflecting boundary condition for the random change, which is
+    // Gaussian with deviation m_deviationMicrotubule.
+    double randomChange = gaussianChange;
 
     // If the change breaks a barrier, reflect it around that barrier.
     // The while loop is there to check if a double reflection is necessary
@@ -491,9 +1308,86 @@ void Propagator::moveMicrotubule(
     }
 
     systemState.updateMobilePosition(deterministicChange + randomChange);
+    if (systemState.hasFixedLatticeWindow()) {
+        systemState.updateFixedLatticeWindow(generator);
+    }
     systemState.updateForceAndEnergy();
 }
 
+void Propagator::moveDistantPartialLinkers(
+        SystemState& systemState,
+        RandomGenerator& generator) {
+    const double coarseGrainingTime = m_coarseGrainingPeriod * m_calcTimeStep;
+
+    for (const auto& typeAndReaction: m_partialHopReactions) {
+        const Crosslinker::Type type = typeAndReaction.first;
+        const HopPartial& hopReaction = *typeAndReaction.second;
+
+        // The linkers are moved one by one, each against the others at their
+        // current positions. In a random order, no linker moves first every
+        // time
+        std::vector<Crosslinker*> distantLinkers =
+                systemState.getDistantPartialLinkers(type);
+        const int32_t nDistantLinkers =
+                static_cast<int32_t>(distantLinkers.size());
+        for (int32_t i = nDistantLinkers - 1; i > 0; --i) {
+            std::swap(
+                    distantLinkers[i],
+                    distantLinkers[generator.getUniformInteger(0, i)]);
+        }
+
+        for (Crosslinker* const p_linker: distantLinkers) {
+            const Crosslinker::Terminus terminus =
+                    p_linker->getBoundTerminusWhenPartiallyConnected();
+            const SiteLocation origin =
+                    p_linker->getBoundLocationWhenPartiallyConnected();
+
+            // Distant linkers are on the fixed microtubule, where a forward
+            // hop (towards the plus tip) raises the site position. Without
+            // cooperativity, the rates do not depend on the neighbours, so
+            // the hop attempts over the period are Poisson distributed, each
+            // forward with the fraction of the forward rate. An attempt
+            // towards an occupied site is rejected, which is exact as long as
+            // the neighbours stay where they are. The attempts are made one at
+            // a time, and once the linker is no longer distant, the rest of
+            // its attempts are dropped: from then on, its hops are made by
+            // the HopPartial reaction again.
+            const double forwardRate = hopReaction.getRateToHop(
+                    terminus, HopDirection::FORWARD, false);
+            const double backwardRate = hopReaction.getRateToHop(
+                    terminus, HopDirection::BACKWARD, false);
+            const int32_t nHopAttempts = generator.getPoisson(
+                    (forwardRate + backwardRate) * coarseGrainingTime);
+            if (nHopAttempts == 0) {
+                continue;
+            }
+            const double forwardProbability =
+                    forwardRate / (forwardRate + backwardRate);
+            int32_t newPosition = origin.position;
+            for (int32_t attempt = 0; attempt < nHopAttempts; ++attempt) {
+                const int32_t direction =
+                        generator.getBernoulli(forwardProbability) ? 1 : -1;
+                newPosition = systemState.getPositionAfterHop(
+                        origin, newPosition, direction);
+                if (!systemState.isDistantSite(
+                            type,
+                            SiteLocation {origin.microtubule, newPosition})) {
+                    break;
+                }
+            }
+            if (newPosition != origin.position) {
+                // Implement the move as a combination of unbinding and
+                // binding, like a single hop
+                systemState.disconnectPartiallyConnectedCrosslinker(*p_linker);
+                systemState.connectFreeCrosslinker(
+                        type,
+                        terminus,
+                        SiteLocation {origin.microtubule, newPosition});
+            }
+        }
+    }
+}
+
 void Propagator::performReaction(
         SystemState& systemState,
         RandomGenerator& generator) {
@@ -502,10 +1396,9 @@ void Propagator::performReaction(
     setNewReactionRateThreshold(generator.getProbability());
     systemState.updateForceAndEnergy();
 #ifdef MYDEBUG
-    static int32_t numberOfReactions = 1;
-    ++numberOfReactions;
-    std::cout << "A reaction happened, so far we've seen " << numberOfReactions
-              << " reactions.\n";
+    ++m_nPerformedReactions;
+    std::cout << "A reaction happened, so far we've seen "
+              << m_nPerformedReactions << " reactions.\n";
 #endif // MYDEBUG
 }
 
@@ -1,5 +1,11 @@
+#include <istream>
+#include <ostream>
 #include <random>
+#include <sstream>
+#include <string>
 
+#include "filament-sliding/Checkpoint.hpp"
+#include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/RandomGenerator.hpp"
 
 RandomGenerator::RandomGenerator(const std::string seedString):
@@ -13,6 +19,23 @@ RandomGenerator::RandomGenerator(const std::string seedString):
 
 RandomGenerator::~RandomGenerator() {}
 
+// The standard library only defines the text representation of the state of
+// the engine, which is stored as a string
+void RandomGenerator::writeCheckpoint(std::ostream& out) const {
+    std::ostringstream state;
+    state << m_generator;
+    Checkpoint::writeString(out, state.str());
+}
+
+void RandomGenerator::readCheckpoint(std::istream& in) {
+    std::istringstream state(Checkpoint::readString(in));
+    if (!(state >> m_generator)) {
+        throw GeneralException(
+                "The state of the random generator could not be read from the "
+                "checkpoint.");
+    }
+}
+
 std::mt19937_64& RandomGenerator::getBareGenerator() { return m_generator; }
 
 double RandomGenerator::getGaussian(const double mean, const double deviation) {
@@ -37,6 +60,14 @@ double RandomGenerator::getUniform(
     return distribution(m_generator);
 }
 
+int32_t RandomGenerator::getPoisson(const double mean) {
+    if (mean <= 0.0) {
+        return 0;
+    }
+    std::poisson_distribution<int32_t> distribution(mean);
+    return distribution(m_generator);
+}
+
 int32_t RandomGenerator::getUniformInteger(
         const int32_t inclusiveLowerBound,
         const int32_t inclusiveUpperBound) {
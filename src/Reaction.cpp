@@ -1,6 +1,26 @@
+#include <algorithm> // std::fill, std::min
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <numeric> // std::accumulate
+#include <ostream>
+#include <vector>
+
+#include "filament-sliding/Checkpoint.hpp"
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/MicrotubuleType.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
 #include "filament-sliding/Reaction.hpp"
+#include "filament-sliding/SublatticeDomains.hpp"
+#include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 
-Reaction::Reaction() {
+Reaction::Reaction():
+        m_currentRate(0.0),
+        mp_threadPool(nullptr),
+        mp_domains(nullptr) {
     resetAction(); // set initial action to zero
 }
 
@@ -8,6 +28,21 @@ Reaction::~Reaction() {}
 
 void Reaction::resetAction() { m_action = 0.0; }
 
+void Reaction::copyStateFrom(const Reaction& other) {
+    m_currentRate = other.m_currentRate;
+    m_action = other.m_action;
+}
+
+void Reaction::writeCheckpoint(std::ostream& out) const {
+    Checkpoint::write(out, m_currentRate);
+    Checkpoint::write(out, m_action);
+}
+
+void Reaction::readCheckpoint(std::istream& in) {
+    Checkpoint::read(in, m_currentRate);
+    Checkpoint::read(in, m_action);
+}
+
 double Reaction::getAction() const { return m_action; }
 
 void Reaction::updateAction() {
@@ -19,3 +54,133 @@ void Reaction::updateAction() {
 }
 
 double Reaction::getCurrentRate() const { return m_currentRate; }
+
+void Reaction::setThreadPool(ThreadPool* const p_threadPool) {
+    mp_threadPool = p_threadPool;
+}
+
+const Reaction::RateEvaluationCounts& Reaction::getRateEvaluationCounts()
+        const {
+    return m_rateEvaluationCounts;
+}
+
+bool Reaction::hasRatePerPossibility() const { return false; }
+
+void Reaction::setSublatticeDomains(const SublatticeDomains* const p_domains) {
+    mp_domains = p_domains;
+    m_domainRates.assign(mp_domains->getNDomains(), 0.0);
+}
+
+double Reaction::getDomainRate(const int32_t domain) const {
+    return m_domainRates[domain];
+}
+
+std::function<void(SystemState&)> Reaction::chooseReactionInDomain(
+        const SystemState&,
+        RandomGenerator&,
+        const int32_t) const {
+    throw GeneralException(
+            "Reaction::chooseReactionInDomain() was called for a reaction "
+            "without a rate per possibility");
+}
+
+void Reaction::forEachRateChunk(
+        const std::size_t nPossibilities,
+        const std::function<void(std::size_t, std::size_t)>& setRatesInChunk) {
+    // Waking up the workers costs a few microseconds, so a chunk should hold
+    // many possibilities for the concurrency to pay off
+    constexpr std::size_t minPossibilitiesPerChunk = 512;
+    // One in this many evaluations that could be split is timed on the calling
+    // thread instead, to compare against
+    constexpr int64_t serialTimingPeriod = 64;
+
+    if (mp_domains != nullptr) {
+        m_possibilityDomains.resize(nPossibilities);
+    }
+
+    RateEvaluationCounts& counts = m_rateEvaluationCounts;
+    ++counts.nEvaluations;
+    if (mp_threadPool == nullptr || mp_threadPool->getNThreads() == 1 ||
+        nPossibilities < 2 * minPossibilitiesPerChunk) {
+        setRatesInChunk(0, nPossibilities);
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+    const bool timeSerially = ((counts.nConcurrentEvaluations +
+                                counts.nTimedSerialEvaluations) %
+                                       serialTimingPeriod ==
+                               0);
+    if (timeSerially) {
+        setRatesInChunk(0, nPossibilities);
+    }
+    else {
+        const std::size_t nChunks = std::min(
+                static_cast<std::size_t>(mp_threadPool->getNThreads()),
+                nPossibilities / minPossibilitiesPerChunk);
+        const std::function<void(int32_t)> setRatesInChunkNumber =
+                [&](const int32_t chunk) {
+                    setRatesInChunk(
+                            nPossibilities * chunk / nChunks,
+                            nPossibilities * (chunk + 1) / nChunks);
+                };
+        mp_threadPool->parallelFor(
+                static_cast<int32_t>(nChunks), setRatesInChunkNumber);
+    }
+    const double seconds = std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+
+    if (timeSerially) {
+        ++counts.nTimedSerialEvaluations;
+        counts.nTimedSerialPossibilities +=
+                static_cast<int64_t>(nPossibilities);
+        counts.timedSerialSeconds += seconds;
+    }
+    else {
+        ++counts.nConcurrentEvaluations;
+        counts.nConcurrentPossibilities +=
+                static_cast<int64_t>(nPossibilities);
+        counts.concurrentSeconds += seconds;
+    }
+}
+
+void Reaction::setPossibilityDomain(
+        const std::size_t label,
+        const SiteLocation& location) {
+    m_possibilityDomains[label] = mp_domains->findDomain(location);
+}
+
+double Reaction::sumRates(const std::vector<double>& individualRates) {
+    if (mp_domains != nullptr) {
+        std::fill(m_domainRates.begin(), m_domainRates.end(), 0.0);
+        for (std::size_t label = 0; label < individualRates.size(); ++label) {
+            m_domainRates[m_possibilityDomains[label]] +=
+                    individualRates[label];
+        }
+    }
+    return std::accumulate(individualRates.begin(), individualRates.end(), 0.0);
+}
+
+std::size_t Reaction::chooseLabelInDomain(
+        const std::vector<double>& individualRates,
+        RandomGenerator& generator,
+        const int32_t domain) const {
+    // The rates are summed in the same order as in sumRates, such that the
+    // sum reaches the rate of the domain
+    const double eventIdentifyingRate =
+            generator.getUniform(0, m_domainRates[domain]);
+    double sum = 0;
+    for (std::size_t label = 0; label < individualRates.size(); ++label) {
+        if (m_possibilityDomains[label] != domain) {
+            continue;
+        }
+        sum += individualRates[label];
+        if (sum > eventIdentifyingRate) {
+            return label;
+        }
+    }
+    throw GeneralException(
+            "The end of Reaction::chooseLabelInDomain() was reached");
+}
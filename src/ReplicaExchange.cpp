@@ -0,0 +1,220 @@
+#include <cmath> // std::exp
+#include <cstdint>
+#include <fstream>
+#include <iomanip> // std::setw
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/OutputParameters.hpp"
+#include "filament-sliding/ParameterMap.hpp"
+#include "filament-sliding/Propagator.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/ReplicaExchange.hpp"
+#include "filament-sliding/Simulation.hpp"
+#include "filament-sliding/SystemModel.hpp"
+#include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+ReplicaExchange::ReplicaExchange(
+        const ParameterMap& parameters,
+        const std::string& runName,
+        const int32_t nRungs,
+        const double lastForceValue,
+        const int32_t exchangePeriod,
+        Log& log):
+        m_runName(runName),
+        m_exchangePeriod(exchangePeriod),
+        m_exchangeGenerator(runName + " exchange"),
+        m_nExchangeRounds(0) {
+    if (nRungs <= 1 || m_exchangePeriod <= 0) {
+        throw GeneralException(
+                "ReplicaExchange was constructed with less than two rungs, or "
+                "an exchange period that is not positive.");
+    }
+
+    // The exchanges need a bounded potential of the force, such that every
+    // rung has an equilibrium distribution. Under a constant force, the
+    // mobile microtubule drifts without bound, and the acceptance of a swap
+    // would depend on how far the rungs have drifted apart. The rungs should
+    // also stay at the same time steps
+    std::string addExternalForce;
+    parameters.copyParameter("addExternalForce", addExternalForce);
+    std::string externalForceType;
+    parameters.copyParameter("externalForceType", externalForceType);
+    if (addExternalForce != "TRUE" || externalForceType != "SINUS") {
+        throw GeneralException(
+                "A replica exchange needs a SINUS external force.");
+    }
+    std::string adaptiveEquilibration;
+    parameters.copyParameter("adaptiveEquilibration", adaptiveEquilibration);
+    double precisionTarget;
+    parameters.copyParameter("precisionTarget", precisionTarget);
+    std::string sharedAccumulators;
+    parameters.copyParameter("sharedAccumulators", sharedAccumulators);
+    if (adaptiveEquilibration == "TRUE" || precisionTarget > 0.0 ||
+        sharedAccumulators != "NONE") {
+        throw GeneralException(
+                "A replica exchange is not supported in combination with "
+                "adaptive equilibration, a precision target or shared "
+                "accumulators.");
+    }
+
+    // A swap replaces the trajectory of a rung by that of its neighbour, so
+    // only observables of the distribution at each force are meaningful
+    std::string recordTransitionPaths;
+    parameters.copyParameter("recordTransitionPaths", recordTransitionPaths);
+    std::string estimateTimeEvolutionAtPeak;
+    parameters.copyParameter(
+            "estimateTimeEvolutionAtPeak", estimateTimeEvolutionAtPeak);
+    if (recordTransitionPaths == "TRUE" ||
+        estimateTimeEvolutionAtPeak == "TRUE") {
+        throw GeneralException(
+                "A replica exchange is not supported in combination with "
+                "recording transition paths or estimating the time evolution "
+                "at the peak, since these follow a trajectory.");
+    }
+
+    double firstForceValue;
+    parameters.copyParameter("externalForceValue", firstForceValue);
+
+    m_rungs.resize(nRungs);
+    for (int32_t rungNumber = 0; rungNumber < nRungs; ++rungNumber) {
+        Rung& rung = m_rungs[rungNumber];
+        rung.runName = m_runName + ".force_" + std::to_string(rungNumber);
+        rung.externalForceValue =
+                firstForceValue + (lastForceValue - firstForceValue) *
+                                          rungNumber / (nRungs - 1);
+        rung.nExchangeAttempts = 0;
+        rung.nAcceptedExchanges = 0;
+
+        // The input file is stored for reference, as the main program does
+        ParameterMap rungParameters = parameters;
+        rungParameters.overrideParameter("runName", rung.runName);
+        rungParameters.overrideParameter(
+                "externalForceValue", rung.externalForceValue);
+        std::ofstream storedFile((rung.runName + ".parameters.txt").c_str());
+        storedFile << rungParameters;
+
+        rung.p_simulation =
+                std::make_unique<Simulation>(rungParameters, rung.runName, log);
+        rung.p_threadPool = std::make_unique<ThreadPool>(1);
+        rung.p_generator = std::make_unique<RandomGenerator>(rung.runName);
+        rung.p_systemState =
+                rung.p_simulation->createSystemState(*rung.p_threadPool);
+        rung.p_propagator = rung.p_simulation->createPropagator(
+                rung.p_simulation->getCalcTimeStep(),
+                *rung.p_generator,
+                *rung.p_threadPool);
+        rung.p_output = rung.p_simulation->createEquilibriumOutput();
+    }
+    mp_swapState = m_rungs.front().p_simulation->createSystemState(
+            *m_rungs.front().p_threadPool);
+}
+
+ReplicaExchange::~ReplicaExchange() {}
+
+void ReplicaExchange::attemptExchange(const std::size_t rung) {
+    Rung& lowerRung = m_rungs[rung];
+    Rung& upperRung = m_rungs[rung + 1];
+    SystemState& lowerState = *lowerRung.p_systemState;
+    SystemState& upperState = *upperRung.p_systemState;
+
+    // The linkers are the same for both forces, so only the potential of the
+    // external force changes
+    const SystemModel& lowerModel = lowerState.getModel();
+    const SystemModel& upperModel = upperState.getModel();
+    const double lowerPosition = lowerState.getMicrotubulePosition();
+    const double upperPosition = upperState.getMicrotubulePosition();
+    const double energyChange = lowerModel.findExternalEnergy(upperPosition) +
+                                upperModel.findExternalEnergy(lowerPosition) -
+                                lowerModel.findExternalEnergy(lowerPosition) -
+                                upperModel.findExternalEnergy(upperPosition);
+
+    ++lowerRung.nExchangeAttempts;
+    if (energyChange > 0.0 &&
+        m_exchangeGenerator.getProbability() >= std::exp(-energyChange)) {
+        return;
+    }
+    ++lowerRung.nAcceptedExchanges;
+
+    // The forces are found anew for the swapped states. Their reactions are
+    // due at other times, and since the waiting times are exponential, the
+    // clocks can be restarted
+    mp_swapState->copyStateFrom(lowerState);
+    lowerState.copyStateFrom(upperState);
+    upperState.copyStateFrom(*mp_swapState);
+    lowerRung.p_propagator->restartReactionClock(*lowerRung.p_generator);
+    upperRung.p_propagator->restartReactionClock(*upperRung.p_generator);
+}
+
+void ReplicaExchange::run(ThreadPool& threadPool) {
+    const int32_t nRungs = static_cast<int32_t>(m_rungs.size());
+    threadPool.parallelFor(nRungs, [&](const int32_t rungNumber) {
+        Rung& rung = m_rungs[rungNumber];
+        rung.p_simulation->createInitialiser()->initialise(
+                *rung.p_systemState, *rung.p_generator);
+    });
+
+    // All rungs have the same blocks, so they finish together
+    bool isRunning = true;
+    while (isRunning) {
+        std::vector<char> rungIsRunning(nRungs);
+        threadPool.parallelFor(nRungs, [&](const int32_t rungNumber) {
+            Rung& rung = m_rungs[rungNumber];
+            rungIsRunning[rungNumber] = rung.p_propagator->propagateInterval(
+                    *rung.p_systemState,
+                    *rung.p_generator,
+                    *rung.p_output,
+                    m_exchangePeriod);
+        });
+        isRunning = (rungIsRunning.front() != 0);
+        if (!isRunning) {
+            break;
+        }
+
+        // The even and the odd pairs take turns
+        const std::size_t firstRung =
+                static_cast<std::size_t>(m_nExchangeRounds % 2);
+        for (std::size_t rung = firstRung; rung + 1 < m_rungs.size();
+             rung += 2) {
+            attemptExchange(rung);
+        }
+        ++m_nExchangeRounds;
+    }
+}
+
+void ReplicaExchange::writeReport() const {
+    const int width = OutputParameters::collumnWidth;
+    std::ofstream report((m_runName + ".replica_exchange.txt").c_str());
+    report << std::left
+           << "The states of neighbouring rungs were exchanged every "
+           << m_exchangePeriod
+           << " time steps, with the Metropolis probability of the change in "
+              "the potential energy of the sinusoidal forces. The output of "
+              "every rung, written with its run name, holds the equilibrium "
+              "histograms at its force only. Since the trajectory of a rung "
+              "jumps at every exchange, it gives no barrier crossing times or "
+              "rates: these need runs without an exchange.\n\n"
+           << std::setw(width) << "RUN NAME" << std::setw(width)
+           << "FORCE VALUE (kT/micron)" << std::setw(width)
+           << "NEXT FORCE VALUE" << std::setw(width) << "EXCHANGE ATTEMPTS"
+           << std::setw(width) << "ACCEPTED EXCHANGES" << "ACCEPTANCE RATIO"
+           << '\n';
+    for (std::size_t rung = 0; rung + 1 < m_rungs.size(); ++rung) {
+        const Rung& lowerRung = m_rungs[rung];
+        const double acceptanceRatio =
+                static_cast<double>(lowerRung.nAcceptedExchanges) /
+                static_cast<double>(lowerRung.nExchangeAttempts);
+        report << std::setw(width) << lowerRung.runName << std::setw(width)
+               << lowerRung.externalForceValue << std::setw(width)
+               << m_rungs[rung + 1].externalForceValue << std::setw(width)
+               << lowerRung.nExchangeAttempts << std::setw(width)
+               << lowerRung.nAcceptedExchanges << acceptanceRatio << '\n';
+    }
+    report << std::setw(width) << m_rungs.back().runName << std::setw(width)
+           << m_rungs.back().externalForceValue << '\n';
+}
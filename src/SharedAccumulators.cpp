@@ -0,0 +1,307 @@
+#include <algorithm> // std::find
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring> // std::strncmp
+#include <fcntl.h> // O_CREAT, only works on POSIX systems
+#include <pthread.h> // pthread_mutex_*, only works on POSIX systems
+#include <string>
+#include <sys/mman.h> // shm_open, mmap, only works on POSIX systems
+#include <sys/stat.h> // fstat, only works on POSIX systems
+#include <thread>
+#include <unistd.h> // ftruncate, close, only works on POSIX systems
+#include <vector>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Histogram.hpp"
+#include "filament-sliding/SharedAccumulators.hpp"
+#include "filament-sliding/Statistics.hpp"
+
+SharedAccumulators::SharedAccumulators(
+        const std::string& name,
+        const std::string& ensemble,
+        const int32_t nProcesses,
+        const std::vector<Statistics*>& statistics,
+        const std::vector<Histogram*>& histograms):
+        m_name(name.front() == '/' ? name : '/' + name),
+        m_ensemble(ensemble),
+        m_statistics(statistics),
+        m_histograms(histograms),
+        m_isLast(false),
+        mp_segment(nullptr) {
+    if (nProcesses <= 0) {
+        throw GeneralException(
+                "SharedAccumulators was constructed with a number of "
+                "processes that is not positive.");
+    }
+    if (m_ensemble.empty() || m_ensemble.size() > maxEnsembleLength) {
+        throw GeneralException(
+                "SharedAccumulators was constructed with an ensemble label "
+                "that is empty or longer than " +
+                std::to_string(maxEnsembleLength) + " characters.");
+    }
+
+    int64_t nBins = 0;
+    for (Histogram* const p_histogram: m_histograms) {
+        m_statistics.push_back(p_histogram);
+        nBins += static_cast<int64_t>(p_histogram->m_bins.size());
+    }
+    m_size = sizeof(Header) + m_statistics.size() * sizeof(Moments) +
+             m_histograms.size() * sizeof(BinBounds) +
+             static_cast<std::size_t>(nBins) * sizeof(std::atomic<int64_t>);
+
+    attach(nProcesses, nBins);
+    if (!matchesSegment(nProcesses, nBins)) {
+        munmap(mp_segment, m_size);
+        throw GeneralException(
+                "The shared accumulators " + m_name +
+                " were created by another ensemble, or by a process with "
+                "other output settings.");
+    }
+
+    // The processes of an ensemble all attach before the first one detaches,
+    // so this segment was left by an ensemble that crashed
+    lock();
+    const int32_t nDetached = mp_header->nDetached;
+    unlock();
+    if (nDetached > 0) {
+        munmap(mp_segment, m_size);
+        throw GeneralException(
+                "The shared accumulators " + m_name +
+                " were left by an ensemble of which processes have already "
+                "finished, and should be removed.");
+    }
+}
+
+SharedAccumulators::~SharedAccumulators() {
+    munmap(mp_segment, m_size);
+    if (m_isLast) {
+        shm_unlink(m_name.c_str());
+    }
+}
+
+void SharedAccumulators::attach(
+        const int32_t nProcesses,
+        const int64_t nBins) {
+    int fileDescriptor =
+            shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    const bool isCreator = (fileDescriptor >= 0);
+    if (!isCreator && errno == EEXIST) {
+        fileDescriptor = shm_open(m_name.c_str(), O_RDWR, 0600);
+    }
+    if (fileDescriptor < 0) {
+        throw GeneralException(
+                "The shared accumulators " + m_name +
+                " could not be opened.");
+    }
+
+    // The segment has no size until its creator has set it. Beyond its size,
+    // a mapping cannot be accessed
+    const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    struct stat status = {};
+    if (isCreator) {
+        if (ftruncate(fileDescriptor, static_cast<off_t>(m_size)) != 0) {
+            close(fileDescriptor);
+            shm_unlink(m_name.c_str());
+            throw GeneralException(
+                    "The shared accumulators " + m_name +
+                    " could not be given their size.");
+        }
+    }
+    else {
+        while (fstat(fileDescriptor, &status) == 0 && status.st_size == 0 &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (status.st_size == 0) {
+            close(fileDescriptor);
+            throw GeneralException(
+                    "The shared accumulators " + m_name +
+                    " were not initialised by the process that created "
+                    "them.");
+        }
+        if (static_cast<std::size_t>(status.st_size) != m_size) {
+            close(fileDescriptor);
+            throw GeneralException(
+                    "The shared accumulators " + m_name +
+                    " were created by a process with other output settings.");
+        }
+    }
+
+    mp_segment = mmap(
+            nullptr,
+            m_size,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            fileDescriptor,
+            0);
+    close(fileDescriptor);
+    if (mp_segment == MAP_FAILED) {
+        throw GeneralException(
+                "The shared accumulators " + m_name +
+                " could not be mapped.");
+    }
+    mp_header = static_cast<Header*>(mp_segment);
+    mp_moments = reinterpret_cast<Moments*>(mp_header + 1);
+    mp_binBounds =
+            reinterpret_cast<BinBounds*>(mp_moments + m_statistics.size());
+    mp_bins = reinterpret_cast<std::atomic<int64_t>*>(
+            mp_binBounds + m_histograms.size());
+
+    // The segment is filled with zeros, which are empty moments. Lock-free
+    // atomics are stored as their values, so the bins are atomics holding zero
+    if (isCreator) {
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&mp_header->mutex, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+
+        m_ensemble.copy(mp_header->ensemble, maxEnsembleLength);
+        mp_header->nProcesses = nProcesses;
+        mp_header->nDetached = 0;
+        mp_header->nStatistics = static_cast<int64_t>(m_statistics.size());
+        mp_header->nBins = nBins;
+        for (std::size_t i = 0; i < m_histograms.size(); ++i) {
+            mp_binBounds[i] = BinBounds {
+                    m_histograms[i]->m_binSize, m_histograms[i]->m_lowestValue};
+        }
+        mp_header->isInitialised.store(1, std::memory_order_release);
+    }
+    else {
+        while (mp_header->isInitialised.load(std::memory_order_acquire) == 0 &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (mp_header->isInitialised.load(std::memory_order_acquire) == 0) {
+            munmap(mp_segment, m_size);
+            throw GeneralException(
+                    "The shared accumulators " + m_name +
+                    " were not initialised by the process that created "
+                    "them.");
+        }
+    }
+}
+
+bool SharedAccumulators::matchesSegment(
+        const int32_t nProcesses,
+        const int64_t nBins) const {
+    if (std::strncmp(
+                mp_header->ensemble,
+                m_ensemble.c_str(),
+                maxEnsembleLength + 1) != 0 ||
+        mp_header->nProcesses != nProcesses ||
+        mp_header->nStatistics != static_cast<int64_t>(m_statistics.size()) ||
+        mp_header->nBins != nBins) {
+        return false;
+    }
+    for (std::size_t i = 0; i < m_histograms.size(); ++i) {
+        if (mp_binBounds[i].binSize != m_histograms[i]->m_binSize ||
+            mp_binBounds[i].lowestValue != m_histograms[i]->m_lowestValue) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SharedAccumulators::lock() const {
+    const int result = pthread_mutex_lock(&mp_header->mutex);
+    if (result == EOWNERDEAD) {
+        // The process that held the mutex crashed. At worst, it left the
+        // moments of one statistics half updated
+        pthread_mutex_consistent(&mp_header->mutex);
+    }
+    else if (result != 0) {
+        throw GeneralException(
+                "The shared accumulators " + m_name + " could not be locked.");
+    }
+}
+
+void SharedAccumulators::unlock() const {
+    pthread_mutex_unlock(&mp_header->mutex);
+}
+
+Statistics SharedAccumulators::toStatistics(const Moments& moments) {
+    Statistics statistics;
+    statistics.m_numberOfSamples = moments.nSamples;
+    statistics.m_mean = moments.mean;
+    statistics.m_previousMean = moments.mean;
+    statistics.m_accumulatedSquaredDeviation =
+            moments.accumulatedSquaredDeviation;
+    return statistics;
+}
+
+SharedAccumulators::Moments SharedAccumulators::toMoments(
+        const Statistics& statistics) {
+    return Moments {
+            statistics.m_numberOfSamples,
+            statistics.m_mean,
+            statistics.m_accumulatedSquaredDeviation};
+}
+
+void SharedAccumulators::fold() {
+    lock();
+    for (std::size_t i = 0; i < m_statistics.size(); ++i) {
+        Statistics aggregate = toStatistics(mp_moments[i]);
+        aggregate.merge(*m_statistics[i]);
+        mp_moments[i] = toMoments(aggregate);
+        *m_statistics[i] = Statistics();
+    }
+    unlock();
+
+    std::atomic<int64_t>* p_bin = mp_bins;
+    for (Histogram* const p_histogram: m_histograms) {
+        for (int64_t& count: p_histogram->m_bins) {
+            if (count != 0) {
+                p_bin->fetch_add(count, std::memory_order_relaxed);
+                count = 0;
+            }
+            ++p_bin;
+        }
+    }
+}
+
+Statistics SharedAccumulators::getAggregate(
+        const Statistics& statistics) const {
+    const std::size_t i = static_cast<std::size_t>(
+            std::find(m_statistics.begin(), m_statistics.end(), &statistics) -
+            m_statistics.begin());
+    if (i == m_statistics.size()) {
+        throw GeneralException(
+                "SharedAccumulators::getAggregate() was called with "
+                "statistics that are not shared.");
+    }
+
+    lock();
+    Statistics aggregate = toStatistics(mp_moments[i]);
+    unlock();
+    aggregate.merge(statistics);
+    return aggregate;
+}
+
+bool SharedAccumulators::detach() {
+    fold();
+
+    lock();
+    m_isLast = (++mp_header->nDetached == mp_header->nProcesses);
+    unlock();
+    if (!m_isLast) {
+        return false;
+    }
+
+    // All other processes have folded their samples before they detached
+    for (std::size_t i = 0; i < m_statistics.size(); ++i) {
+        m_statistics[i]->merge(toStatistics(mp_moments[i]));
+    }
+    const std::atomic<int64_t>* p_bin = mp_bins;
+    for (Histogram* const p_histogram: m_histograms) {
+        for (int64_t& count: p_histogram->m_bins) {
+            count = p_bin->load(std::memory_order_relaxed);
+            ++p_bin;
+        }
+    }
+    return true;
+}
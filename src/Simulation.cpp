@@ -0,0 +1,748 @@
+#include <algorithm> // std::min
+#include <cmath> // std::lround
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Initialiser.hpp"
+#include "filament-sliding/LockstepReplicas.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/ParameterMap.hpp"
+#include "filament-sliding/Propagator.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/Simulation.hpp"
+#include "filament-sliding/SystemModel.hpp"
+#include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+Simulation::Simulation(
+        const ParameterMap& parameters,
+        const std::string& runName,
+        Log& log):
+        m_runName(runName), m_log(log) {
+    parameters.copyParameter(
+            "lengthMobileMicrotubule", m_lengthMobileMicrotubule);
+    if (m_lengthMobileMicrotubule <= 0.0) {
+        throw GeneralException(
+                "The parameter lengthMobileMicrotubule contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "lengthFixedMicrotubule", m_lengthFixedMicrotubule);
+    if (m_lengthFixedMicrotubule <= 0.0) {
+        throw GeneralException(
+                "The parameter lengthFixedMicrotubule contains a wrong value.");
+    }
+
+    parameters.copyParameter("latticeSpacing", m_latticeSpacing);
+    if (m_latticeSpacing <= 0.0) {
+        throw GeneralException(
+                "The parameter latticeSpacing contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "maximumStretch", m_maximumStretchPerLatticeSpacing);
+    if (m_maximumStretchPerLatticeSpacing <= 0.0) {
+        throw GeneralException(
+                "The parameter maximumStretchPerLatticeSpacing "
+                "contains a wrong value.");
+    }
+
+    std::string periodicBoundariesString;
+    parameters.copyParameter("periodicBoundaries", periodicBoundariesString);
+    m_periodicBoundaries = (periodicBoundariesString == "TRUE");
+
+    std::string fixedLatticeWindowString;
+    parameters.copyParameter("fixedLatticeWindow", fixedLatticeWindowString);
+    m_fixedLatticeWindow = (fixedLatticeWindowString == "TRUE");
+
+    parameters.copyParameter(
+            "fixedLatticeWindowMargin", m_fixedLatticeWindowMargin);
+    if (m_fixedLatticeWindowMargin <= 0.0) {
+        throw GeneralException(
+                "The parameter fixedLatticeWindowMargin contains a wrong "
+                "value.");
+    }
+    if (m_fixedLatticeWindow && m_periodicBoundaries) {
+        throw GeneralException(
+                "A window on the fixed microtubule is not supported in "
+                "combination with periodic boundaries.");
+    }
+
+    parameters.copyParameter("numberActiveCrosslinkers", m_nActiveCrosslinkers);
+    if (m_nActiveCrosslinkers < 0) {
+        throw GeneralException(
+                "The parameter nActiveCrosslinkers contains a wrong value.");
+    }
+
+    parameters.copyParameter("numberDualCrosslinkers", m_nDualCrosslinkers);
+    if (m_nDualCrosslinkers < 0) {
+        throw GeneralException(
+                "The parameter nDualCrosslinkers contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "numberPassiveCrosslinkers", m_nPassiveCrosslinkers);
+    if (m_nPassiveCrosslinkers < 0) {
+        throw GeneralException(
+                "The parameter nPassiveCrosslinkers contains a wrong value.");
+    }
+
+    parameters.copyParameter("springConstant", m_springConstant);
+    if (m_springConstant < 0.0) {
+        throw GeneralException(
+                "The parameter springConstant contains a wrong value.");
+    }
+
+    std::string addExternalForceString;
+    parameters.copyParameter("addExternalForce", addExternalForceString);
+    m_addExternalForce =
+            (addExternalForceString ==
+             "TRUE"); // Whenever it is not TRUE, assume it is false
+
+    parameters.copyParameter("externalForceType", m_externalForceTypeString);
+
+    parameters.copyParameter("externalForceValue", m_externalForceValue);
+
+    std::string coarseGrainDistantPartialsString;
+    parameters.copyParameter(
+            "coarseGrainDistantPartials", coarseGrainDistantPartialsString);
+    m_coarseGrainDistantPartials = (coarseGrainDistantPartialsString == "TRUE");
+
+    parameters.copyParameter("coarseGrainingPeriod", m_coarseGrainingPeriod);
+    if (m_coarseGrainingPeriod <= 0) {
+        throw GeneralException(
+                "The parameter coarseGrainingPeriod contains a wrong value.");
+    }
+
+    // Distant linkers are defined by their distance to the ends of the
+    // overlap, which a periodic system does not have
+    if (m_periodicBoundaries && m_coarseGrainDistantPartials) {
+        throw GeneralException(
+                "Coarse graining distant partial linkers is not supported in "
+                "combination with periodic boundaries.");
+    }
+
+    // All systems created by this simulation, such as the replicas of a run or
+    // of a point of a sweep, share one model and only own their occupancy
+    mp_systemModel = std::make_shared<const SystemModel>(
+            m_lengthMobileMicrotubule,
+            m_lengthFixedMicrotubule,
+            m_latticeSpacing,
+            m_maximumStretchPerLatticeSpacing,
+            m_nActiveCrosslinkers,
+            m_nDualCrosslinkers,
+            m_nPassiveCrosslinkers,
+            m_springConstant,
+            m_addExternalForce,
+            m_externalForceTypeString,
+            m_externalForceValue,
+            m_coarseGrainDistantPartials,
+            m_periodicBoundaries,
+            m_fixedLatticeWindow,
+            m_fixedLatticeWindowMargin);
+
+    // A reaction changes the sites within the maximum stretch of its linker,
+    // and the rates of the neighbouring sites, so the domains in between two
+    // domains of one colour keep these apart
+    parameters.copyParameter("numberSublatticeDomains", m_nSublatticeDomains);
+    if (m_nSublatticeDomains < 0 || m_nSublatticeDomains % 2 != 0) {
+        throw GeneralException(
+                "The parameter numberSublatticeDomains contains a wrong "
+                "value.");
+    }
+    if (m_nSublatticeDomains > 0 &&
+        m_lengthFixedMicrotubule / m_nSublatticeDomains <
+                2 * mp_systemModel->getMaxStretch() + 6 * m_latticeSpacing) {
+        throw GeneralException(
+                "The sublattice domains should be wider than twice the "
+                "maximum stretch plus six lattice spacings.");
+    }
+    if (m_nSublatticeDomains > 0 && m_fixedLatticeWindow) {
+        throw GeneralException(
+                "Sublattice domains are not supported in combination with a "
+                "window on the fixed microtubule.");
+    }
+
+    std::string validateStoragePrecisionString;
+    parameters.copyParameter(
+            "validateStoragePrecision", validateStoragePrecisionString);
+    m_validateStoragePrecision = (validateStoragePrecisionString == "TRUE");
+
+    parameters.copyParameter("checkpointPeriod", m_checkpointPeriod);
+    if (m_checkpointPeriod < 0) {
+        throw GeneralException(
+                "The parameter checkpointPeriod contains a wrong value.");
+    }
+
+    std::string adaptiveEquilibrationString;
+    parameters.copyParameter(
+            "adaptiveEquilibration", adaptiveEquilibrationString);
+    m_adaptiveEquilibration = (adaptiveEquilibrationString == "TRUE");
+
+    parameters.copyParameter(
+            "equilibrationProbePeriod", m_equilibrationProbePeriod);
+    if (m_equilibrationProbePeriod <= 0) {
+        throw GeneralException(
+                "The parameter equilibrationProbePeriod contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "equilibrationTolerance", m_equilibrationTolerance);
+    if (m_equilibrationTolerance <= 0.0) {
+        throw GeneralException(
+                "The parameter equilibrationTolerance contains a wrong value.");
+    }
+
+    std::string recordTransitionPathsString;
+    parameters.copyParameter(
+            "recordTransitionPaths", recordTransitionPathsString);
+    m_recordTransitionPaths = (recordTransitionPathsString == "TRUE");
+
+    std::string samplePositionalDistributionString;
+    parameters.copyParameter(
+            "samplePositionalDistribution", samplePositionalDistributionString);
+    // Whenever it is not TRUE, assume it is false.
+    // Also overwrite sampling the positional distribution even when it is
+    // turned off when recordTransitionPaths is true. This is a choice made in
+    // the output class, and setting samplePositionalDistribution to true makes
+    // sure those assumptions are satisfied
+    m_samplePositionalDistribution =
+            (samplePositionalDistributionString == "TRUE") ||
+            m_recordTransitionPaths;
+
+    parameters.copyParameter(
+            "positionalHistogramBinSize", m_positionalHistogramBinSize);
+    if (m_samplePositionalDistribution && m_positionalHistogramBinSize <= 0.0) {
+        throw GeneralException(
+                "The parameter positionalHistogramBinSize contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "positionalHistogramLowestValue", m_positionalHistogramLowestValue);
+    if (m_positionalHistogramLowestValue < 0.0) {
+        throw GeneralException(
+                "The parameter positionalHistogramLowestValue contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "positionalHistogramHighestValue",
+            m_positionalHistogramHighestValue);
+    if (m_positionalHistogramHighestValue <= m_positionalHistogramLowestValue) {
+        throw GeneralException(
+                "The parameter positionalHistogramHighestValue "
+                "contains a wrong value.");
+    }
+
+    std::string bindingDynamicsString;
+    parameters.copyParameter("bindingDynamics", bindingDynamicsString);
+    const bool bindingDynamics = (bindingDynamicsString == "TRUE");
+
+    if (bindingDynamics) {
+        // A system is made only to count its sites
+        ThreadPool threadPool(1);
+        const std::unique_ptr<SystemState> p_systemState =
+                createSystemState(threadPool);
+        m_maxNFullCrosslinkers = std::min(
+                p_systemState->getNFreeSitesFixed(),
+                p_systemState->getNFreeSitesMobile());
+    }
+    else {
+        m_maxNFullCrosslinkers = m_nActiveCrosslinkers + m_nDualCrosslinkers +
+                                 m_nPassiveCrosslinkers;
+    }
+
+#ifdef MYDEBUG
+    std::cout << "The maximum number of full linkers is given by "
+              << m_maxNFullCrosslinkers << ".\n";
+#endif // MYDEBUG
+
+    parameters.copyParameter(
+            "transitionPathProbePeriod", m_transitionPathProbePeriod);
+    if (m_transitionPathProbePeriod <= 0) {
+        throw GeneralException(
+                "The parameter transitionPathProbePeriod contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "maxNumberTransitionPaths", m_maxNumberTransitionPaths);
+    if (m_maxNumberTransitionPaths < 0) {
+        throw GeneralException(
+                "The parameter maxNumberTransitionPaths contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "maxPeriodPositionTracking", m_maxPeriodPositionTracking);
+    if (m_maxPeriodPositionTracking < 0.0) {
+        throw GeneralException(
+                "The parameter maxPeriodPositionTracking contains a wrong "
+                "value.");
+    }
+
+    std::string estimateTimeEvolutionAtPeakString;
+    parameters.copyParameter(
+            "estimateTimeEvolutionAtPeak", estimateTimeEvolutionAtPeakString);
+    m_estimateTimeEvolutionAtPeak =
+            (estimateTimeEvolutionAtPeakString == "TRUE");
+
+    parameters.copyParameter(
+            "timeStepsPerDistributionEstimate",
+            m_timeStepsPerDistributionEstimate);
+    if (m_estimateTimeEvolutionAtPeak &&
+        m_timeStepsPerDistributionEstimate <= 0) {
+        throw GeneralException(
+                "The parameter timeStepsPerDistributionEstimate "
+                "contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "nEstimatesDistribution", m_nEstimatesDistribution);
+    if (m_estimateTimeEvolutionAtPeak && m_nEstimatesDistribution <= 0) {
+        throw GeneralException(
+                "The parameter nEstimatesDistribution contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "dynamicsEstimationInitialRegionWidth",
+            m_dynamicsEstimationInitialRegionWidth);
+    if (m_estimateTimeEvolutionAtPeak &&
+        (m_dynamicsEstimationInitialRegionWidth <= 0.0 ||
+         m_dynamicsEstimationInitialRegionWidth > 1.0)) {
+        throw GeneralException(
+                "The parameter dynamicsEstimationInitialRegionWidth "
+                "contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "dynamicsEstimationFinalRegionWidth",
+            m_dynamicsEstimationFinalRegionWidth);
+    if (m_estimateTimeEvolutionAtPeak &&
+        (m_dynamicsEstimationFinalRegionWidth <= 0.0 ||
+         m_dynamicsEstimationFinalRegionWidth > 1.0)) {
+        throw GeneralException(
+                "The parameter dynamicsEstimationFinalRegionWidth "
+                "contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "initialPositionMicrotubule", m_initialPositionMicrotubule);
+
+    parameters.copyParameter(
+            "fractionOverlapSitesConnected", m_fractionOverlapSitesConnected);
+    if (m_fractionOverlapSitesConnected < 0.0 ||
+        m_fractionOverlapSitesConnected > 1.0) {
+        throw GeneralException(
+                "The parameter fractionOverlapSitesConnected contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "initialCrosslinkerDistribution",
+            m_initialCrosslinkerDistributionString);
+
+    parameters.copyParameter(
+            "numberEquilibrationBlocks", m_numberEquilibrationBlocks);
+    if (m_numberEquilibrationBlocks < 0) {
+        throw GeneralException(
+                "The parameter numberEquilibrationBlocks contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter("numberRunBlocks", m_numberRunBlocks);
+    if (m_numberRunBlocks < 0) {
+        throw GeneralException(
+                "The parameter numberRunBlocks contains a wrong value.");
+    }
+
+    parameters.copyParameter("precisionTarget", m_precisionTarget);
+    if (m_precisionTarget < 0.0) {
+        throw GeneralException(
+                "The parameter precisionTarget contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "precisionTargetStatistic", m_precisionTargetStatistic);
+    // The time to the final region is only gathered by the peak analysis
+    if (m_precisionTarget > 0.0 &&
+        m_precisionTargetStatistic == "FINAL_REGION_TIME" &&
+        !m_estimateTimeEvolutionAtPeak) {
+        throw GeneralException(
+                "A precision target for the time to the final region requires "
+                "estimateTimeEvolutionAtPeak.");
+    }
+
+    parameters.copyParameter("minimumRunBlocks", m_minimumRunBlocks);
+    if (m_minimumRunBlocks <= 0) {
+        throw GeneralException(
+                "The parameter minimumRunBlocks contains a wrong value.");
+    }
+
+    parameters.copyParameter("timeStepsPerBlock", m_nTimeSteps);
+    if (m_nTimeSteps <= 0) {
+        throw GeneralException(
+                "The parameter nTimeSteps contains a wrong value.");
+    }
+
+    parameters.copyParameter("calcTimeStep", m_calcTimeStep);
+    if (m_calcTimeStep <= 0.0) {
+        throw GeneralException(
+                "The parameter calcTimeStep contains a wrong value.");
+    }
+
+    parameters.copyParameter("positionProbePeriod", m_positionProbePeriod);
+    if (m_positionProbePeriod <= 0) {
+        throw GeneralException(
+                "The parameter positionProbePeriod contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "diffusionConstantMicrotubule", m_diffusionConstantMicrotubule);
+    if (m_diffusionConstantMicrotubule < 0.0) {
+        throw GeneralException(
+                "The parameter diffusionConstantMicrotubule contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter("ratePassivePartialHop", m_ratePassivePartialHop);
+    if (m_ratePassivePartialHop < 0.0) {
+        throw GeneralException(
+                "The parameter ratePassivePartialHop contains a wrong value.");
+    }
+
+    parameters.copyParameter("ratePassiveFullHop", m_ratePassiveFullHop);
+    if (m_ratePassiveFullHop < 0.0) {
+        throw GeneralException(
+                "The parameter ratePassiveFullHop contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "baseRateActivePartialHop", m_baseRateActivePartialHop);
+    if (m_baseRateActivePartialHop < 0.0) {
+        throw GeneralException(
+                "The parameter baseRateActivePartialHop contains a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter("baseRateActiveFullHop", m_baseRateActiveFullHop);
+    if (m_baseRateActiveFullHop < 0.0) {
+        throw GeneralException(
+                "The parameter baseRateActiveFullHop contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "activeHopToPlusBiasEnergy", m_activeHopToPlusBiasEnergy);
+
+    std::string cooperativityString;
+    parameters.copyParameter("cooperativity", cooperativityString);
+    const bool cooperativity = (cooperativityString == "TRUE");
+
+    parameters.copyParameter("neighbourBiasEnergy", m_neighbourBiasEnergy);
+    if (!cooperativity) {
+        m_neighbourBiasEnergy = 0.0;
+    }
+
+    parameters.copyParameter(
+            "baseRateZeroToOneExtremitiesConnected",
+            m_baseRateZeroToOneExtremitiesConnected);
+    if (m_baseRateZeroToOneExtremitiesConnected < 0.0) {
+        throw GeneralException(
+                "The parameter baseRateZeroToOneExtremitiesConnected contains "
+                "a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "baseRateOneToZeroExtremitiesConnected",
+            m_baseRateOneToZeroExtremitiesConnected);
+    if (m_baseRateOneToZeroExtremitiesConnected < 0.0) {
+        throw GeneralException(
+                "The parameter baseRateOneToZeroExtremitiesConnected contains "
+                "a wrong "
+                "value.");
+    }
+
+    parameters.copyParameter(
+            "baseRateOneToTwoExtremitiesConnected",
+            m_baseRateOneToTwoExtremitiesConnected);
+    if (m_baseRateOneToTwoExtremitiesConnected < 0.0) {
+        throw GeneralException(
+                "The parameter baseRateOneToTwoExtremitiesConnected "
+                "contains a wrong value.");
+    }
+
+    parameters.copyParameter(
+            "baseRateTwoToOneExtremitiesConnected",
+            m_baseRateTwoToOneExtremitiesConnected);
+    if (m_baseRateTwoToOneExtremitiesConnected < 0.0) {
+        throw GeneralException(
+                "The parameter baseRateTwoToOneExtremitiesConnected "
+                "contains a wrong value.");
+    }
+
+    // Force the (un)binding rates to zero when binding dynamics is turned off,
+    // because then the maximum number of full linkers can be properly set
+    // before
+    if (!bindingDynamics) {
+        m_baseRateZeroToOneExtremitiesConnected = 0.0;
+        m_baseRateOneToZeroExtremitiesConnected = 0.0;
+        m_baseRateOneToTwoExtremitiesConnected = 0.0;
+        m_baseRateTwoToOneExtremitiesConnected = 0.0;
+    }
+
+    if (bindingDynamics && cooperativity) {
+        throw GeneralException(
+                "Currently, cooperativity is only supported on a system with "
+                "hopping "
+                "crosslinkers, not on a system with binding dynamics.");
+    }
+
+    // The coarse grained moves assume that the hopping rates of a partial
+    // linker do not depend on its neighbours
+    if (m_coarseGrainDistantPartials && cooperativity) {
+        throw GeneralException(
+                "Coarse graining distant partial linkers is not supported in "
+                "combination with cooperativity.");
+    }
+
+    parameters.copyParameter("headBindingBiasEnergy", m_headBindingBiasEnergy);
+}
+
+Simulation::~Simulation() {}
+
+std::unique_ptr<SystemState> Simulation::createSystemState(
+        ThreadPool& threadPool) const {
+    auto p_systemState = std::make_unique<SystemState>(mp_systemModel);
+    p_systemState->setThreadPool(&threadPool);
+    return p_systemState;
+}
+
+std::unique_ptr<Output> Simulation::createOutput(const bool writeFiles) const {
+    return std::make_unique<Output>(
+            m_runName,
+            m_samplePositionalDistribution,
+            m_recordTransitionPaths,
+            m_transitionPathProbePeriod,
+            m_maxNumberTransitionPaths,
+            m_positionalHistogramBinSize,
+            m_positionalHistogramLowestValue,
+            m_positionalHistogramHighestValue,
+            m_maxNFullCrosslinkers,
+            m_maxPeriodPositionTracking,
+            m_latticeSpacing,
+            m_estimateTimeEvolutionAtPeak,
+            m_timeStepsPerDistributionEstimate,
+            m_nEstimatesDistribution,
+            m_dynamicsEstimationInitialRegionWidth,
+            m_dynamicsEstimationFinalRegionWidth,
+            true,
+            writeFiles);
+}
+
+std::unique_ptr<Output> Simulation::createEquilibriumOutput() const {
+    return std::make_unique<Output>(
+            m_runName,
+            m_samplePositionalDistribution,
+            m_recordTransitionPaths,
+            m_transitionPathProbePeriod,
+            m_maxNumberTransitionPaths,
+            m_positionalHistogramBinSize,
+            m_positionalHistogramLowestValue,
+            m_positionalHistogramHighestValue,
+            m_maxNFullCrosslinkers,
+            m_maxPeriodPositionTracking,
+            m_latticeSpacing,
+            m_estimateTimeEvolutionAtPeak,
+            m_timeStepsPerDistributionEstimate,
+            m_nEstimatesDistribution,
+            m_dynamicsEstimationInitialRegionWidth,
+            m_dynamicsEstimationFinalRegionWidth,
+            false,
+            true);
+}
+
+std::unique_ptr<Initialiser> Simulation::createInitialiser() const {
+    return std::make_unique<Initialiser>(
+            m_initialPositionMicrotubule,
+            m_fractionOverlapSitesConnected,
+            m_initialCrosslinkerDistributionString);
+}
+
+std::unique_ptr<Propagator> Simulation::createPropagator(
+        const double timeStep,
+        RandomGenerator& generator,
+        ThreadPool& threadPool) const {
+    const int32_t scaledCoarseGrainingPeriod = std::max(
+            1,
+            static_cast<int32_t>(std::lround(
+                    m_coarseGrainingPeriod * m_calcTimeStep / timeStep)));
+    return std::make_unique<Propagator>(
+            m_numberEquilibrationBlocks,
+            m_numberRunBlocks,
+            m_nTimeSteps,
+            timeStep,
+            m_positionProbePeriod,
+            m_diffusionConstantMicrotubule,
+            m_springConstant,
+            m_latticeSpacing,
+            m_ratePassivePartialHop,
+            m_ratePassiveFullHop,
+            m_baseRateActivePartialHop,
+            m_baseRateActiveFullHop,
+            m_activeHopToPlusBiasEnergy,
+            m_neighbourBiasEnergy,
+            m_baseRateZeroToOneExtremitiesConnected,
+            m_baseRateOneToZeroExtremitiesConnected,
+            m_baseRateOneToTwoExtremitiesConnected,
+            m_baseRateTwoToOneExtremitiesConnected,
+            m_nPassiveCrosslinkers != 0,
+            m_nDualCrosslinkers != 0,
+            m_nActiveCrosslinkers != 0,
+            m_headBindingBiasEnergy,
+            generator,
+            m_samplePositionalDistribution,
+            m_recordTransitionPaths,
+            m_transitionPathProbePeriod,
+            m_addExternalForce,
+            m_estimateTimeEvolutionAtPeak,
+            m_coarseGrainDistantPartials,
+            scaledCoarseGrainingPeriod,
+            m_validateStoragePrecision,
+            m_checkpointPeriod,
+            m_runName + ".checkpoint.bin",
+            m_adaptiveEquilibration,
+            m_equilibrationProbePeriod,
+            m_equilibrationTolerance,
+            m_precisionTarget,
+            m_precisionTargetStatistic,
+            m_minimumRunBlocks,
+            m_nSublatticeDomains,
+            threadPool,
+            m_log);
+}
+
+void Simulation::runReplica(RandomGenerator& generator, Output& output) const {
+    ThreadPool threadPool(1); // The calling thread only
+    const std::unique_ptr<SystemState> p_systemState =
+            createSystemState(threadPool);
+    const std::unique_ptr<Propagator> p_propagator =
+            createPropagator(m_calcTimeStep, generator, threadPool);
+
+    createInitialiser()->initialise(*p_systemState, generator);
+    p_propagator->equilibrate(*p_systemState, generator, output);
+    p_propagator->run(*p_systemState, generator, output);
+}
+
+bool Simulation::supportsLockstepReplicas() const {
+    const bool hasBindingDynamics =
+            m_baseRateZeroToOneExtremitiesConnected != 0.0 ||
+            m_baseRateOneToZeroExtremitiesConnected != 0.0 ||
+            m_baseRateOneToTwoExtremitiesConnected != 0.0 ||
+            m_baseRateTwoToOneExtremitiesConnected != 0.0;
+    const bool hasConstantExternalForce =
+            !m_addExternalForce || m_externalForceTypeString == "CONSTANT";
+    return !hasBindingDynamics && hasConstantExternalForce &&
+           !m_periodicBoundaries && !m_fixedLatticeWindow &&
+           !m_coarseGrainDistantPartials && !m_samplePositionalDistribution &&
+           !m_estimateTimeEvolutionAtPeak && !m_recordTransitionPaths &&
+           !m_validateStoragePrecision && !m_adaptiveEquilibration &&
+           m_precisionTarget == 0.0 && m_nSublatticeDomains == 0;
+}
+
+void Simulation::runLockstepReplicas(
+        const std::vector<RandomGenerator*>& generators,
+        const std::vector<Output*>& outputs) const {
+    ThreadPool threadPool(1); // The calling thread only
+    const std::unique_ptr<Initialiser> p_initialiser = createInitialiser();
+
+    std::vector<std::unique_ptr<SystemState>> systemStates;
+    std::vector<std::unique_ptr<Propagator>> propagators;
+    std::vector<LockstepReplicas::Replica> replicas;
+    for (std::size_t replica = 0; replica < generators.size(); ++replica) {
+        RandomGenerator& generator = *generators[replica];
+        systemStates.push_back(createSystemState(threadPool));
+        propagators.push_back(
+                createPropagator(m_calcTimeStep, generator, threadPool));
+        p_initialiser->initialise(*systemStates.back(), generator);
+        replicas.push_back(LockstepReplicas::Replica {
+                *systemStates.back(),
+                *propagators.back(),
+                generator,
+                *outputs[replica]});
+    }
+
+    LockstepReplicas lockstepReplicas(
+            replicas,
+            m_numberEquilibrationBlocks,
+            m_numberRunBlocks,
+            m_nTimeSteps,
+            m_calcTimeStep,
+            m_positionProbePeriod,
+            m_diffusionConstantMicrotubule,
+            m_springConstant,
+            m_latticeSpacing,
+            m_log);
+    lockstepReplicas.equilibrate();
+    lockstepReplicas.run();
+}
+
+void Simulation::validateJournal(
+        const SystemState& systemState,
+        ThreadPool& threadPool) const {
+    RandomGenerator generator(m_runName + ".journal");
+    const std::unique_ptr<SystemState> p_trialState =
+            createSystemState(threadPool);
+    const std::unique_ptr<Propagator> p_propagator =
+            createPropagator(m_calcTimeStep, generator, threadPool);
+
+    p_trialState->copyStateFrom(systemState);
+    p_trialState->startJournal();
+    p_propagator->restartReactionClock(generator);
+    for (int32_t step = 0; step < m_nTimeSteps; ++step) {
+        p_propagator->advanceCoupledTimeStep(
+                *p_trialState, generator, generator.getGaussian(0.0, 1.0));
+    }
+    const int32_t nChanges = p_trialState->getJournalMark();
+    p_trialState->rollBack(0);
+    p_trialState->stopJournal();
+
+    m_log.writeJournalValidation(
+            nChanges,
+            p_trialState->hasSameConfigurationAs(systemState),
+            p_trialState->getForce() - systemState.getForce());
+}
+
+std::string Simulation::getEquilibrationSettings() const {
+    std::ostringstream settings;
+    settings.precision(std::numeric_limits<double>::max_digits10);
+    settings << "equilibration time steps "
+             << static_cast<int64_t>(m_numberEquilibrationBlocks) * m_nTimeSteps
+             << '\n';
+    if (m_adaptiveEquilibration) {
+        settings << "adaptive equilibration, probed every "
+                 << m_equilibrationProbePeriod << " time steps, tolerance "
+                 << m_equilibrationTolerance << '\n';
+    }
+    return settings.str();
+}
+
+int32_t Simulation::getNEquilibrationBlocks() const {
+    return m_numberEquilibrationBlocks;
+}
+
+int32_t Simulation::getNTimeStepsPerBlock() const { return m_nTimeSteps; }
+
+double Simulation::getCalcTimeStep() const { return m_calcTimeStep; }
+
+int32_t Simulation::getCheckpointPeriod() const { return m_checkpointPeriod; }
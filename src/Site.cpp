@@ -1,6 +1,11 @@
 #include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "filament-sliding/Checkpoint.hpp"
 
 #include "filament-sliding/Crosslinker.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 #include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/Site.hpp"
 
@@ -94,3 +99,25 @@ Crosslinker* Site::whichCrosslinkerIsBound() const {
 #endif // MYDEBUG
     return mp_connectedCrosslinker;
 }
+
+void Site::relocateCrosslinker(const CrosslinkerRelocation& relocation) {
+    mp_connectedCrosslinker = relocation.relocate(mp_connectedCrosslinker);
+}
+
+void Site::writeCheckpoint(
+        std::ostream& out,
+        const CrosslinkerRelocation& relocation) const {
+    Checkpoint::write(out, m_isFree);
+    Checkpoint::write(out, relocation.getIndex(mp_connectedCrosslinker));
+    Checkpoint::write(out, m_connectedTerminus);
+}
+
+void Site::readCheckpoint(
+        std::istream& in,
+        const CrosslinkerRelocation& relocation) {
+    Checkpoint::read(in, m_isFree);
+    int32_t linkerIndex;
+    Checkpoint::read(in, linkerIndex);
+    mp_connectedCrosslinker = relocation.getCrosslinker(linkerIndex);
+    Checkpoint::read(in, m_connectedTerminus);
+}
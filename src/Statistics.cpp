@@ -1,6 +1,9 @@
 #include <cmath>
 #include <cstdint>
+#include <istream>
+#include <ostream>
 
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/Statistics.hpp"
 
@@ -27,6 +30,46 @@ void Statistics::addValue(const double value) {
             (value - m_mean) * (value - m_previousMean);
 }
 
+void Statistics::merge(const Statistics& other) {
+    if (other.m_numberOfSamples == 0) {
+        return;
+    }
+    const int64_t nSamples = m_numberOfSamples + other.m_numberOfSamples;
+    const double difference = other.m_mean - m_mean;
+    const double fractionOther = static_cast<double>(other.m_numberOfSamples) /
+                                 static_cast<double>(nSamples);
+
+    m_accumulatedSquaredDeviation +=
+            other.m_accumulatedSquaredDeviation +
+            difference * difference *
+                    static_cast<double>(m_numberOfSamples) * fractionOther;
+    m_previousMean = m_mean;
+    m_mean += difference * fractionOther;
+    m_numberOfSamples = nSamples;
+}
+
+void Statistics::serialize(std::ostream& out) const {
+    Checkpoint::write(out, m_numberOfSamples);
+    Checkpoint::write(out, m_mean);
+    Checkpoint::write(out, m_accumulatedSquaredDeviation);
+}
+
+void Statistics::readSerialized(std::istream& in) {
+    Checkpoint::read(in, m_numberOfSamples);
+    Checkpoint::read(in, m_mean);
+    Checkpoint::read(in, m_accumulatedSquaredDeviation);
+    if (m_numberOfSamples < 0 || !(m_accumulatedSquaredDeviation >= 0.0)) {
+        throw GeneralException("Serialized statistics are corrupted.");
+    }
+    m_previousMean = m_mean;
+}
+
+void Statistics::mergeSerialized(std::istream& in) {
+    Statistics other;
+    other.readSerialized(in);
+    merge(other);
+}
+
 int64_t Statistics::getNumberOfSamples() const { return m_numberOfSamples; }
 
 double Statistics::getMean() const {
@@ -55,3 +98,17 @@ bool Statistics::canReportStatistics() const {
     return (m_numberOfSamples >
             1); // For the variance, at least 2 values are necessary
 }
+
+void Statistics::writeCheckpoint(std::ostream& out) const {
+    Checkpoint::write(out, m_numberOfSamples);
+    Checkpoint::write(out, m_mean);
+    Checkpoint::write(out, m_previousMean);
+    Checkpoint::write(out, m_accumulatedSquaredDeviation);
+}
+
+void Statistics::readCheckpoint(std::istream& in) {
+    Checkpoint::read(in, m_numberOfSamples);
+    Checkpoint::read(in, m_mean);
+    Checkpoint::read(in, m_previousMean);
+    Checkpoint::read(in, m_accumulatedSquaredDeviation);
+}
@@ -0,0 +1,51 @@
+#include <algorithm> // std::min, std::max
+#include <cmath> // std::lround
+#include <cstdint>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/MicrotubuleType.hpp"
+#include "filament-sliding/SublatticeDomains.hpp"
+#include "filament-sliding/SystemState.hpp"
+
+SublatticeDomains::SublatticeDomains(const int32_t nDomains):
+        m_nDomains(nDomains),
+        m_nSitesFixed(1),
+        m_periodic(false),
+        m_mobileSiteOffset(0) {
+    if (m_nDomains < 2 || m_nDomains % 2 != 0) {
+        throw GeneralException(
+                "SublatticeDomains needs an even number of domains, of at "
+                "least two.");
+    }
+}
+
+SublatticeDomains::~SublatticeDomains() {}
+
+int32_t SublatticeDomains::getNDomains() const { return m_nDomains; }
+
+void SublatticeDomains::setSystemState(const SystemState& systemState) {
+    m_nSitesFixed = systemState.getNSites(MicrotubuleType::FIXED);
+    m_periodic = systemState.hasPeriodicBoundaries();
+    // The fixed site at position 0 is at the origin
+    m_mobileSiteOffset = static_cast<int32_t>(std::lround(
+            systemState.getMicrotubulePosition() /
+            systemState.getLatticeSpacing()));
+}
+
+int32_t SublatticeDomains::findDomain(const SiteLocation& location) const {
+    int32_t fixedSite = location.position;
+    if (location.microtubule == MicrotubuleType::MOBILE) {
+        fixedSite += m_mobileSiteOffset;
+    }
+    if (m_periodic) {
+        fixedSite %= m_nSitesFixed;
+        if (fixedSite < 0) {
+            fixedSite += m_nSitesFixed;
+        }
+    }
+    else {
+        fixedSite = std::min(std::max(fixedSite, 0), m_nSitesFixed - 1);
+    }
+    return static_cast<int32_t>(
+            static_cast<int64_t>(fixedSite) * m_nDomains / m_nSitesFixed);
+}
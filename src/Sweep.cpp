@@ -0,0 +1,287 @@
+#include <algorithm> // std::min, std::max, std::stable_sort
+#include <cmath> // std::ceil
+#include <cstdint>
+#include <fstream>
+#include <iomanip> // std::setw
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/InputException.hpp"
+#include "filament-sliding/JobQueue.hpp"
+#include "filament-sliding/Log.hpp"
+#include "filament-sliding/Output.hpp"
+#include "filament-sliding/OutputParameters.hpp"
+#include "filament-sliding/ParameterGrid.hpp"
+#include "filament-sliding/ParameterMap.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/Simulation.hpp"
+#include "filament-sliding/Sweep.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+Sweep::Sweep(const std::string& runName, Log& log):
+        m_runName(runName), m_log(log) {}
+
+Sweep::~Sweep() {}
+
+ParameterMap Sweep::readParameterFile(const std::string& fileName) const {
+    std::ifstream parameterFile(fileName.c_str());
+    if (!parameterFile) {
+        throw GeneralException(
+                "The parameter file " + fileName + " could not be opened.");
+    }
+    ParameterMap parameters;
+    try {
+        parameterFile >> parameters;
+    } catch (const InputException&) {
+        throw GeneralException(
+                "The parameter file " + fileName +
+                " of the sweep is not a valid input file.");
+    }
+    return parameters;
+}
+
+void Sweep::readPointFiles(const std::string& listFileName) {
+    std::ifstream listFile(listFileName.c_str());
+    if (!listFile) {
+        throw GeneralException(
+                "The list of sweep points " + listFileName +
+                " could not be opened.");
+    }
+
+    std::string fileName;
+    while (listFile >> fileName) {
+        addPoint(
+                readParameterFile(fileName),
+                m_runName + ".point_" + std::to_string(m_points.size()),
+                fileName);
+    }
+}
+
+void Sweep::addGridPoints(const ParameterGrid& grid) {
+    for (int32_t point = 0; point < grid.getNPoints(); ++point) {
+        addPoint(
+                grid.getPoint(point),
+                m_runName + ".point_" + std::to_string(m_points.size()),
+                grid.describePoint(point));
+    }
+}
+
+void Sweep::addQueuedPoint(const std::string& fileName) {
+    const ParameterMap parameters = readParameterFile(fileName);
+    std::string runName;
+    parameters.copyParameter("runName", runName);
+    addPoint(parameters, runName, fileName);
+}
+
+void Sweep::enqueue(JobQueue& queue) const {
+    for (const Point& point: m_points) {
+        queue.addTask(point.runName, point.parameters);
+    }
+}
+
+void Sweep::addPoint(
+        ParameterMap parameters,
+        const std::string& runName,
+        const std::string& description) {
+    Point point;
+    point.description = description;
+    point.runName = runName;
+    point.parameters = parameters;
+
+    // The replicas of a point only share their statistics
+    std::string showGraphics;
+    point.parameters.copyParameter("showGraphics", showGraphics);
+    int32_t multilevelLevels;
+    point.parameters.copyParameter("multilevelLevels", multilevelLevels);
+    int32_t checkpointPeriod;
+    point.parameters.copyParameter("checkpointPeriod", checkpointPeriod);
+    std::string resumeFromCheckpoint;
+    point.parameters.copyParameter(
+            "resumeFromCheckpoint", resumeFromCheckpoint);
+    std::string equilibrationCacheDirectory;
+    point.parameters.copyParameter(
+            "equilibrationCacheDirectory", equilibrationCacheDirectory);
+    if (showGraphics == "TRUE" || multilevelLevels > 0 ||
+        checkpointPeriod > 0 || resumeFromCheckpoint != "NONE" ||
+        equilibrationCacheDirectory != "NONE") {
+        throw GeneralException(
+                "The sweep point " + description +
+                " uses graphics, a multilevel estimate, checkpoints or the "
+                "equilibration cache, which are not supported in a sweep.");
+    }
+
+    point.parameters.copyParameter("numberReplicas", point.nReplicas);
+    if (point.nReplicas <= 0) {
+        throw GeneralException(
+                "The parameter numberReplicas of the sweep point " +
+                description + " contains a wrong value.");
+    }
+
+    // The input file is stored for reference, as the main program does
+    point.parameters.overrideParameter("runName", point.runName);
+    std::ofstream storedFile((point.runName + ".parameters.txt").c_str());
+    storedFile << point.parameters;
+
+    m_points.push_back(std::move(point));
+}
+
+void Sweep::schedule(const int32_t nThreads) {
+    if (m_points.empty()) {
+        throw GeneralException("The sweep " + m_runName + " has no points.");
+    }
+
+    // The work of a replica grows with the number of time steps, and with the
+    // number of particles that can react in every time step
+    std::vector<double> blockCosts;
+    std::vector<int32_t> nEquilibrationBlocks;
+    std::vector<int32_t> nRunBlocks;
+    double totalCost = 0.0;
+    for (const Point& point: m_points) {
+        int32_t nTimeSteps;
+        int32_t nActive;
+        int32_t nDual;
+        int32_t nPassive;
+        point.parameters.copyParameter("timeStepsPerBlock", nTimeSteps);
+        point.parameters.copyParameter("numberActiveCrosslinkers", nActive);
+        point.parameters.copyParameter("numberDualCrosslinkers", nDual);
+        point.parameters.copyParameter("numberPassiveCrosslinkers", nPassive);
+        blockCosts.push_back(
+                static_cast<double>(nTimeSteps) *
+                (1.0 + nActive + nDual + nPassive));
+
+        int32_t nEquilibration;
+        int32_t nRun;
+        point.parameters.copyParameter(
+                "numberEquilibrationBlocks", nEquilibration);
+        point.parameters.copyParameter("numberRunBlocks", nRun);
+        nEquilibrationBlocks.push_back(nEquilibration);
+        nRunBlocks.push_back(nRun);
+
+        totalCost += point.nReplicas * blockCosts.back() *
+                     (nEquilibrationBlocks.back() + nRunBlocks.back());
+    }
+
+    // A replica that costs more than an even share of the threads is split,
+    // such that its run blocks are divided over more replicas. Each of them
+    // repeats the equilibration. A precision target decides when to stop from
+    // all run blocks together, so such points are not split
+    const double maxTaskCost = totalCost / std::max(1, nThreads);
+    for (std::size_t i = 0; i < m_points.size(); ++i) {
+        Point& point = m_points[i];
+        const double replicaCost =
+                blockCosts[i] * (nEquilibrationBlocks[i] + nRunBlocks[i]);
+        double precisionTarget;
+        point.parameters.copyParameter("precisionTarget", precisionTarget);
+
+        int32_t splitFactor = 1;
+        if (precisionTarget <= 0.0 && nRunBlocks[i] > 1 &&
+            replicaCost > maxTaskCost) {
+            splitFactor = std::min(
+                    nRunBlocks[i],
+                    static_cast<int32_t>(std::ceil(replicaCost / maxTaskCost)));
+        }
+        // The remaining blocks go to the first replicas, one each, such that
+        // the total number of run blocks is kept
+        point.nRunBlocksPerReplica = nRunBlocks[i] / splitFactor;
+        point.nLongReplicas = point.nReplicas * (nRunBlocks[i] % splitFactor);
+        point.nReplicas *= splitFactor;
+        point.costPerReplica =
+                blockCosts[i] *
+                (nEquilibrationBlocks[i] + point.nRunBlocksPerReplica);
+
+        // Every parameter is checked here, before any point runs
+        ParameterMap replicaParameters = point.parameters;
+        replicaParameters.overrideParameter(
+                "numberRunBlocks", point.nRunBlocksPerReplica);
+        point.p_simulation = std::make_unique<Simulation>(
+                replicaParameters, point.runName, m_log);
+        if (point.nLongReplicas > 0) {
+            replicaParameters.overrideParameter(
+                    "numberRunBlocks", point.nRunBlocksPerReplica + 1);
+            point.p_longSimulation = std::make_unique<Simulation>(
+                    replicaParameters, point.runName, m_log);
+        }
+        point.replicaOutputs.resize(point.nReplicas);
+        point.nUnfinishedReplicas = point.nReplicas;
+
+        for (int32_t replica = 0; replica < point.nReplicas; ++replica) {
+            const double cost = (replica < point.nLongReplicas)
+                                        ? point.costPerReplica + blockCosts[i]
+                                        : point.costPerReplica;
+            m_tasks.push_back({static_cast<int32_t>(i), replica, cost});
+        }
+    }
+
+    // The most expensive replicas start first, and the cheap ones fill up the
+    // threads that finish early
+    std::stable_sort(
+            m_tasks.begin(),
+            m_tasks.end(),
+            [](const Task& first, const Task& second) {
+                return first.cost > second.cost;
+            });
+}
+
+void Sweep::writeSchedule() const {
+    const int width = OutputParameters::collumnWidth;
+    std::ofstream file((m_runName + ".sweep.txt").c_str());
+    file << std::left << std::setw(width) << "RUN NAME" << std::setw(width)
+         << "NUMBER OF REPLICAS" << std::setw(width)
+         << "RUN BLOCKS PER REPLICA" << std::setw(width)
+         << "COST PER REPLICA" << "PARAMETERS" << '\n';
+    for (const Point& point: m_points) {
+        std::string nRunBlocks = std::to_string(point.nRunBlocksPerReplica);
+        if (point.nLongReplicas > 0) {
+            nRunBlocks = std::to_string(point.nRunBlocksPerReplica + 1) +
+                         " (" + std::to_string(point.nLongReplicas) + "), " +
+                         nRunBlocks;
+        }
+        file << std::setw(width) << point.runName << std::setw(width)
+             << point.nReplicas << std::setw(width) << nRunBlocks
+             << std::setw(width) << point.costPerReplica << point.description
+             << '\n';
+    }
+    file << "\nThe cost counts the time steps of all blocks, times the number "
+         << "of crosslinkers plus one. Where the run blocks are not divided "
+         << "evenly, the number of replicas that run one block more is given "
+         << "in brackets, and the cost is that of the other replicas.\n";
+}
+
+void Sweep::runTask(const Task& task) {
+    Point& point = m_points[task.point];
+    const Simulation& simulation = (task.replica < point.nLongReplicas)
+                                           ? *point.p_longSimulation
+                                           : *point.p_simulation;
+    RandomGenerator generator(
+            point.runName + " replica " + std::to_string(task.replica));
+    point.replicaOutputs[task.replica] = simulation.createOutput(false);
+    simulation.runReplica(generator, *point.replicaOutputs[task.replica]);
+
+    bool isLastReplica;
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        isLastReplica = (--point.nUnfinishedReplicas == 0);
+    }
+    if (isLastReplica) {
+        // The files are written when the merged output is destroyed, in the
+        // same order of the replicas every time
+        std::unique_ptr<Output> p_output =
+                point.p_simulation->createOutput(true);
+        for (const std::unique_ptr<Output>& p_replicaOutput:
+             point.replicaOutputs) {
+            p_output->merge(*p_replicaOutput);
+        }
+        p_output.reset();
+        point.replicaOutputs.clear();
+        m_log.writeSweepPoint(point.runName, point.nReplicas);
+    }
+}
+
+void Sweep::run(ThreadPool& threadPool) {
+    threadPool.parallelFor(
+            static_cast<int32_t>(m_tasks.size()),
+            [this](const int32_t task) { runTask(m_tasks[task]); });
+}
@@ -0,0 +1,137 @@
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/SystemModel.hpp"
+
+SystemModel::SystemModel(
+        const double lengthMobileMicrotubule,
+        const double lengthFixedMicrotubule,
+        const double latticeSpacing,
+        const double maxStretchPerLatticeSpacing,
+        const int32_t nActiveCrosslinkers,
+        const int32_t nDualCrosslinkers,
+        const int32_t nPassiveCrosslinkers,
+        const double springConstant,
+        const bool addExternalForce,
+        const std::string& externalForceTypeString,
+        const double externalForceValue,
+        const bool coarseGrainDistantPartials,
+        const bool periodicBoundaries,
+        const bool fixedLatticeWindow,
+        const double fixedLatticeWindowMargin):
+        m_lengthMobileMicrotubule(lengthMobileMicrotubule),
+        m_lengthFixedMicrotubule(lengthFixedMicrotubule),
+        m_latticeSpacing(latticeSpacing),
+        m_maxStretchPerLatticeSpacing(maxStretchPerLatticeSpacing),
+        m_maxNumberOfCloseSites(static_cast<int32_t>(
+                std::ceil(2 * m_maxStretchPerLatticeSpacing))),
+        m_maxStretch(m_maxStretchPerLatticeSpacing * latticeSpacing),
+        m_nActiveCrosslinkers(nActiveCrosslinkers),
+        m_nDualCrosslinkers(nDualCrosslinkers),
+        m_nPassiveCrosslinkers(nPassiveCrosslinkers),
+        m_springConstant(springConstant),
+        m_addExternalForce(addExternalForce),
+        m_externalForceValue(externalForceValue),
+        m_coarseGrainDistantPartials(coarseGrainDistantPartials),
+        m_periodicBoundaries(periodicBoundaries),
+        m_fixedLatticeWindow(fixedLatticeWindow),
+        m_nSitesWindowMargin(
+                fixedLatticeWindow ? static_cast<int32_t>(std::round(
+                                             fixedLatticeWindowMargin /
+                                             latticeSpacing))
+                                   : 0) {
+    if (externalForceTypeString == "BARRIERFREE") {
+        m_externalForceType = ExternalForceType::BARRIERFREE;
+    }
+    else if (externalForceTypeString == "SINUS") {
+        m_externalForceType = ExternalForceType::SINUS;
+    }
+    else if (externalForceTypeString == "CONSTANT") {
+        m_externalForceType = ExternalForceType::CONSTANT;
+    }
+    else {
+        throw GeneralException(
+                "In the SystemModel constructor, the given "
+                "externalForceTypeString "
+                "does not hold a recognised value.");
+    }
+}
+
+SystemModel::~SystemModel() {}
+
+double SystemModel::getLengthMobileMicrotubule() const {
+    return m_lengthMobileMicrotubule;
+}
+
+double SystemModel::getLengthFixedMicrotubule() const {
+    return m_lengthFixedMicrotubule;
+}
+
+double SystemModel::getLatticeSpacing() const { return m_latticeSpacing; }
+
+double SystemModel::getMaxStretch() const { return m_maxStretch; }
+
+int32_t SystemModel::getMaxNumberOfCloseSites() const {
+    return m_maxNumberOfCloseSites;
+}
+
+int32_t SystemModel::getNActiveCrosslinkers() const {
+    return m_nActiveCrosslinkers;
+}
+
+int32_t SystemModel::getNDualCrosslinkers() const {
+    return m_nDualCrosslinkers;
+}
+
+int32_t SystemModel::getNPassiveCrosslinkers() const {
+    return m_nPassiveCrosslinkers;
+}
+
+double SystemModel::getSpringConstant() const { return m_springConstant; }
+
+bool SystemModel::addsExternalForce() const { return m_addExternalForce; }
+
+SystemModel::ExternalForceType SystemModel::getExternalForceType() const {
+    return m_externalForceType;
+}
+
+double SystemModel::getExternalForceValue() const {
+    return m_externalForceValue;
+}
+
+double SystemModel::findExternalEnergy(const double positionMicrotubule) const {
+    if (!m_addExternalForce) {
+        return 0.0;
+    }
+
+    // The negative integrals of the forces in SystemState::findExternalForce
+    switch (m_externalForceType) {
+    case ExternalForceType::SINUS:
+        return -m_externalForceValue * m_latticeSpacing / (2 * m_pi) *
+               std::cos(2 * m_pi * positionMicrotubule / m_latticeSpacing);
+    case ExternalForceType::CONSTANT:
+        return -m_externalForceValue * positionMicrotubule;
+    default:
+        throw GeneralException(
+                "SystemModel::findExternalEnergy() was called for an external "
+                "force without a potential.");
+    }
+}
+
+bool SystemModel::coarseGrainsDistantPartials() const {
+    return m_coarseGrainDistantPartials;
+}
+
+bool SystemModel::hasPeriodicBoundaries() const {
+    return m_periodicBoundaries;
+}
+
+bool SystemModel::hasFixedLatticeWindow() const {
+    return m_fixedLatticeWindow;
+}
+
+int32_t SystemModel::getNSitesWindowMargin() const {
+    return m_nSitesWindowMargin;
+}
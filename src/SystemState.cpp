@@ -1,98 +1,124 @@
 #include <algorithm> // max/min
 #include <cmath> // ceil/floor/abs
 #include <deque>
+#include <istream>
+#include <map>
+#include <memory>
+#include <ostream>
 #include <string>
+#include <vector>
 #include <utility> // pair
 
-#include <gsl/gsl_sf_psi.h>
-
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/Crosslinker.hpp"
 #include "filament-sliding/CrosslinkerContainer.hpp"
+#include "filament-sliding/CrosslinkerRelocation.hpp"
 #include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/JournalEntry.hpp"
 #include "filament-sliding/MathematicalFunctions.hpp"
 #include "filament-sliding/Microtubule.hpp"
 #include "filament-sliding/MicrotubuleType.hpp"
 #include "filament-sliding/MobileMicrotubule.hpp"
 #include "filament-sliding/PossibleFullConnection.hpp"
+#include "filament-sliding/RandomGenerator.hpp"
+#include "filament-sliding/SystemModel.hpp"
 #include "filament-sliding/SystemState.hpp"
+#include "filament-sliding/ThreadPool.hpp"
 
-SystemState::SystemState(
-        const double lengthMobileMicrotubule,
-        const double lengthFixedMicrotubule,
-        const double latticeSpacing,
-        const double maxStretchPerLatticeSpacing,
-        const int32_t nActiveCrosslinkers,
-        const int32_t nDualCrosslinkers,
-        const int32_t nPassiveCrosslinkers,
-        const double springConstant,
-        const bool addExternalForce,
-        const std::string externalForceTypeString,
-        const double externalForceValue):
-        m_maxStretchPerLatticeSpacing(maxStretchPerLatticeSpacing),
-        m_maxNumberOfCloseSites(static_cast<int32_t>(
-                std::ceil(2 * m_maxStretchPerLatticeSpacing))),
-        m_maxStretch(m_maxStretchPerLatticeSpacing * latticeSpacing),
-        m_latticeSpacing(latticeSpacing),
-        m_springConstant(springConstant),
+SystemState::SystemState(const std::shared_ptr<const SystemModel>& p_model):
+        mp_model(p_model),
         m_fixedMicrotubule(
                 MicrotubuleType::FIXED,
-                lengthFixedMicrotubule,
-                latticeSpacing),
-        m_mobileMicrotubule(lengthMobileMicrotubule, latticeSpacing),
-        m_nPassiveCrosslinkers(nPassiveCrosslinkers),
-        m_nDualCrosslinkers(nDualCrosslinkers),
-        m_nActiveCrosslinkers(nActiveCrosslinkers),
-        m_nCrosslinkers(
-                m_nActiveCrosslinkers + m_nDualCrosslinkers +
-                m_nPassiveCrosslinkers),
+                p_model->getLengthFixedMicrotubule(),
+                p_model->getLatticeSpacing(),
+                p_model->hasPeriodicBoundaries(),
+                p_model->hasFixedLatticeWindow()
+                        ? static_cast<int32_t>(std::floor(
+                                  p_model->getLengthMobileMicrotubule() /
+                                  p_model->getLatticeSpacing())) +
+                                  1 + 2 * p_model->getNSitesWindowMargin()
+                        : 0),
+        m_mobileMicrotubule(
+                p_model->getLengthMobileMicrotubule(),
+                p_model->getLatticeSpacing(),
+                p_model->hasPeriodicBoundaries()),
         m_passiveCrosslinkers(
-                m_nPassiveCrosslinkers,
+                p_model->getNPassiveCrosslinkers(),
                 Crosslinker(Crosslinker::Type::PASSIVE),
                 Crosslinker::Type::PASSIVE,
                 m_fixedMicrotubule,
                 m_mobileMicrotubule,
-                m_latticeSpacing,
-                m_maxStretch),
+                p_model->getLatticeSpacing(),
+                p_model->getMaxStretch(),
+                p_model->coarseGrainsDistantPartials()),
         m_dualCrosslinkers(
-                m_nDualCrosslinkers,
+                p_model->getNDualCrosslinkers(),
                 Crosslinker(Crosslinker::Type::DUAL),
                 Crosslinker::Type::DUAL,
                 m_fixedMicrotubule,
                 m_mobileMicrotubule,
-                m_latticeSpacing,
-                m_maxStretch),
+                p_model->getLatticeSpacing(),
+                p_model->getMaxStretch(),
+                p_model->coarseGrainsDistantPartials()),
         m_activeCrosslinkers(
-                m_nActiveCrosslinkers,
+                p_model->getNActiveCrosslinkers(),
                 Crosslinker(Crosslinker::Type::ACTIVE),
                 Crosslinker::Type::ACTIVE,
                 m_fixedMicrotubule,
                 m_mobileMicrotubule,
-                m_latticeSpacing,
-                m_maxStretch),
-        m_addExternalForce(addExternalForce),
-        m_externalForceValue(externalForceValue) {
-    if (externalForceTypeString == "BARRIERFREE") {
-        m_externalForceType = ExternalForceType::BARRIERFREE;
-    }
-    else if (externalForceTypeString == "SINUS") {
-        m_externalForceType = ExternalForceType::SINUS;
-    }
-    else if (externalForceTypeString == "CONSTANT") {
-        m_externalForceType = ExternalForceType::CONSTANT;
+                p_model->getLatticeSpacing(),
+                p_model->getMaxStretch(),
+                p_model->coarseGrainsDistantPartials()) {
+    // Periodic microtubules wrap around together, and a linker should never
+    // be able to reach a site and one of its periodic images at the same time
+    if (mp_model->hasPeriodicBoundaries()) {
+        if (m_fixedMicrotubule.getNSites() != m_mobileMicrotubule.getNSites()) {
+            throw GeneralException(
+                    "With periodic boundaries, the fixed and mobile "
+                    "microtubules should have the same number of sites.");
+        }
+        if (m_fixedMicrotubule.getLength() <= 4 * mp_model->getMaxStretch()) {
+            throw GeneralException(
+                    "With periodic boundaries, the microtubules should be "
+                    "longer than four times the maximum stretch.");
+        }
     }
-    else {
-        throw GeneralException(
-                "In the SystemState constructor, the given "
-                "externalForceTypeString "
-                "does not hold a recognised value.");
+
+    // The window only moves once half of a margin is left, and no full linker
+    // should reach the sites that leave it
+    if (mp_model->hasFixedLatticeWindow()) {
+        if (mp_model->hasPeriodicBoundaries()) {
+            throw GeneralException(
+                    "A window on the fixed microtubule cannot be combined "
+                    "with periodic boundaries.");
+        }
+        if (mp_model->getNSitesWindowMargin() / 2 <=
+            mp_model->getMaxNumberOfCloseSites()) {
+            throw GeneralException(
+                    "The margin of the window on the fixed microtubule should "
+                    "be larger than four times the maximum stretch.");
+        }
     }
+
+    m_occupancyBelowWindow.nSites = 0;
+    m_occupancyAboveWindow.nSites = m_fixedMicrotubule.getNSites() -
+                                    m_fixedMicrotubule.getLastStoredSite() - 1;
 }
 
 SystemState::~SystemState() {}
 
+void SystemState::setThreadPool(ThreadPool* const p_threadPool) {
+    m_passiveCrosslinkers.setThreadPool(p_threadPool);
+    m_dualCrosslinkers.setThreadPool(p_threadPool);
+    m_activeCrosslinkers.setThreadPool(p_threadPool);
+}
+
 void SystemState::setMicrotubulePosition(const double initialPosition) {
 #ifdef MYDEBUG
-    if (m_nCrosslinkers != getNFreeCrosslinkers()) {
+    if (mp_model->getNActiveCrosslinkers() +
+                mp_model->getNDualCrosslinkers() +
+                mp_model->getNPassiveCrosslinkers() !=
+        getNFreeCrosslinkers()) {
         throw GeneralException(
                 "SystemState::setMicrotubulePosition() was called "
                 "on a system which has connected linkers");
@@ -101,6 +127,14 @@ void SystemState::setMicrotubulePosition(const double initialPosition) {
 
     m_mobileMicrotubule.setPosition(initialPosition);
 
+    if (m_fixedMicrotubule.hasWindow()) {
+        m_fixedMicrotubule.moveWindow(centredFixedLatticeWindowStart());
+        m_occupancyBelowWindow.nSites = m_fixedMicrotubule.getFirstStoredSite();
+        m_occupancyAboveWindow.nSites =
+                m_fixedMicrotubule.getNSites() -
+                m_fixedMicrotubule.getLastStoredSite() - 1;
+    }
+
     // since no linkers are connected, the only thing the following function
     // calls do is set the borders of the region within the possibilities are
     // valid
@@ -109,6 +143,233 @@ void SystemState::setMicrotubulePosition(const double initialPosition) {
     m_activeCrosslinkers.resetPossibilities();
 }
 
+void SystemState::copyStateFrom(const SystemState& other) {
+    if (other.mp_model->getLatticeSpacing() != mp_model->getLatticeSpacing() ||
+        other.mp_model->getMaxStretch() != mp_model->getMaxStretch() ||
+        other.mp_model->getNSitesWindowMargin() !=
+                mp_model->getNSitesWindowMargin()) {
+        throw GeneralException(
+                "SystemState::copyStateFrom() was called with a system with "
+                "another lattice, maximum stretch or window");
+    }
+
+    CrosslinkerRelocation relocation;
+    m_passiveCrosslinkers.addToRelocation(
+            other.m_passiveCrosslinkers, relocation);
+    m_dualCrosslinkers.addToRelocation(other.m_dualCrosslinkers, relocation);
+    m_activeCrosslinkers.addToRelocation(
+            other.m_activeCrosslinkers, relocation);
+
+    m_fixedMicrotubule.copyStateFrom(other.m_fixedMicrotubule, relocation);
+    m_mobileMicrotubule.copyStateFrom(other.m_mobileMicrotubule, relocation);
+    m_passiveCrosslinkers.copyStateFrom(
+            other.m_passiveCrosslinkers, relocation);
+    m_dualCrosslinkers.copyStateFrom(other.m_dualCrosslinkers, relocation);
+    m_activeCrosslinkers.copyStateFrom(other.m_activeCrosslinkers, relocation);
+
+    m_occupancyBelowWindow = other.m_occupancyBelowWindow;
+    m_occupancyAboveWindow = other.m_occupancyAboveWindow;
+
+    m_journal.clear();
+    m_journalOccupancies.clear();
+
+    updateForceAndEnergy();
+}
+
+void SystemState::writeCheckpoint(std::ostream& out) const {
+    CrosslinkerRelocation relocation;
+    m_passiveCrosslinkers.addToRelocation(relocation);
+    m_dualCrosslinkers.addToRelocation(relocation);
+    m_activeCrosslinkers.addToRelocation(relocation);
+
+    m_fixedMicrotubule.writeCheckpoint(out, relocation);
+    m_mobileMicrotubule.writeCheckpoint(out, relocation);
+    m_passiveCrosslinkers.writeCheckpoint(out, relocation);
+    m_dualCrosslinkers.writeCheckpoint(out, relocation);
+    m_activeCrosslinkers.writeCheckpoint(out, relocation);
+
+    writeOccupancy(out, m_occupancyBelowWindow);
+    writeOccupancy(out, m_occupancyAboveWindow);
+}
+
+void SystemState::readCheckpoint(std::istream& in) {
+    // The crosslinkers are restored in place, so they are relocated onto
+    // themselves
+    CrosslinkerRelocation relocation;
+    m_passiveCrosslinkers.addToRelocation(m_passiveCrosslinkers, relocation);
+    m_dualCrosslinkers.addToRelocation(m_dualCrosslinkers, relocation);
+    m_activeCrosslinkers.addToRelocation(m_activeCrosslinkers, relocation);
+
+    m_fixedMicrotubule.readCheckpoint(in, relocation);
+    m_mobileMicrotubule.readCheckpoint(in, relocation);
+    m_passiveCrosslinkers.readCheckpoint(in, relocation);
+    m_dualCrosslinkers.readCheckpoint(in, relocation);
+    m_activeCrosslinkers.readCheckpoint(in, relocation);
+
+    readOccupancy(in, m_occupancyBelowWindow);
+    readOccupancy(in, m_occupancyAboveWindow);
+
+    m_journal.clear();
+    m_journalOccupancies.clear();
+
+    updateForceAndEnergy();
+}
+
+void SystemState::writeOccupancy(
+        std::ostream& out,
+        const RegionOccupancy& occupancy) {
+    Checkpoint::write(out, occupancy.nSites);
+    Checkpoint::write(
+            out, static_cast<int64_t>(occupancy.nPartialLinkers.size()));
+    for (const auto& nLinkers: occupancy.nPartialLinkers) {
+        Checkpoint::write(out, nLinkers.first.first);
+        Checkpoint::write(out, nLinkers.first.second);
+        Checkpoint::write(out, nLinkers.second);
+    }
+}
+
+void SystemState::readOccupancy(std::istream& in, RegionOccupancy& occupancy) {
+    Checkpoint::read(in, occupancy.nSites);
+    int64_t nEntries;
+    Checkpoint::read(in, nEntries);
+    occupancy.nPartialLinkers.clear();
+    for (int64_t i = 0; i < nEntries; ++i) {
+        Crosslinker::Type type;
+        Crosslinker::Terminus terminus;
+        int32_t nLinkers;
+        Checkpoint::read(in, type);
+        Checkpoint::read(in, terminus);
+        Checkpoint::read(in, nLinkers);
+        occupancy.nPartialLinkers[{type, terminus}] = nLinkers;
+    }
+}
+
+void SystemState::startJournal() { m_recordJournal = true; }
+
+void SystemState::stopJournal() {
+    m_recordJournal = false;
+    m_journal.clear();
+    m_journalOccupancies.clear();
+}
+
+int32_t SystemState::getJournalMark() const {
+    return static_cast<int32_t>(m_journal.size());
+}
+
+void SystemState::rollBack(const int32_t mark) {
+    if (mark < 0 || mark > getJournalMark()) {
+        throw GeneralException(
+                "SystemState::rollBack() was called with a mark that is not "
+                "in the journal");
+    }
+
+    // Undoing a change should not be recorded itself
+    const bool recordJournal = m_recordJournal;
+    m_recordJournal = false;
+    while (getJournalMark() > mark) {
+        undoChange(m_journal.back());
+        m_journal.pop_back();
+    }
+    m_recordJournal = recordJournal;
+
+    updateForceAndEnergy();
+}
+
+bool SystemState::hasSameConfigurationAs(const SystemState& other) const {
+    const auto hasSameOccupancy = [](const RegionOccupancy& occupancy,
+                                     const RegionOccupancy& otherOccupancy) {
+        return occupancy.nSites == otherOccupancy.nSites &&
+               occupancy.nPartialLinkers == otherOccupancy.nPartialLinkers;
+    };
+    return m_mobileMicrotubule.getPosition() ==
+                   other.m_mobileMicrotubule.getPosition() &&
+           m_mobileMicrotubule.getAttractorPosition() ==
+                   other.m_mobileMicrotubule.getAttractorPosition() &&
+           m_fixedMicrotubule.hasSameOccupationAs(other.m_fixedMicrotubule) &&
+           m_mobileMicrotubule.hasSameOccupationAs(
+                   other.m_mobileMicrotubule) &&
+           hasSameOccupancy(
+                   m_occupancyBelowWindow, other.m_occupancyBelowWindow) &&
+           hasSameOccupancy(
+                   m_occupancyAboveWindow, other.m_occupancyAboveWindow);
+}
+
+void SystemState::undoChange(const JournalEntry& entry) {
+    switch (entry.change) {
+    case JournalEntry::Change::CONNECT_FREE:
+        disconnectPartiallyConnectedCrosslinker(crosslinkerAt(entry.location));
+        break;
+    case JournalEntry::Change::DISCONNECT_PARTIAL:
+        connectFreeCrosslinker(entry.type, entry.terminus, entry.location);
+        break;
+    case JournalEntry::Change::CONNECT_PARTIAL:
+        disconnectFullyConnectedCrosslinker(
+                crosslinkerAt(entry.location), entry.terminus);
+        break;
+    case JournalEntry::Change::DISCONNECT_FULL:
+        connectPartiallyConnectedCrosslinker(
+                crosslinkerAt(entry.remainingLocation), entry.location);
+        break;
+    case JournalEntry::Change::MOVE_MOBILE: {
+        // Restored exactly, instead of moving back by the opposite change
+        const double change =
+                entry.position - m_mobileMicrotubule.getPosition();
+        m_mobileMicrotubule.restorePosition(
+                entry.position, entry.attractorPosition);
+        m_passiveCrosslinkers.updateConnectionDataMobilePositionChange(change);
+        m_dualCrosslinkers.updateConnectionDataMobilePositionChange(change);
+        m_activeCrosslinkers.updateConnectionDataMobilePositionChange(change);
+        break;
+    }
+    case JournalEntry::Change::CROSS_BARRIER:
+        m_mobileMicrotubule.restorePosition(
+                entry.position, entry.attractorPosition);
+        break;
+    case JournalEntry::Change::MOVE_WINDOW:
+        // The linkers that were drawn onto the sites entering the window have
+        // been disconnected already, and are stored again. The ones that were
+        // stored away are released here, and connected again afterwards
+        m_fixedMicrotubule.moveWindow(entry.firstStoredSite);
+        m_occupancyBelowWindow = m_journalOccupancies.back().first;
+        m_occupancyAboveWindow = m_journalOccupancies.back().second;
+        m_journalOccupancies.pop_back();
+        storeLinkersOfOccupancies();
+        findPossibilities(Crosslinker::Type::PASSIVE);
+        findPossibilities(Crosslinker::Type::DUAL);
+        findPossibilities(Crosslinker::Type::ACTIVE);
+        break;
+    default:
+        throw GeneralException(
+                "An incorrect change was passed to SystemState::undoChange()");
+        break;
+    }
+}
+
+Crosslinker& SystemState::crosslinkerAt(const SiteLocation location) {
+    Crosslinker* p_crosslinker = nullptr;
+    switch (location.microtubule) {
+    case MicrotubuleType::FIXED:
+        p_crosslinker =
+                m_fixedMicrotubule.whichCrosslinkerIsBoundTo(location.position);
+        break;
+    case MicrotubuleType::MOBILE:
+        p_crosslinker = m_mobileMicrotubule.whichCrosslinkerIsBoundTo(
+                location.position);
+        break;
+    default:
+        throw GeneralException(
+                "An incorrect microtubule type was passed to "
+                "SystemState::crosslinkerAt()");
+        break;
+    }
+
+    if (p_crosslinker == nullptr) {
+        throw GeneralException(
+                "SystemState::crosslinkerAt() was called on a free site");
+    }
+    return *p_crosslinker;
+}
+
 // The following function assumes that it is possible to connect the
 // crosslinker, otherwise it will throw
 Crosslinker& SystemState::connectFreeCrosslinker(
@@ -177,6 +438,13 @@ Crosslinker& SystemState::connectFreeCrosslinker(
     m_activeCrosslinkers.updateConnectionDataFreeToPartial(
             p_connectingCrosslinker);
 
+    if (m_recordJournal) {
+        JournalEntry entry {};
+        entry.change = JournalEntry::Change::CONNECT_FREE;
+        entry.location = locationToConnectTo;
+        m_journal.push_back(entry);
+    }
+
     return *p_connectingCrosslinker; // Such that the caller can use this
                                      // specific crosslinker immediately
 }
@@ -252,6 +520,15 @@ void SystemState::disconnectPartiallyConnectedCrosslinker(
             &disconnectingCrosslinker,
             locationToDisconnectFrom,
             disconnectingTerminus);
+
+    if (m_recordJournal) {
+        JournalEntry entry {};
+        entry.change = JournalEntry::Change::DISCONNECT_PARTIAL;
+        entry.type = type;
+        entry.terminus = disconnectingTerminus;
+        entry.location = locationToDisconnectFrom;
+        m_journal.push_back(entry);
+    }
 }
 
 void SystemState::connectPartiallyConnectedCrosslinker(
@@ -275,25 +552,27 @@ void SystemState::connectPartiallyConnectedCrosslinker(
                 "connect a crosslinker twice to one microtubule");
     }
 
-    // Test whether the connection is not outside of the range set by
-    // m_maxStretch position is calculated relative to the fixed microtubule,
-    // because we want to calculate the total stretch for the check
+    // Test whether the connection is not outside of the range set by the
+    // maximum stretch. The position is calculated relative to the fixed
+    // microtubule, because we want to calculate the total stretch for the
+    // check
+    const double latticeSpacing = mp_model->getLatticeSpacing();
     double positionOnFixedMicrotubule;
     double positionOnMobileMicrotubule;
 
     switch (locationOppositeMicrotubule.microtubule) {
     case MicrotubuleType::FIXED:
         positionOnFixedMicrotubule =
-                locationOppositeMicrotubule.position * m_latticeSpacing;
+                locationOppositeMicrotubule.position * latticeSpacing;
         positionOnMobileMicrotubule =
-                locationThisMicrotubule.position * m_latticeSpacing +
+                locationThisMicrotubule.position * latticeSpacing +
                 m_mobileMicrotubule.getPosition();
         break;
     case MicrotubuleType::MOBILE:
         positionOnFixedMicrotubule =
-                locationThisMicrotubule.position * m_latticeSpacing;
+                locationThisMicrotubule.position * latticeSpacing;
         positionOnMobileMicrotubule =
-                locationOppositeMicrotubule.position * m_latticeSpacing +
+                locationOppositeMicrotubule.position * latticeSpacing +
                 m_mobileMicrotubule.getPosition();
         break;
     default:
@@ -303,8 +582,9 @@ void SystemState::connectPartiallyConnectedCrosslinker(
         break;
     }
 
-    if (std::abs(positionOnFixedMicrotubule - positionOnMobileMicrotubule) >=
-        m_maxStretch) {
+    if (std::abs(m_fixedMicrotubule.getMinimumImage(
+                positionOnFixedMicrotubule - positionOnMobileMicrotubule)) >=
+        mp_model->getMaxStretch()) {
         throw GeneralException(
                 "A full connection attempt was made creating an overstretched "
                 "crosslinker in "
@@ -371,6 +651,14 @@ void SystemState::connectPartiallyConnectedCrosslinker(
             &connectingCrosslinker,
             locationOppositeMicrotubule,
             terminusToConnect);
+
+    if (m_recordJournal) {
+        JournalEntry entry {};
+        entry.change = JournalEntry::Change::CONNECT_PARTIAL;
+        entry.terminus = terminusToConnect;
+        entry.location = locationOppositeMicrotubule;
+        m_journal.push_back(entry);
+    }
 }
 
 void SystemState::disconnectFullyConnectedCrosslinker(
@@ -440,6 +728,16 @@ void SystemState::disconnectFullyConnectedCrosslinker(
             &disconnectingCrosslinker, locationToDisconnectFrom);
     m_activeCrosslinkers.updateConnectionDataFullToPartial(
             &disconnectingCrosslinker, locationToDisconnectFrom);
+
+    if (m_recordJournal) {
+        JournalEntry entry {};
+        entry.change = JournalEntry::Change::DISCONNECT_FULL;
+        entry.location = locationToDisconnectFrom;
+        entry.remainingLocation =
+                disconnectingCrosslinker
+                        .getBoundLocationWhenPartiallyConnected();
+        m_journal.push_back(entry);
+    }
 }
 
 // This function performs all steps to go from a free to a fully connected
@@ -466,6 +764,14 @@ void SystemState::fullyConnectFreeCrosslinker(
 void SystemState::updateMobilePosition(const double changeMicrotubulePosition) {
     // This method assumes that the change in the microtubule position is
     // allowed by the fully connected crosslinkers
+    if (m_recordJournal) {
+        JournalEntry entry {};
+        entry.change = JournalEntry::Change::MOVE_MOBILE;
+        entry.position = m_mobileMicrotubule.getPosition();
+        entry.attractorPosition = m_mobileMicrotubule.getAttractorPosition();
+        m_journal.push_back(entry);
+    }
+
     m_mobileMicrotubule.updatePosition(changeMicrotubulePosition);
 
     m_passiveCrosslinkers.updateConnectionDataMobilePositionChange(
@@ -476,8 +782,250 @@ void SystemState::updateMobilePosition(const double changeMicrotubulePosition) {
             changeMicrotubulePosition);
 }
 
+bool SystemState::hasFixedLatticeWindow() const {
+    return m_fixedMicrotubule.hasWindow();
+}
+
+int32_t SystemState::centredFixedLatticeWindowStart() const {
+    const int32_t nStoredSites = m_fixedMicrotubule.getLastStoredSite() -
+                                 m_fixedMicrotubule.getFirstStoredSite() + 1;
+    const int32_t firstSite =
+            static_cast<int32_t>(std::floor(
+                    m_mobileMicrotubule.getPosition() /
+                    mp_model->getLatticeSpacing())) -
+            mp_model->getNSitesWindowMargin();
+    return std::max(
+            0,
+            std::min(
+                    firstSite,
+                    m_fixedMicrotubule.getNSites() - nStoredSites));
+}
+
+void SystemState::updateFixedLatticeWindow(RandomGenerator& generator) {
+    if (!m_fixedMicrotubule.hasWindow()) {
+        return;
+    }
+
+    const int32_t oldFirstSite = m_fixedMicrotubule.getFirstStoredSite();
+    const int32_t oldLastSite = m_fixedMicrotubule.getLastStoredSite();
+    const int32_t firstSiteMobile = static_cast<int32_t>(std::floor(
+            m_mobileMicrotubule.getPosition() / mp_model->getLatticeSpacing()));
+    const int32_t lastSiteMobile =
+            firstSiteMobile + m_mobileMicrotubule.getNSites() - 1;
+
+    // A margin that reaches the end of the fixed microtubule cannot grow
+    const int32_t halfMargin = mp_model->getNSitesWindowMargin() / 2;
+    const bool enoughBelow =
+            oldFirstSite == 0 || firstSiteMobile - oldFirstSite >= halfMargin;
+    const bool enoughAbove =
+            oldLastSite == m_fixedMicrotubule.getNSites() - 1 ||
+            oldLastSite - lastSiteMobile >= halfMargin;
+    if (enoughBelow && enoughAbove) {
+        return;
+    }
+
+    const int32_t newFirstSite = centredFixedLatticeWindowStart();
+    const int32_t newLastSite = newFirstSite + oldLastSite - oldFirstSite;
+    if (newFirstSite == oldFirstSite) {
+        return;
+    }
+
+    // The move is recorded in between storing and restoring the occupancies,
+    // such that the stored linkers are connected again after the window has
+    // moved back
+    JournalEntry entry {};
+    entry.change = JournalEntry::Change::MOVE_WINDOW;
+    entry.firstStoredSite = oldFirstSite;
+    if (m_recordJournal) {
+        m_journalOccupancies.emplace_back(
+                m_occupancyBelowWindow, m_occupancyAboveWindow);
+    }
+
+    if (newFirstSite > oldFirstSite) {
+        storeOccupancy(
+                oldFirstSite,
+                std::min(newFirstSite - 1, oldLastSite),
+                m_occupancyBelowWindow);
+        if (m_recordJournal) {
+            m_journal.push_back(entry);
+        }
+        m_fixedMicrotubule.moveWindow(newFirstSite);
+        restoreOccupancy(
+                std::max(oldLastSite + 1, newFirstSite),
+                newLastSite,
+                m_occupancyAboveWindow,
+                generator);
+    }
+    else {
+        storeOccupancy(
+                std::max(newLastSite + 1, oldFirstSite),
+                oldLastSite,
+                m_occupancyAboveWindow);
+        if (m_recordJournal) {
+            m_journal.push_back(entry);
+        }
+        m_fixedMicrotubule.moveWindow(newFirstSite);
+        restoreOccupancy(
+                newFirstSite,
+                std::min(oldFirstSite - 1, newLastSite),
+                m_occupancyBelowWindow,
+                generator);
+    }
+
+    // Linkers at the new ends of the window can hop to sites they could not
+    // reach before, and the other way around
+    findPossibilities(Crosslinker::Type::PASSIVE);
+    findPossibilities(Crosslinker::Type::DUAL);
+    findPossibilities(Crosslinker::Type::ACTIVE);
+
+#ifdef MYDEBUG
+    for (const Crosslinker::Type type:
+         {Crosslinker::Type::PASSIVE,
+          Crosslinker::Type::DUAL,
+          Crosslinker::Type::ACTIVE}) {
+        if (getCrosslinkerContainer(type).getNStoredCrosslinkers() !=
+            getNLinkersOfOccupancies(type)) {
+            throw GeneralException(
+                    "After the window moved, the stored linkers did not "
+                    "match the occupancies outside of it.");
+        }
+    }
+#endif // MYDEBUG
+}
+
+CrosslinkerContainer& SystemState::getCrosslinkerContainer(
+        const Crosslinker::Type type) {
+    switch (type) {
+    case Crosslinker::Type::PASSIVE:
+        return m_passiveCrosslinkers;
+    case Crosslinker::Type::DUAL:
+        return m_dualCrosslinkers;
+    case Crosslinker::Type::ACTIVE:
+        return m_activeCrosslinkers;
+    default:
+        throw GeneralException(
+                "An incorrect type was passed to "
+                "SystemState::getCrosslinkerContainer()");
+    }
+}
+
+void SystemState::storeOccupancy(
+        const int32_t firstSite,
+        const int32_t lastSite,
+        RegionOccupancy& occupancy) {
+    for (const Crosslinker::Type type:
+         {Crosslinker::Type::PASSIVE,
+          Crosslinker::Type::DUAL,
+          Crosslinker::Type::ACTIVE}) {
+        // Copied, since disconnecting linkers changes the original
+        const std::vector<Crosslinker*> partialLinkers =
+                getPartialLinkers(type);
+        for (Crosslinker* const p_linker: partialLinkers) {
+            const SiteLocation location =
+                    p_linker->getBoundLocationWhenPartiallyConnected();
+            if (location.microtubule == MicrotubuleType::FIXED &&
+                location.position >= firstSite &&
+                location.position <= lastSite) {
+                ++occupancy.nPartialLinkers[std::make_pair(
+                        type,
+                        p_linker->getBoundTerminusWhenPartiallyConnected())];
+                disconnectPartiallyConnectedCrosslinker(*p_linker);
+                // The disconnected linker is the last free one
+                CrosslinkerContainer& container =
+                        getCrosslinkerContainer(type);
+                container.setNStoredCrosslinkers(
+                        container.getNStoredCrosslinkers() + 1);
+            }
+        }
+    }
+
+    occupancy.nSites += lastSite - firstSite + 1;
+}
+
+void SystemState::restoreOccupancy(
+        const int32_t firstSite,
+        const int32_t lastSite,
+        RegionOccupancy& occupancy,
+        RandomGenerator& generator) {
+    int32_t nPartialLinkers = 0;
+    for (const auto& category: occupancy.nPartialLinkers) {
+        nPartialLinkers += category.second;
+    }
+
+    for (int32_t position = firstSite; position <= lastSite; ++position) {
+        if (nPartialLinkers == 0) {
+            --occupancy.nSites;
+            continue;
+        }
+
+        // Draw without replacement, such that the region keeps its occupancy
+        // when it is stored and restored again
+        int32_t draw = generator.getUniformInteger(0, occupancy.nSites - 1);
+        --occupancy.nSites;
+        for (auto& category: occupancy.nPartialLinkers) {
+            if (draw < category.second) {
+                --category.second;
+                --nPartialLinkers;
+                const Crosslinker::Type type = category.first.first;
+                CrosslinkerContainer& container =
+                        getCrosslinkerContainer(type);
+                if (container.getNStoredCrosslinkers() == 0) {
+                    throw GeneralException(
+                            "SystemState::restoreOccupancy() found fewer "
+                            "stored linkers than the regions outside of the "
+                            "window hold.");
+                }
+                // The released linker is the last free one, which is the one
+                // that is connected
+                container.setNStoredCrosslinkers(
+                        container.getNStoredCrosslinkers() - 1);
+                connectFreeCrosslinker(
+                        type,
+                        category.first.second,
+                        SiteLocation{MicrotubuleType::FIXED, position});
+                break;
+            }
+            draw -= category.second;
+        }
+    }
+}
+
+int32_t SystemState::getNLinkersOfOccupancies(
+        const Crosslinker::Type type) const {
+    int32_t nLinkers = 0;
+    for (const RegionOccupancy* const p_occupancy:
+         {&m_occupancyBelowWindow, &m_occupancyAboveWindow}) {
+        for (const auto& category: p_occupancy->nPartialLinkers) {
+            if (category.first.first == type) {
+                nLinkers += category.second;
+            }
+        }
+    }
+    return nLinkers;
+}
+
+void SystemState::storeLinkersOfOccupancies() {
+    for (const Crosslinker::Type type:
+         {Crosslinker::Type::PASSIVE,
+          Crosslinker::Type::DUAL,
+          Crosslinker::Type::ACTIVE}) {
+        getCrosslinkerContainer(type).setNStoredCrosslinkers(
+                getNLinkersOfOccupancies(type));
+    }
+}
+
 int32_t SystemState::barrierCrossed() {
-    return m_mobileMicrotubule.barrierCrossed();
+    const int32_t oldAttractorPosition =
+            m_mobileMicrotubule.getAttractorPosition();
+    const int32_t direction = m_mobileMicrotubule.barrierCrossed();
+    if (m_recordJournal && direction != 0) {
+        JournalEntry entry {};
+        entry.change = JournalEntry::Change::CROSS_BARRIER;
+        entry.position = m_mobileMicrotubule.getPosition();
+        entry.attractorPosition = oldAttractorPosition;
+        m_journal.push_back(entry);
+    }
+    return direction;
 }
 
 // Gives the upper and lower bounds to the possible change in mobile microtubule
@@ -499,10 +1047,30 @@ std::pair<double, double> SystemState::movementBordersSetByFullLinkers() const {
                      setByActive.second}));
 }
 
+std::pair<double, double> SystemState::getPossibilityBorders() const {
+    const std::pair<double, double> passiveBorders =
+            m_passiveCrosslinkers.getPossibilityBorders();
+    const std::pair<double, double> dualBorders =
+            m_dualCrosslinkers.getPossibilityBorders();
+    const std::pair<double, double> activeBorders =
+            m_activeCrosslinkers.getPossibilityBorders();
+    return std::pair<double, double>(
+            std::max(
+                    {passiveBorders.first,
+                     dualBorders.first,
+                     activeBorders.first}),
+            std::min(
+                    {passiveBorders.second,
+                     dualBorders.second,
+                     activeBorders.second}));
+}
+
 double SystemState::getMicrotubulePosition() const {
     return m_mobileMicrotubule.getPosition();
 }
 
+const SystemModel& SystemState::getModel() const { return *mp_model; }
+
 int32_t SystemState::getNFreeCrosslinkersOfType(
         const Crosslinker::Type type) const {
     switch (type) {
@@ -584,12 +1152,18 @@ int32_t SystemState::getNFullRightPullingCrosslinkers() const {
 }
 
 double SystemState::beginningOverlap() const {
+    if (m_fixedMicrotubule.isPeriodic()) {
+        return 0.0;
+    }
     // 0.0 is the position of the minus end of the fixed microtubule (the
     // origin)
     return std::max(0.0, m_mobileMicrotubule.getPosition());
 }
 
 double SystemState::endOverlap() const {
+    if (m_fixedMicrotubule.isPeriodic()) {
+        return m_fixedMicrotubule.getLength();
+    }
     return std::min(
             m_fixedMicrotubule.getLength(),
             m_mobileMicrotubule.getLength() +
@@ -602,7 +1176,7 @@ double SystemState::overlapLength() const {
 
     // Leave this test: if the microtubule ever moves into an unbound
     // configuration and drifts away, we should know about it
-    if (overlap <= (-m_maxStretch)) {
+    if (overlap <= (-mp_model->getMaxStretch())) {
         throw GeneralException(
                 "The overlap disappeared according to "
                 "SystemState::overlapLength()");
@@ -615,33 +1189,85 @@ double SystemState::overlapLength() const {
 // site just next to the strict overlap is still an option. Assume that the
 // overlap exists
 int32_t SystemState::firstSiteOverlapFixed() const {
+    if (m_fixedMicrotubule.isPeriodic()) {
+        return 0;
+    }
     double pos = beginningOverlap();
-    return m_fixedMicrotubule.getFirstPositionCloseTo(pos, m_maxStretch);
+    return m_fixedMicrotubule.getFirstPositionCloseTo(
+            pos, mp_model->getMaxStretch());
 }
 
 int32_t SystemState::lastSiteOverlapFixed() const {
+    if (m_fixedMicrotubule.isPeriodic()) {
+        return m_fixedMicrotubule.getNSites() - 1;
+    }
     double pos = endOverlap();
-    return m_fixedMicrotubule.getLastPositionCloseTo(pos, m_maxStretch);
+    return m_fixedMicrotubule.getLastPositionCloseTo(
+            pos, mp_model->getMaxStretch());
 }
 
 int32_t SystemState::firstSiteOverlapMobile() const {
+    if (m_mobileMicrotubule.isPeriodic()) {
+        return m_mobileMicrotubule.getPeriodicPosition(static_cast<int32_t>(
+                std::round(-m_mobileMicrotubule.getPosition() /
+                           mp_model->getLatticeSpacing())));
+    }
     double pos = beginningOverlap() - m_mobileMicrotubule.getPosition();
-    return m_mobileMicrotubule.getFirstPositionCloseTo(pos, m_maxStretch);
+    return m_mobileMicrotubule.getFirstPositionCloseTo(
+            pos, mp_model->getMaxStretch());
 }
 
 int32_t SystemState::lastSiteOverlapMobile() const {
+    if (m_mobileMicrotubule.isPeriodic()) {
+        return m_mobileMicrotubule.getPeriodicPosition(
+                firstSiteOverlapMobile() - 1);
+    }
     double pos = endOverlap() - m_mobileMicrotubule.getPosition();
-    return m_mobileMicrotubule.getLastPositionCloseTo(pos, m_maxStretch);
+    return m_mobileMicrotubule.getLastPositionCloseTo(
+            pos, mp_model->getMaxStretch());
 }
 
 int32_t SystemState::getNSitesOverlapFixed() const {
+    if (m_fixedMicrotubule.isPeriodic()) {
+        return m_fixedMicrotubule.getNSites();
+    }
     return lastSiteOverlapFixed() - firstSiteOverlapFixed() + 1;
 }
 
 int32_t SystemState::getNSitesOverlapMobile() const {
+    if (m_mobileMicrotubule.isPeriodic()) {
+        return m_mobileMicrotubule.getNSites();
+    }
     return lastSiteOverlapMobile() - firstSiteOverlapMobile() + 1;
 }
 
+int32_t SystemState::getNOccupiedSitesOverlapFixed() const {
+    return getNSitesOverlapFixed() -
+           m_fixedMicrotubule.getNFreeSitesBetween(
+                   firstSiteOverlapFixed(), lastSiteOverlapFixed());
+}
+
+bool SystemState::hasPeriodicBoundaries() const {
+    return m_fixedMicrotubule.isPeriodic();
+}
+
+int32_t SystemState::getPeriodicPosition(
+        const MicrotubuleType microtubuleType,
+        const int32_t position) const {
+    switch (microtubuleType) {
+    case MicrotubuleType::FIXED:
+        return m_fixedMicrotubule.getPeriodicPosition(position);
+        break;
+    case MicrotubuleType::MOBILE:
+        return m_mobileMicrotubule.getPeriodicPosition(position);
+        break;
+    default:
+        throw GeneralException(
+                "An incorrect microtubule type was passed to "
+                "SystemState::getPeriodicPosition()");
+    }
+}
+
 int32_t SystemState::getNFreeSites() const {
     return m_fixedMicrotubule.getNFreeSites() +
            m_mobileMicrotubule.getNFreeSites();
@@ -673,7 +1299,7 @@ int32_t SystemState::getFreeSitePosition(
     }
 }
 
-double SystemState::getMaxStretch() const { return m_maxStretch; }
+double SystemState::getMaxStretch() const { return mp_model->getMaxStretch(); }
 
 #ifdef MYDEBUG
 int32_t SystemState::getNSitesToBindPartial(
@@ -802,6 +1428,24 @@ const std::vector<FullConnection>& SystemState::getFullConnections(
     }
 }
 
+double SystemState::getExtensionShift(const Crosslinker::Type type) const {
+    switch (type) {
+    case Crosslinker::Type::PASSIVE:
+        return m_passiveCrosslinkers.getExtensionShift();
+        break;
+    case Crosslinker::Type::DUAL:
+        return m_dualCrosslinkers.getExtensionShift();
+        break;
+    case Crosslinker::Type::ACTIVE:
+        return m_activeCrosslinkers.getExtensionShift();
+        break;
+    default:
+        throw GeneralException(
+                "An incorrect type was passed to "
+                "SystemState::getExtensionShift()");
+    }
+}
+
 const std::vector<Crosslinker*>& SystemState::getPartialLinkers(
         const Crosslinker::Type type) const {
     switch (type) {
@@ -821,6 +1465,65 @@ const std::vector<Crosslinker*>& SystemState::getPartialLinkers(
     }
 }
 
+std::vector<Crosslinker*> SystemState::getDistantPartialLinkers(
+        const Crosslinker::Type type) const {
+    switch (type) {
+    case Crosslinker::Type::PASSIVE:
+        return m_passiveCrosslinkers.getDistantPartialLinkers();
+        break;
+    case Crosslinker::Type::DUAL:
+        return m_dualCrosslinkers.getDistantPartialLinkers();
+        break;
+    case Crosslinker::Type::ACTIVE:
+        return m_activeCrosslinkers.getDistantPartialLinkers();
+        break;
+    default:
+        throw GeneralException(
+                "An incorrect type was passed to "
+                "SystemState::getDistantPartialLinkers()");
+    }
+}
+
+bool SystemState::isDistantSite(
+        const Crosslinker::Type type,
+        const SiteLocation& location) const {
+    switch (type) {
+    case Crosslinker::Type::PASSIVE:
+        return m_passiveCrosslinkers.isDistantSite(location);
+        break;
+    case Crosslinker::Type::DUAL:
+        return m_dualCrosslinkers.isDistantSite(location);
+        break;
+    case Crosslinker::Type::ACTIVE:
+        return m_activeCrosslinkers.isDistantSite(location);
+        break;
+    default:
+        throw GeneralException(
+                "An incorrect type was passed to "
+                "SystemState::isDistantSite()");
+    }
+}
+
+int32_t SystemState::getPositionAfterHop(
+        const SiteLocation& origin,
+        const int32_t position,
+        const int32_t direction) const {
+    switch (origin.microtubule) {
+    case MicrotubuleType::FIXED:
+        return m_fixedMicrotubule.getPositionAfterHop(
+                origin.position, position, direction);
+        break;
+    case MicrotubuleType::MOBILE:
+        return m_mobileMicrotubule.getPositionAfterHop(
+                origin.position, position, direction);
+        break;
+    default:
+        throw GeneralException(
+                "An incorrect microtubule type was passed to "
+                "SystemState::getPositionAfterHop()");
+    }
+}
+
 const std::vector<Crosslinker*>& SystemState::getFullLinkers(
         const Crosslinker::Type type) const {
     switch (type) {
@@ -879,44 +1582,47 @@ const std::vector<Crosslinker*>& SystemState::getPartialLinkersBoundWithTail(
 }
 
 void SystemState::updateForceAndEnergy() {
-    const std::vector<FullConnection>& passiveFullConnections =
-            getFullConnections(Crosslinker::Type::PASSIVE);
-    const std::vector<FullConnection>& dualFullConnections =
-            getFullConnections(Crosslinker::Type::DUAL);
-    const std::vector<FullConnection>& activeFullConnections =
-            getFullConnections(Crosslinker::Type::ACTIVE);
-
     double totalExtension = 0;
     double totalSquaredExtension = 0;
 
-    for (const FullConnection& fullConnection: passiveFullConnections) {
-        totalExtension += fullConnection.extension;
-        totalSquaredExtension +=
-                fullConnection.extension * fullConnection.extension;
-    }
-    for (const FullConnection& fullConnection: dualFullConnections) {
-        totalExtension += fullConnection.extension;
-        totalSquaredExtension +=
-                fullConnection.extension * fullConnection.extension;
-    }
-    for (const FullConnection& fullConnection: activeFullConnections) {
-        totalExtension += fullConnection.extension;
-        totalSquaredExtension +=
-                fullConnection.extension * fullConnection.extension;
+    for (const CrosslinkerContainer* const p_container:
+         {&m_passiveCrosslinkers, &m_dualCrosslinkers, &m_activeCrosslinkers}) {
+        const double extensionShift = p_container->getExtensionShift();
+        for (const FullConnection& fullConnection:
+             p_container->getFullConnections()) {
+            const double extension = fullConnection.extension + extensionShift;
+            totalExtension += extension;
+            totalSquaredExtension += extension * extension;
+        }
     }
 
     // Force has a minus sign: a positively expanded linker pulls the mobile
     // microtubule to negative values
-    m_forceMicrotubule = -m_springConstant * totalExtension;
-    m_energy = 0.5 * m_springConstant * totalSquaredExtension;
+    m_forceMicrotubule = -mp_model->getSpringConstant() * totalExtension;
+    m_energy = 0.5 * mp_model->getSpringConstant() * totalSquaredExtension;
     m_totalExtensionLinkers =
             totalExtension; // save, for this can be used by the propagator to
                             // integrate the force over the time step (instead
                             // of assuming a constant force during it)
 
     // Recalculate the external force every time step, since it can change
-    // depending on the position of the microtubule
-    m_forceMicrotubule += findExternalForce();
+    // depending on the position of the microtubule. Store it, such that the
+    // propagator does not need to recalculate it when moving the microtubule
+    m_externalForce = findExternalForce();
+    m_forceMicrotubule += m_externalForce;
+}
+
+double SystemState::findLinkerForceInDoublePrecision() const {
+    double totalExtension = 0;
+    for (const CrosslinkerContainer* const p_container:
+         {&m_passiveCrosslinkers, &m_dualCrosslinkers, &m_activeCrosslinkers}) {
+        for (const FullConnection& fullConnection:
+             p_container->getFullConnections()) {
+            totalExtension +=
+                    p_container->findExtension(*fullConnection.p_fullLinker);
+        }
+    }
+    return -mp_model->getSpringConstant() * totalExtension;
 }
 
 double SystemState::getForce() const {
@@ -934,29 +1640,39 @@ double SystemState::getTotalExtensionLinkers() const {
     return m_totalExtensionLinkers;
 }
 
+double SystemState::getExternalForce() const {
+    // call the updateForceAndEnergy function before!
+    return m_externalForce;
+}
+
 double SystemState::externalForceFlatOptimalPath() const {
+    const double latticeSpacing = mp_model->getLatticeSpacing();
     const double position = MathematicalFunctions::mod(
-            m_mobileMicrotubule.getPosition(), m_latticeSpacing);
-    const double positionFraction = position / m_latticeSpacing;
-    const double nSitesMobileMicrotubule =
-            static_cast<double>(m_mobileMicrotubule.getNSites());
-    const double nFullLinkers = static_cast<double>(getNFullCrosslinkers());
+            m_mobileMicrotubule.getPosition(), latticeSpacing);
+    const double positionFraction = position / latticeSpacing;
+    const int32_t nSitesMobileMicrotubule = m_mobileMicrotubule.getNSites();
+    const int32_t nFullLinkers = getNFullCrosslinkers();
+    const double fractionalLinkers = positionFraction * nFullLinkers;
 
     // The following force has to counter the force felt by the system at the
     // optimal path. Hence, use that force with a minus sign. See notes for
     // explanations. First, calculate the energetic part:
-    double externalForce = m_springConstant * nFullLinkers *
-                           (0.5 * m_latticeSpacing - position);
-    // and then the entropic part:
-    externalForce += nFullLinkers / m_latticeSpacing *
-                     (gsl_sf_psi(
-                              nSitesMobileMicrotubule -
-                              positionFraction * nFullLinkers + 1) -
-                      gsl_sf_psi((1 - positionFraction) * nFullLinkers + 1) -
-                      gsl_sf_psi(
-                              nSitesMobileMicrotubule -
-                              (1 - positionFraction) * nFullLinkers + 1) +
-                      gsl_sf_psi(positionFraction * nFullLinkers + 1));
+    double externalForce = mp_model->getSpringConstant() * nFullLinkers *
+                           (0.5 * latticeSpacing - position);
+    // and then the entropic part. It contains the digamma functions
+    // psi(M - fN + 1) - psi((1-f)N + 1) - psi(M - (1-f)N + 1) + psi(fN + 1),
+    // with M the number of sites on the mobile microtubule, N the number of
+    // full linkers and f the position fraction. Pairwise, their arguments
+    // differ by the integer M - N, such that the differences reduce to sums
+    // over fractions.
+    externalForce +=
+            nFullLinkers / latticeSpacing *
+            (MathematicalFunctions::digammaDifference(
+                     nFullLinkers - fractionalLinkers + 1,
+                     nSitesMobileMicrotubule - nFullLinkers) -
+             MathematicalFunctions::digammaDifference(
+                     fractionalLinkers + 1,
+                     nSitesMobileMicrotubule - nFullLinkers));
 
     return externalForce;
 }
@@ -964,22 +1680,22 @@ double SystemState::externalForceFlatOptimalPath() const {
 double SystemState::findExternalForce() const {
     double externalForce = 0;
 
-    if (m_addExternalForce) // It can be called without it actually doing
-                            // something
+    if (mp_model->addsExternalForce()) // It can be called without it
+                                       // actually doing something
     {
-        switch (m_externalForceType) {
-        case ExternalForceType::BARRIERFREE:
+        switch (mp_model->getExternalForceType()) {
+        case SystemModel::ExternalForceType::BARRIERFREE:
             externalForce = externalForceFlatOptimalPath();
             break;
-        case ExternalForceType::SINUS:
+        case SystemModel::ExternalForceType::SINUS:
             externalForce =
-                    -m_externalForceValue *
+                    -mp_model->getExternalForceValue() *
                     std::sin(
                             2 * m_pi * m_mobileMicrotubule.getPosition() /
-                            m_latticeSpacing);
+                            mp_model->getLatticeSpacing());
             break;
-        case ExternalForceType::CONSTANT:
-            externalForce = m_externalForceValue;
+        case SystemModel::ExternalForceType::CONSTANT:
+            externalForce = mp_model->getExternalForceValue();
             break;
         default:
             throw GeneralException(
@@ -1045,4 +1761,6 @@ void SystemState::TESTunbindAFullCrosslinker(
 }
 #endif // MYDEBUG
 
-double SystemState::getLatticeSpacing() const { return m_latticeSpacing; }
+double SystemState::getLatticeSpacing() const {
+    return mp_model->getLatticeSpacing();
+}
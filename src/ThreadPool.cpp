@@ -0,0 +1,121 @@
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+
+ThreadPool::ThreadPool(const int32_t nThreads):
+        mp_task(nullptr),
+        m_nTasks(0),
+        m_nextTask(0),
+        m_nUnfinishedTasks(0),
+        m_generation(0),
+        m_stop(false) {
+    if (nThreads < 1) {
+        throw GeneralException(
+                "ThreadPool::ThreadPool() was called with less than one "
+                "thread");
+    }
+
+    m_workers.reserve(nThreads - 1);
+    for (int32_t i = 1; i < nThreads; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_tasksAvailable.notify_all();
+    for (std::thread& worker: m_workers) {
+        worker.join();
+    }
+}
+
+int32_t ThreadPool::getNThreads() const {
+    return static_cast<int32_t>(m_workers.size()) + 1;
+}
+
+void ThreadPool::parallelFor(
+        const int32_t nTasks,
+        const std::function<void(int32_t)>& task) {
+    // Without workers, or with a single task, there is nothing to distribute
+    if (m_workers.empty() || nTasks <= 1) {
+        for (int32_t taskNumber = 0; taskNumber < nTasks; ++taskNumber) {
+            task(taskNumber);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        mp_task = &task;
+        m_nTasks = nTasks;
+        m_nextTask = 0;
+        m_nUnfinishedTasks = nTasks;
+        m_taskException = nullptr;
+        ++m_generation;
+    }
+    m_tasksAvailable.notify_all();
+
+    runTasks();
+
+    std::exception_ptr taskException;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_tasksFinished.wait(lock, [this] { return m_nUnfinishedTasks == 0; });
+        mp_task = nullptr;
+        taskException = m_taskException;
+    }
+
+    if (taskException) {
+        std::rethrow_exception(taskException);
+    }
+}
+
+void ThreadPool::runTasks() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_nextTask < m_nTasks) {
+        const int32_t taskNumber = m_nextTask++;
+        const std::function<void(int32_t)>* const p_task = mp_task;
+        lock.unlock();
+
+        try {
+            (*p_task)(taskNumber);
+        }
+        catch (...) {
+            lock.lock();
+            m_taskException = std::current_exception();
+            lock.unlock();
+        }
+
+        lock.lock();
+        if (--m_nUnfinishedTasks == 0) {
+            m_tasksFinished.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop() {
+    int64_t generationSeen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_tasksAvailable.wait(lock, [this, generationSeen] {
+                return m_stop || m_generation != generationSeen;
+            });
+            if (m_stop) {
+                return;
+            }
+            generationSeen = m_generation;
+        }
+
+        runTasks();
+    }
+}
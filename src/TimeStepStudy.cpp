@@ -0,0 +1,345 @@
+#include <algorithm> // std::max
+#include <cmath>
+#include <cstdint>
+#include <cstdlib> // std::system
+#include <fstream>
+#include <iomanip> // std::setw
+#include <limits>
+#include <sstream>
+#include <string>
+#include <sys/stat.h> // mkdir, only works on POSIX systems
+#include <vector>
+
+#include "filament-sliding/GeneralException.hpp"
+#include "filament-sliding/Input.hpp"
+#include "filament-sliding/OutputParameters.hpp"
+#include "filament-sliding/Statistics.hpp"
+#include "filament-sliding/ThreadPool.hpp"
+#include "filament-sliding/TimeStepStudy.hpp"
+
+TimeStepStudy::TimeStepStudy(
+        const std::string& runName,
+        const std::string& programName,
+        const int32_t nRungs,
+        const double factor,
+        const double tolerance,
+        const double calcTimeStep):
+        m_runName(runName),
+        m_programName(programName),
+        m_tolerance(tolerance) {
+    if (nRungs < 2 || factor <= 1.0) {
+        throw GeneralException(
+                "TimeStepStudy needs at least two time steps that differ.");
+    }
+    for (int32_t rung = 0; rung < nRungs; ++rung) {
+        m_timeSteps.push_back(calcTimeStep * std::pow(factor, rung));
+        m_directories.push_back(
+                m_runName + ".timestep_" + std::to_string(rung));
+    }
+
+    const std::vector<double> unmeasured(
+            nRungs, std::numeric_limits<double>::quiet_NaN());
+    m_observables = {
+            {"BARRIER CROSSING RATE", "s^(-1)", unmeasured, unmeasured},
+            {"DIFFUSION CONSTANT", "micron^2/s", unmeasured, unmeasured},
+            {"MEAN REMAINDER", "micron", unmeasured, unmeasured},
+            {"VARIANCE REMAINDER", "micron^2", unmeasured, unmeasured}};
+}
+
+TimeStepStudy::~TimeStepStudy() {}
+
+TimeStepStudy::Observable& TimeStepStudy::getObservable(
+        const std::string& name) {
+    for (Observable& observable: m_observables) {
+        if (observable.name == name) {
+            return observable;
+        }
+    }
+    throw GeneralException(
+            "TimeStepStudy::getObservable() was called with the unknown "
+            "observable " +
+            name);
+}
+
+void TimeStepStudy::prepareRungs(Input& input) const {
+    // The parameters that count time steps are scaled, such that they cover
+    // the same time at every rung
+    const std::vector<std::string> stepParameters = {
+            "timeStepsPerBlock",
+            "positionProbePeriod",
+            "coarseGrainingPeriod",
+            "checkpointPeriod",
+            "equilibrationProbePeriod",
+            "timeStepsDisplayInterval",
+            "transitionPathProbePeriod",
+            "timeStepsPerDistributionEstimate"};
+    std::vector<int32_t> nSteps(stepParameters.size());
+    for (std::size_t i = 0; i < stepParameters.size(); ++i) {
+        input.copyParameter(stepParameters[i], nSteps[i]);
+    }
+
+    input.overrideParameter("runName", std::string("rung"));
+    input.overrideParameter("showGraphics", std::string("FALSE"));
+    input.overrideParameter("resumeFromCheckpoint", std::string("NONE"));
+    input.overrideParameter("sharedAccumulators", std::string("NONE"));
+    for (std::size_t rung = 0; rung < m_timeSteps.size(); ++rung) {
+        const double scale = m_timeSteps[rung] / m_timeSteps.front();
+        input.overrideParameter("calcTimeStep", m_timeSteps[rung]);
+        for (std::size_t i = 0; i < stepParameters.size(); ++i) {
+            // A period of 0, which turns off checkpoints, is kept
+            const int32_t scaledNSteps =
+                    (nSteps[i] == 0)
+                            ? 0
+                            : std::max(
+                                      1,
+                                      static_cast<int32_t>(
+                                              std::lround(nSteps[i] / scale)));
+            input.overrideParameter(stepParameters[i], scaledNSteps);
+        }
+
+        if (mkdir(m_directories[rung].c_str(), 0755) != 0) {
+            throw GeneralException(
+                    "The directory " + m_directories[rung] +
+                    " could not be created.");
+        }
+        input.writeParameters(m_directories[rung] + "/parameters.txt");
+    }
+}
+
+void TimeStepStudy::runRungs(ThreadPool& threadPool) const {
+    threadPool.parallelFor(
+            static_cast<int32_t>(m_directories.size()),
+            [this](const int32_t rung) {
+                const std::string command =
+                        "cd \"" + m_directories[rung] + "\" && \"" +
+                        m_programName + "\" > stdout.txt 2>&1";
+                if (std::system(command.c_str()) != 0) {
+                    throw GeneralException(
+                            "The run in " + m_directories[rung] +
+                            " failed, see its log.");
+                }
+            });
+}
+
+void TimeStepStudy::readStatisticalAnalysis(const int32_t rung) {
+    std::ifstream file(
+            (m_directories[rung] + "/rung.statistical_analysis.txt").c_str());
+    std::string line;
+    std::getline(file, line); // The titles of the columns
+    while (std::getline(file, line)) {
+        if (line.size() < OutputParameters::collumnWidth) {
+            continue;
+        }
+        // The names of the variables contain spaces, so they are told apart
+        // by the width of the column
+        std::string name = line.substr(0, OutputParameters::collumnWidth);
+        name.erase(name.find_last_not_of(' ') + 1);
+        std::istringstream values(line.substr(OutputParameters::collumnWidth));
+        int64_t nSamples;
+        double mean;
+        double variance;
+        double SEM;
+        if (!(values >> nSamples >> mean >> variance >> SEM)) {
+            continue;
+        }
+
+        if (name == "BARRIER CROSSING TIME") {
+            Observable& rate = getObservable("BARRIER CROSSING RATE");
+            rate.values[rung] = 1.0 / mean;
+            rate.SEMs[rung] = SEM / (mean * mean);
+        }
+        else if (name == "REMAINDER TOP MICROTUBULE POSITION") {
+            Observable& meanRemainder = getObservable("MEAN REMAINDER");
+            meanRemainder.values[rung] = mean;
+            meanRemainder.SEMs[rung] = SEM;
+            getObservable("VARIANCE REMAINDER").values[rung] = variance;
+        }
+    }
+}
+
+void TimeStepStudy::readMicrotubulePosition(const int32_t rung) {
+    std::ifstream file(
+            (m_directories[rung] + "/rung.microtubule_position.txt").c_str());
+    std::string line;
+    std::getline(file, line); // The titles of the columns
+
+    // Every displacement between consecutive probes within a block gives an
+    // estimate <dx^2>/(2 dt) of the diffusion constant
+    Statistics diffusionConstant;
+    bool hasPrevious = false;
+    double previousTime = 0.0;
+    double previousPosition = 0.0;
+    while (std::getline(file, line)) {
+        std::istringstream values(line);
+        double time;
+        double position;
+        if (!(values >> time >> position)) {
+            hasPrevious = false; // A new block starts
+            continue;
+        }
+        if (hasPrevious && time > previousTime) {
+            const double displacement = position - previousPosition;
+            diffusionConstant.addValue(
+                    displacement * displacement /
+                    (2.0 * (time - previousTime)));
+        }
+        hasPrevious = true;
+        previousTime = time;
+        previousPosition = position;
+    }
+
+    if (diffusionConstant.canReportStatistics()) {
+        Observable& observable = getObservable("DIFFUSION CONSTANT");
+        observable.values[rung] = diffusionConstant.getMean();
+        observable.SEMs[rung] = diffusionConstant.getSEM();
+    }
+}
+
+void TimeStepStudy::readObservables() {
+    for (std::size_t rung = 0; rung < m_timeSteps.size(); ++rung) {
+        readStatisticalAnalysis(static_cast<int32_t>(rung));
+        readMicrotubulePosition(static_cast<int32_t>(rung));
+    }
+}
+
+TimeStepStudy::Extrapolation TimeStepStudy::extrapolate(
+        const Observable& observable) const {
+    Extrapolation extrapolation {false, 0.0, 0.0, 0.0, 0.0};
+    std::vector<std::size_t> rungs;
+    bool allSEMsKnown = true;
+    for (std::size_t rung = 0; rung < m_timeSteps.size(); ++rung) {
+        if (std::isfinite(observable.values[rung])) {
+            rungs.push_back(rung);
+            allSEMsKnown = allSEMsKnown &&
+                           std::isfinite(observable.SEMs[rung]) &&
+                           observable.SEMs[rung] > 0.0;
+        }
+    }
+    if (rungs.size() < 2) {
+        return extrapolation;
+    }
+
+    // Least squares fit of value = intercept + slope * timeStep, weighted with
+    // the inverse variances when these are known
+    double sumWeights = 0.0;
+    double sumX = 0.0;
+    double sumY = 0.0;
+    double sumXX = 0.0;
+    double sumXY = 0.0;
+    for (const std::size_t rung: rungs) {
+        const double weight =
+                allSEMsKnown ? 1.0 / (observable.SEMs[rung] *
+                                      observable.SEMs[rung])
+                             : 1.0;
+        const double x = m_timeSteps[rung];
+        const double y = observable.values[rung];
+        sumWeights += weight;
+        sumX += weight * x;
+        sumY += weight * y;
+        sumXX += weight * x * x;
+        sumXY += weight * x * y;
+    }
+    const double determinant = sumWeights * sumXX - sumX * sumX;
+    extrapolation.intercept = (sumXX * sumY - sumX * sumXY) / determinant;
+    extrapolation.slope = (sumWeights * sumXY - sumX * sumY) / determinant;
+
+    // Without known errors, the variance of the values is estimated from the
+    // residuals, which requires more points than fit parameters
+    double residualVariance = 1.0;
+    if (!allSEMsKnown) {
+        double sumSquaredResiduals = 0.0;
+        for (const std::size_t rung: rungs) {
+            const double residual =
+                    observable.values[rung] - extrapolation.intercept -
+                    extrapolation.slope * m_timeSteps[rung];
+            sumSquaredResiduals += residual * residual;
+        }
+        residualVariance =
+                (rungs.size() > 2)
+                        ? sumSquaredResiduals / static_cast<double>(
+                                                        rungs.size() - 2)
+                        : std::numeric_limits<double>::quiet_NaN();
+    }
+    extrapolation.interceptSEM =
+            std::sqrt(residualVariance * sumXX / determinant);
+    extrapolation.slopeSEM =
+            std::sqrt(residualVariance * sumWeights / determinant);
+    extrapolation.isValid = (determinant > 0.0);
+    return extrapolation;
+}
+
+void TimeStepStudy::writeReport() const {
+    const int width = OutputParameters::collumnWidth;
+    std::ofstream report((m_runName + ".timestep_study.txt").c_str());
+    report << std::left
+           << "The observables were measured at every time step, and "
+              "extrapolated linearly to a vanishing time step. The relative "
+              "bias is the deviation of the fit from the extrapolation. It "
+              "only counts against a time step when the slope of the fit "
+              "exceeds its standard error.\n";
+
+    // Per time step, whether all observables that could be extrapolated are
+    // within the tolerance
+    std::vector<bool> isWithinTolerance(m_timeSteps.size(), true);
+    for (const Observable& observable: m_observables) {
+        report << "\n"
+               << observable.name << " (" << observable.unit << ")\n"
+               << std::setw(width) << "TIME STEP (s)" << std::setw(width)
+               << "VALUE" << std::setw(width) << "STANDARD ERROR OF THE MEAN"
+               << std::setw(width) << "RELATIVE BIAS" << std::setw(width)
+               << "RELATIVE BIAS SE" << '\n';
+
+        const Extrapolation extrapolation = extrapolate(observable);
+        // Without a standard error of the slope, the bias is taken to be real
+        const bool isSignificant =
+                !(std::abs(extrapolation.slope) <= extrapolation.slopeSEM);
+        for (std::size_t rung = 0; rung < m_timeSteps.size(); ++rung) {
+            report << std::setw(width) << m_timeSteps[rung] << std::setw(width)
+                   << observable.values[rung] << std::setw(width)
+                   << observable.SEMs[rung];
+            if (extrapolation.isValid) {
+                const double bias =
+                        std::abs(extrapolation.slope * m_timeSteps[rung] /
+                                 extrapolation.intercept);
+                report << std::setw(width) << bias << std::setw(width)
+                       << std::abs(extrapolation.slopeSEM * m_timeSteps[rung] /
+                                   extrapolation.intercept);
+                if (isSignificant && !(bias <= m_tolerance)) {
+                    isWithinTolerance[rung] = false;
+                }
+            }
+            report << '\n';
+        }
+
+        if (extrapolation.isValid) {
+            report << std::setw(width) << "EXTRAPOLATION" << std::setw(width)
+                   << extrapolation.intercept << std::setw(width)
+                   << extrapolation.interceptSEM << '\n'
+                   << std::setw(width) << "SLOPE" << std::setw(width)
+                   << extrapolation.slope << std::setw(width)
+                   << extrapolation.slopeSEM << '\n';
+            if (!isSignificant) {
+                report << "The slope is within its standard error, so the "
+                          "bias is not significant at any time step.\n";
+            }
+        }
+        else {
+            report << "The observable was measured at too few time steps to "
+                      "extrapolate it, and is left out of the "
+                      "recommendation.\n";
+        }
+    }
+
+    report << '\n';
+    for (std::size_t rung = m_timeSteps.size(); rung-- > 0;) {
+        if (isWithinTolerance[rung]) {
+            report << "Recommended time step: " << m_timeSteps[rung]
+                   << " s, at which the significant relative bias is at most "
+                   << m_tolerance << ".\n";
+            return;
+        }
+    }
+    report << "None of the time steps keeps the significant relative bias "
+              "within "
+           << m_tolerance << ", so a smaller calcTimeStep is needed.\n";
+}
@@ -1,8 +1,11 @@
 #include <cstdint>
 #include <iomanip>
+#include <istream>
+#include <ostream>
 #include <stdexcept>
 #include <vector>
 
+#include "filament-sliding/Checkpoint.hpp"
 #include "filament-sliding/GeneralException.hpp"
 #include "filament-sliding/OutputParameters.hpp"
 #include "filament-sliding/TransitionPath.hpp"
@@ -22,6 +25,30 @@ void TransitionPath::addPoint(
 
 void TransitionPath::clean() { m_pathVector.clear(); }
 
+void TransitionPath::writeCheckpoint(std::ostream& out) const {
+    Checkpoint::write(out, static_cast<int64_t>(m_pathVector.size()));
+    for (const SystemCoordinate& coordinate: m_pathVector) {
+        Checkpoint::write(out, coordinate.m_time);
+        Checkpoint::write(out, coordinate.m_mobilePosition);
+        Checkpoint::write(out, coordinate.m_nRightPullingCrosslinkers);
+    }
+}
+
+void TransitionPath::readCheckpoint(std::istream& in) {
+    int64_t nPoints;
+    Checkpoint::read(in, nPoints);
+    m_pathVector.clear();
+    for (int64_t point = 0; point < nPoints; ++point) {
+        double time;
+        double mobilePosition;
+        int32_t nRightPullingCrosslinkers;
+        Checkpoint::read(in, time);
+        Checkpoint::read(in, mobilePosition);
+        Checkpoint::read(in, nRightPullingCrosslinkers);
+        addPoint(time, mobilePosition, nRightPullingCrosslinkers);
+    }
+}
+
 int32_t TransitionPath::getSize() const { return m_pathVector.size(); }
 
 double TransitionPath::getMobilePosition(const int32_t label) const {
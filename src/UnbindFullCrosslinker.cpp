@@ -1,6 +1,11 @@
+#include <cmath> // exp
+#include <cstddef> // size_t
+#include <cstdint>
+#include <functional>
 #include <vector>
 
 #include "filament-sliding/FullConnection.hpp"
+#include "filament-sliding/MicrotubuleType.hpp"
 #include "filament-sliding/RandomGenerator.hpp"
 #include "filament-sliding/SystemState.hpp"
 #include "filament-sliding/UnbindFullCrosslinker.hpp"
@@ -23,23 +28,35 @@ UnbindFullCrosslinker::~UnbindFullCrosslinker() {}
 void UnbindFullCrosslinker::setCurrentRate(const SystemState& systemState) {
     const std::vector<FullConnection>& fullConnections =
             systemState.getFullConnections(m_typeToUnbind);
-    m_individualRates.clear();
-    m_individualRates.reserve(fullConnections.size());
-    double sum = 0;
-    for (const FullConnection& fullConnection: fullConnections) {
-        // spread the effect of extension evenly over connecting and
-        // disconnecting: rate scales with exp(k x^2 / (4 k_B T)) Give the rate
-        // of unbinding this crosslinker: which terminus is unbound is decided
-        // upon performing the actual event.
-        const double rate =
-                m_rateOneLinkerUnbinds *
-                std::exp(
-                        m_springConstant * fullConnection.extension *
-                        fullConnection.extension * 0.25);
-        m_individualRates.push_back(rate);
-        sum += rate;
-    }
-    m_currentRate = sum;
+    const double extensionShift = systemState.getExtensionShift(m_typeToUnbind);
+    m_individualRates.resize(fullConnections.size());
+
+    forEachRateChunk(
+            fullConnections.size(),
+            [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t label = begin; label < end; ++label) {
+                    if (mp_domains != nullptr) {
+                        setPossibilityDomain(
+                                label,
+                                fullConnections[label]
+                                        .p_fullLinker->getLocationOfFullOn(
+                                                MicrotubuleType::FIXED));
+                    }
+                    const double extension =
+                            fullConnections[label].extension + extensionShift;
+                    // spread the effect of extension evenly over connecting and
+                    // disconnecting: rate scales with exp(k x^2 / (4 k_B T))
+                    // Give the rate of unbinding this crosslinker: which
+                    // terminus is unbound is decided upon performing the actual
+                    // event.
+                    m_individualRates[label] =
+                            m_rateOneLinkerUnbinds *
+                            std::exp(
+                                    m_springConstant * extension * extension *
+                                    0.25);
+                }
+            });
+    m_currentRate = sumRates(m_individualRates);
 }
 
 void UnbindFullCrosslinker::performReaction(
@@ -90,3 +107,25 @@ FullConnection UnbindFullCrosslinker::whichToDisconnect(
     throw GeneralException(
             "The end of UnbindFullCrosslinker::whichToConnect() was reached");
 }
+
+bool UnbindFullCrosslinker::hasRatePerPossibility() const { return true; }
+
+std::function<void(SystemState&)> UnbindFullCrosslinker::
+        chooseReactionInDomain(
+                const SystemState& systemState,
+                RandomGenerator& generator,
+                const int32_t domain) const {
+    Crosslinker* const p_linkerToDisconnect =
+            systemState.getFullConnections(m_typeToUnbind)[chooseLabelInDomain(
+                    m_individualRates, generator, domain)]
+                    .p_fullLinker;
+    const Crosslinker::Terminus terminusToDisconnect =
+            ((generator.getBernoulli(m_probHeadUnbinds)) ?
+                     (Crosslinker::Terminus::HEAD) :
+                     (Crosslinker::Terminus::TAIL));
+    return [p_linkerToDisconnect,
+            terminusToDisconnect](SystemState& changedSystemState) {
+        changedSystemState.disconnectFullyConnectedCrosslinker(
+                *p_linkerToDisconnect, terminusToDisconnect);
+    };
+}